@@ -0,0 +1,48 @@
+#ifndef STARGBC_COREBENCH_H
+#define STARGBC_COREBENCH_H
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <Gameboy.h>
+
+#include "CoreComparison.h"
+
+struct CoreResult {
+    const char *name;
+    double seconds;
+    std::vector<uint32_t> finalFrame;
+};
+
+static CoreResult TimeCore(const BenchCore &core, const GameboySettings &settings, const int frames) {
+    Gameboy gameboy(settings);
+
+    // Warm up caches and the coroutine frame slot before timing
+    for (int i = 0; i < 10; i++) gameboy.RunFrame();
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < frames; i++) gameboy.RunFrame();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    const uint32_t *screen = gameboy.GetScreenData();
+    return {core.name, elapsed.count(), std::vector(screen, screen + SCREEN_WIDTH * SCREEN_HEIGHT)};
+}
+
+// Runs the same ROM through each CPU core and reports frames per second,
+// and which cores ended on a different frame (see CompareFinalStates)
+static int BenchCores(const std::string &rom, const int frames, const Mode mode) {
+    const std::vector<CoreResult> results = TimeEachCore(
+        {.romName = rom, .mode = mode},
+        [&](const BenchCore &core, const GameboySettings &settings) { return TimeCore(core, settings, frames); });
+
+    for (const auto &[name, seconds, finalFrame]: results) {
+        std::printf("%-12s %8.1f frames/s %10.1f us/frame %6.2fx\n", name, frames / seconds,
+                    seconds * 1e6 / frames, results[0].seconds / seconds);
+    }
+    return CompareFinalStates(results, [](const CoreResult &result) -> const auto & { return result.finalFrame; },
+                              "frame");
+}
+
+#endif //STARGBC_COREBENCH_H
@@ -0,0 +1,63 @@
+#ifndef STARGBC_CORECOMPARISON_H
+#define STARGBC_CORECOMPARISON_H
+
+#include <cstdio>
+#include <vector>
+
+#include <Gameboy.h>
+
+// The CPU core configurations --cores and --movie run side by side. The
+// first EXACT_BENCH_CORES are cycle-accurate and have to end in the same
+// state, otherwise the timings are meaningless; the rest may drift.
+struct BenchCore {
+    const char *name;
+    CpuCore cpuCore;
+    bool fast;
+    bool blocks;
+    bool jit;
+};
+
+static constexpr BenchCore BENCH_CORES[] = {
+    {"step table", CpuCore::StepTable, false, false, false},
+    {"coroutine", CpuCore::Coroutine, false, false, false},
+    {"fast", CpuCore::StepTable, true, false, false},
+    {"blocks", CpuCore::StepTable, true, true, false},
+    {"jit", CpuCore::StepTable, true, true, true},
+};
+
+static constexpr size_t EXACT_BENCH_CORES = 2;
+
+// Calls time(core, settings) for every core, with `settings` switched to
+// that core and unthrottled
+template<typename Time>
+static auto TimeEachCore(const GameboySettings &settings, Time time) {
+    std::vector<decltype(time(BENCH_CORES[0], settings))> results;
+    for (const BenchCore &core: BENCH_CORES) {
+        GameboySettings coreSettings = settings;
+        coreSettings.cpuCore = core.cpuCore;
+        coreSettings.fastCore = core.fast;
+        coreSettings.blockCache = core.blocks;
+        coreSettings.jit = core.jit;
+        coreSettings.unthrottled = true;
+        results.push_back(time(core, coreSettings));
+    }
+    return results;
+}
+
+// Compares what each core ended on, final(result), with the first core.
+// Returns 1 when the cycle-accurate cores disagree; drift in the others is
+// only reported. `what` names the compared thing in the messages.
+template<typename Result, typename Final>
+static int CompareFinalStates(const std::vector<Result> &results, Final final, const char *what) {
+    for (size_t i = 1; i < results.size(); i++) {
+        if (final(results[i]) == final(results[0])) continue;
+        if (i < EXACT_BENCH_CORES) {
+            std::fprintf(stderr, "Cores diverged: final %ss differ\n", what);
+            return 1;
+        }
+        std::printf("%s drifted: final %s differs from the cycle-accurate cores\n", BENCH_CORES[i].name, what);
+    }
+    return 0;
+}
+
+#endif //STARGBC_CORECOMPARISON_H
@@ -0,0 +1,56 @@
+#ifndef STARGBC_IDLELOOPBENCH_H
+#define STARGBC_IDLELOOPBENCH_H
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <Gameboy.h>
+
+struct IdleLoopRun {
+    double seconds;
+    IdleLoopStats stats;
+    std::vector<uint32_t> finalFrame;
+};
+
+static IdleLoopRun TimeIdleLoops(GameboySettings settings, const bool idleLoops, const int frames) {
+    settings.idleLoops = idleLoops;
+    settings.unthrottled = true;
+    Gameboy gameboy(settings);
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < frames; i++) gameboy.RunFrame();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    const uint32_t *screen = gameboy.GetScreenData();
+    return {elapsed.count(), gameboy.GetIdleLoopStats(), std::vector(screen, screen + SCREEN_WIDTH * SCREEN_HEIGHT)};
+}
+
+// Runs each ROM with and without idle-loop skipping, on the cycle-accurate
+// and the fast core, and reports the share of emulated time skipped. Skipping
+// is exact, so any difference in the final frame is a bug.
+static int BenchIdleLoops(const std::vector<std::string> &roms, const int frames, const Mode mode) {
+    static constexpr double kFrameCycles = 70224.0 * 2;
+    int status = 0;
+    std::printf("%-32s %-5s %9s %8s %10s %8s\n", "rom", "core", "skips", "skipped", "frames/s", "speedup");
+    for (const auto &rom: roms) {
+        for (const bool fast: {false, true}) {
+            GameboySettings settings{.romName = rom, .mode = mode};
+            settings.fastCore = fast;
+            const IdleLoopRun base = TimeIdleLoops(settings, false, frames);
+            const IdleLoopRun skipping = TimeIdleLoops(settings, true, frames);
+            std::printf("%-32s %-5s %9llu %7.1f%% %10.1f %7.2fx\n", rom.c_str(), fast ? "fast" : "step",
+                        static_cast<unsigned long long>(skipping.stats.skips),
+                        100.0 * static_cast<double>(skipping.stats.skippedCycles) / (kFrameCycles * frames),
+                        frames / skipping.seconds, base.seconds / skipping.seconds);
+            if (skipping.finalFrame != base.finalFrame) {
+                std::fprintf(stderr, "%s: final frame differs with idle loops skipped\n", rom.c_str());
+                status = 1;
+            }
+        }
+    }
+    return status;
+}
+
+#endif //STARGBC_IDLELOOPBENCH_H
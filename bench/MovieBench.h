@@ -0,0 +1,49 @@
+#ifndef STARGBC_MOVIEBENCH_H
+#define STARGBC_MOVIEBENCH_H
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <Gameboy.h>
+#include <InputMovie.h>
+
+#include "CoreComparison.h"
+
+struct MovieResult {
+    const char *name;
+    double seconds;
+    uint64_t frames;
+    uint64_t finalState; // StateView hash
+};
+
+static MovieResult TimeMovie(const BenchCore &core, const GameboySettings &settings, const InputMovie &movie) {
+    Gameboy gameboy(settings);
+    gameboy.PlayMovie(movie);
+
+    uint64_t frames = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (; gameboy.IsPlayingMovie(); frames++) gameboy.RunFrame();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return {core.name, elapsed.count(), frames, gameboy.GetStateView().Hash()};
+}
+
+// Replays a recorded session on each CPU core at full speed. As with
+// --cores, the cycle-accurate cores have to finish in the same state; the
+// fast ones apply key changes a few cycles off and only report drifting.
+static int BenchMovie(const std::string &rom, const std::string &moviePath, const Mode mode) {
+    const InputMovie movie = InputMovie::Read(moviePath);
+    const std::vector<MovieResult> results = TimeEachCore(
+        {.romName = rom, .mode = mode, .readOnlySave = true},
+        [&](const BenchCore &core, const GameboySettings &settings) { return TimeMovie(core, settings, movie); });
+
+    for (const auto &[name, seconds, frames, finalState]: results) {
+        std::printf("%-12s %8llu frames %10.1f frames/s  state %016llx\n", name,
+                    static_cast<unsigned long long>(frames), static_cast<double>(frames) / seconds,
+                    static_cast<unsigned long long>(finalState));
+    }
+    return CompareFinalStates(results, [](const MovieResult &result) { return result.finalState; }, "state");
+}
+
+#endif //STARGBC_MOVIEBENCH_H
@@ -0,0 +1,92 @@
+#ifndef STARGBC_OPCODEBENCH_H
+#define STARGBC_OPCODEBENCH_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+#include "CPU.h"
+#include "FlatBus.h"
+
+struct OpcodeTiming {
+    uint32_t mCycles; // per run, 0 if the opcode never completes
+    double nsPerInstruction;
+    double nsPerMCycle;
+};
+
+// Runs one opcode `runs` times through CPU<FlatBus>, starting each run from
+// the same registers with the opcode already fetched at 0x0100, so jumps,
+// calls and returns repeat just like straight-line code. A CB row times the
+// op after the prefix; the prefix itself is row 0xCB of the main table.
+static OpcodeTiming TimeOpcode(const bool prefixed, const uint8_t opcode, const int runs) {
+    // Operand bytes: d8 0, a16/d16 $C000, r8 0
+    static constexpr Registers START{.a = 0x12, .f = 0x00, .b = 0xC0, .c = 0x10, .d = 0xC0, .e = 0x20, .h = 0xC0, .l = 0x30};
+    static constexpr uint16_t STACK = 0xDFF0;
+    FlatBus bus;
+    bus.memory[0x0101] = 0x00;
+    bus.memory[0x0102] = 0xC0;
+    Interrupts interrupts;
+    interrupts.interruptEnable = 0x00;
+    Registers registers;
+    CPU<FlatBus> cpu(Mode::DMG, nullptr, bus, interrupts, registers);
+    Instructions<CPU<FlatBus> > instructions(registers, interrupts);
+
+    const auto restart = [&] {
+        registers = START;
+        cpu.pc(0x0101);
+        cpu.sp(STACK);
+        cpu.halted(false);
+        cpu.stopped(false);
+        cpu.currentInstruction = opcode;
+        cpu.prefixed = prefixed;
+    };
+
+    // The unused opcodes hang until reset
+    restart();
+    uint32_t mCycles = 1;
+    while (!cpu.StepMCycle(instructions, false)) {
+        if (++mCycles > 8) return {0, 0.0, 0.0};
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int run = 0; run < runs; run++) {
+        restart();
+        while (!cpu.StepMCycle(instructions, false)) {
+        }
+    }
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return {mCycles, elapsed.count() / runs, elapsed.count() / (static_cast<double>(runs) * mCycles)};
+}
+
+// Every opcode of both tables, one line each, so runs from two builds can be
+// diffed to find the instructions whose dispatch got slower
+static int BenchOpcodes(const int runs) {
+    Registers registers;
+    Interrupts interrupts;
+    const Instructions<CPU<FlatBus> > names(registers, interrupts);
+    double totalNs = 0.0;
+    uint64_t totalMCycles = 0;
+    std::printf("%-6s %-14s %7s %9s %9s\n", "opcode", "instruction", "cycles", "ns/instr", "ns/cycle");
+    for (const bool prefixed: {false, true}) {
+        for (int opcode = 0; opcode < 0x100; opcode++) {
+            const uint16_t instruction = static_cast<uint16_t>((prefixed ? 0xCB00 : 0) | opcode);
+            const std::string mnemonic = names.GetMnemonic(instruction);
+            const OpcodeTiming timing = TimeOpcode(prefixed, static_cast<uint8_t>(opcode), runs);
+            if (timing.mCycles == 0) {
+                std::printf("%0*X%*s %-14s %7s\n", prefixed ? 4 : 2, instruction, prefixed ? 2 : 4, "",
+                            mnemonic.c_str(), "hangs");
+                continue;
+            }
+            std::printf("%0*X%*s %-14s %7u %9.2f %9.2f\n", prefixed ? 4 : 2, instruction, prefixed ? 2 : 4, "",
+                        mnemonic.c_str(), timing.mCycles, timing.nsPerInstruction, timing.nsPerMCycle);
+            totalNs += timing.nsPerInstruction;
+            totalMCycles += timing.mCycles;
+        }
+    }
+    std::printf("\nmean %.2f ns/M-cycle over all opcodes, %d runs each\n",
+                totalNs / static_cast<double>(std::max<uint64_t>(totalMCycles, 1)), runs);
+    return 0;
+}
+
+#endif //STARGBC_OPCODEBENCH_H
@@ -0,0 +1,40 @@
+#ifndef STARGBC_PROFILEBENCH_H
+#define STARGBC_PROFILEBENCH_H
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+#include <Gameboy.h>
+
+// Frames per second with the profiler off, on exactly and on sampling 1 in
+// 16, followed by the exact run's hotspot report
+static double TimeProfiled(const GameboySettings &settings, const bool profile, const uint32_t sampleEvery,
+                           const int frames, const bool report) {
+    Gameboy gameboy(settings);
+    for (int i = 0; i < 10; i++) gameboy.RunFrame();
+    gameboy.SetProfiling(profile, sampleEvery);
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < frames; i++) gameboy.RunFrame();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    if (report) gameboy.WriteProfileReport(stdout, 20);
+    return elapsed.count();
+}
+
+static int BenchProfiler(const std::string &rom, const int frames, const Mode mode) {
+    GameboySettings settings{.romName = rom, .mode = mode};
+    settings.unthrottled = true;
+    settings.fastCore = true;
+    const double off = TimeProfiled(settings, false, 1, frames, false);
+    const double exact = TimeProfiled(settings, true, 1, frames, true);
+    const double sampled = TimeProfiled(settings, true, 16, frames, false);
+    std::printf("\n%-10s %10s %9s\n", "profiler", "frames/s", "overhead");
+    std::printf("%-10s %10.1f %9s\n", "off", frames / off, "-");
+    std::printf("%-10s %10.1f %8.1f%%\n", "exact", frames / exact, 100.0 * (exact / off - 1.0));
+    std::printf("%-10s %10.1f %8.1f%%\n", "1 in 16", frames / sampled, 100.0 * (sampled / off - 1.0));
+    return 0;
+}
+
+#endif //STARGBC_PROFILEBENCH_H
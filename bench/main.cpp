@@ -0,0 +1,68 @@
+#include "CoreBench.h"
+#include "IdleLoopBench.h"
+#include "MovieBench.h"
+#include "OpcodeBench.h"
+#include "ProfileBench.h"
+
+int main(const int argc, char **argv) {
+    const std::vector<std::string_view> args(argv + 1, argv + argc);
+    std::vector<std::string> roms;
+    int frames = 600;
+    int runs = 100000;
+    Mode mode = Mode::None;
+    bool cores = false;
+    bool idleLoops = false;
+    bool profiler = false;
+    bool opcodes = false;
+    std::string moviePath;
+    for (size_t i = 0; i < args.size(); i++) {
+        if (args[i] == "--cores") {
+            cores = true;
+        } else if (args[i] == "--idle-loops") {
+            idleLoops = true;
+        } else if (args[i] == "--profiler") {
+            profiler = true;
+        } else if (args[i] == "--opcodes") {
+            opcodes = true;
+        } else if (args[i] == "--movie" && i + 1 < args.size()) {
+            moviePath = args[++i];
+        } else if (args[i] == "--frames" && i + 1 < args.size()) {
+            frames = std::stoi(std::string(args[++i]));
+        } else if (args[i] == "--runs" && i + 1 < args.size()) {
+            runs = std::stoi(std::string(args[++i]));
+        } else if (args[i] == "--gbc") {
+            mode = Mode::CGB_GBC;
+        } else if (args[i] == "--gb") {
+            mode = Mode::DMG;
+        } else {
+            roms.emplace_back(args[i]);
+        }
+    }
+
+    const bool romsMatch = opcodes ? roms.empty() : !roms.empty() && (idleLoops || roms.size() == 1);
+    const bool movie = !moviePath.empty();
+    if (cores + idleLoops + profiler + opcodes + movie != 1 || !romsMatch || frames <= 0 || runs <= 0) {
+        std::fprintf(stderr, "USAGE: StarGBC_Bench [options] <rom>...\n"
+                     "Options:\n"
+                     "  --cores             step table vs coroutine vs fast CPU core (one rom)\n"
+                     "  --idle-loops        cycles skipped in busy-wait loops, per rom\n"
+                     "  --profiler          per-PC profiler overhead and hotspots (one rom)\n"
+                     "  --opcodes           ns per instruction and M-cycle for every opcode (no rom)\n"
+                     "  --movie <file>      replay a recorded movie on every core (one rom)\n"
+                     "  --frames <n>        frames to time (default 600)\n"
+                     "  --runs <n>          runs of each opcode (default 100000)\n"
+                     "  --gbc | --gb        force gbc/dmg mode\n");
+        return -1;
+    }
+    if (opcodes) return BenchOpcodes(runs);
+    if (profiler) return BenchProfiler(roms.front(), frames, mode);
+    if (movie) {
+        try {
+            return BenchMovie(roms.front(), moviePath, mode);
+        } catch (const std::exception &e) {
+            std::fprintf(stderr, "Error: %s\n", e.what());
+            return -1;
+        }
+    }
+    return cores ? BenchCores(roms.front(), frames, mode) : BenchIdleLoops(roms, frames, mode);
+}
@@ -9,6 +9,9 @@
 class Audio;
 
 static constexpr int AUDIO_SAMPLE_RATE = 48000; // Higher sample rate for better quality
+// A frame's samples must fit in the sample buffer (AUDIO_BUFFER_SIZE)
+static constexpr int MIN_AUDIO_SAMPLE_RATE = 8000;
+static constexpr int MAX_AUDIO_SAMPLE_RATE = 96000;
 static constexpr int AUDIO_BUFFER_SIZE = 2048;
 static constexpr double APU_CLOCK_RATE = 4194304.0;
 static constexpr double CYCLES_PER_SAMPLE = APU_CLOCK_RATE / AUDIO_SAMPLE_RATE;
@@ -33,6 +36,11 @@ struct BandLimited {
         lastLeft = lastRight = 0.0;
         pos = 0;
     }
+
+    template<typename Archive>
+    void Serialize(Archive &archive) {
+        archive(bufferLeft, bufferRight, outputLeft, outputRight, lastLeft, lastRight, pos);
+    }
 };
 
 struct Frequency {
@@ -65,6 +73,11 @@ struct Sweep {
     [[nodiscard]] uint8_t Value() const {
         return static_cast<uint8_t>(pace << 4 | (direction ? 0x08 : 0x00) | step | 0x80);
     }
+
+    template<typename Archive>
+    void Serialize(Archive &archive) {
+        archive(pace, direction, step, timer, enabled, shadowFreq, subtractionCalculationMade);
+    }
 };
 
 struct Envelope {
@@ -98,6 +111,11 @@ struct Length {
     [[nodiscard]] uint8_t Value() const {
         return static_cast<uint8_t>(dutyCycle << 6 | 0x3F);
     }
+
+    template<typename Archive>
+    void Serialize(Archive &archive) {
+        archive(enabled, lengthTimer, dutyCycle);
+    }
 };
 
 struct Noise {
@@ -166,6 +184,12 @@ struct Channel1 final : Channel {
     void WriteByte(uint16_t address, uint8_t value, bool audioEnabled, uint8_t freqStep, uint32_t tickCounter);
 
     [[nodiscard]] uint8_t GetDigitalOutput() const;
+
+    template<typename Archive>
+    void Serialize(Archive &archive) {
+        archive(enabled, dacEnabled, sweep, lengthTimer, envelope, frequency, freqTimer, pcmUpdateDelay, dutyStep,
+                pcmOutput, currentOutput);
+    }
 };
 
 struct Channel2 final : Channel {
@@ -191,6 +215,11 @@ struct Channel2 final : Channel {
     void WriteByte(uint16_t address, uint8_t value, bool audioEnabled, uint8_t freqStep, uint32_t tickCounter);
 
     [[nodiscard]] uint8_t GetDigitalOutput() const;
+
+    template<typename Archive>
+    void Serialize(Archive &archive) {
+        archive(enabled, dacEnabled, lengthTimer, envelope, frequency, freqTimer, dutyStep, currentOutput);
+    }
 };
 
 struct Channel3 final : Channel {
@@ -229,6 +258,12 @@ struct Channel3 final : Channel {
     void WriteByte(uint16_t address, uint8_t value, uint8_t freqStep, bool dmg);
 
     [[nodiscard]] uint8_t GetDigitalOutput() const;
+
+    template<typename Archive>
+    void Serialize(Archive &archive) {
+        archive(enabled, dacEnabled, lengthEnabled, playing, alternateRead, lengthTimer, outputLevel, volumeShift,
+                frequency, sampleByte, period, waveStep, currentOutput, waveRam);
+    }
 };
 
 struct Channel4 final : Channel {
@@ -258,6 +293,11 @@ struct Channel4 final : Channel {
     void WriteByte(uint16_t address, uint8_t value, bool audioEnabled, uint8_t freqStep);
 
     [[nodiscard]] uint8_t GetDigitalOutput() const;
+
+    template<typename Archive>
+    void Serialize(Archive &archive) {
+        archive(enabled, dacEnabled, lengthTimer, envelope, noise, freqTimer, lfsr, currentOutput, trigger);
+    }
 };
 
 class Audio {
@@ -268,29 +308,31 @@ class Audio {
     bool skipNextFrameSeqTick{false};
     uint32_t tickCounter{0};
 
-    std::vector<float> sampleBuffer{};
+    std::array<float, AUDIO_BUFFER_SIZE * 2> sampleBuffer{}; // *2 for stereo
     size_t bufferWritePos{0};
     size_t bufferReadPos{0};
     size_t samplesAvailable{0};
     double sampleCounter{0.0};
+    uint32_t sampleRate{AUDIO_SAMPLE_RATE};
+    double cyclesPerSample{CYCLES_PER_SAMPLE};
 
     std::array<BandLimited, 4> bandLimited{};
-    std::array<std::array<double, BL_WIDTH>, BL_PHASES> blSteps{};
+    // Read-only and identical for every instance, so it is built once per process
+    using BandLimitedTable = std::array<std::array<double, BL_WIDTH>, BL_PHASES>;
+    const BandLimitedTable *blSteps{&BandLimitedSteps()};
     double highpassLeft{0.0};
     double highpassRight{0.0};
     double highpassRate{0.0};
 
-    void InitBandLimitedTable();
+    static const BandLimitedTable &BandLimitedSteps();
 
     void BandLimitedUpdate(int channel, double left, double right, int phase);
 
     void BandLimitedRead(int channel, double &outLeft, double &outRight);
 
 public:
-    Audio() {
-        sampleBuffer.resize(AUDIO_BUFFER_SIZE * 2); // *2 for stereo
-        highpassRate = std::pow(0.999958, APU_CLOCK_RATE / AUDIO_SAMPLE_RATE);
-        InitBandLimitedTable();
+    explicit Audio(const uint32_t rate = AUDIO_SAMPLE_RATE) {
+        SetSampleRate(rate);
     }
 
     Channel1 ch1{};
@@ -301,10 +343,20 @@ public:
     uint8_t nr50{};
     uint8_t nr51{};
 
+    // Samples buffered, and dropped because the buffer was full; gathered
+    // once per frame
+    uint64_t samplesProduced{0};
+    uint64_t samplesDropped{0};
+
     void SetDMG(const bool value) { dmg = value; }
     [[nodiscard]] bool IsDMG() const { return dmg; }
     [[nodiscard]] uint32_t GetTickCounter() const { return tickCounter; }
 
+    // Output rate, a host setting that snapshots leave alone
+    void SetSampleRate(uint32_t rate);
+
+    [[nodiscard]] uint32_t GetSampleRate() const { return sampleRate; }
+
     // DIV-APU
     void TickFrameSequencer();
 
@@ -329,4 +381,13 @@ public:
     size_t ReadSamples(float *output, size_t numSamples);
 
     void ClearBuffer();
+
+    // Samples not yet read are included: a full buffer changes how the
+    // next ones are filtered
+    template<typename Archive>
+    void Serialize(Archive &archive) {
+        archive(audioEnabled, dmg, cycleCounter, frameSeqStep, skipNextFrameSeqTick, tickCounter, sampleBuffer,
+                bufferWritePos, bufferReadPos, samplesAvailable, sampleCounter, bandLimited, highpassLeft,
+                highpassRight, ch1, ch2, ch3, ch4, nr50, nr51);
+    }
 };
@@ -0,0 +1,205 @@
+#ifndef STARGBC_BLOCKCACHE_H
+#define STARGBC_BLOCKCACHE_H
+
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+
+#include "Cartridge.h"
+#include "Instructions.h"
+#include "Memory.h"
+
+template<typename CPUType>
+class BlockJit;
+
+// Runs of straight-line code decoded once and replayed by CPU::RunBlock.
+// Blocks are keyed by where their first byte physically lives: ROM code by
+// its offset into the ROM image, which tells banks apart, and WRAM/HRAM code
+// by its offset into RAM, revalidated against the page generation in Memory.
+// Running a block still goes through the Instructions step rows and reads
+// operands from the bus. What it saves is decoding and dispatch, and the
+// interrupt and peripheral checks between the instructions of the block.
+template<typename CPUType>
+class BlockCache {
+public:
+    using StepRow = typename Instructions<CPUType>::StepRow;
+
+    static constexpr uint8_t MAX_OPS = 32;
+
+    // A CB-prefixed instruction is two ops, PREFIX and then the CB opcode,
+    // matching how the CPU runs it
+    struct Op {
+        const StepRow *steps{nullptr};
+        uint8_t opcode{0};
+        bool prefixed{false};
+    };
+
+    struct Block {
+        std::array<Op, MAX_OPS> ops{};
+        uint8_t count{0};
+        uint16_t mCycles{0}; // every op summed, taking no branches
+        uint32_t generation{0}; // generation of the RAM page when decoded
+        // Left to BlockJit: times entered, and the native code once hot,
+        // valid when entered at nativeAddress
+        uint32_t runs{0};
+        const void *native{nullptr};
+        uint16_t nativeAddress{0};
+    };
+
+    // Block for the instruction the CPU has just fetched (at pc - 1), or
+    // null when that address is not cacheable or starts with an instruction
+    // a block cannot hold
+    Block *Lookup(CPUType &cpu) {
+        const uint16_t address = cpu.pc() - 1;
+        const auto &bus = cpu.bus_;
+        Memory &memory = bus.memory_;
+        uint32_t key;
+        const uint8_t *code;
+        const uint8_t *end;
+        size_t page = NO_PAGE;
+
+        if (address < 0x8000) {
+            if (bus.bootromRunning) return nullptr;
+            const size_t offset = bus.cartridge_.RomPageOffset(address);
+            if (offset == Cartridge::NO_ROM_OFFSET) return nullptr;
+            const uint8_t *rom = bus.cartridge_.RomPage(address);
+            key = static_cast<uint32_t>(offset + (address & 0x1FFF));
+            code = rom + (address & 0x1FFF);
+            end = rom + 0x2000;
+        } else if (address >= 0xC000 && address <= 0xDFFF) {
+            const size_t index = address < 0xD000
+                                     ? address - 0xC000
+                                     : address - 0xD000 + 0x1000 * (memory.wramBank_ & 0x07);
+            page = index >> 8;
+            key = WRAM_KEY | static_cast<uint32_t>(index);
+            code = memory.wram_.data() + index;
+            end = memory.wram_.data() + (page + 1) * 0x100;
+        } else if (address >= Memory::HRAM_BEGIN && address <= Memory::HRAM_END) {
+            page = Memory::HRAM_CODE_PAGE;
+            key = HRAM_KEY | (address - Memory::HRAM_BEGIN);
+            code = memory.hram_.data() + (address - Memory::HRAM_BEGIN);
+            end = memory.hram_.data() + (Memory::HRAM_END - Memory::HRAM_BEGIN + 1);
+        } else {
+            return nullptr;
+        }
+
+        auto [it, inserted] = blocks_.try_emplace(key);
+        Block &block = it->second;
+        if (page == NO_PAGE) {
+            if (inserted) Decode(block, code, end);
+        } else if (inserted || block.generation != memory.codeGenerations_[page]) {
+            Decode(block, code, end);
+            block.generation = memory.codeGenerations_[page];
+            memory.codePages_[page] = true;
+        }
+        return block.count ? &block : nullptr;
+    }
+
+    void Clear() { blocks_.clear(); }
+
+    [[nodiscard]] size_t size() const { return blocks_.size(); }
+
+private:
+    friend class BlockJit<CPUType>;
+
+    static constexpr size_t NO_PAGE = SIZE_MAX;
+    static constexpr uint32_t WRAM_KEY = 0x0100'0000; // above any ROM offset (8 MiB max)
+    static constexpr uint32_t HRAM_KEY = 0x0200'0000;
+
+    // Instruction length in bytes and M-cycles with no branch taken. The CB
+    // prefix is decoded separately.
+    static constexpr std::array<uint8_t, 256> LENGTHS = {
+        1, 3, 1, 1, 1, 1, 2, 1, 3, 1, 1, 1, 1, 1, 2, 1,
+        2, 3, 1, 1, 1, 1, 2, 1, 2, 1, 1, 1, 1, 1, 2, 1,
+        2, 3, 1, 1, 1, 1, 2, 1, 2, 1, 1, 1, 1, 1, 2, 1,
+        2, 3, 1, 1, 1, 1, 2, 1, 2, 1, 1, 1, 1, 1, 2, 1,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+        1, 1, 3, 3, 3, 1, 2, 1, 1, 1, 3, 1, 3, 3, 2, 1,
+        1, 1, 3, 1, 3, 1, 2, 1, 1, 1, 3, 1, 3, 1, 2, 1,
+        2, 1, 1, 1, 1, 1, 2, 1, 2, 1, 3, 1, 1, 1, 2, 1,
+        2, 1, 1, 1, 1, 1, 2, 1, 2, 1, 3, 1, 1, 1, 2, 1,
+    };
+
+    static constexpr std::array<uint8_t, 256> CYCLES = {
+        1, 3, 2, 2, 1, 1, 2, 1, 5, 2, 2, 2, 1, 1, 2, 1,
+        1, 3, 2, 2, 1, 1, 2, 1, 3, 2, 2, 2, 1, 1, 2, 1,
+        2, 3, 2, 2, 1, 1, 2, 1, 2, 2, 2, 2, 1, 1, 2, 1,
+        2, 3, 2, 2, 3, 3, 3, 1, 2, 2, 2, 2, 1, 1, 2, 1,
+        1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1,
+        1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1,
+        1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1,
+        2, 2, 2, 2, 2, 2, 1, 2, 1, 1, 1, 1, 1, 1, 2, 1,
+        1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1,
+        1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1,
+        1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1,
+        1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1,
+        2, 3, 3, 4, 3, 4, 2, 4, 2, 4, 3, 1, 3, 6, 2, 4,
+        2, 3, 3, 0, 3, 4, 2, 4, 2, 4, 3, 0, 3, 0, 2, 4,
+        3, 3, 2, 0, 0, 4, 2, 4, 4, 1, 4, 0, 0, 0, 2, 4,
+        3, 3, 2, 1, 0, 4, 2, 4, 3, 2, 4, 1, 0, 0, 2, 4,
+    };
+
+    // STOP can switch speed and the unused opcodes hang, so neither goes in a block
+    static constexpr bool Excluded(const uint8_t opcode) {
+        switch (opcode) {
+            case 0x10:
+            case 0xD3: case 0xDB: case 0xDD: case 0xE3: case 0xE4:
+            case 0xEB: case 0xEC: case 0xED: case 0xF4: case 0xFC: case 0xFD:
+                return true;
+            default: return false;
+        }
+    }
+
+    // Jumps, calls, returns, HALT and EI are the last op of their block
+    static constexpr bool EndsBlock(const uint8_t opcode) {
+        switch (opcode) {
+            case 0x18: case 0x20: case 0x28: case 0x30: case 0x38:
+            case 0xC0: case 0xC2: case 0xC3: case 0xC4: case 0xC8: case 0xC9: case 0xCA: case 0xCC: case 0xCD:
+            case 0xD0: case 0xD2: case 0xD4: case 0xD8: case 0xD9: case 0xDA: case 0xDC:
+            case 0xC7: case 0xCF: case 0xD7: case 0xDF: case 0xE7: case 0xEF: case 0xF7: case 0xFF:
+            case 0xE9: case 0x76: case 0xFB:
+                return true;
+            default: return false;
+        }
+    }
+
+    static constexpr uint8_t PrefixedCycles(const uint8_t opcode) {
+        if ((opcode & 0x07) != 0x06) return 1;
+        return opcode >= 0x40 && opcode <= 0x7F ? 2 : 3; // BIT n,(HL) does not write back
+    }
+
+    // Decodes until a block-ending instruction, MAX_OPS, or an instruction
+    // that would run past `end`
+    static void Decode(Block &block, const uint8_t *code, const uint8_t *end) {
+        block.count = 0;
+        block.mCycles = 0;
+        while (code < end) {
+            const uint8_t opcode = *code;
+            if (Excluded(opcode)) break;
+            if (opcode == 0xCB) {
+                if (end - code < 2 || block.count + 2 > MAX_OPS) break;
+                block.ops[block.count++] = {&Instructions<CPUType>::Steps(false, 0xCB), 0xCB, false};
+                block.ops[block.count++] = {&Instructions<CPUType>::Steps(true, code[1]), code[1], true};
+                block.mCycles += 1 + PrefixedCycles(code[1]);
+                code += 2;
+            } else {
+                if (end - code < LENGTHS[opcode] || block.count + 1 > MAX_OPS) break;
+                block.ops[block.count++] = {&Instructions<CPUType>::Steps(false, opcode), opcode, false};
+                block.mCycles += CYCLES[opcode];
+                code += LENGTHS[opcode];
+                if (EndsBlock(opcode)) break;
+            }
+        }
+    }
+
+    std::unordered_map<uint32_t, Block> blocks_;
+};
+
+#endif //STARGBC_BLOCKCACHE_H
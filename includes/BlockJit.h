@@ -0,0 +1,1154 @@
+#ifndef STARGBC_BLOCKJIT_H
+#define STARGBC_BLOCKJIT_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "BlockCache.h"
+#include "ExecutableArena.h"
+#include "GPU.h"
+#include "Instructions.h"
+#include "Interrupts.h"
+#include "Memory.h"
+#include "Registers.h"
+#include "X64Emitter.h"
+
+#ifdef STARGBC_JIT_X64
+#include <cpuid.h>
+#endif
+
+// Compiles hot ROM blocks of the BlockCache to x86-64 and runs them in place
+// of CPU::RunBlock, leaving the machine exactly as RunBlock would.
+// - Registers stay in Registers; flags are only computed where a later
+//   instruction or a possible exit can see them.
+// - ROM, WRAM and HRAM are read and written inline. Anything else goes
+//   through the Bus with the block's M-cycles charged first, so the
+//   peripherals see the access on the same cycle as the interpreter.
+// - After such an access the block is left at the next instruction boundary
+//   when RunBlock would stop there: an interrupt, OAM DMA or a bank switch
+//   under the block.
+// - Blocks in RAM are never compiled, so self-modifying code keeps going
+//   through the page generations of the BlockCache.
+template<typename CPUType>
+class BlockJit {
+public:
+    using Cache = BlockCache<CPUType>;
+    using Block = typename Cache::Block;
+
+    // Runs of a block before it is compiled
+    static constexpr uint32_t HOT_RUNS = 16;
+    static constexpr size_t ARENA_SIZE = 16 << 20;
+
+    explicit BlockJit(CPUType &cpu) : cpu_(cpu), arena_(ARENA_SIZE) {
+        context_.registers = &cpu.regs_;
+        context_.memory = &cpu.bus_.memory_;
+        context_.romPages = cpu.bus_.cartridge_.RomPages();
+        context_.accessEpoch = &cpu.bus_.accessEpoch_;
+        context_.interrupts = &cpu.interrupts_;
+        context_.jit = this;
+        // LAHF puts SF ZF 0 AF 0 PF 1 CF in AH
+        for (size_t ah = 0; ah < context_.flags.size(); ++ah) {
+            context_.flags[ah] = static_cast<uint8_t>((ah & 0x40 ? 0x80 : 0) | (ah & 0x10 ? 0x20 : 0) |
+                                                      (ah & 0x01 ? 0x10 : 0));
+        }
+    }
+
+    // x86-64 with LAHF in long mode, which every flag computation uses
+    [[nodiscard]] static bool Supported() {
+#ifdef STARGBC_JIT_X64
+        unsigned eax, ebx, ecx, edx;
+        return ExecutableArena::Supported() && __get_cpuid(0x80000001, &eax, &ebx, &ecx, &edx) && (ecx & 1);
+#else
+        return false;
+#endif
+    }
+
+    // Runs `block` natively when it is compiled or has just become hot.
+    // Returns the ops run, to hand RunBlock as its first; 0 leaves the
+    // whole block to RunBlock.
+    uint8_t Run(Block &block, Instructions<CPUType> &instructions) {
+        const auto address = static_cast<uint16_t>(cpu_.pc_ - 1);
+        if (!block.native) {
+            if (address >= 0x8000 || ++block.runs != HOT_RUNS) return 0;
+            block.native = Compile(block, address);
+            block.nativeAddress = address;
+            if (!block.native) return 0;
+        }
+        auto &bus = cpu_.bus_;
+        // What RunBlock checks before its first op, and OAM DMA, which the
+        // inline accesses do not model
+        if (block.nativeAddress != address || cpu_.currentInstruction != block.ops[0].opcode || cpu_.prefixed ||
+            cpu_.haltBug_ || bus.dma_.transferActive) {
+            return 0;
+        }
+
+        context_.page = bus.cartridge_.RomPage(address);
+        context_.address = address;
+        context_.pc = cpu_.pc_;
+        context_.sp = cpu_.sp_;
+        context_.charged = 0;
+        context_.bail = false;
+        const uint32_t result = reinterpret_cast<uint32_t (*)(Context *)>(const_cast<void *>(block.native))(&context_);
+        const auto ops = static_cast<uint8_t>(result);
+
+        cpu_.blockMCycles_ += (result >> 8) - context_.charged;
+        cpu_.pc_ = context_.pc;
+        cpu_.sp_ = context_.sp;
+        cpu_.currentInstruction = cpu_.nextInstruction_ = context_.opcode;
+        cpu_.mCycleCounter_ = 1;
+        cpu_.instructionCount += ops;
+        instructions.ResetState();
+        return ops;
+    }
+
+    // With BlockCache::Clear(): the blocks hold entry points into the arena
+    void Clear() { arena_.Clear(); }
+
+private:
+    using enum x64::Reg;
+    using enum x64::Cond;
+    using Alu = x64::Alu;
+    using Mem = x64::Mem;
+    using Shift = x64::Shift;
+    using Label = x64::Emitter::Label;
+
+    // What the generated code reaches through RBP
+    struct Context {
+        Registers *registers{nullptr};
+        Memory *memory{nullptr};
+        const uint8_t *const *romPages{nullptr};
+        uint32_t *accessEpoch{nullptr};
+        Interrupts *interrupts{nullptr};
+        BlockJit *jit{nullptr};
+        const uint8_t *page{nullptr}; // ROM page the block was entered from
+        uint32_t charged{0}; // block M-cycles already added to the CPU
+        uint16_t address{0};
+        uint16_t pc{0};
+        uint16_t sp{0};
+        uint8_t opcode{0}; // fetched at the exit
+        bool bail{false}; // leave at the next instruction boundary
+        std::array<uint8_t, 256> flags{}; // AH after LAHF to Z, H and C
+    };
+
+    struct Insn {
+        uint16_t address{0};
+        uint8_t opcode{0};
+        uint8_t cb{0};
+        uint8_t imm8{0};
+        uint16_t imm16{0};
+        uint8_t length{1};
+        uint8_t ops{1};
+        uint8_t cycles{1};
+        uint16_t base{0}; // block M-cycles before it
+        uint8_t liveOut{0xF0}; // flags read before they are next written
+    };
+
+    static constexpr auto REGISTERS = static_cast<int32_t>(offsetof(Context, registers));
+    static constexpr auto MEMORY = static_cast<int32_t>(offsetof(Context, memory));
+    static constexpr auto ROM_PAGES = static_cast<int32_t>(offsetof(Context, romPages));
+    static constexpr auto ACCESS_EPOCH = static_cast<int32_t>(offsetof(Context, accessEpoch));
+    static constexpr auto INTERRUPTS = static_cast<int32_t>(offsetof(Context, interrupts));
+    static constexpr auto PC = static_cast<int32_t>(offsetof(Context, pc));
+    static constexpr auto SP = static_cast<int32_t>(offsetof(Context, sp));
+    static constexpr auto OPCODE = static_cast<int32_t>(offsetof(Context, opcode));
+    static constexpr auto BAIL = static_cast<int32_t>(offsetof(Context, bail));
+    static constexpr auto FLAGS = static_cast<int32_t>(offsetof(Context, flags));
+
+    static constexpr auto WRAM = static_cast<int32_t>(offsetof(Memory, wram_));
+    static constexpr auto HRAM = static_cast<int32_t>(offsetof(Memory, hram_));
+    static constexpr auto WRAM_BANK = static_cast<int32_t>(offsetof(Memory, wramBank_));
+    static constexpr auto CODE_PAGES = static_cast<int32_t>(offsetof(Memory, codePages_));
+
+    // B C D E H L (HL) A, and the high byte of BC DE HL AF
+    static constexpr std::array<int32_t, 8> REG = {
+        offsetof(Registers, b), offsetof(Registers, c), offsetof(Registers, d), offsetof(Registers, e),
+        offsetof(Registers, h), offsetof(Registers, l), -1, offsetof(Registers, a)
+    };
+    static constexpr std::array<int32_t, 4> PAIR = {
+        offsetof(Registers, b), offsetof(Registers, d), offsetof(Registers, h), offsetof(Registers, a)
+    };
+    static constexpr auto F = static_cast<int32_t>(offsetof(Registers, f));
+    static_assert(offsetof(Registers, c) == offsetof(Registers, b) + 1 &&
+                  offsetof(Registers, e) == offsetof(Registers, d) + 1 &&
+                  offsetof(Registers, l) == offsetof(Registers, h) + 1 &&
+                  offsetof(Registers, f) == offsetof(Registers, a) + 1);
+    static_assert(offsetof(Interrupts, interruptDelay) == offsetof(Interrupts, interruptMasterEnable) + 1);
+
+    // Called from generated code. An access through the Bus first brings
+    // the CPU's block cycles up to `mCycles`, the cycle it happens on.
+    void Charge(const uint32_t mCycles) {
+        cpu_.blockMCycles_ += mCycles - context_.charged;
+        context_.charged = mCycles;
+    }
+
+    // The checks RunBlock makes before its next op, and the ROM page the
+    // block was compiled from still being mapped
+    void CheckBail() {
+        const auto &bus = cpu_.bus_;
+        context_.bail = !cpu_.CanRunBlock() || bus.dma_.transferActive ||
+                        bus.cartridge_.RomPage(context_.address) != context_.page;
+    }
+
+    static uint32_t ReadSlow(Context *context, const uint32_t address, const uint32_t mCycles) {
+        BlockJit &jit = *context->jit;
+        jit.Charge(mCycles);
+        const uint8_t value = jit.cpu_.bus_.ReadByte(static_cast<uint16_t>(address), ComponentSource::CPU);
+        jit.CheckBail();
+        return value;
+    }
+
+    static void WriteSlow(Context *context, const uint32_t address, const uint32_t value, const uint32_t mCycles) {
+        BlockJit &jit = *context->jit;
+        jit.Charge(mCycles);
+        jit.cpu_.bus_.WriteByte(static_cast<uint16_t>(address), static_cast<uint8_t>(value), ComponentSource::CPU);
+        jit.CheckBail();
+    }
+
+    static void CorruptOam(Context *context, const uint32_t address, const uint32_t type) {
+        context->jit->cpu_.bus_.HandleOAMCorruption(static_cast<uint16_t>(address), static_cast<CorruptionType>(type));
+    }
+
+    // As Instructions::DAA
+    static void Daa(Context *context) {
+        Registers &regs = *context->registers;
+        uint8_t adjust = 0;
+        bool carry = regs.FlagCarry();
+        if (!regs.FlagSubtract()) {
+            if (regs.FlagHalf() || (regs.a & 0x0F) > 0x09) adjust |= 0x06;
+            if (regs.FlagCarry() || regs.a > 0x99) {
+                adjust |= 0x60;
+                carry = true;
+            }
+            regs.a += adjust;
+        } else {
+            if (regs.FlagHalf()) adjust |= 0x06;
+            if (regs.FlagCarry()) adjust |= 0x60;
+            regs.a -= adjust;
+        }
+        regs.SetCarry(carry);
+        regs.SetZero(regs.a == 0);
+        regs.SetHalf(false);
+    }
+
+    // EI, HALT and RETI change how the CPU goes on, so a compiled block
+    // stops before them and RunBlock takes over
+    static bool Translatable(const uint8_t opcode) {
+        return opcode != 0xFB && opcode != 0x76 && opcode != 0xD9;
+    }
+
+    // Whether the instruction reads or writes data memory, after which the
+    // block may be left
+    static bool Accesses(const Insn &in) {
+        const uint8_t op = in.opcode;
+        if (op == 0xCB) return (in.cb & 0x07) == 0x06;
+        if (op >= 0x40 && op < 0xC0) return (op & 0x07) == 0x06 || (op >= 0x70 && op < 0x78);
+        switch (op) {
+            case 0x02: case 0x12: case 0x22: case 0x32: case 0x0A: case 0x1A: case 0x2A: case 0x3A:
+            case 0x08: case 0x34: case 0x35: case 0x36:
+            case 0xC1: case 0xD1: case 0xE1: case 0xF1: case 0xC5: case 0xD5: case 0xE5: case 0xF5:
+            case 0xE0: case 0xF0: case 0xE2: case 0xF2: case 0xEA: case 0xFA:
+                return true;
+            default: return false; // jumps, calls and returns end the block anyway
+        }
+    }
+
+    // Flags read and written, as ZNHC in the high nibble
+    static std::pair<uint8_t, uint8_t> FlagUse(const Insn &in) {
+        const uint8_t op = in.opcode;
+        if (op == 0xCB) {
+            const uint8_t x = in.cb >> 6, y = in.cb >> 3 & 0x07;
+            if (x == 0) return {y == 2 || y == 3 ? 0x10 : 0x00, 0xF0};
+            return {0x00, x == 1 ? 0xE0 : 0x00};
+        }
+        if ((op >= 0x80 && op < 0xC0) || (op >= 0xC0 && (op & 0x07) == 0x06)) {
+            const uint8_t alu = op >> 3 & 0x07;
+            return {alu == 1 || alu == 3 ? 0x10 : 0x00, 0xF0};
+        }
+        if (op < 0x40 && ((op & 0x07) == 0x04 || (op & 0x07) == 0x05)) return {0x00, 0xE0};
+        if (op < 0x40 && (op & 0x0F) == 0x09) return {0x00, 0x70};
+        switch (op) {
+            case 0x07: case 0x0F: return {0x00, 0xF0};
+            case 0x17: case 0x1F: return {0x10, 0xF0};
+            case 0x27: return {0x70, 0xB0};
+            case 0x2F: return {0x00, 0x60};
+            case 0x37: return {0x00, 0x70};
+            case 0x3F: return {0x10, 0x70};
+            case 0xE8: case 0xF8: case 0xF1: return {0x00, 0xF0};
+            case 0xF5: return {0xF0, 0x00};
+            case 0x20: case 0x28: case 0xC0: case 0xC8: case 0xC2: case 0xCA: case 0xC4: case 0xCC:
+                return {0x80, 0x00};
+            case 0x30: case 0x38: case 0xD0: case 0xD8: case 0xD2: case 0xDA: case 0xD4: case 0xDC:
+                return {0x10, 0x00};
+            default: return {0x00, 0x00};
+        }
+    }
+
+    const void *Compile(const Block &block, const uint16_t address) {
+        const uint8_t *page = cpu_.bus_.cartridge_.RomPage(address);
+        std::vector<Insn> insns;
+        uint16_t pc = address;
+        uint16_t mCycles = 0;
+        for (uint8_t i = 0; i < block.count;) {
+            Insn in;
+            in.address = pc;
+            in.opcode = block.ops[i].opcode;
+            in.base = mCycles;
+            const uint8_t *code = page + (pc & 0x1FFF);
+            if (in.opcode == 0xCB) {
+                in.cb = block.ops[i + 1].opcode;
+                in.length = 2;
+                in.ops = 2;
+                in.cycles = 1 + Cache::PrefixedCycles(in.cb);
+            } else {
+                if (!Translatable(in.opcode)) break;
+                in.length = Cache::LENGTHS[in.opcode];
+                in.cycles = Cache::CYCLES[in.opcode];
+                if (in.length > 1) in.imm8 = code[1];
+                if (in.length > 2) in.imm16 = static_cast<uint16_t>(code[1] | code[2] << 8);
+            }
+            insns.push_back(in);
+            pc += in.length;
+            mCycles += in.cycles;
+            i += in.ops;
+        }
+        if (insns.empty()) return nullptr;
+
+        // Every flag can be seen at the end and wherever the block may be left
+        uint8_t live = 0xF0;
+        for (auto it = insns.rbegin(); it != insns.rend(); ++it) {
+            if (Accesses(*it)) live = 0xF0;
+            it->liveOut = live;
+            const auto [uses, defs] = FlagUse(*it);
+            live = static_cast<uint8_t>((live & ~defs) | uses);
+        }
+
+        Translator translator(insns, address, page, cpu_.bus_.gpu_.hardware == Hardware::DMG);
+        const std::vector<uint8_t> code = translator.Translate();
+        return code.empty() ? nullptr : arena_.Commit(code);
+    }
+
+    // Emits one block. RBP holds the Context, RBX the Registers, R12 the ROM
+    // pages and R15 Memory; R13 and R14 carry an address and a value across
+    // calls into the Bus. Each exit leaves the ops and cycles run in EAX.
+    class Translator {
+    public:
+        Translator(const std::vector<Insn> &insns, const uint16_t address, const uint8_t *page, const bool oamBug)
+            : insns_(insns), address_(address), page_(page), oamBug_(oamBug) {
+        }
+
+        std::vector<uint8_t> Translate() {
+            for (const x64::Reg reg: {RBX, RBP, R12, R13, R14, R15}) e_.Push(reg);
+            e_.Alu64(Alu::Sub, RSP, 8);
+            e_.Mov64(RBP, RDI);
+            e_.Load64(RBX, Field(REGISTERS));
+            e_.Load64(R12, Field(ROM_PAGES));
+            e_.Load64(R15, Field(MEMORY));
+            for (size_t i = 0; i < insns_.size(); ++i) {
+                in_ = &insns_[i];
+                last_ = i + 1 == insns_.size();
+                ops_ += in_->ops;
+                slow_ = false;
+                Emit();
+            }
+            e_.Bind(epilogue_);
+            e_.Alu64(Alu::Add, RSP, 8);
+            for (const x64::Reg reg: {R15, R14, R13, R12, RBP, RBX}) e_.Pop(reg);
+            e_.Ret();
+            return e_.Finish();
+        }
+
+    private:
+        static Mem Field(const int32_t offset) { return {RBP, offset}; }
+        static Mem Reg8(const uint8_t index) { return {RBX, REG[index]}; }
+        static Mem Flags() { return {RBX, F}; }
+
+        // dst = BC, DE, HL or SP
+        void LoadPair(const x64::Reg dst, const uint8_t pair) {
+            if (pair == 3) {
+                e_.Load16(dst, Field(SP));
+                return;
+            }
+            e_.Load16(dst, {RBX, PAIR[pair]});
+            e_.Swap16(dst);
+        }
+
+        // Clobbers src
+        void StorePair(const uint8_t pair, const x64::Reg src) {
+            if (pair == 3) {
+                e_.Store16(Field(SP), src);
+                return;
+            }
+            e_.Swap16(src);
+            e_.Store16({RBX, PAIR[pair]}, src);
+        }
+
+        // reg = (reg + delta) & FFFF
+        void Step(const x64::Reg reg, const int32_t delta) {
+            e_.Lea(reg, {reg, delta});
+            e_.Alu32(Alu::And, reg, 0xFFFF);
+        }
+
+        // F = F & ~mask | bits: the `computed` ones from `bits`, the rest
+        // from `constant`
+        void MergeFlags(const uint8_t mask, const uint8_t computed, const uint8_t constant, const x64::Reg bits) {
+            const auto fromBits = static_cast<uint8_t>(mask & computed);
+            const auto ones = static_cast<uint8_t>(mask & ~computed & constant);
+            if (fromBits) {
+                e_.Alu32(Alu::And, bits, fromBits);
+                if (ones) e_.Alu32(Alu::Or, bits, ones);
+                e_.Alu8(Alu::And, Flags(), static_cast<uint8_t>(~mask));
+                e_.Alu8(Alu::Or, Flags(), bits);
+                return;
+            }
+            if (const auto zeros = static_cast<uint8_t>(mask & ~constant)) e_.Alu8(Alu::And, Flags(), static_cast<uint8_t>(~zeros));
+            if (ones) e_.Alu8(Alu::Or, Flags(), ones);
+        }
+
+        // The flags the instruction writes, the `computed` ones from the
+        // host's ZF, AF and CF. Clobbers ECX and AH.
+        void HostFlags(const uint8_t defs, const uint8_t computed, const uint8_t constant) {
+            const auto mask = static_cast<uint8_t>(defs & in_->liveOut);
+            if (mask & computed) {
+                e_.LoadFlags(RCX);
+                e_.Load8(RCX, {RBP, FLAGS, RCX});
+            }
+            MergeFlags(mask, computed, constant, RCX);
+        }
+
+        // Once an access may have gone through the Bus, later ones in the
+        // instruction take the slow path too if the block is being left
+        void Guard(const Label slow) {
+            if (!slow_) return;
+            e_.Alu8(Alu::Cmp, Field(BAIL), uint8_t{0});
+            e_.Jcc(NE, slow);
+        }
+
+        // `address` < 0 means R13
+        void CallRead(const int32_t address, const uint32_t mCycles) {
+            e_.Mov64(RDI, RBP);
+            if (address < 0) e_.Mov(RSI, R13);
+            else e_.MovImm(RSI, static_cast<uint32_t>(address));
+            e_.MovImm(RDX, mCycles);
+            e_.Call(reinterpret_cast<const void *>(&BlockJit::ReadSlow));
+        }
+
+        void CallWrite(const int32_t address, const uint32_t mCycles) {
+            e_.Mov64(RDI, RBP);
+            if (address < 0) e_.Mov(RSI, R13);
+            else e_.MovImm(RSI, static_cast<uint32_t>(address));
+            e_.Mov(RDX, R14);
+            e_.MovImm(RCX, mCycles);
+            e_.Call(reinterpret_cast<const void *>(&BlockJit::WriteSlow));
+        }
+
+        void BumpEpoch() {
+            e_.Load64(RCX, Field(ACCESS_EPOCH));
+            e_.Inc32(Mem{RCX});
+        }
+
+        // EAX = address - C000 in D000-DFFF becomes the index into wram_,
+        // or jumps to `slow` for a bank past its end
+        void BankedIndex(const Label slow) {
+            e_.Load8(RCX, {R15, WRAM_BANK});
+            e_.Shift32(Shift::Shl, RCX, 12);
+            e_.Lea(RAX, {RAX, -0x1000, RCX});
+            e_.Alu32(Alu::Cmp, RAX, 0x8000);
+            e_.Jcc(AE, slow);
+        }
+
+        // EAX = the byte at R13, read on block cycle `mCycles`
+        void ReadRuntime(const uint32_t mCycles) {
+            const Label slow = e_.NewLabel(), notRom = e_.NewLabel(), done = e_.NewLabel();
+            Guard(slow);
+            e_.Alu32(Alu::Cmp, R13, 0x8000);
+            e_.Jcc(AE, notRom);
+            e_.Mov(RAX, R13);
+            e_.Shift32(Shift::Shr, RAX, 13);
+            e_.Load64(RAX, {R12, 0, RAX, 8});
+            e_.Mov(RCX, R13);
+            e_.Alu32(Alu::And, RCX, 0x1FFF);
+            e_.Load8(RAX, {RAX, 0, RCX});
+            e_.Bind(done);
+            e_.Cold([=, this] {
+                const Label banked = e_.NewLabel(), notWram = e_.NewLabel();
+                e_.Bind(notRom);
+                e_.Lea(RAX, {R13, -0xC000});
+                e_.Alu32(Alu::Cmp, RAX, 0x1000);
+                e_.Jcc(AE, banked);
+                e_.Load8(RAX, {R15, WRAM, RAX});
+                e_.Jmp(done);
+                e_.Bind(banked);
+                e_.Alu32(Alu::Cmp, RAX, 0x2000);
+                e_.Jcc(AE, notWram);
+                BankedIndex(slow);
+                e_.Load8(RAX, {R15, WRAM, RAX});
+                e_.Jmp(done);
+                e_.Bind(notWram);
+                e_.Lea(RAX, {R13, -0xFF80});
+                e_.Alu32(Alu::Cmp, RAX, 0x7F);
+                e_.Jcc(AE, slow);
+                e_.Load8(RAX, {R15, HRAM, RAX});
+                e_.Jmp(done);
+                e_.Bind(slow);
+                CallRead(-1, mCycles);
+                e_.Jmp(done);
+            });
+            slow_ = true;
+        }
+
+        // Writes R14B to R13 on block cycle `mCycles`. WRAM and HRAM pages
+        // holding cached code go through the Bus, which invalidates them.
+        void WriteRuntime(const uint32_t mCycles) {
+            const Label slow = e_.NewLabel(), other = e_.NewLabel(), wram = e_.NewLabel(), done = e_.NewLabel();
+            Guard(slow);
+            e_.Lea(RAX, {R13, -0xC000});
+            e_.Alu32(Alu::Cmp, RAX, 0x1000);
+            e_.Jcc(AE, other);
+            e_.Bind(wram);
+            e_.Mov(RCX, RAX);
+            e_.Shift32(Shift::Shr, RCX, 8);
+            e_.Alu8(Alu::Cmp, Mem{R15, CODE_PAGES, RCX}, uint8_t{0});
+            e_.Jcc(NE, slow);
+            e_.Store8({R15, WRAM, RAX}, R14);
+            BumpEpoch();
+            e_.Bind(done);
+            e_.Cold([=, this] {
+                const Label notWram = e_.NewLabel();
+                e_.Bind(other);
+                e_.Alu32(Alu::Cmp, RAX, 0x2000);
+                e_.Jcc(AE, notWram);
+                BankedIndex(slow);
+                e_.Jmp(wram);
+                e_.Bind(notWram);
+                e_.Lea(RAX, {R13, -0xFF80});
+                e_.Alu32(Alu::Cmp, RAX, 0x7F);
+                e_.Jcc(AE, slow);
+                e_.Alu8(Alu::Cmp, Mem{R15, CODE_PAGES + static_cast<int32_t>(Memory::HRAM_CODE_PAGE)}, uint8_t{0});
+                e_.Jcc(NE, slow);
+                e_.Store8({R15, HRAM, RAX}, R14);
+                BumpEpoch();
+                e_.Jmp(done);
+                e_.Bind(slow);
+                CallWrite(-1, mCycles);
+                e_.Jmp(done);
+            });
+            slow_ = true;
+        }
+
+        // EAX = the byte at a known address. The block's own ROM page is
+        // folded in, since leaving it ends the block.
+        void ReadConst(const uint16_t address, const uint32_t mCycles) {
+            if (address >= 0xD000 && address < 0xE000) {
+                e_.MovImm(R13, address);
+                ReadRuntime(mCycles);
+                return;
+            }
+            const bool rom = address < 0x8000;
+            const bool wram = address >= 0xC000 && address < 0xD000;
+            const bool hram = address >= Memory::HRAM_BEGIN && address <= Memory::HRAM_END;
+            if (!rom && !wram && !hram) {
+                CallRead(address, mCycles);
+                slow_ = true;
+                return;
+            }
+            const Label slow = e_.NewLabel(), done = e_.NewLabel();
+            if (slow_) {
+                Guard(slow);
+                e_.Cold([=, this] {
+                    e_.Bind(slow);
+                    CallRead(address, mCycles);
+                    e_.Jmp(done);
+                });
+            }
+            if (rom && address >> 13 == address_ >> 13) {
+                e_.MovImm(RAX, page_[address & 0x1FFF]);
+            } else if (rom) {
+                e_.Load64(RAX, {R12, (address >> 13) * 8});
+                e_.Load8(RAX, {RAX, address & 0x1FFF});
+            } else {
+                e_.Load8(RAX, {R15, wram ? WRAM + address - 0xC000 : HRAM + address - Memory::HRAM_BEGIN});
+            }
+            e_.Bind(done);
+        }
+
+        // Writes R14B to a known address
+        void WriteConst(const uint16_t address, const uint32_t mCycles) {
+            if (address >= 0xD000 && address < 0xE000) {
+                e_.MovImm(R13, address);
+                WriteRuntime(mCycles);
+                return;
+            }
+            const bool wram = address >= 0xC000 && address < 0xD000;
+            if (!wram && (address < Memory::HRAM_BEGIN || address > Memory::HRAM_END)) {
+                CallWrite(address, mCycles);
+                slow_ = true;
+                return;
+            }
+            const auto page = static_cast<int32_t>(wram ? (address - 0xC000) >> 8 : Memory::HRAM_CODE_PAGE);
+            const Label slow = e_.NewLabel(), done = e_.NewLabel();
+            Guard(slow);
+            e_.Alu8(Alu::Cmp, Mem{R15, CODE_PAGES + page}, uint8_t{0});
+            e_.Jcc(NE, slow);
+            e_.Store8({R15, wram ? WRAM + address - 0xC000 : HRAM + address - Memory::HRAM_BEGIN}, R14);
+            BumpEpoch();
+            e_.Bind(done);
+            e_.Cold([=, this] {
+                e_.Bind(slow);
+                CallWrite(address, mCycles);
+                e_.Jmp(done);
+            });
+            slow_ = true;
+        }
+
+        // The DMG OAM bug for a 16-bit register pointing into FE00-FEFF
+        void Corrupt(const x64::Reg address, const CorruptionType type) {
+            if (!oamBug_) return;
+            const Label cold = e_.NewLabel(), done = e_.NewLabel();
+            e_.Lea(RAX, {address, -0xFE00});
+            e_.Alu32(Alu::Cmp, RAX, 0x100);
+            e_.Jcc(B, cold);
+            e_.Bind(done);
+            e_.Cold([=, this] {
+                e_.Bind(cold);
+                e_.Mov64(RDI, RBP);
+                e_.Mov(RSI, address);
+                e_.MovImm(RDX, static_cast<uint32_t>(type));
+                e_.Call(reinterpret_cast<const void *>(&BlockJit::CorruptOam));
+                e_.Jmp(done);
+            });
+        }
+
+        void Exit(const uint32_t mCycles, const uint32_t ops) {
+            e_.MovImm(RAX, mCycles << 8 | ops);
+            e_.Jmp(epilogue_);
+        }
+
+        // Fetches the opcode at `target` on block cycle `mCycles` and leaves
+        void FetchExit(const uint16_t target, const uint32_t mCycles) {
+            ReadConst(target, mCycles);
+            e_.Store8(Field(OPCODE), RAX);
+            e_.Store16(Field(PC), static_cast<uint16_t>(target + 1));
+            Exit(mCycles, ops_);
+        }
+
+        // The same for a target in R13
+        void FetchExitRuntime(const uint32_t mCycles) {
+            ReadRuntime(mCycles);
+            e_.Store8(Field(OPCODE), RAX);
+            e_.Lea(RAX, {R13, 1});
+            e_.Store16(Field(PC), RAX);
+            Exit(mCycles, ops_);
+        }
+
+        // Falls through to the next instruction, whose opcode is already
+        // known, unless the block ends here or is being left
+        void Next() {
+            const auto next = static_cast<uint16_t>(in_->address + in_->length);
+            const uint32_t mCycles = in_->base + in_->cycles;
+            if (last_) {
+                FetchExit(next, mCycles);
+                return;
+            }
+            if (!slow_) return;
+            const Label leave = e_.NewLabel();
+            e_.Alu8(Alu::Cmp, Field(BAIL), uint8_t{0});
+            e_.Jcc(NE, leave);
+            e_.Cold([=, this, ops = ops_] {
+                e_.Bind(leave);
+                CallRead(next, mCycles);
+                e_.Store8(Field(OPCODE), RAX);
+                e_.Store16(Field(PC), static_cast<uint16_t>(next + 1));
+                Exit(mCycles, ops);
+            });
+        }
+
+        // Conditional jumps, calls and returns; both paths end in an exit
+        template<typename Taken, typename NotTaken>
+        void Branch(Taken taken, NotTaken notTaken) {
+            const uint8_t flag = in_->opcode & 0x10 ? 0x10 : 0x80;
+            const Label skip = e_.NewLabel();
+            e_.Test8(Flags(), flag);
+            e_.Jcc(in_->opcode & 0x08 ? E : NE, skip);
+            const bool slow = slow_;
+            taken();
+            e_.Bind(skip);
+            slow_ = slow;
+            notTaken();
+        }
+
+        // R14D = the word at SP, popped as POP (with the OAM bug) or RET
+        // do, reading on `mCycles` and the cycle after
+        void PopWord(const uint32_t mCycles, const bool corrupt) {
+            LoadPair(R13, 3);
+            if (corrupt) Corrupt(R13, CorruptionType::ReadWrite);
+            ReadRuntime(mCycles);
+            e_.Mov(R14, RAX);
+            Step(R13, 1);
+            if (corrupt) Corrupt(R13, CorruptionType::Read);
+            ReadRuntime(mCycles + 1);
+            e_.Shift32(Shift::Shl, RAX, 8);
+            e_.Alu32(Alu::Or, R14, RAX);
+            Step(R13, 1);
+            e_.Store16(Field(SP), R13);
+        }
+
+        // Pushes the return address of CALL and RST, writing on `mCycles`
+        // and the cycle after
+        void PushReturn(const uint16_t value, const uint32_t mCycles) {
+            LoadPair(R13, 3);
+            Step(R13, -1);
+            e_.MovImm(R14, value >> 8);
+            WriteRuntime(mCycles);
+            Step(R13, -1);
+            e_.MovImm(R14, value & 0xFF);
+            WriteRuntime(mCycles + 1);
+            e_.Store16(Field(SP), R13);
+        }
+
+        // A op= DL
+        void Arithmetic(const uint8_t alu) {
+            static constexpr std::array<Alu, 8> OPS = {
+                Alu::Add, Alu::Adc, Alu::Sub, Alu::Sbb, Alu::And, Alu::Xor, Alu::Or, Alu::Cmp
+            };
+            e_.Load8(RAX, Reg8(7));
+            if (alu == 1 || alu == 3) {
+                e_.Load8(RCX, Flags());
+                e_.Bt32(RCX, 4);
+            }
+            e_.Alu8(OPS[alu], RAX, RDX);
+            switch (alu) {
+                case 0: case 1: HostFlags(0xF0, 0xB0, 0x00);
+                    break;
+                case 4: HostFlags(0xF0, 0x80, 0x20);
+                    break;
+                case 5: case 6: HostFlags(0xF0, 0x80, 0x00);
+                    break;
+                default: HostFlags(0xF0, 0xB0, 0x40);
+            }
+            if (alu != 7) e_.Store8(Reg8(7), RAX);
+        }
+
+        // ADD SP,e and LD HL,SP+e: H and C from adding e to the low byte
+        void AddSigned(const bool toHl) {
+            e_.Load16(RSI, Field(SP));
+            e_.Mov(RDX, RSI);
+            e_.Alu8(Alu::Add, RDX, in_->imm8);
+            HostFlags(0xF0, 0x30, 0x00);
+            e_.Alu32(Alu::Add, RSI, static_cast<int8_t>(in_->imm8));
+            if (toHl) StorePair(2, RSI);
+            else e_.Store16(Field(SP), RSI);
+        }
+
+        // The CB rotates and shifts on AL
+        void RotateShift(const uint8_t kind) {
+            switch (kind) {
+                case 4: case 5: case 7:
+                    e_.Shift8(kind == 4 ? Shift::Shl : kind == 5 ? Shift::Sar : Shift::Shr, RAX, 1);
+                    HostFlags(0xF0, 0x90, 0x00);
+                    return;
+                case 6:
+                    e_.Shift8(Shift::Rol, RAX, 4);
+                    e_.Test8(RAX, RAX);
+                    HostFlags(0xF0, 0x80, 0x00);
+                    return;
+                default: {
+                    // x86 rotates leave ZF alone
+                    const auto mask = static_cast<uint8_t>(0xF0 & in_->liveOut);
+                    const bool computed = mask & 0x90;
+                    if (computed) {
+                        e_.Alu32(Alu::Xor, RCX, RCX);
+                        e_.Alu32(Alu::Xor, RDX, RDX);
+                    }
+                    if (kind >= 2) {
+                        e_.Load8(RSI, Flags());
+                        e_.Bt32(RSI, 4);
+                    }
+                    static constexpr std::array<Shift, 4> OPS = {Shift::Rol, Shift::Ror, Shift::Rcl, Shift::Rcr};
+                    e_.Shift8(OPS[kind], RAX, 1);
+                    if (computed) {
+                        e_.Setcc(B, RDX);
+                        e_.Test8(RAX, RAX);
+                        e_.Setcc(E, RCX);
+                        e_.Shift32(Shift::Shl, RCX, 7);
+                        e_.Shift32(Shift::Shl, RDX, 4);
+                        e_.Alu32(Alu::Or, RCX, RDX);
+                    }
+                    MergeFlags(mask, 0x90, 0x00, RCX);
+                }
+            }
+        }
+
+        void EmitPrefixed() {
+            const uint8_t cb = in_->cb, x = cb >> 6, y = cb >> 3 & 0x07, z = cb & 0x07;
+            const auto bit = static_cast<uint8_t>(1 << y);
+            // (HL) is read on the CB op's second cycle and written on its third
+            const uint32_t read = in_->base + 2;
+            if (z != 6 && x >= 1) {
+                if (x == 1) {
+                    e_.Test8(Reg8(z), bit);
+                    HostFlags(0xE0, 0x80, 0x20);
+                } else if (x == 2) {
+                    e_.Alu8(Alu::And, Reg8(z), static_cast<uint8_t>(~bit));
+                } else {
+                    e_.Alu8(Alu::Or, Reg8(z), bit);
+                }
+                Next();
+                return;
+            }
+            if (z == 6) {
+                LoadPair(R13, 2);
+                ReadRuntime(read);
+            } else {
+                e_.Load8(RAX, Reg8(z));
+            }
+            switch (x) {
+                case 0: RotateShift(y);
+                    break;
+                case 1:
+                    e_.Test8(RAX, bit);
+                    HostFlags(0xE0, 0x80, 0x20);
+                    Next();
+                    return;
+                case 2: e_.Alu8(Alu::And, RAX, static_cast<uint8_t>(~bit));
+                    break;
+                default: e_.Alu8(Alu::Or, RAX, bit);
+            }
+            if (z == 6) {
+                e_.Mov(R14, RAX);
+                WriteRuntime(read + 1);
+            } else {
+                e_.Store8(Reg8(z), RAX);
+            }
+            Next();
+        }
+
+        void Emit() {
+            const Insn &in = *in_;
+            const uint8_t op = in.opcode;
+            const uint8_t pair = op >> 4 & 0x03;
+            const uint32_t base = in.base;
+            const auto next = static_cast<uint16_t>(in.address + in.length);
+
+            if (op == 0xCB) {
+                EmitPrefixed();
+                return;
+            }
+            if (op >= 0x40 && op < 0x80) {
+                const uint8_t dst = op >> 3 & 0x07, src = op & 0x07;
+                if (src == 6) {
+                    LoadPair(R13, 2);
+                    ReadRuntime(base + 1);
+                    e_.Store8(Reg8(dst), RAX);
+                } else if (dst == 6) {
+                    LoadPair(R13, 2);
+                    e_.Load8(R14, Reg8(src));
+                    WriteRuntime(base + 1);
+                } else if (dst != src) {
+                    e_.Load8(RAX, Reg8(src));
+                    e_.Store8(Reg8(dst), RAX);
+                }
+                Next();
+                return;
+            }
+            if (op >= 0x80 && op < 0xC0) {
+                if ((op & 0x07) == 6) {
+                    LoadPair(R13, 2);
+                    ReadRuntime(base + 1);
+                    e_.Mov(RDX, RAX);
+                } else {
+                    e_.Load8(RDX, Reg8(op & 0x07));
+                }
+                Arithmetic(op >> 3 & 0x07);
+                Next();
+                return;
+            }
+            if (op >= 0xC0 && (op & 0x07) == 0x06) {
+                e_.MovImm(RDX, in.imm8);
+                Arithmetic(op >> 3 & 0x07);
+                Next();
+                return;
+            }
+            if (op < 0x40 && (op & 0x07) >= 4 && (op & 0x07) <= 6) {
+                const uint8_t r = op >> 3 & 0x07;
+                const bool inc = (op & 0x07) == 4;
+                if ((op & 0x07) == 6) {
+                    if (r == 6) {
+                        LoadPair(R13, 2);
+                        e_.MovImm(R14, in.imm8);
+                        WriteRuntime(base + 2);
+                    } else {
+                        e_.Store8(Reg8(r), in.imm8);
+                    }
+                } else if (r == 6) {
+                    LoadPair(R13, 2);
+                    ReadRuntime(base + 1);
+                    e_.Mov(R14, RAX);
+                    if (inc) e_.Inc8(R14);
+                    else e_.Dec8(R14);
+                    HostFlags(0xE0, 0xA0, inc ? 0x00 : 0x40);
+                    WriteRuntime(base + 2);
+                } else {
+                    if (inc) e_.Inc8(Reg8(r));
+                    else e_.Dec8(Reg8(r));
+                    HostFlags(0xE0, 0xA0, inc ? 0x00 : 0x40);
+                }
+                Next();
+                return;
+            }
+            if (op < 0x40 && (op & 0x07) == 0x03) {
+                // INC rr and DEC rr, with the OAM bug for the old value
+                LoadPair(R13, pair);
+                Corrupt(R13, CorruptionType::Write);
+                e_.Lea(RAX, {R13, op & 0x08 ? -1 : 1});
+                StorePair(pair, RAX);
+                Next();
+                return;
+            }
+
+            switch (op) {
+                case 0x00:
+                    Next();
+                    break;
+                case 0x01: case 0x11: case 0x21: case 0x31:
+                    if (pair == 3) e_.Store16(Field(SP), in.imm16);
+                    else e_.Store16({RBX, PAIR[pair]}, static_cast<uint16_t>(in.imm16 >> 8 | in.imm16 << 8));
+                    Next();
+                    break;
+                case 0x02: case 0x12:
+                    LoadPair(R13, pair);
+                    e_.Load8(R14, Reg8(7));
+                    WriteRuntime(base + 1);
+                    Next();
+                    break;
+                case 0x0A: case 0x1A:
+                    LoadPair(R13, pair);
+                    ReadRuntime(base + 1);
+                    e_.Store8(Reg8(7), RAX);
+                    Next();
+                    break;
+                case 0x22: case 0x32:
+                    LoadPair(R13, 2);
+                    Corrupt(R13, CorruptionType::Write);
+                    e_.Load8(R14, Reg8(7));
+                    WriteRuntime(base + 1);
+                    Corrupt(R13, CorruptionType::Write);
+                    e_.Lea(RAX, {R13, op == 0x22 ? 1 : -1});
+                    StorePair(2, RAX);
+                    Next();
+                    break;
+                case 0x2A: case 0x3A:
+                    LoadPair(R13, 2);
+                    ReadRuntime(base + 1);
+                    e_.Store8(Reg8(7), RAX);
+                    Corrupt(R13, CorruptionType::ReadWrite);
+                    e_.Lea(RAX, {R13, op == 0x2A ? 1 : -1});
+                    StorePair(2, RAX);
+                    Next();
+                    break;
+                case 0x07: case 0x0F:
+                    e_.Shift8(op == 0x07 ? Shift::Rol : Shift::Ror, Reg8(7), 1);
+                    HostFlags(0xF0, 0x10, 0x00);
+                    Next();
+                    break;
+                case 0x17: case 0x1F:
+                    e_.Load8(RCX, Flags());
+                    e_.Bt32(RCX, 4);
+                    e_.Shift8(op == 0x17 ? Shift::Rcl : Shift::Rcr, Reg8(7), 1);
+                    HostFlags(0xF0, 0x10, 0x00);
+                    Next();
+                    break;
+                case 0x08:
+                    e_.Load16(R14, Field(SP));
+                    WriteConst(in.imm16, base + 3);
+                    e_.Shift32(Shift::Shr, R14, 8);
+                    WriteConst(static_cast<uint16_t>(in.imm16 + 1), base + 4);
+                    Next();
+                    break;
+                case 0x09: case 0x19: case 0x29: case 0x39: {
+                    // H from bit 11 and C from bit 16 of HL ^ rr ^ sum
+                    const auto mask = static_cast<uint8_t>(0x70 & in.liveOut);
+                    LoadPair(RCX, pair);
+                    LoadPair(RAX, 2);
+                    e_.Mov(RDX, RAX);
+                    e_.Alu32(Alu::Xor, RDX, RCX);
+                    e_.Alu32(Alu::Add, RAX, RCX);
+                    e_.Alu32(Alu::Xor, RDX, RAX);
+                    if (mask & 0x30) {
+                        e_.Mov(RCX, RDX);
+                        e_.Shift32(Shift::Shr, RCX, 6);
+                        e_.Shift32(Shift::Shr, RDX, 12);
+                        e_.Alu32(Alu::And, RCX, 0x20);
+                        e_.Alu32(Alu::And, RDX, 0x10);
+                        e_.Alu32(Alu::Or, RCX, RDX);
+                    }
+                    MergeFlags(mask, 0x30, 0x00, RCX);
+                    StorePair(2, RAX);
+                    Next();
+                    break;
+                }
+                case 0x18:
+                    FetchExit(static_cast<uint16_t>(next + static_cast<int8_t>(in.imm8)), base + 3);
+                    break;
+                case 0x20: case 0x28: case 0x30: case 0x38:
+                    Branch([&] { FetchExit(static_cast<uint16_t>(next + static_cast<int8_t>(in.imm8)), base + 3); },
+                           [&] { FetchExit(next, base + 2); });
+                    break;
+                case 0x27:
+                    e_.Mov64(RDI, RBP);
+                    e_.Call(reinterpret_cast<const void *>(&BlockJit::Daa));
+                    Next();
+                    break;
+                case 0x2F: {
+                    e_.Not8(Reg8(7));
+                    HostFlags(0x60, 0x00, 0x60);
+                    Next();
+                    break;
+                }
+                case 0x37:
+                    HostFlags(0x70, 0x00, 0x10);
+                    Next();
+                    break;
+                case 0x3F:
+                    if (in.liveOut & 0x10) e_.Alu8(Alu::Xor, Flags(), uint8_t{0x10});
+                    HostFlags(0x60, 0x00, 0x00);
+                    Next();
+                    break;
+                case 0xC0: case 0xC8: case 0xD0: case 0xD8:
+                    Branch([&] {
+                               PopWord(base + 2, false);
+                               e_.Mov(R13, R14);
+                               FetchExitRuntime(base + 5);
+                           },
+                           [&] { FetchExit(next, base + 2); });
+                    break;
+                case 0xC9:
+                    PopWord(base + 1, false);
+                    e_.Mov(R13, R14);
+                    FetchExitRuntime(base + 4);
+                    break;
+                case 0xC1: case 0xD1: case 0xE1: case 0xF1:
+                    PopWord(base + 1, true);
+                    if (pair == 3) {
+                        e_.Alu32(Alu::And, R14, 0xFFF0);
+                        e_.Swap16(R14);
+                        e_.Store16({RBX, PAIR[3]}, R14);
+                    } else {
+                        StorePair(pair, R14);
+                    }
+                    Next();
+                    break;
+                case 0xC5: case 0xD5: case 0xE5: case 0xF5:
+                    LoadPair(R13, 3);
+                    Corrupt(R13, CorruptionType::Write);
+                    Step(R13, -1);
+                    Corrupt(R13, CorruptionType::Write);
+                    e_.Load8(R14, {RBX, PAIR[pair]});
+                    WriteRuntime(base + 2);
+                    Step(R13, -1);
+                    Corrupt(R13, CorruptionType::Write);
+                    e_.Load8(R14, {RBX, PAIR[pair] + 1});
+                    WriteRuntime(base + 3);
+                    e_.Store16(Field(SP), R13);
+                    Next();
+                    break;
+                case 0xC3:
+                    FetchExit(in.imm16, base + 4);
+                    break;
+                case 0xC2: case 0xCA: case 0xD2: case 0xDA:
+                    Branch([&] { FetchExit(in.imm16, base + 4); }, [&] { FetchExit(next, base + 3); });
+                    break;
+                case 0xCD:
+                    PushReturn(next, base + 4);
+                    FetchExit(in.imm16, base + 6);
+                    break;
+                case 0xC4: case 0xCC: case 0xD4: case 0xDC:
+                    Branch([&] {
+                               PushReturn(next, base + 4);
+                               FetchExit(in.imm16, base + 6);
+                           },
+                           [&] { FetchExit(next, base + 3); });
+                    break;
+                case 0xC7: case 0xCF: case 0xD7: case 0xDF: case 0xE7: case 0xEF: case 0xF7: case 0xFF:
+                    PushReturn(next, base + 2);
+                    FetchExit(op & 0x38, base + 4);
+                    break;
+                case 0xE0:
+                    e_.Load8(R14, Reg8(7));
+                    WriteConst(0xFF00 | in.imm8, base + 2);
+                    Next();
+                    break;
+                case 0xF0:
+                    ReadConst(0xFF00 | in.imm8, base + 2);
+                    e_.Store8(Reg8(7), RAX);
+                    Next();
+                    break;
+                case 0xE2:
+                    e_.Load8(R13, Reg8(1));
+                    e_.Alu32(Alu::Or, R13, 0xFF00);
+                    e_.Load8(R14, Reg8(7));
+                    WriteRuntime(base + 1);
+                    Next();
+                    break;
+                case 0xF2:
+                    e_.Load8(R13, Reg8(1));
+                    e_.Alu32(Alu::Or, R13, 0xFF00);
+                    ReadRuntime(base + 1);
+                    e_.Store8(Reg8(7), RAX);
+                    Next();
+                    break;
+                case 0xEA:
+                    e_.Load8(R14, Reg8(7));
+                    WriteConst(in.imm16, base + 3);
+                    Next();
+                    break;
+                case 0xFA:
+                    ReadConst(in.imm16, base + 3);
+                    e_.Store8(Reg8(7), RAX);
+                    Next();
+                    break;
+                case 0xE8: case 0xF8:
+                    AddSigned(op == 0xF8);
+                    Next();
+                    break;
+                case 0xE9:
+                    LoadPair(R13, 2);
+                    FetchExitRuntime(base + 1);
+                    break;
+                case 0xF3:
+                    // DI clears IME and a pending EI
+                    e_.Load64(RAX, Field(INTERRUPTS));
+                    e_.Store16({RAX, static_cast<int32_t>(offsetof(Interrupts, interruptMasterEnable))}, uint16_t{0});
+                    Next();
+                    break;
+                case 0xF9:
+                    LoadPair(RAX, 2);
+                    e_.Store16(Field(SP), RAX);
+                    Next();
+                    break;
+                default:
+                    // Compile() only hands over what is covered above; a
+                    // label left unbound makes Finish() fail the block
+                    e_.Jmp(e_.NewLabel());
+            }
+        }
+
+        x64::Emitter e_;
+        const std::vector<Insn> &insns_;
+        const uint16_t address_;
+        const uint8_t *page_;
+        const bool oamBug_;
+        const Label epilogue_{e_.NewLabel()};
+        const Insn *in_{nullptr};
+        bool last_{false};
+        uint32_t ops_{0}; // ops up to and including the current instruction
+        bool slow_{false}; // the current instruction has made an access that may leave
+    };
+
+    CPUType &cpu_;
+    ExecutableArena arena_;
+    Context context_;
+};
+
+#endif //STARGBC_BLOCKJIT_H
@@ -0,0 +1,46 @@
+#ifndef STARGBC_BOOTSTATECACHE_H
+#define STARGBC_BOOTSTATECACHE_H
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "Common.h"
+
+// Snapshots of the machine as the bootrom hands over to the game, one file
+// per (bootrom, cartridge header, hardware). The bootrom reads nothing of
+// the cartridge past the header, so every game sharing a header and
+// bootrom boots into the same state. Entries carry the snapshot version
+// and a CRC of the payload; anything that does not match is a miss.
+class BootStateCache {
+public:
+    struct Key {
+        uint32_t bootromCrc{0};
+        uint32_t headerCrc{0}; // 0x100-0x14F as mapped at power-on
+        Hardware hardware{Hardware::DMG};
+
+        [[nodiscard]] std::string FileName() const;
+    };
+
+    explicit BootStateCache(std::filesystem::path directory) : directory_(std::move(directory)) {
+    }
+
+    [[nodiscard]] static Key MakeKey(std::span<const uint8_t> bootrom, std::span<const uint8_t> header,
+                                     Hardware hardware);
+
+    [[nodiscard]] std::optional<std::vector<uint8_t> > Load(const Key &key) const;
+
+    // Written to a temporary file and renamed into place, so instances
+    // starting at the same time never read a partial entry
+    void Store(const Key &key, std::span<const uint8_t> snapshot) const;
+
+private:
+    static constexpr uint32_t MAGIC = 0x53424753; // "SGBS"
+
+    std::filesystem::path directory_;
+};
+
+#endif //STARGBC_BOOTSTATECACHE_H
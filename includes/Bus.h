@@ -26,8 +26,34 @@ public:
                                                                    gpu_(gpu) {
     }
 
+    // Boot ROMs never change, so one copy backs every Bus that runs it
+    static std::shared_ptr<const std::vector<uint8_t> > LoadBootrom(const std::string &path);
+
+    // Called before CPU accesses that can observe peripheral state (VRAM and
+    // OAM, which the PPU mode gates, I/O, IE, or anything while OAM DMA runs)
+    // so a core that ticks peripherals lazily can bring them up to date first
+    using SyncHook = void (*)(void *context);
+
+    void SetSyncHook(const SyncHook hook, void *context) {
+        syncHook_ = hook;
+        syncContext_ = context;
+    }
+
     [[nodiscard]] uint8_t ReadByte(uint16_t, ComponentSource) const;
 
+    // The byte mapped at `address`, read without syncing the peripherals,
+    // bumping the access epoch or seeing the OAM DMA bus conflict, so
+    // observers can look at a running game without changing it
+    [[nodiscard]] uint8_t PeekByte(uint16_t address) const;
+
+    // Bumped by every write and by every read of state that can change with
+    // nothing raising an interrupt: DIV/TIMA, the APU and cartridge RAM
+    // (RTC, sensors). An unchanged epoch means the code in between only read
+    // values that stay put until the next interrupt-raising event.
+    [[nodiscard]] uint32_t AccessEpoch() const {
+        return accessEpoch_;
+    }
+
     [[nodiscard]] uint8_t ReadDMASource(uint16_t);
 
     [[nodiscard]] uint8_t ReadOAM(uint16_t) const;
@@ -42,6 +68,12 @@ public:
 
     void RunHDMA() const;
 
+    // Neither OAM DMA nor HDMA has work to do, so UpdateDMA() only cycles
+    // its tick counter and RunHDMA() returns straight away
+    [[nodiscard]] bool DMAIdle() const;
+
+    void SkipIdleDMATicks(uint32_t ticks);
+
     void ChangeSpeed();
 
     void HandleOAMCorruption(uint16_t, CorruptionType) const;
@@ -50,6 +82,14 @@ public:
 
     void LoadState(std::ifstream &);
 
+    // Every component the bus reaches except the cartridge, which owns the
+    // battery-backed state and is snapshotted on its own
+    template<typename Archive>
+    void Serialize(Archive &archive) {
+        archive(bootromRunning, prepareSpeedShift, speedShiftActive, speed, dmaReadByte, accessEpoch_);
+        archive(joypad_, memory_, timer_, serial_, dma_, audio_, interrupts_, gpu_);
+    }
+
     Joypad &joypad_;
     Memory &memory_;
     Timer &timer_;
@@ -65,5 +105,25 @@ public:
     bool speedShiftActive{false};
     Speed speed{Speed::Regular};
     uint8_t dmaReadByte{};
-    std::vector<uint8_t> bootrom;
+    std::shared_ptr<const std::vector<uint8_t> > bootrom;
+    uint64_t oamDmaMCycles{0}; // gathered once per frame
+
+private:
+    // Compiled blocks bump the access epoch for the RAM writes they inline
+    template<typename CPUType>
+    friend class BlockJit;
+
+    // The address decode behind ReadByte and PeekByte; only counted reads
+    // bump the access epoch
+    [[nodiscard]] uint8_t ReadMapped(uint16_t address, bool countAccess) const;
+
+    [[nodiscard]] bool NeedsSync(const uint16_t address, const ComponentSource source) const {
+        return syncHook_ && source == ComponentSource::CPU &&
+               ((address >= 0x8000 && address < 0xA000) ||
+                (address >= 0xFE00 && (address < 0xFF80 || address == 0xFFFF)) || dma_.transferActive);
+    }
+
+    SyncHook syncHook_{nullptr};
+    void *syncContext_{nullptr};
+    mutable uint32_t accessEpoch_{0};
 };
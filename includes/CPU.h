@@ -1,9 +1,19 @@
 #ifndef STARGBC_CPU_H
 #define STARGBC_CPU_H
 
+#include <stdexcept>
+
+#include "BlockCache.h"
 #include "Bus.h"
 #include "Instructions.h"
 #include "Registers.h"
+#include "RomProfiler.h"
+
+template<typename CPUType>
+class CoroutineCore;
+
+template<typename CPUType>
+class BlockJit;
 
 template<BusLike BusT>
 class CPU {
@@ -11,7 +21,7 @@ public:
     using Self = CPU<BusT>;
 
     explicit CPU(const Mode mode,
-                 const std::string &biosPath,
+                 std::shared_ptr<const std::vector<uint8_t> > bootrom,
                  BusT &bus,
                  Interrupts &interrupts,
                  Registers &registers) : bus_(bus),
@@ -26,9 +36,9 @@ public:
             bus.gpu_.hardware = Hardware::CGB;
             bus.audio_.SetDMG(false);
         }
-        if (!biosPath.empty()) {
+        if (bootrom) {
             bus.bootromRunning = true;
-            InitializeBootrom(biosPath);
+            bus.bootrom = std::move(bootrom);
             pc_ = 0x0000;
         } else {
             pc_ = 0x100;
@@ -37,12 +47,62 @@ public:
         currentInstruction = bus.ReadByte(pc_++, ComponentSource::CPU);
     }
 
-    void InitializeBootrom(const std::string &) const;
-
     void InitializeSystem(Mode);
 
     void ExecuteMicroOp(Instructions<Self> &instructions, bool);
 
+    // One M-cycle with no T-cycle pacing, for callers that keep their own
+    // clock. Returns true when the CPU is between instructions afterwards.
+    bool StepMCycle(Instructions<Self> &instructions, bool hdmaActive);
+
+    // True between instructions when nothing needs the per-cycle path: no
+    // interrupt to dispatch or EI pending, not halted or stopped, no HDMA
+    [[nodiscard]] bool CanRunBlock() const {
+        return !instrRunning && interruptState == InterruptState::M1 && !halted_ && !stopped_ &&
+               !interrupts_.interruptDelay &&
+               !(interrupts_.interruptMasterEnable && (interrupts_.interruptEnable & interrupts_.interruptFlag & 0x1F)) &&
+               !bus_.gpu_.hdma.ShouldHaltCPU();
+    }
+
+    // True when halted with nothing to wake on: every M-cycle until an
+    // interrupt is requested only advances the T-cycle counter
+    [[nodiscard]] bool IdleInHalt() const {
+        return halted_ && !instrRunning && interruptState == InterruptState::M1 && !interrupts_.interruptDelay &&
+               (interrupts_.interruptEnable & interrupts_.interruptFlag & 0x1F) == 0;
+    }
+
+    // True when the next ExecuteMicroOp starts a new M-cycle
+    [[nodiscard]] bool AtMCycleStart() const {
+        return tCycleCounter == 0;
+    }
+
+    // Stands in for `tCycles` calls to ExecuteMicroOp while IdleInHalt()
+    void SkipIdleCycles(const uint32_t tCycles) {
+        tCycleCounter = static_cast<uint8_t>((tCycleCounter + tCycles) % 4);
+    }
+
+    // Runs the instructions of `block` from op `first`, the one just
+    // fetched, while CanRunBlock() holds and the fetched opcodes still
+    // match. Returns the index of the op it stopped at.
+    uint8_t RunBlock(Instructions<Self> &instructions, const typename BlockCache<Self>::Block &block, uint8_t first = 0);
+
+    // M-cycles run by RunBlock since the last call
+    uint32_t TakeBlockCycles() {
+        return std::exchange(blockMCycles_, 0);
+    }
+
+    // Runs instructions through `core` instead of the step tables; null switches back
+    void UseCoroutineCore(CoroutineCore<Self> *core) {
+        coroutineCore_ = core;
+    }
+
+    // Null stops profiling. The instruction just fetched is the first one
+    // recorded.
+    void UseProfiler(RomProfiler *profiler) {
+        profiler_ = profiler;
+        profileStart_ = static_cast<uint16_t>(pc_ - 1);
+    }
+
     [[nodiscard]] std::add_lvalue_reference_t<uint16_t> pc() {
         return pc_;
     }
@@ -51,10 +111,18 @@ public:
         pc_ = value;
     }
 
+    [[nodiscard]] uint16_t pc() const {
+        return pc_;
+    }
+
     [[nodiscard]] std::add_lvalue_reference_t<uint16_t>  sp() {
         return sp_;
     }
 
+    [[nodiscard]] uint16_t sp() const {
+        return sp_;
+    }
+
     void sp(const uint16_t value) {
         sp_ = value;
     }
@@ -95,15 +163,50 @@ public:
         return stopped_;
     }
 
+    [[nodiscard]] bool stopped() const {
+        return stopped_;
+    }
+
     Hardware hardware() {
         return bus_.gpu_.hardware;
     }
 
+    // True once the instruction in flight (if any) has completed and the
+    // next opcode has been fetched
+    [[nodiscard]] bool BetweenInstructions() const {
+        return !instrRunning;
+    }
+
+    // Between instructions with no interrupt dispatch under way
+    [[nodiscard]] bool AtInstructionBoundary() const {
+        return !instrRunning && interruptState == InterruptState::M1;
+    }
+
+    // The coroutine core keeps a suspended instruction on its own stack, so
+    // it can only be snapshotted between instructions
+    template<typename Archive>
+    void Serialize(Archive &archive) {
+        if (coroutineCore_ && instrRunning) {
+            throw std::runtime_error("Cannot snapshot the coroutine core mid-instruction");
+        }
+        archive(currentInstruction, prefixed, pc_, sp_, icount_, mCycleCounter_, nextInstruction_, halted_, haltBug_,
+                stopped_, interruptState, tCycleCounter, interruptBit, interruptMask, instrRunning, blockMCycles_);
+    }
+
     BusT &bus_;
     uint16_t currentInstruction{0x0000};
     bool prefixed{false};
 
+    // Event counts, gathered and zeroed by the Gameboy once per frame
+    uint64_t instructionCount{0};
+    uint64_t haltedMCycles{0};
+    uint64_t hdmaStallMCycles{0};
+    std::array<uint64_t, 5> interruptCounts{}; // dispatched, by IF bit
+
 private:
+    // Compiled blocks stand in for RunBlock and leave the CPU as it would
+    friend class BlockJit<Self>;
+
     uint8_t RunInstructionCycle(Instructions<Self> &, uint8_t, bool);
 
     uint8_t InterruptAddress(uint8_t) const;
@@ -116,8 +219,13 @@ private:
 
     void RunPostCompletion(Instructions<Self> &);
 
+    void RecordProfile() const;
+
     Interrupts &interrupts_;
     Registers &regs_;
+    CoroutineCore<Self> *coroutineCore_{nullptr};
+    RomProfiler *profiler_{nullptr};
+    uint16_t profileStart_{0}; // address of the instruction in flight, while profiling
 
     Mode mode_{Mode::DMG};
 
@@ -135,6 +243,7 @@ private:
     uint8_t interruptBit{0x00};
     uint8_t interruptMask{0x00};
     bool instrRunning{false};
+    uint32_t blockMCycles_{0};
 };
 
 #endif //STARGBC_CPU_H
@@ -1,56 +1,130 @@
 #pragma once
 #include <functional>
+#include <memory>
+#include <span>
+#include "Mappers.h"
+#include "RomSource.h"
 #include "RealTimeClock.h"
 
 class Cartridge {
 public:
-    explicit Cartridge(const std::string &romLocation, RealTimeClock &rtc) : rtc_(rtc) {
-        rtc_.RecalculateZeroTime();
-        ReadFile(romLocation);
-        romBankCount = gameRom_.size() / 0x4000;
-        lowRomMask = std::bit_width(romBankCount) - 1;
-        savepath_ = RemoveExtension(romLocation).append(".sav");
-        DetermineMBC();
-        ramBankCount = gameRam_.size() / 0x2000;
-        multicart = IsLikelyMulticart();
+    using CameraSource = std::function<void(std::span<uint8_t>)>;
+
+    explicit Cartridge(const std::string &romLocation, RealTimeClock &rtc) : Cartridge(
+        romLocation, LoadRom(romLocation), rtc) {
+    }
+
+    // The ROM image is never written, so any number of cartridges may share one
+    Cartridge(const std::string &romLocation, std::shared_ptr<const RomImage> rom, RealTimeClock &rtc,
+              const bool loadSave = true) : rtc_(rtc) {
+        Insert(romLocation, std::move(rom), loadSave);
     }
 
+    // Swaps in another game: its mapper, its save file and power-on bank
+    // registers. The camera and accelerometer inputs stay attached. Without
+    // `loadSave` the save RAM starts blank and the clock at zero, for a
+    // caller that restores both from a snapshot.
+    void Insert(const std::string &romLocation, std::shared_ptr<const RomImage> rom, bool loadSave = true);
+
+    // Bank and mapper registers back to their power-on values. Save RAM is
+    // battery-backed and keeps its contents.
+    void Reset();
+
     static uint32_t GetRamSize(uint8_t byte);
 
+    // Reads a ROM file and pads it to whole banks. Throws if the header
+    // names a mapper or RAM size this emulator does not support.
+    static std::shared_ptr<const RomImage> LoadRom(const std::string &path);
+
+    // CRC32 of the decoded ROM file, before padding
+    [[nodiscard]] uint32_t GetRomCrc32() const { return rom_->crc32; }
+
+    // Instances sharing a save file should not all write it back
+    void SetSaveWritable(const bool writable) { saveWritable_ = writable; }
+
     void Save() const;
 
     [[nodiscard]] uint8_t ReadByte(uint16_t address) const;
 
     void WriteByte(uint16_t address, uint8_t value);
 
-    bool SaveState(std::ofstream &stateFile) const;
+    // The 8 KiB ROM page mapped at `address` (< 0x8000)
+    [[nodiscard]] const uint8_t *RomPage(const uint16_t address) const { return romPages_[address >> 13]; }
 
-    bool LoadState(std::ifstream &stateFile);
+    // All four, for compiled code that indexes them itself (see BlockJit)
+    [[nodiscard]] const uint8_t *const *RomPages() const { return romPages_.data(); }
 
-private:
-    void ReadFile(const std::string &file);
+    // Where that page starts in the ROM image, so code can be identified
+    // across bank switches; NO_ROM_OFFSET when the page is not ROM (MBC6 flash)
+    [[nodiscard]] size_t RomPageOffset(uint16_t address) const;
 
-    void LoadRam(uint16_t size);
+    static constexpr size_t NO_ROM_OFFSET = SIZE_MAX;
 
-    void DetermineMBC();
+    [[nodiscard]] const std::shared_ptr<const RomImage> &Rom() const { return rom_; }
 
-    [[nodiscard]] uint8_t ReadByteNone(uint16_t address) const;
+    [[nodiscard]] std::span<const uint8_t> GameRam() const { return gameRam_; }
 
-    [[nodiscard]] uint8_t ReadByteMBC1(uint16_t address) const;
+    // Replaces the save RAM contents; throws unless `ram` is the same size
+    void SetGameRam(std::span<const uint8_t> ram);
 
-    [[nodiscard]] uint8_t ReadByteMBC2(uint16_t address) const;
+    // Register writes that changed what is mapped, gathered once per frame
+    uint64_t bankSwitches{0};
 
-    [[nodiscard]] uint8_t ReadByteMBC3(uint16_t address) const;
+    bool SaveState(std::ofstream &stateFile) const;
 
-    [[nodiscard]] uint8_t ReadByteMBC5(uint16_t address) const;
+    // The clock is serialized on its own, by whoever owns it
+    template<typename Archive>
+    void Serialize(Archive &archive) {
+        archive(gameRam_, romBank, ramBank, bank1, bank2, mode, ramEnabled, ramDirty_, prevRamEnable_, rumbleOn_,
+                mapperState_);
+        if constexpr (Archive::LOADING) mapHandler_(*this);
+    }
 
-    void WriteByteMBC1(uint16_t address, uint8_t value);
+    bool LoadState(std::ifstream &stateFile);
+
+    // Pocket Camera sensor input, 128x112 8-bit luminance (0 = black)
+    void SetCameraSource(CameraSource source) { cameraSource_ = std::move(source); }
+
+    // MBC7 tilt sensor input in g, positive x = right, positive y = down
+    void SetAccelerometer(const double x, const double y) {
+        accelX_ = x;
+        accelY_ = y;
+    }
+
+private:
+    friend struct NoMapper;
+    friend struct MBC1Mapper;
+    friend struct MBC2Mapper;
+    friend struct MBC3Mapper;
+    friend struct MBC5Mapper;
+    friend struct MBC6Mapper;
+    friend struct MBC7Mapper;
+    friend struct HuC1Mapper;
+    friend struct HuC3Mapper;
+    friend struct MMM01Mapper;
+    friend struct PocketCameraMapper;
+
+    void LoadRam(uint32_t size);
+
+    void InstallMapper();
+
+    void ResetBankRegisters();
+
+    template<MapperLike Mapper>
+    void Install() {
+        readHandler_ = &Mapper::ReadByte;
+        writeHandler_ = &Mapper::WriteByte;
+        mapHandler_ = &Mapper::MapBanks;
+        mapHandler_(*this);
+    }
+
+    void MapRom(size_t bank0, size_t bankN);
 
-    void WriteByteMBC2(uint16_t address, uint8_t value);
+    void MapRam(bool enabled, size_t bank);
 
-    void WriteByteMBC3(uint16_t address, uint8_t value);
+    void UnmapRam();
 
-    void WriteByteMBC5(uint16_t address, uint8_t value);
+    bool WriteRamPage(uint16_t address, uint8_t value);
 
     [[nodiscard]] uint32_t HandleRomBank(uint16_t address) const;
 
@@ -58,27 +132,56 @@ private:
 
     [[nodiscard]] bool IsLikelyMulticart() const;
 
-    [[nodiscard]] uint8_t BankBitmask() const;
+    [[nodiscard]] uint16_t BankBitmask() const;
 
-    inline void HandleRamEnableEdge(bool enable);
+    void HandleRamEnableEdge(bool enable);
 
     static std::string RemoveExtension(const std::string &filename);
 
     enum class MBC {
-        None, MBC1, MBC2, MBC3, MBC5
+        None, MBC1, MBC2, MBC3, MBC5, MBC6, MBC7, HuC1, HuC3, MMM01, PocketCamera
+    };
+
+    // What the header says is on the board
+    struct Layout {
+        MBC mbc{MBC::None};
+        uint32_t ramSize{0};
+        bool battery{false};
+        bool rumble{false};
     };
 
+    // Throws FatalErrorException on an unsupported mapper or RAM size
+    static Layout ReadLayout(std::span<const uint8_t> rom);
+
     RealTimeClock& rtc_;
+    std::shared_ptr<const RomImage> rom_;
+
+    // Resolved by the mapper on every banking register write so reads are a
+    // single offset. ROM is mapped in 8 KiB pages and external RAM in 4 KiB
+    // pages (MBC6 switches at that granularity). A null RAM page means the
+    // window is not plain RAM (disabled, RTC/sensor registers, MBC2 nibble
+    // RAM, or a bank past the end of gameRam_) and reads go to the mapper.
+    std::array<const uint8_t *, 4> romPages_{};
+    std::array<uint8_t *, 2> ramPages_{};
+
+    // The mapper's entry points, set by Install<Mapper>(). Calls through
+    // them are indirect, but only register writes and reads of windows
+    // with a null page get here; ROM and plain RAM never do. Templating
+    // Bus and CPU on the mapper would remove the indirection at the cost
+    // of one copy of the whole core per mapper.
+    uint8_t (*readHandler_)(const Cartridge &, uint16_t){nullptr};
+    void (*writeHandler_)(Cartridge &, uint16_t, uint8_t){nullptr};
+    void (*mapHandler_)(Cartridge &){nullptr};
 
     std::string savepath_;
-    std::vector<uint8_t> gameRom_;
+    std::span<const uint8_t> gameRom_;
     std::vector<uint8_t> gameRam_;
 
     MBC mbc{MBC::None};
     uint32_t gameRamSize{0x00};
     uint32_t romBankCount{0x00};
     uint32_t ramBankCount{0x00};
-    uint8_t romBank{0x01};
+    uint16_t romBank{0x01}; // 9 bits on MBC5
     uint8_t ramBank{0x00};
     uint8_t bank1{0x01};
     uint8_t bank2{0x00};
@@ -88,8 +191,14 @@ private:
     bool ramEnabled{false};
     bool multicart{false};
     bool ramDirty_{false};
+    bool saveWritable_{true};
     bool prevRamEnable_{false};
     bool hasRumble_{false};
     bool rumbleOn_{false};
     std::function<void(bool)> rumbleCallback_;
+
+    MapperState mapperState_{};
+    CameraSource cameraSource_;
+    double accelX_{0.0};
+    double accelY_{0.0};
 };
@@ -29,6 +29,10 @@ static constexpr uint8_t OAM_VRAM_BANK_BIT = 3;
 static constexpr uint16_t SCANLINE_CYCLES = 456;
 static constexpr uint8_t MODE2_CYCLES = 80;
 
+// Returned by the IdleTicks()/IdleDots() queries when a component has no
+// event coming up on its own
+static constexpr uint32_t IDLE_UNBOUNDED = UINT32_MAX;
+
 static constexpr uint8_t OBJ_TOTAL_SPRITES = 40;
 
 // 0xFF40 -- LCD Control
@@ -0,0 +1,679 @@
+#ifndef STARGBC_COROUTINECORE_H
+#define STARGBC_COROUTINECORE_H
+
+#include <array>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <memory>
+
+#include "Instructions.h"
+
+// Alternative to the step tables in Instructions: every multi-cycle opcode is
+// a coroutine that suspends at the end of each M-cycle, so the compiler keeps
+// the instruction's progress and temporaries in the coroutine frame instead
+// of mCycleCounter and the word/byte scratch fields. Bus accesses happen in
+// the same M-cycles as the table core, so the two are interchangeable.
+//
+// Opcodes that finish in one M-cycle have nothing to suspend and go straight
+// to the table core.
+template<typename CPUType>
+class CoroutineCore {
+public:
+    CoroutineCore(Registers &regs, Interrupts &interrupts) : regs_(regs), interrupts_(interrupts) {
+    }
+
+    CoroutineCore(const CoroutineCore &) = delete;
+
+    CoroutineCore &operator=(const CoroutineCore &) = delete;
+
+    ~CoroutineCore() {
+        if (running_) running_.destroy();
+    }
+
+    // Runs one M-cycle of `opcode`; true once the instruction has completed
+    bool Step(Instructions<CPUType> &instructions, const uint8_t opcode, const bool prefixed, CPUType &cpu) {
+        if (running_) {
+            running_.resume();
+        } else {
+            running_ = (prefixed ? StartPrefixed(opcode, cpu) : Start(opcode, cpu)).handle;
+            if (!running_) {
+                return prefixed ? instructions.prefixedInstr(opcode, cpu) : instructions.nonPrefixedInstr(opcode, cpu);
+            }
+        }
+        if (!running_.done()) return false;
+        // A bus access that threw (a save failing on a RAM enable edge, say)
+        // also ends the instruction; the frame slot is freed before it carries on
+        const std::exception_ptr exception = running_.promise().exception;
+        running_.destroy();
+        running_ = nullptr;
+        if (exception) std::rethrow_exception(exception);
+        return true;
+    }
+
+    // Abandons the instruction in flight, for a reset
+    void Cancel() {
+        if (running_) running_.destroy();
+        running_ = nullptr;
+    }
+
+    // Times the frame slot had to grow; stays constant once every opcode has run
+    [[nodiscard]] size_t ArenaGrowths() const { return arena_.growths; }
+
+private:
+    // Frames are carved from a single recycled slot: only one instruction is
+    // in flight at a time, so the slot is free again whenever a new one starts.
+    // It is sized for the largest frame up front and only grows if a compiler
+    // lays frames out bigger than expected.
+    struct FrameArena {
+        static constexpr size_t INITIAL_CAPACITY = 256;
+        static constexpr size_t HEADER = alignof(std::max_align_t);
+
+        FrameArena() : slot(std::make_unique<std::byte[]>(HEADER + INITIAL_CAPACITY)) {
+        }
+
+        void *Allocate(const size_t size) {
+            if (inUse) throw FatalErrorException("Coroutine core started an instruction while another was running");
+            if (size > capacity) {
+                slot = std::make_unique<std::byte[]>(HEADER + size);
+                capacity = size;
+                ++growths;
+            }
+            inUse = true;
+            // The header lets the frame find its way back here when released
+            *reinterpret_cast<FrameArena **>(slot.get()) = this;
+            return slot.get() + HEADER;
+        }
+
+        static void Release(void *frame) {
+            (*reinterpret_cast<FrameArena **>(static_cast<std::byte *>(frame) - HEADER))->inUse = false;
+        }
+
+        std::unique_ptr<std::byte[]> slot;
+        size_t capacity{INITIAL_CAPACITY};
+        size_t growths{0};
+        bool inUse{false};
+    };
+
+    struct Op {
+        struct promise_type {
+            template<typename... Args>
+            static void *operator new(const size_t size, CoroutineCore &core, Args &&...) {
+                return core.arena_.Allocate(size);
+            }
+
+            static void operator delete(void *frame, size_t) {
+                FrameArena::Release(frame);
+            }
+
+            Op get_return_object() { return {std::coroutine_handle<promise_type>::from_promise(*this)}; }
+
+            // The first M-cycle runs as part of starting the instruction
+            std::suspend_never initial_suspend() noexcept { return {}; }
+
+            std::suspend_always final_suspend() noexcept { return {}; }
+
+            void return_void() {
+            }
+
+            // Held for Step to rethrow: letting it escape here would leave
+            // the frame, and with it the arena slot, behind
+            void unhandled_exception() { exception = std::current_exception(); }
+
+            std::exception_ptr exception;
+        };
+
+        std::coroutine_handle<promise_type> handle;
+    };
+
+    static constexpr std::suspend_always NextCycle{};
+
+    static constexpr std::array<uint8_t Registers::*, 8> REGISTERS = {
+        &Registers::b, &Registers::c, &Registers::d, &Registers::e,
+        &Registers::h, &Registers::l, nullptr, &Registers::a,
+    };
+
+    Registers &regs_;
+    Interrupts &interrupts_;
+    FrameArena arena_;
+    std::coroutine_handle<typename Op::promise_type> running_;
+
+    static uint8_t Read(CPUType &cpu, const uint16_t address) {
+        return cpu.bus_.ReadByte(address, ComponentSource::CPU);
+    }
+
+    static uint8_t ReadImmediate(CPUType &cpu) {
+        return cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU);
+    }
+
+    static void Write(CPUType &cpu, const uint16_t address, const uint8_t value) {
+        cpu.bus_.WriteByte(address, value, ComponentSource::CPU);
+    }
+
+    static void Fetch(CPUType &cpu) {
+        cpu.nextInstruction() = cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU);
+    }
+
+    // cc field of conditional jumps: NZ, Z, NC, C
+    [[nodiscard]] bool Condition(const uint8_t cc) const {
+        switch (cc) {
+            case 0: return !regs_.FlagZero();
+            case 1: return regs_.FlagZero();
+            case 2: return !regs_.FlagCarry();
+            default: return regs_.FlagCarry();
+        }
+    }
+
+    // rr field of 16-bit loads and arithmetic: BC, DE, HL, SP
+    [[nodiscard]] uint16_t GetPair(CPUType &cpu, const uint8_t pair) const {
+        switch (pair) {
+            case 0: return regs_.GetBC();
+            case 1: return regs_.GetDE();
+            case 2: return regs_.GetHL();
+            default: return cpu.sp();
+        }
+    }
+
+    void SetPair(CPUType &cpu, const uint8_t pair, const uint16_t value) {
+        switch (pair) {
+            case 0: regs_.SetBC(value); break;
+            case 1: regs_.SetDE(value); break;
+            case 2: regs_.SetHL(value); break;
+            default: cpu.sp() = value; break;
+        }
+    }
+
+    // ADD, ADC, SUB, SBC, AND, XOR, OR, CP against A, as in the table core
+    void Alu(const uint8_t op, const uint8_t value) {
+        const uint8_t a = regs_.a;
+        const uint8_t carry = regs_.FlagCarry() ? 1 : 0;
+        switch (op) {
+            case 0: {
+                const uint8_t result = a + value;
+                regs_.SetCarry(static_cast<uint16_t>(a) + value > 0xFF);
+                regs_.SetZero(result == 0);
+                regs_.SetSubtract(false);
+                regs_.SetHalf((a & 0xF) + (value & 0xF) > 0xF);
+                regs_.a = result;
+                break;
+            }
+            case 1: {
+                const uint8_t result = a + value + carry;
+                regs_.SetCarry(static_cast<uint16_t>(a) + value + carry > 0xFF);
+                regs_.SetHalf((a & 0xF) + (value & 0xF) + carry > 0xF);
+                regs_.SetSubtract(false);
+                regs_.SetZero(result == 0);
+                regs_.a = result;
+                break;
+            }
+            case 2:
+            case 7: {
+                const uint8_t result = a - value;
+                regs_.SetCarry(a < value);
+                regs_.SetHalf((a & 0xF) < (value & 0xF));
+                regs_.SetSubtract(true);
+                regs_.SetZero(result == 0);
+                if (op == 2) regs_.a = result;
+                break;
+            }
+            case 3: {
+                const uint8_t result = a - value - carry;
+                regs_.SetCarry(a < value + static_cast<uint16_t>(carry));
+                regs_.SetHalf((a & 0xF) < (value & 0xF) + carry);
+                regs_.SetSubtract(true);
+                regs_.SetZero(result == 0);
+                regs_.a = result;
+                break;
+            }
+            default: {
+                regs_.a = op == 4 ? a & value : op == 5 ? a ^ value : a | value;
+                regs_.SetZero(regs_.a == 0);
+                regs_.SetSubtract(false);
+                regs_.SetHalf(op == 4);
+                regs_.SetCarry(false);
+                break;
+            }
+        }
+    }
+
+    Op Start(const uint8_t opcode, CPUType &cpu) {
+        const uint8_t y = (opcode >> 3) & 0x07;
+        const uint8_t pair = (opcode >> 4) & 0x03;
+        switch (opcode) {
+            case 0x01: case 0x11: case 0x21: case 0x31: return LoadPairImmediate(cpu, pair);
+            case 0x02: case 0x12: return StoreAccumulator(cpu, pair == 0 ? regs_.GetBC() : regs_.GetDE());
+            case 0x03: case 0x13: case 0x23: case 0x33: return StepPair(cpu, pair, 1);
+            case 0x0B: case 0x1B: case 0x2B: case 0x3B: return StepPair(cpu, pair, -1);
+            case 0x34: return IncrementIndirect(cpu, 1);
+            case 0x35: return IncrementIndirect(cpu, -1);
+            case 0x36: return StoreImmediateIndirect(cpu);
+            case 0x06: case 0x0E: case 0x16: case 0x1E: case 0x26: case 0x2E: case 0x3E:
+                return LoadRegisterImmediate(cpu, y);
+            case 0x08: return StoreStackPointer(cpu);
+            case 0x09: case 0x19: case 0x29: case 0x39: return AddPair(cpu, pair);
+            case 0x0A: case 0x1A: return LoadAccumulator(cpu, pair == 0 ? regs_.GetBC() : regs_.GetDE());
+            case 0x18: return JumpRelative(cpu, true);
+            case 0x20: case 0x28: case 0x30: case 0x38: return JumpRelative(cpu, Condition(y - 4));
+            case 0x22: return StoreAccumulatorStepHL(cpu, 1);
+            case 0x32: return StoreAccumulatorStepHL(cpu, -1);
+            case 0x2A: return LoadAccumulatorStepHL(cpu, 1);
+            case 0x3A: return LoadAccumulatorStepHL(cpu, -1);
+            case 0x46: case 0x4E: case 0x56: case 0x5E: case 0x66: case 0x6E: case 0x7E:
+                return LoadRegisterIndirect(cpu, y);
+            case 0x70 ... 0x75: case 0x77: return StoreRegisterIndirect(cpu, opcode & 0x07);
+            case 0x86: case 0x8E: case 0x96: case 0x9E: case 0xA6: case 0xAE: case 0xB6: case 0xBE:
+                return AluIndirect(cpu, y);
+            case 0xC6: case 0xCE: case 0xD6: case 0xDE: case 0xE6: case 0xEE: case 0xF6: case 0xFE:
+                return AluImmediate(cpu, y);
+            case 0xC0: case 0xC8: case 0xD0: case 0xD8: return ReturnConditional(cpu, y);
+            case 0xC9: return Return(cpu, false);
+            case 0xD9: return Return(cpu, true);
+            case 0xC1: case 0xD1: case 0xE1: case 0xF1: return Pop(cpu, pair);
+            case 0xC5: case 0xD5: case 0xE5: case 0xF5: return Push(cpu, pair);
+            case 0xC2: case 0xCA: case 0xD2: case 0xDA: return Jump(cpu, y);
+            case 0xC3: return Jump(cpu, 0xFF);
+            case 0xC4: case 0xCC: case 0xD4: case 0xDC: return Call(cpu, y);
+            case 0xCD: return Call(cpu, 0xFF);
+            case 0xC7: case 0xCF: case 0xD7: case 0xDF: case 0xE7: case 0xEF: case 0xF7: case 0xFF:
+                return Restart(cpu, opcode & 0x38);
+            case 0xE0: return StoreHighImmediate(cpu);
+            case 0xE2: return StoreAccumulator(cpu, 0xFF00 | regs_.c);
+            case 0xF0: return LoadHighImmediate(cpu);
+            case 0xF2: return LoadAccumulator(cpu, 0xFF00 | regs_.c);
+            case 0xE8: return AddStackPointer(cpu);
+            case 0xF8: return LoadStackPointerOffset(cpu);
+            case 0xF9: return LoadStackPointerHL(cpu);
+            case 0xEA: return StoreAccumulatorDirect(cpu);
+            case 0xFA: return LoadAccumulatorDirect(cpu);
+            default: return {};
+        }
+    }
+
+    Op StartPrefixed(const uint8_t opcode, CPUType &cpu) {
+        if ((opcode & 0x07) != 0x06) return {};
+        const uint8_t y = (opcode >> 3) & 0x07;
+        switch (opcode >> 6) {
+            case 0: return ShiftIndirect(cpu, y);
+            case 1: return TestBitIndirect(cpu, y);
+            case 2: return WriteBitIndirect(cpu, y, false);
+            default: return WriteBitIndirect(cpu, y, true);
+        }
+    }
+
+    Op LoadPairImmediate(CPUType &cpu, const uint8_t pair) {
+        uint16_t value = ReadImmediate(cpu);
+        co_await NextCycle;
+        value |= static_cast<uint16_t>(ReadImmediate(cpu)) << 8;
+        co_await NextCycle;
+        SetPair(cpu, pair, value);
+        Fetch(cpu);
+    }
+
+    Op StoreAccumulator(CPUType &cpu, const uint16_t address) {
+        Write(cpu, address, regs_.a);
+        co_await NextCycle;
+        Fetch(cpu);
+    }
+
+    Op LoadAccumulator(CPUType &cpu, const uint16_t address) {
+        const uint8_t value = Read(cpu, address);
+        co_await NextCycle;
+        regs_.a = value;
+        Fetch(cpu);
+    }
+
+    Op StepPair(CPUType &cpu, const uint8_t pair, const int delta) {
+        const uint16_t value = GetPair(cpu, pair);
+        cpu.bus_.HandleOAMCorruption(value, CorruptionType::Write);
+        SetPair(cpu, pair, static_cast<uint16_t>(value + delta));
+        co_await NextCycle;
+        Fetch(cpu);
+    }
+
+    Op IncrementIndirect(CPUType &cpu, const int delta) {
+        const uint8_t value = Read(cpu, regs_.GetHL());
+        co_await NextCycle;
+        const uint8_t result = value + delta;
+        regs_.SetHalf(delta > 0 ? (value & 0xF) == 0xF : (value & 0xF) == 0x0);
+        regs_.SetZero(result == 0);
+        regs_.SetSubtract(delta < 0);
+        Write(cpu, regs_.GetHL(), result);
+        co_await NextCycle;
+        Fetch(cpu);
+    }
+
+    Op StoreImmediateIndirect(CPUType &cpu) {
+        const uint8_t value = ReadImmediate(cpu);
+        co_await NextCycle;
+        Write(cpu, regs_.GetHL(), value);
+        co_await NextCycle;
+        Fetch(cpu);
+    }
+
+    Op LoadRegisterImmediate(CPUType &cpu, const uint8_t target) {
+        const uint8_t value = ReadImmediate(cpu);
+        co_await NextCycle;
+        regs_.*REGISTERS[target] = value;
+        Fetch(cpu);
+    }
+
+    Op LoadRegisterIndirect(CPUType &cpu, const uint8_t target) {
+        const uint8_t value = Read(cpu, regs_.GetHL());
+        co_await NextCycle;
+        regs_.*REGISTERS[target] = value;
+        Fetch(cpu);
+    }
+
+    Op StoreRegisterIndirect(CPUType &cpu, const uint8_t source) {
+        Write(cpu, regs_.GetHL(), regs_.*REGISTERS[source]);
+        co_await NextCycle;
+        Fetch(cpu);
+    }
+
+    Op StoreStackPointer(CPUType &cpu) {
+        uint16_t address = ReadImmediate(cpu);
+        co_await NextCycle;
+        address |= static_cast<uint16_t>(ReadImmediate(cpu)) << 8;
+        co_await NextCycle;
+        Write(cpu, address, cpu.sp() & 0xFF);
+        co_await NextCycle;
+        Write(cpu, address + 1, cpu.sp() >> 8);
+        co_await NextCycle;
+        Fetch(cpu);
+    }
+
+    Op AddPair(CPUType &cpu, const uint8_t pair) {
+        const uint16_t value = GetPair(cpu, pair);
+        co_await NextCycle;
+        const uint16_t hl = regs_.GetHL();
+        regs_.SetCarry(hl > 0xFFFF - value);
+        regs_.SetSubtract(false);
+        regs_.SetHalf((hl & 0x07FF) + (value & 0x07FF) > 0x07FF);
+        regs_.SetHL(hl + value);
+        Fetch(cpu);
+    }
+
+    Op JumpRelative(CPUType &cpu, bool taken) {
+        const auto offset = std::bit_cast<int8_t>(ReadImmediate(cpu));
+        co_await NextCycle;
+        if (!taken) {
+            Fetch(cpu);
+            co_return;
+        }
+        cpu.pc() += offset;
+        co_await NextCycle;
+        Fetch(cpu);
+    }
+
+    Op StoreAccumulatorStepHL(CPUType &cpu, const int delta) {
+        const uint16_t address = regs_.GetHL();
+        cpu.bus_.HandleOAMCorruption(address, CorruptionType::Write);
+        Write(cpu, address, regs_.a);
+        cpu.bus_.HandleOAMCorruption(address, CorruptionType::Write);
+        regs_.SetHL(address + delta);
+        co_await NextCycle;
+        Fetch(cpu);
+    }
+
+    Op LoadAccumulatorStepHL(CPUType &cpu, const int delta) {
+        const uint8_t value = Read(cpu, regs_.GetHL());
+        cpu.bus_.HandleOAMCorruption(regs_.GetHL(), CorruptionType::ReadWrite);
+        regs_.SetHL(regs_.GetHL() + delta);
+        co_await NextCycle;
+        regs_.a = value;
+        Fetch(cpu);
+    }
+
+    Op AluIndirect(CPUType &cpu, const uint8_t op) {
+        const uint8_t value = Read(cpu, regs_.GetHL());
+        co_await NextCycle;
+        Alu(op, value);
+        Fetch(cpu);
+    }
+
+    Op AluImmediate(CPUType &cpu, const uint8_t op) {
+        const uint8_t value = ReadImmediate(cpu);
+        co_await NextCycle;
+        Alu(op, value);
+        Fetch(cpu);
+    }
+
+    Op ReturnConditional(CPUType &cpu, const uint8_t cc) {
+        const bool taken = Condition(cc);
+        co_await NextCycle;
+        if (!taken) {
+            Fetch(cpu);
+            co_return;
+        }
+        uint16_t target = Read(cpu, cpu.sp()++);
+        co_await NextCycle;
+        target |= static_cast<uint16_t>(Read(cpu, cpu.sp()++)) << 8;
+        co_await NextCycle;
+        cpu.pc() = target;
+        co_await NextCycle;
+        Fetch(cpu);
+    }
+
+    Op Return(CPUType &cpu, const bool enableInterrupts) {
+        uint16_t target = Read(cpu, cpu.sp()++);
+        co_await NextCycle;
+        target |= static_cast<uint16_t>(Read(cpu, cpu.sp()++)) << 8;
+        co_await NextCycle;
+        cpu.pc() = target;
+        if (enableInterrupts) interrupts_.interruptMasterEnable = true;
+        co_await NextCycle;
+        Fetch(cpu);
+    }
+
+    Op Pop(CPUType &cpu, const uint8_t pair) {
+        cpu.bus_.HandleOAMCorruption(cpu.sp(), CorruptionType::ReadWrite);
+        uint16_t value = Read(cpu, cpu.sp()++);
+        co_await NextCycle;
+        cpu.bus_.HandleOAMCorruption(cpu.sp(), CorruptionType::Read);
+        value |= static_cast<uint16_t>(Read(cpu, cpu.sp()++)) << 8;
+        co_await NextCycle;
+        if (pair == 3) regs_.SetAF(value & 0xFFF0);
+        else SetPair(cpu, pair, value);
+        Fetch(cpu);
+    }
+
+    Op Push(CPUType &cpu, const uint8_t pair) {
+        cpu.bus_.HandleOAMCorruption(cpu.sp(), CorruptionType::Write);
+        cpu.sp() -= 1;
+        co_await NextCycle;
+        cpu.bus_.HandleOAMCorruption(cpu.sp(), CorruptionType::Write);
+        const uint16_t value = pair == 3 ? regs_.GetAF() : GetPair(cpu, pair);
+        Write(cpu, cpu.sp()--, value >> 8);
+        co_await NextCycle;
+        cpu.bus_.HandleOAMCorruption(cpu.sp(), CorruptionType::Write);
+        Write(cpu, cpu.sp(), value & 0xFF);
+        co_await NextCycle;
+        Fetch(cpu);
+    }
+
+    // cc of 0xFF means unconditional
+    Op Jump(CPUType &cpu, const uint8_t cc) {
+        uint16_t target = ReadImmediate(cpu);
+        co_await NextCycle;
+        target |= static_cast<uint16_t>(ReadImmediate(cpu)) << 8;
+        const bool taken = cc == 0xFF || Condition(cc);
+        co_await NextCycle;
+        if (!taken) {
+            Fetch(cpu);
+            co_return;
+        }
+        cpu.pc() = target;
+        co_await NextCycle;
+        Fetch(cpu);
+    }
+
+    Op Call(CPUType &cpu, const uint8_t cc) {
+        uint16_t target = ReadImmediate(cpu);
+        co_await NextCycle;
+        const bool taken = cc == 0xFF || Condition(cc);
+        target |= static_cast<uint16_t>(ReadImmediate(cpu)) << 8;
+        co_await NextCycle;
+        if (!taken) {
+            Fetch(cpu);
+            co_return;
+        }
+        cpu.sp() -= 1;
+        co_await NextCycle;
+        Write(cpu, cpu.sp()--, cpu.pc() >> 8);
+        co_await NextCycle;
+        Write(cpu, cpu.sp(), cpu.pc() & 0xFF);
+        cpu.pc() = target;
+        co_await NextCycle;
+        Fetch(cpu);
+    }
+
+    Op Restart(CPUType &cpu, const uint8_t target) {
+        cpu.sp() -= 1;
+        co_await NextCycle;
+        Write(cpu, cpu.sp()--, cpu.pc() >> 8);
+        co_await NextCycle;
+        Write(cpu, cpu.sp(), cpu.pc() & 0xFF);
+        cpu.pc() = target;
+        co_await NextCycle;
+        Fetch(cpu);
+    }
+
+    Op StoreHighImmediate(CPUType &cpu) {
+        const uint8_t offset = ReadImmediate(cpu);
+        co_await NextCycle;
+        Write(cpu, 0xFF00 | offset, regs_.a);
+        co_await NextCycle;
+        Fetch(cpu);
+    }
+
+    Op LoadHighImmediate(CPUType &cpu) {
+        const uint8_t offset = ReadImmediate(cpu);
+        co_await NextCycle;
+        const uint8_t value = Read(cpu, 0xFF00 | offset);
+        co_await NextCycle;
+        Fetch(cpu);
+        regs_.a = value;
+    }
+
+    Op StoreAccumulatorDirect(CPUType &cpu) {
+        uint16_t address = ReadImmediate(cpu);
+        co_await NextCycle;
+        address |= static_cast<uint16_t>(ReadImmediate(cpu)) << 8;
+        co_await NextCycle;
+        Write(cpu, address, regs_.a);
+        co_await NextCycle;
+        Fetch(cpu);
+    }
+
+    Op LoadAccumulatorDirect(CPUType &cpu) {
+        uint16_t address = ReadImmediate(cpu);
+        co_await NextCycle;
+        address |= static_cast<uint16_t>(ReadImmediate(cpu)) << 8;
+        co_await NextCycle;
+        regs_.a = Read(cpu, address);
+        co_await NextCycle;
+        Fetch(cpu);
+    }
+
+    Op AddStackPointer(CPUType &cpu) {
+        const auto offset = static_cast<uint16_t>(std::bit_cast<int8_t>(ReadImmediate(cpu)));
+        co_await NextCycle;
+        const uint16_t sp = cpu.sp();
+        co_await NextCycle;
+        regs_.SetCarry((sp & 0xFF) + (offset & 0xFF) > 0xFF);
+        regs_.SetHalf((sp & 0xF) + (offset & 0xF) > 0xF);
+        regs_.SetSubtract(false);
+        regs_.SetZero(false);
+        co_await NextCycle;
+        cpu.sp() = sp + offset;
+        Fetch(cpu);
+    }
+
+    Op LoadStackPointerOffset(CPUType &cpu) {
+        const auto offset = static_cast<uint16_t>(std::bit_cast<int8_t>(ReadImmediate(cpu)));
+        co_await NextCycle;
+        regs_.SetCarry((cpu.sp() & 0xFF) + (offset & 0xFF) > 0xFF);
+        regs_.SetHalf((cpu.sp() & 0xF) + (offset & 0xF) > 0xF);
+        regs_.SetSubtract(false);
+        regs_.SetZero(false);
+        co_await NextCycle;
+        regs_.SetHL(cpu.sp() + offset);
+        Fetch(cpu);
+    }
+
+    Op LoadStackPointerHL(CPUType &cpu) {
+        cpu.sp() = regs_.GetHL();
+        co_await NextCycle;
+        Fetch(cpu);
+    }
+
+    // RLC, RRC, RL, RR, SLA, SRA, SWAP, SRL on (HL). Flags land in the same
+    // M-cycles as in the table core.
+    Op ShiftIndirect(CPUType &cpu, const uint8_t op) {
+        uint8_t value = Read(cpu, regs_.GetHL());
+        if (op == 7) regs_.SetCarry(value & 0x01);
+        co_await NextCycle;
+        bool lateCarry = false;
+        switch (op) {
+            case 0:
+                regs_.SetCarry(value & 0x80);
+                value = value << 1 | value >> 7;
+                break;
+            case 1:
+                regs_.SetCarry(value & 0x01);
+                value = value >> 1 | value << 7;
+                break;
+            case 2: {
+                const uint8_t carry = regs_.FlagCarry() ? 1 : 0;
+                regs_.SetCarry(value & 0x80);
+                value = value << 1 | carry;
+                break;
+            }
+            case 3:
+                lateCarry = value & 0x01;
+                value = regs_.FlagCarry() ? 0x80 | value >> 1 : value >> 1;
+                break;
+            case 4:
+                regs_.SetCarry(value & 0x80);
+                value <<= 1;
+                break;
+            case 5:
+                regs_.SetCarry(value & 0x01);
+                value = value >> 1 | (value & 0x80);
+                break;
+            case 6:
+                value = value >> 4 | value << 4;
+                break;
+            default:
+                value >>= 1;
+                break;
+        }
+        Write(cpu, regs_.GetHL(), value);
+        co_await NextCycle;
+        if (op == 3) regs_.SetCarry(lateCarry);
+        if (op == 6) regs_.SetCarry(false);
+        regs_.SetZero(value == 0);
+        regs_.SetSubtract(false);
+        regs_.SetHalf(false);
+        Fetch(cpu);
+    }
+
+    Op TestBitIndirect(CPUType &cpu, const uint8_t bit) {
+        const uint8_t value = Read(cpu, regs_.GetHL());
+        co_await NextCycle;
+        regs_.SetZero((value & (1 << bit)) == 0);
+        regs_.SetSubtract(false);
+        regs_.SetHalf(true);
+        Fetch(cpu);
+    }
+
+    Op WriteBitIndirect(CPUType &cpu, const uint8_t bit, const bool set) {
+        const uint8_t value = Read(cpu, regs_.GetHL());
+        co_await NextCycle;
+        Write(cpu, regs_.GetHL(), set ? value | 1 << bit : value & ~(1 << bit));
+        co_await NextCycle;
+        Fetch(cpu);
+    }
+};
+
+#endif //STARGBC_COROUTINECORE_H
@@ -20,6 +20,11 @@ struct DMA {
 
     void Set(uint8_t);
 
+    template<typename Archive>
+    void Serialize(Archive &archive) {
+        archive(dmaTickCounter, writtenValue, startAddress, currentByte, transferActive, restartPending,
+                pendingStart, restartCountdown, ticks, transferComplete);
+    }
 };
 
 #endif //STARGBC_DMA_H
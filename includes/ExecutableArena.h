@@ -0,0 +1,44 @@
+#ifndef STARGBC_EXECUTABLEARENA_H
+#define STARGBC_EXECUTABLEARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+// Generated code follows the System V x86-64 calling convention
+#if defined(__x86_64__) && !defined(_WIN32)
+#define STARGBC_JIT_X64 1
+#endif
+
+// Fixed-size region for generated machine code. The pages are only ever
+// writable or executable, never both: Commit() flips them to write, copies
+// the code in and flips them back.
+class ExecutableArena {
+public:
+    explicit ExecutableArena(size_t capacity);
+
+    ExecutableArena(const ExecutableArena &) = delete;
+
+    ExecutableArena &operator=(const ExecutableArena &) = delete;
+
+    ~ExecutableArena();
+
+    // Whether this host can run code from the arena at all
+    [[nodiscard]] static bool Supported();
+
+    // Copies `code` in and returns its entry point, or null when the arena
+    // is full or the host is not supported
+    [[nodiscard]] const void *Commit(std::span<const uint8_t> code);
+
+    // Drops everything committed; earlier entry points must not run again
+    void Clear() { used_ = 0; }
+
+    [[nodiscard]] size_t used() const { return used_; }
+
+private:
+    uint8_t *base_{nullptr};
+    size_t capacity_{0};
+    size_t used_{0};
+};
+
+#endif //STARGBC_EXECUTABLEARENA_H
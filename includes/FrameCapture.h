@@ -0,0 +1,85 @@
+#ifndef STARGBC_FRAMECAPTURE_H
+#define STARGBC_FRAMECAPTURE_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Common.h"
+
+// Writes frames out on a worker thread. Submit() copies a finished frame
+// into a preallocated pool and returns at once; if the worker has fallen so
+// far behind that the pool is full, the frame is dropped and counted rather
+// than waited for, so capturing never holds up emulation.
+class FrameCapture {
+public:
+    static constexpr size_t FRAME_PIXELS = SCREEN_WIDTH * SCREEN_HEIGHT;
+
+    enum class Format : uint8_t {
+        Png, // `path` is a directory, one frame-<n>.png per frame
+        Y4m, // one YUV 4:4:4 stream for a video encoder to read
+        Rgba, // raw frames back to back, in GetScreenData() byte order
+    };
+
+    struct Stats {
+        uint64_t submitted;
+        uint64_t written;
+        uint64_t dropped; // pool full, or the output failed
+    };
+
+    // For Y4m and Rgba, a `path` of "-" streams to stdout (e.g. into a pipe)
+    FrameCapture(std::string path, Format format, size_t poolFrames = 16);
+
+    FrameCapture(const FrameCapture &) = delete;
+
+    FrameCapture &operator=(const FrameCapture &) = delete;
+
+    // Writes out everything already submitted, then closes the output
+    ~FrameCapture();
+
+    // .y4m and .rgba files and "-" stream; any other path is a PNG directory
+    static Format FormatOf(const std::string &path);
+
+    // Called from the emulation thread only. False if the frame was dropped.
+    bool Submit(const uint32_t *pixels);
+
+    // From the emulation thread, like Submit()
+    [[nodiscard]] Stats GetStats() const;
+
+    // Why the output stopped taking frames; empty while it is fine
+    [[nodiscard]] std::string Error() const;
+
+private:
+    void Run();
+
+    void Write(const uint32_t *pixels, uint64_t frame);
+
+    void WriteY4mFrame(const uint32_t *pixels);
+
+    const std::string path_;
+    const Format format_;
+    const size_t poolFrames_;
+    std::vector<uint32_t> pool_;
+    std::vector<uint64_t> slotFrame_; // Submit() count when each slot was filled
+    std::vector<uint8_t> planes_; // Y4M conversion buffer
+    std::FILE *out_{nullptr};
+
+    // Single producer, single consumer: the emulation thread fills slots and
+    // advances head_, the worker empties them and advances tail_
+    std::atomic<uint64_t> head_{0};
+    std::atomic<uint64_t> tail_{0};
+    std::atomic<uint32_t> wake_{0};
+    std::atomic<bool> stopping_{false};
+    std::atomic<bool> failed_{false};
+    std::atomic<uint64_t> written_{0};
+    std::atomic<uint64_t> dropped_{0};
+    uint64_t submitted_{0};
+    std::string error_; // set by the worker before failed_
+
+    std::thread worker_;
+};
+
+#endif //STARGBC_FRAMECAPTURE_H
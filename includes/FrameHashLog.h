@@ -0,0 +1,42 @@
+#ifndef STARGBC_FRAMEHASHLOG_H
+#define STARGBC_FRAMEHASHLOG_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// A 64-bit hash of the screen every `interval` frames, so hours of play can
+// be checked against a known-good build with kilobytes of golden data
+// instead of the frames themselves. Entry i is the screen after frame
+// (i + 1) * interval, counting from the last reset. The file is a small
+// header and the hashes, in host byte order.
+class FrameHashLog {
+public:
+    FrameHashLog(const uint32_t romCrc32, const uint32_t interval) : romCrc32_(romCrc32),
+                                                                     interval_(interval ? interval : 1) {
+    }
+
+    // Called after every frame with the frames run so far
+    void Record(const uint64_t frame, const uint64_t hash) {
+        if (frame % interval_ == 0) hashes_.push_back(hash);
+    }
+
+    [[nodiscard]] uint64_t FrameOf(const size_t entry) const { return (entry + 1) * interval_; }
+
+    [[nodiscard]] uint32_t RomCrc32() const { return romCrc32_; }
+
+    [[nodiscard]] uint32_t Interval() const { return interval_; }
+
+    [[nodiscard]] const std::vector<uint64_t> &Hashes() const { return hashes_; }
+
+    void Write(const std::string &path) const;
+
+    static FrameHashLog Read(const std::string &path);
+
+private:
+    uint32_t romCrc32_;
+    uint32_t interval_;
+    std::vector<uint64_t> hashes_;
+};
+
+#endif //STARGBC_FRAMEHASHLOG_H
@@ -4,6 +4,7 @@
 #include "Common.h"
 #include "HDMA.h"
 #include "Interrupts.h"
+#include "Trace.h"
 
 struct Pixel {
     uint8_t color{0x00};
@@ -35,6 +36,11 @@ struct Sprite {
     bool operator<(const Sprite &s) const {
         return x < s.x || spriteNum < s.spriteNum;
     }
+
+    template<typename Archive>
+    void Serialize(Archive &archive) {
+        archive(spriteNum, x, y, tileIndex, attributes, processed);
+    }
 };
 
 // State for the pixel fetcher
@@ -77,6 +83,11 @@ struct Stat {
                enableM1Interrupt << 4 | enableM0Interrupt << 3 |
                coincidenceFlag << 2 | static_cast<uint8_t>(mode);
     }
+
+    template<typename Archive>
+    void Serialize(Archive &archive) {
+        archive(enableLYInterrupt, enableM2Interrupt, enableM1Interrupt, enableM0Interrupt, coincidenceFlag, mode);
+    }
 };
 
 class GPU {
@@ -119,9 +130,9 @@ public:
     bool objectPriority{false};
     bool initialSCXSet{false};
 
-    std::vector<uint8_t> vram = std::vector<uint8_t>(VRAM_SIZE);
+    std::array<uint8_t, VRAM_SIZE> vram{};
     std::array<uint32_t, SCREEN_HEIGHT * SCREEN_WIDTH * 3> screenData{};
-    std::vector<uint8_t> oam = std::vector<uint8_t>(0xA0);
+    std::array<uint8_t, 0xA0> oam{};
     uint8_t lyc = 0; // 0xFF45
 
     std::pair<bool, uint8_t> priority_[160];
@@ -151,10 +162,26 @@ public:
     std::array<std::array<std::array<uint8_t, 3>, 4>, 8> obpd = {}; // 0xFF6B
 
     HDMA hdma{};
+    trace::Span hdmaSpan; // an HBlank block, or a whole general-purpose transfer
     Hardware hardware = Hardware::DMG;
 
+    std::array<uint64_t, 4> modeDots{}; // dots spent in each GPUMode, gathered once per frame
+
     void Update();
 
+    // Dots of Update() that would only advance scanlineCounter: the LCD is
+    // off, or it is in HBlank/VBlank short of the line end with every STAT
+    // source already latched and no delayed interrupt in flight
+    [[nodiscard]] uint32_t IdleDots() const;
+
+    void SkipIdleDots(uint32_t dots);
+
+    // Records hdmaSpan, named after the kind of transfer running
+    void EndHdmaSpan();
+
+    // Records the trace spans still open, so none runs past the frame
+    void EndTraceSpans();
+
     void TickOAMScan();
 
     void TickMode3();
@@ -181,9 +208,26 @@ public:
 
     [[nodiscard]] bool LCDDisabled() const;
 
+    template<typename Archive>
+    void Serialize(Archive &archive) {
+        archive(backgroundQueue, spriteFetchQueue, spriteArray, windowTriggeredThisFrame, spriteToFetch_,
+                backgroundTileAttributes_, fetcherState_, firstScanlineDataHigh, lastAddress_, spriteFetchActive_,
+                isFetchingWindow_, fetcherDelay_, fetcherTileX_, fetcherTileNum_, fetcherTileDataLow_,
+                fetcherTileDataHigh_, windowLineCounter_, spriteBuffer, initialScrollXDiscard_, pixelsDrawn,
+                objectPriority, initialSCXSet, vram, screenData, oam, lyc, priority_, lcdc, stat, currentLine,
+                windowX, windowY, backgroundPalette, obp0Palette, obp1Palette, scrollX, scrollY, scanlineCounter,
+                shortenScanline, vblank, statTriggered, hblank, bgpi, obpi, vramBank, bgpd, obpd, hdma, hardware);
+    }
+
 private:
     Interrupts &interrupts_;
 
+    // Trace spans cover whole PPU modes rather than single dots
+    trace::Span modeSpan_;
+    GPUMode tracedMode_{GPUMode::MODE_0};
+
+    void TraceMode();
+
     void Fetcher_StepSpriteFetch();
 
     void Fetcher_StepBackgroundFetch();
@@ -1,12 +1,31 @@
 #pragma once
 
+#include <array>
+#include <cstdio>
 #include <fstream>
 #include <memory>
+#include <span>
 #include <utility>
 
+#include "BlockJit.h"
 #include "Common.h"
+#include "CoroutineCore.h"
 #include "CPU.h"
+#include "FrameHashLog.h"
+#include "IdleLoop.h"
+#include "InputMovie.h"
 #include "Memory.h"
+#include "RomProfiler.h"
+
+enum class CpuCore {
+    StepTable, // per-M-cycle handler tables in Instructions
+    Coroutine, // one coroutine per instruction, see CoroutineCore
+};
+
+enum class ResetKind {
+    Hard, // power cycle: RAM cleared and the bootrom, if any, run again
+    Soft, // reset line: work RAM, VRAM and OAM keep their contents
+};
 
 struct GameboySettings {
     std::string romName;
@@ -16,21 +35,118 @@ struct GameboySettings {
     bool debugStart{false};
     bool realRTC{false};
     bool unthrottled{false};
+    bool readOnlySave{false};
+    CpuCore cpuCore{CpuCore::StepTable};
+    // Run whole instructions and let peripherals catch up at I/O accesses and
+    // instruction boundaries. Faster, but not cycle-accurate.
+    bool fastCore{false};
+    // With fastCore, run straight-line code as cached blocks of pre-decoded
+    // instructions (see BlockCache). Ignored by the coroutine core.
+    bool blockCache{false};
+    // With blockCache, compile hot ROM blocks to native code (see BlockJit).
+    // Hosts other than x86-64 keep interpreting them.
+    bool jit{false};
+    // Skip iterations of busy-wait loops that poll LY/STAT/IF and the like
+    // (see IdleLoopDetector). The result is exact; it is opt-in per ROM so
+    // the savings can be measured (GetIdleLoopStats).
+    bool idleLoops{false};
+    // With a bootrom, restore the machine at the end of the boot sequence
+    // from this directory instead of emulating it, caching it there on the
+    // first run (see BootStateCache). Empty disables the cache.
+    std::string bootStateCache;
+    // Audio output rate, MIN_AUDIO_SAMPLE_RATE to MAX_AUDIO_SAMPLE_RATE
+    uint32_t audioSampleRate{AUDIO_SAMPLE_RATE};
+};
+
+// What the emulated hardware did over one RunFrame(), and what it cost the
+// host. CPU-side counts are in M-cycles at the current speed, PPU ones in
+// dots. Skipped idle-loop iterations count no instructions.
+struct FrameStats {
+    uint64_t instructions{0};
+    uint64_t haltedMCycles{0};
+    uint64_t hdmaStallMCycles{0}; // CPU held by HDMA or GDMA
+    uint64_t oamDmaMCycles{0};
+    std::array<uint64_t, 4> ppuModeDots{}; // indexed by GPUMode
+    std::array<uint64_t, 5> interrupts{}; // dispatched: VBlank, STAT, timer, serial, joypad
+    uint64_t bankSwitches{0};
+    uint64_t samplesProduced{0};
+    uint64_t samplesDropped{0}; // the sample buffer was full
+    double hostSeconds{0.0};
+};
+
+// The state two instances running the same game agree on whatever CPU core
+// they use: registers, interrupt enables and every RAM. Regions point into
+// the instance and are valid until it runs again.
+struct StateView {
+    struct Region {
+        const char *name;
+        std::span<const uint8_t> bytes;
+    };
+
+    // A F B C D E H L, SP and PC high byte first, IME, IE, IF
+    static constexpr std::array<const char *, 15> CPU_FIELDS = {
+        "A", "F", "B", "C", "D", "E", "H", "L", "SP.hi", "SP.lo", "PC.hi", "PC.lo", "IME", "IE", "IF"
+    };
+
+    std::array<uint8_t, CPU_FIELDS.size()> cpu{};
+    // FF00-FF7F as the CPU would read them; timers, LY and STAT make timing
+    // drift visible before it reaches memory
+    std::array<uint8_t, 0x80> io{};
+    std::array<Region, 5> memory{};
+
+    // XXHash64 of everything above
+    [[nodiscard]] uint64_t Hash() const;
+};
+
+// Read-only inputs that any number of Gameboy instances running the same
+// game can point at instead of loading their own copies
+struct SharedResources {
+    std::shared_ptr<const RomImage> rom;
+    std::shared_ptr<const std::vector<uint8_t> > bootrom; // null when starting without a bootrom
+
+    static SharedResources Load(const GameboySettings &settings);
 };
 
 class Gameboy {
 public:
-    explicit Gameboy(const GameboySettings &settings) : romPath_(std::move(settings.romName)),
-                                                        biosPath_(std::move(settings.biosPath)),
-                                                        rtc_(settings.realRTC),
-                                                        cartridge_(romPath_, rtc_),
-                                                        joypad_(interrupts_), serial_(interrupts_), gpu_(interrupts_),
-                                                        bus_(joypad_, memory_, timer_, cartridge_, serial_, dma_, audio_, interrupts_, gpu_),
-                                                        cpu_(settings.mode, biosPath_, bus_, interrupts_, registers_),
-                                                        instructions_(registers_, interrupts_),
-                                                        throttleSpeed_(!settings.unthrottled),
-                                                        timer_(audio_, interrupts_),
-                                                        paused_(settings.debugStart) {
+    explicit Gameboy(const GameboySettings &settings) : Gameboy(settings, SharedResources::Load(settings)) {
+    }
+
+    // Without `loadSave` the save file is not read and save RAM starts
+    // blank, for a caller that restores it (and the clock) from a snapshot
+    Gameboy(const GameboySettings &settings, const SharedResources &resources,
+            const bool loadSave = true) : romPath_(settings.romName),
+                                          biosPath_(settings.biosPath),
+                                          mode_(settings.mode),
+                                          bootStateCache_(settings.bootStateCache),
+                                          realRTC_(settings.realRTC),
+                                          rtc_(settings.realRTC),
+                                          cartridge_(romPath_, resources.rom, rtc_, loadSave),
+                                          joypad_(interrupts_), serial_(interrupts_), gpu_(interrupts_),
+                                          bus_(joypad_, memory_, timer_, cartridge_, serial_, dma_, audio_, interrupts_, gpu_),
+                                          cpu_(settings.mode, resources.bootrom, bus_, interrupts_, registers_),
+                                          instructions_(registers_, interrupts_),
+                                          throttleSpeed_(!settings.unthrottled),
+                                          timer_(audio_, interrupts_),
+                                          paused_(settings.debugStart) {
+        cartridge_.SetSaveWritable(!settings.readOnlySave);
+        audio_.SetSampleRate(settings.audioSampleRate);
+        if (settings.cpuCore == CpuCore::Coroutine) {
+            coroutineCore_ = std::make_unique<CoroutineCore<CPU<Bus> > >(registers_, interrupts_);
+            cpu_.UseCoroutineCore(coroutineCore_.get());
+        }
+        if (settings.fastCore) {
+            fastCore_ = true;
+            bus_.SetSyncHook(&Gameboy::SyncPeripherals, this);
+            if (settings.blockCache && settings.cpuCore == CpuCore::StepTable) {
+                blockCache_ = std::make_unique<BlockCache<CPU<Bus> > >();
+                if (settings.jit && BlockJit<CPU<Bus> >::Supported()) jit_ = std::make_unique<BlockJit<CPU<Bus> > >(cpu_);
+            }
+        }
+        SetIdleLoopSkipping(settings.idleLoops);
+        if (resources.bootrom && !settings.bootStateCache.empty()) {
+            BootThroughCache(settings.bootStateCache, *resources.bootrom);
+        }
     }
 
     Gameboy(const Gameboy &other) = delete;
@@ -49,6 +165,78 @@ public:
 
     void UpdateEmulator();
 
+    // One frame of emulation with no pacing, for batch and headless use
+    void RunFrame();
+
+    // Back to power-on in place, reusing the instance and its ROM and
+    // caches. Save RAM and the cartridge clock are battery-backed and
+    // carry on either way. Ends any movie recording or playback.
+    void Reset(ResetKind kind);
+
+    // Writes the save file and swaps in another game, then resets hard.
+    // Throws before changing anything when the ROM cannot be loaded or its
+    // header names a mapper or RAM size that is not supported.
+    void LoadRom(const std::string &path);
+
+    // An independent copy of this instance as it stands, sharing the ROM and
+    // bootrom. It runs the same settings but never writes the save file.
+    // Call between frames; the coroutine core forks between instructions only.
+    [[nodiscard]] std::unique_ptr<Gameboy> Fork() const;
+
+    // Runs until the next instruction completes, taking the same path
+    // RunFrame would (without block cache or idle skipping) and
+    // charging the cycles to the next frame. False when none completes
+    // within a frame's worth of cycles: stopped, or halted with nothing to
+    // wake it.
+    bool StepInstruction();
+
+    // True between instructions, outside interrupt dispatch
+    [[nodiscard]] bool AtInstructionBoundary() const {
+        return cpu_.AtInstructionBoundary();
+    }
+
+    // Instructions completed since construction or the last reset
+    [[nodiscard]] uint64_t InstructionsRetired() const {
+        return instructionsRetired_ + cpu_.instructionCount;
+    }
+
+    [[nodiscard]] StateView GetStateView() const;
+
+    // Master cycles emulated since construction or the last reset, counting
+    // whole frames plus however far the CPU ran past the last one. What
+    // movie events are stamped with.
+    [[nodiscard]] uint64_t CycleCount() const;
+
+    // Records key changes from now on. From power-on the machine is reset
+    // hard first; otherwise the movie starts from a snapshot of it as it
+    // stands. The cartridge clock runs on emulated time until it stops.
+    void StartRecording(bool fromPowerOn);
+
+    // Stops recording and returns the movie; throws if not recording
+    [[nodiscard]] InputMovie StopRecording();
+
+    [[nodiscard]] bool IsRecording() const {
+        return recording_ != nullptr;
+    }
+
+    // Restores the movie's start and from then on takes keys from the movie
+    // alone, applying each event at the first frame boundary at or after
+    // its stamp. That is where the frontend made it while recording, so
+    // the same core replays exactly; another core may apply it a few cycles
+    // off. The save file is not written from then on. Throws if the movie
+    // is for another ROM.
+    void PlayMovie(InputMovie movie);
+
+    // From PlayMovie until the recorded length has run
+    [[nodiscard]] bool IsPlayingMovie() const;
+
+    // Presses exactly the keys in `pressed` (a mask of Keys) and releases the rest
+    void SetKeys(uint8_t pressed);
+
+    // Side-effect free read of the address space, for observing game state
+    // (see Bus::PeekByte)
+    [[nodiscard]] uint8_t PeekByte(uint16_t address) const;
+
     [[nodiscard]] bool ShouldRender() const;
 
     void Save() const;
@@ -59,12 +247,29 @@ public:
 
     [[nodiscard]] const uint32_t *GetScreenData() const;
 
+    // XXHash64 of the screen as GetScreenData() has it
+    [[nodiscard]] uint64_t ScreenHash() const;
+
+    // Logs ScreenHash() every `interval` frames from now on (see
+    // FrameHashLog); 0 stops logging and drops the log. A reset starts it
+    // over, since frames are counted from there.
+    void SetFrameHashing(const uint32_t interval) {
+        frameHashes_ = interval ? std::make_unique<FrameHashLog>(GetRomCrc32(), interval) : nullptr;
+    }
+
+    // Null unless hashing frames
+    [[nodiscard]] const FrameHashLog *GetFrameHashLog() const { return frameHashes_.get(); }
+
     void ToggleSpeed();
 
     void SetThrottle(bool throttle);
 
     void SaveScreen() const;
 
+    [[nodiscard]] uint32_t GetRomCrc32() const {
+        return cartridge_.GetRomCrc32();
+    }
+
     void SetPaused(const bool val) {
         paused_ = val;
     }
@@ -73,6 +278,50 @@ public:
         return paused_;
     }
 
+    // Stopped with the LCD off: frames change nothing until a key goes
+    // down, so a frontend can block on input instead of running them
+    [[nodiscard]] bool IsIdle() const {
+        return cpu_.stopped() && gpu_.LCDDisabled();
+    }
+
+    // Switching off drops the counts reported by GetIdleLoopStats
+    void SetIdleLoopSkipping(const bool enabled) {
+        if (!enabled) idleLoops_.reset();
+        else if (!idleLoops_) {
+            idleLoops_ = std::make_unique<IdleLoopDetector<CPU<Bus> > >(registers_, interrupts_, CGB_CYCLES_PER_SECOND);
+        }
+    }
+
+    // Cycles per instruction address from now on (see RomProfiler), every
+    // instruction or one in `sampleEvery`. Switching off drops the profile.
+    void SetProfiling(const bool enabled, const uint32_t sampleEvery = 1) {
+        if (!enabled) {
+            profiler_.reset();
+        } else if (!profiler_ || profiler_->SampleEvery() != sampleEvery) {
+            profiler_ = std::make_unique<RomProfiler>(cartridge_.Rom()->data.size(), sampleEvery);
+        }
+        cpu_.UseProfiler(profiler_.get());
+    }
+
+    // Null unless profiling
+    [[nodiscard]] const RomProfiler *GetProfiler() const { return profiler_.get(); }
+
+    // The `count` costliest instructions with their disassembly
+    void WriteProfileReport(std::FILE *out, size_t count) const;
+
+    // Counts for the last completed frame
+    [[nodiscard]] const FrameStats &GetFrameStats() const {
+        return frameStats_;
+    }
+
+    [[nodiscard]] IdleLoopStats GetIdleLoopStats() const {
+        return idleLoops_ ? idleLoops_->Stats() : IdleLoopStats{};
+    }
+
+    [[nodiscard]] uint32_t GetAudioSampleRate() const {
+        return audio_.GetSampleRate();
+    }
+
     [[nodiscard]] size_t GetAudioSamplesAvailable() const {
         return audio_.GetSamplesAvailable();
     }
@@ -94,6 +343,9 @@ private:
 
     std::string romPath_;
     std::string biosPath_;
+    Mode mode_;
+    std::string bootStateCache_;
+    bool realRTC_; // the setting; movies pin the clock to emulated time
 
     RealTimeClock rtc_; // init in constructor
     Cartridge cartridge_; // init in constructor
@@ -109,11 +361,82 @@ private:
     Bus bus_;
     CPU<Bus> cpu_;
     Instructions<CPU<Bus> > instructions_;
+    std::unique_ptr<CoroutineCore<CPU<Bus> > > coroutineCore_;
+    std::unique_ptr<BlockCache<CPU<Bus> > > blockCache_;
+    std::unique_ptr<BlockJit<CPU<Bus> > > jit_;
+    std::unique_ptr<IdleLoopDetector<CPU<Bus> > > idleLoops_;
+    std::unique_ptr<RomProfiler> profiler_;
+    std::unique_ptr<FrameHashLog> frameHashes_;
+    std::unique_ptr<InputMovie> recording_;
+    std::unique_ptr<InputMovie> playback_;
+    size_t playbackEvent_{0}; // next of playback_->events to apply
+    uint64_t movieStartCycle_{0};
 
     uint32_t masterCycles{0x00000000};
+    bool fastCore_{false};
+    int64_t fastFrameBudget_{0}; // master cycles the fast core still owes this frame
+    uint32_t peripheralDebt_{0}; // master cycles the CPU has run ahead of the peripherals
+    uint32_t frameProgress_{0}; // master cycles of the next frame already run (the boot ended mid-frame)
+    uint64_t framesRun_{0};
+    FrameStats frameStats_{};
+    uint64_t instructionsRetired_{0}; // before the current frame's count
     int speedMultiplier_{1};
     bool throttleSpeed_{true};
     bool paused_{false};
 
     void AdvanceFrame();
+
+    void RecordKey(Keys key, bool down);
+
+    // Applies the playback events that are due, ending playback after the last
+    void ApplyMovieInput();
+
+    // Stops recording and playback, giving the cartridge clock back its setting
+    void EndMovie();
+
+    // The whole machine with the cartridge and its clock, as Fork copies it
+    void WriteSnapshot(std::vector<uint8_t> &out) const;
+
+    void ReadSnapshot(std::span<const uint8_t> in);
+
+    void TickPeripherals(uint32_t speedDivider);
+
+    void RunFrameAccurate();
+
+    void RunFrameFast();
+
+    // One instruction, or one M-cycle of interrupt dispatch or HALT, on the
+    // fast core
+    void StepFast();
+
+    // Moves the components' event counts into frameStats_
+    void GatherFrameStats(double hostSeconds);
+
+    void CatchUpPeripherals();
+
+    static void SyncPeripherals(void *gameboy) {
+        static_cast<Gameboy *>(gameboy)->CatchUpPeripherals();
+    }
+
+    // Moves the master clock on as that many AdvanceFrame() calls would
+    void AdvanceMasterCycles(uint32_t cycles);
+
+    [[nodiscard]] uint32_t IdleCyclesAhead() const;
+
+    void FastForward(uint32_t cycles);
+
+    uint32_t SkipIdleHalt(uint32_t limit, uint32_t granularity);
+
+    uint32_t SkipIdleLoop(uint32_t limit);
+
+    void BootThroughCache(const std::string &directory, const std::vector<uint8_t> &bootrom);
+
+    // Everything but the cartridge and its clock, which hold the battery
+    // state and are left to the save file. Static so a const instance can
+    // be written: `self` is const Gameboy for a StateWriter.
+    template<typename Self, typename Archive>
+    static void SerializeMachine(Self &self, Archive &archive) {
+        archive(self.registers_, self.cpu_, self.instructions_, self.bus_);
+        archive(self.masterCycles, self.fastFrameBudget_, self.peripheralDebt_, self.frameProgress_, self.framesRun_);
+    }
 };
@@ -0,0 +1,80 @@
+#ifndef STARGBC_GAMEBOYFACTORY_H
+#define STARGBC_GAMEBOYFACTORY_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+
+#include "Gameboy.h"
+
+// N instances placed back to back in one allocation. Each instance starts on
+// its own cache line so neighbours never share one.
+class GameboyBatch {
+public:
+    static constexpr size_t ALIGNMENT = 64;
+    static constexpr size_t STRIDE = (sizeof(Gameboy) + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+
+    GameboyBatch() = default;
+
+    GameboyBatch(const GameboyBatch &) = delete;
+
+    GameboyBatch &operator=(const GameboyBatch &) = delete;
+
+    GameboyBatch(GameboyBatch &&other) noexcept;
+
+    GameboyBatch &operator=(GameboyBatch &&other) noexcept;
+
+    ~GameboyBatch();
+
+    [[nodiscard]] size_t size() const { return count_; }
+
+    Gameboy &operator[](const size_t index) {
+        return *std::launder(reinterpret_cast<Gameboy *>(storage_.get() + index * STRIDE));
+    }
+
+    const Gameboy &operator[](const size_t index) const {
+        return *std::launder(reinterpret_cast<const Gameboy *>(storage_.get() + index * STRIDE));
+    }
+
+private:
+    friend class GameboyFactory;
+
+    struct AlignedDelete {
+        void operator()(std::byte *p) const { ::operator delete[](p, std::align_val_t{ALIGNMENT}); }
+    };
+
+    GameboyBatch(size_t count, const GameboySettings &settings, const SharedResources &resources);
+
+    void Destroy();
+
+    std::unique_ptr<std::byte[], AlignedDelete> storage_;
+    size_t count_{0};
+};
+
+// Loads the ROM and bootrom once and hands out instances that share them
+// (along with the process-wide audio and palette tables). Every instance
+// still gets its own save RAM, RTC and machine state.
+class GameboyFactory {
+public:
+    explicit GameboyFactory(GameboySettings settings) : settings_(std::move(settings)),
+                                                        resources_(SharedResources::Load(settings_)) {
+    }
+
+    [[nodiscard]] std::unique_ptr<Gameboy> Create() const {
+        return std::make_unique<Gameboy>(settings_, resources_);
+    }
+
+    [[nodiscard]] GameboyBatch CreateBatch(const size_t count) const {
+        return GameboyBatch(count, settings_, resources_);
+    }
+
+    [[nodiscard]] const GameboySettings &Settings() const { return settings_; }
+
+    [[nodiscard]] const SharedResources &Resources() const { return resources_; }
+
+private:
+    GameboySettings settings_;
+    SharedResources resources_;
+};
+
+#endif //STARGBC_GAMEBOYFACTORY_H
@@ -0,0 +1,121 @@
+#ifndef STARGBC_GAMEBOYPOOL_H
+#define STARGBC_GAMEBOYPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "GameboyFactory.h"
+
+// Cache-line aligned storage so that the slices of an output array written
+// by different workers never share a line.
+template<typename T>
+struct CacheAlignedAllocator {
+    using value_type = T;
+
+    CacheAlignedAllocator() = default;
+
+    template<typename U>
+    explicit CacheAlignedAllocator(const CacheAlignedAllocator<U> &) noexcept {
+    }
+
+    T *allocate(const size_t n) {
+        return static_cast<T *>(::operator new[](n * sizeof(T), std::align_val_t{GameboyBatch::ALIGNMENT}));
+    }
+
+    void deallocate(T *p, size_t) noexcept {
+        ::operator delete[](p, std::align_val_t{GameboyBatch::ALIGNMENT});
+    }
+
+    bool operator==(const CacheAlignedAllocator &) const { return true; }
+};
+
+// Results of the last Step(), one array per field. Instance i's framebuffer
+// starts at i * FRAME_PIXELS and its observed bytes at i * observationStride.
+struct PoolOutputs {
+    static constexpr size_t FRAME_PIXELS = SCREEN_WIDTH * SCREEN_HEIGHT;
+
+    size_t instances{0};
+    size_t observationStride{0};
+    std::span<const uint32_t> framebuffers;
+    std::span<const float> rewards;
+    std::span<const uint8_t> observations;
+};
+
+// Steps many instances of one game by a frame per call across a thread pool.
+// Instances are split into fixed chunks; each worker starts on its own share
+// and then steals unclaimed chunks from the others, so an instance that runs
+// slow (e.g. a lag frame) does not hold up the whole batch.
+class GameboyPool {
+public:
+    using RewardFunction = std::function<float(const Gameboy &, size_t index)>;
+
+    // `threads` counts the calling thread; 0 means one per hardware thread
+    GameboyPool(const GameboyFactory &factory, size_t instances, size_t threads = 0);
+
+    GameboyPool(const GameboyPool &) = delete;
+
+    GameboyPool &operator=(const GameboyPool &) = delete;
+
+    ~GameboyPool();
+
+    // Bytes read from each instance after every frame
+    void SetObservedAddresses(std::vector<uint16_t> addresses);
+
+    // Called on the worker thread right after an instance's frame
+    void SetRewardFunction(RewardFunction reward) { reward_ = std::move(reward); }
+
+    // `inputs[i]` is the mask of Keys held by instance i for this frame.
+    // Returns once every instance has finished the frame.
+    PoolOutputs Step(std::span<const uint8_t> inputs);
+
+    [[nodiscard]] size_t size() const { return batch_.size(); }
+
+    [[nodiscard]] size_t ThreadCount() const { return workers_.size() + 1; }
+
+    Gameboy &operator[](const size_t index) { return batch_[index]; }
+
+private:
+    // 16 rewards fill one cache line
+    static constexpr size_t CHUNK = GameboyBatch::ALIGNMENT / sizeof(float);
+
+    struct alignas(GameboyBatch::ALIGNMENT) Partition {
+        std::atomic<size_t> next{0};
+        size_t begin{0};
+        size_t end{0};
+    };
+
+    void WorkerLoop(size_t id);
+
+    void RunPartitions(size_t id);
+
+    void StepInstance(size_t index);
+
+    GameboyBatch batch_;
+    std::vector<uint16_t> observed_;
+    RewardFunction reward_;
+
+    std::vector<uint32_t, CacheAlignedAllocator<uint32_t> > framebuffers_;
+    std::vector<float, CacheAlignedAllocator<float> > rewards_;
+    std::vector<uint8_t, CacheAlignedAllocator<uint8_t> > observations_;
+    size_t observationStride_{0};
+
+    std::unique_ptr<Partition[]> partitions_;
+    std::vector<std::thread> workers_;
+    std::span<const uint8_t> inputs_;
+
+    std::mutex mutex_;
+    std::condition_variable startCv_;
+    std::condition_variable doneCv_;
+    uint64_t generation_{0};
+    size_t pending_{0};
+    bool stopping_{false};
+    std::exception_ptr error_;
+};
+
+#endif //STARGBC_GAMEBOYPOOL_H
@@ -29,6 +29,12 @@ struct HDMA {
     void WriteHDMA(uint16_t, uint8_t, bool, bool);
     [[nodiscard]] uint8_t ReadHDMA(uint16_t, bool) const;
     [[nodiscard]] bool ShouldHaltCPU() const;
+
+    template<typename Archive>
+    void Serialize(Archive &archive) {
+        archive(hdmaSource, hdmaDestination, hdmaRemain, hdmaStartDelay, hdma5, bytesThisBlock, byte, step,
+                hdmaMode, hdmaActive, hblankBlockFinished, singleBlockTransfer, transferringBlock);
+    }
 };
 
 #endif //STARGBC_HDMA_H
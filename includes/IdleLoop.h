@@ -0,0 +1,97 @@
+#ifndef STARGBC_IDLELOOP_H
+#define STARGBC_IDLELOOP_H
+
+#include <algorithm>
+#include <cstdint>
+
+#include "Interrupts.h"
+#include "Registers.h"
+
+struct IdleLoopStats {
+    uint64_t skips{0}; // times a run of iterations was skipped
+    uint64_t skippedCycles{0}; // master cycles those runs would have taken
+};
+
+// Spots busy-wait loops (`ldh a,[rLY]; cp 144; jr nz`, IF polling with IME
+// off and the like) so whole iterations can be skipped. Detection is
+// dynamic rather than by decoding: the CPU is observed at loop points (a
+// jump about to run, or the entry of a cached block), and an iteration is
+// proven to repeat once two consecutive observations find the same CPU
+// state and bus access epoch (no writes, no reads of free-running
+// registers) with no peripheral event in between. Every iteration after
+// that reads the same values and ends in the same state, until the next
+// event that could change what the loop polls.
+template<typename CPUType>
+class IdleLoopDetector {
+public:
+    // `cycleWrap` is where the caller's master cycle counter wraps
+    IdleLoopDetector(const Registers &registers, const Interrupts &interrupts, const uint32_t cycleWrap)
+        : registers_(registers), interrupts_(interrupts), cycleWrap_(cycleWrap) {
+    }
+
+    // Jumps whose boundary the step-by-step cores observe
+    static constexpr bool IsLoopPoint(const uint16_t opcode) {
+        switch (opcode) {
+            case 0x18: case 0x20: case 0x28: case 0x30: case 0x38:
+            case 0xC2: case 0xC3: case 0xCA: case 0xD2: case 0xDA:
+                return true;
+            default: return false;
+        }
+    }
+
+    // Called at a loop point with the CPU between instructions and nothing
+    // to dispatch. `now` is the master cycle counter and `window()` the
+    // master cycles left before the next peripheral event. Returns the
+    // master cycles of whole iterations the caller may skip, at most
+    // `limit`, or 0 to run on.
+    template<typename Window>
+    uint32_t Observe(CPUType &cpu, const uint32_t now, const uint32_t limit, Window &&window) {
+        const State state{
+            registers_, cpu.pc(), cpu.sp(), interrupts_.interruptMasterEnable, cpu.bus_.AccessEpoch()
+        };
+        if (state != last_) {
+            last_ = state;
+            observedAt_ = now;
+            window_ = 0;
+            return 0;
+        }
+
+        const uint32_t iteration = (now + cycleWrap_ - observedAt_) % cycleWrap_;
+        const bool proven = iteration > 0 && iteration <= window_;
+        observedAt_ = now;
+        window_ = window();
+        if (!proven) return 0;
+
+        const uint32_t skipped = std::min(limit, window_) / iteration * iteration;
+        if (skipped == 0) return 0;
+        observedAt_ = (now + skipped) % cycleWrap_;
+        window_ -= skipped;
+        ++stats_.skips;
+        stats_.skippedCycles += skipped;
+        return skipped;
+    }
+
+    [[nodiscard]] const IdleLoopStats &Stats() const { return stats_; }
+
+private:
+    struct State {
+        Registers registers;
+        uint16_t pc{0};
+        uint16_t sp{0};
+        bool ime{false};
+        uint32_t epoch{0};
+
+        bool operator==(const State &) const = default;
+    };
+
+    const Registers &registers_;
+    const Interrupts &interrupts_;
+    uint32_t cycleWrap_;
+
+    State last_{};
+    uint32_t observedAt_{0};
+    uint32_t window_{0}; // event-free master cycles from observedAt_
+    IdleLoopStats stats_{};
+};
+
+#endif //STARGBC_IDLELOOP_H
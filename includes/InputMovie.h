@@ -0,0 +1,39 @@
+#ifndef STARGBC_INPUTMOVIE_H
+#define STARGBC_INPUTMOVIE_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// A recorded session: the state it started from and every KeyDown and
+// KeyUp in order, stamped with Gameboy::CycleCount() relative to the start.
+// The cartridge clock runs on emulated time while recording and playing,
+// so replaying on the same CPU core reproduces the session exactly.
+struct InputMovie {
+    enum class Start : uint8_t {
+        PowerOn, // a hard reset with `sram` and `rtc` as the battery contents
+        Snapshot, // `snapshot`, from a build with the same SNAPSHOT_VERSION
+    };
+
+    struct Event {
+        uint64_t cycle;
+        uint8_t key; // a Keys value
+        bool down;
+    };
+
+    uint32_t romCrc32{0};
+    Start start{Start::PowerOn};
+    std::vector<uint8_t> sram;
+    std::array<uint8_t, 5> rtc{}; // see RealTimeClock::GetRegisters
+    std::vector<uint8_t> snapshot;
+    std::vector<Event> events;
+    uint64_t length{0}; // master cycles recorded
+
+    // Fields in host byte order, with a CRC over everything after the header
+    void Write(const std::string &path) const;
+
+    static InputMovie Read(const std::string &path);
+};
+
+#endif //STARGBC_INPUTMOVIE_H
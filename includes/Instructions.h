@@ -1,6 +1,7 @@
 #pragma once
 
-#include <functional>
+#include <array>
+#include <utility>
 
 #include "Common.h"
 #include "GPU.h"
@@ -57,14 +58,24 @@ public:
     explicit Instructions(Registers &regs, Interrupts &interrupts) : regs_(regs), interrupts_(interrupts) {
     }
 
-    template<typename... Args>
-    bool prefixedInstr(const uint8_t opcode, Args &&... args) {
-        return prefixedTable[opcode](std::forward<Args>(args)...);
+    // Each opcode is decoded ahead of time into one step per M-cycle. Row
+    // index is the CPU's mCycleCounter (2..7 while an instruction runs), so
+    // dispatch is a single indirect call with no per-cycle branching.
+    using Step = bool (*)(Instructions &, CPUType &);
+    using StepRow = std::array<Step, 8>;
+
+    // Step row of an opcode, for callers that decode ahead of the CPU
+    static const StepRow &Steps(const bool prefixed, const uint8_t opcode) {
+        return prefixed ? prefixedSteps[opcode] : nonPrefixedSteps[opcode];
+    }
+
+    // Runs the step of `opcode` for the M-cycle the CPU is currently in
+    bool prefixedInstr(const uint8_t opcode, CPUType &cpu) {
+        return prefixedSteps[opcode][cpu.mCycleCounter()](*this, cpu);
     }
 
-    template<typename... Args>
-    bool nonPrefixedInstr(const uint8_t opcode, Args &&... args) {
-        return nonPrefixedTable[opcode](std::forward<Args>(args)...);
+    bool nonPrefixedInstr(const uint8_t opcode, CPUType &cpu) {
+        return nonPrefixedSteps[opcode][cpu.mCycleCounter()](*this, cpu);
     }
 
     void ResetState() {
@@ -72,6 +83,11 @@ public:
         jumpCondition = false;
     }
 
+    template<typename Archive>
+    void Serialize(Archive &archive) {
+        archive(signedByte, byte, word, word2, jumpCondition);
+    }
+
     std::string GetMnemonic(uint16_t instruction) const {
         const bool prefixed = instruction >> 8 == 0xCB;
         instruction &= 0xFF;
@@ -87,7 +103,29 @@ private:
     uint16_t word2{0};
     bool jumpCondition{false};
 
-    using WrappedFunction = std::function<bool(CPUType &cpu)>;
+    template<auto Fn>
+    static bool Thunk(Instructions &self, CPUType &cpu) {
+        return (self.*Fn)(cpu);
+    }
+
+    // Single-cycle handlers run the same step whatever the counter says
+    template<auto Fn>
+    static constexpr StepRow Single() {
+        StepRow row{};
+        row.fill(&Thunk<Fn>);
+        return row;
+    }
+
+    // `handler` maps a cycle number to the handler specialised for it
+    template<typename Handler, size_t... Cycle>
+    static constexpr StepRow Cycled(Handler, std::index_sequence<Cycle...>) {
+        return StepRow{&Thunk<Handler{}.template operator()<Cycle>()>...};
+    }
+
+    template<typename Handler>
+    static constexpr StepRow Cycled(Handler handler) {
+        return Cycled(handler, std::make_index_sequence<std::tuple_size_v<StepRow> >{});
+    }
 
     template<Register source>
     static constexpr auto GetRegisterPtr() {
@@ -139,23 +177,24 @@ private:
         return true;
     }
 
+    template<uint8_t cycle>
     bool RETI(CPUType &cpu) {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             word = cpu.bus_.ReadByte(cpu.sp(), ComponentSource::CPU);
             cpu.sp() += 1;
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             word |= static_cast<uint16_t>(cpu.bus_.ReadByte(cpu.sp(), ComponentSource::CPU)) << 8;
             cpu.sp() += 1;
             return false;
         }
-        if (cpu.mCycleCounter() == 4) {
+        if constexpr (cycle == 4) {
             cpu.pc() = word;
             interrupts_.interruptMasterEnable = true;
             return false;
         }
-        if (cpu.mCycleCounter() == 5) {
+        if constexpr (cycle == 5) {
             cpu.nextInstruction() = cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU);
             return true;
         }
@@ -191,70 +230,77 @@ private:
         return true;
     }
 
-    template<RSTTarget target>
+    // The unused opcodes hang the CPU until the console is reset
+    bool Illegal(CPUType &cpu) const {
+        cpu.mCycleCounter(1);
+        return false;
+    }
+
+    template<RSTTarget target, uint8_t cycle>
     bool RST(CPUType &cpu) {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             cpu.sp() -= 1;
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             cpu.bus_.WriteByte(cpu.sp(), (cpu.pc() & 0xFF00) >> 8, ComponentSource::CPU);
             cpu.sp() -= 1;
             return false;
         }
-        if (cpu.mCycleCounter() == 4) {
+        if constexpr (cycle == 4) {
             cpu.bus_.WriteByte(cpu.sp(), cpu.pc() & 0xFF, ComponentSource::CPU);
             constexpr auto location = GetRSTAddress<target>();
             cpu.pc() = location;
             return false;
         }
-        if (cpu.mCycleCounter() == 5) {
+        if constexpr (cycle == 5) {
             cpu.nextInstruction() = cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU);
             return true;
         }
         return false;
     }
 
+    template<uint8_t cycle>
     bool CALLUnconditional(CPUType &cpu) {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             word = cpu.bus_.ReadByte(cpu.pc(), ComponentSource::CPU);
             cpu.pc() += 1;
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             word |= static_cast<uint16_t>(cpu.bus_.ReadByte(cpu.pc(), ComponentSource::CPU)) << 8;
             cpu.pc() += 1;
             return false;
         }
-        if (cpu.mCycleCounter() == 4) {
+        if constexpr (cycle == 4) {
             cpu.sp() -= 1;
             return false;
         }
-        if (cpu.mCycleCounter() == 5) {
+        if constexpr (cycle == 5) {
             cpu.bus_.WriteByte(cpu.sp(), (cpu.pc() & 0xFF00) >> 8, ComponentSource::CPU);
             cpu.sp() -= 1;
             return false;
         }
-        if (cpu.mCycleCounter() == 6) {
+        if constexpr (cycle == 6) {
             cpu.bus_.WriteByte(cpu.sp(), cpu.pc() & 0xFF, ComponentSource::CPU);
             cpu.pc() = word;
             return false;
         }
-        if (cpu.mCycleCounter() == 7) {
+        if constexpr (cycle == 7) {
             cpu.nextInstruction() = cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU);
             return true;
         }
         return false;
     }
 
-    template<JumpTest test>
+    template<JumpTest test, uint8_t cycle>
     bool CALL(CPUType &cpu) {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             word = cpu.bus_.ReadByte(cpu.pc(), ComponentSource::CPU);
             cpu.pc() += 1;
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             if constexpr (test == JumpTest::NotZero) jumpCondition = !regs_.FlagZero();
             else if constexpr (test == JumpTest::Zero) jumpCondition = regs_.FlagZero();
             else if constexpr (test == JumpTest::Carry) jumpCondition = regs_.FlagCarry();
@@ -263,7 +309,7 @@ private:
             cpu.pc() += 1;
             return false;
         }
-        if (cpu.mCycleCounter() == 4) {
+        if constexpr (cycle == 4) {
             if (jumpCondition) {
                 cpu.sp() -= 1;
                 return false;
@@ -272,17 +318,17 @@ private:
             cpu.nextInstruction() = cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU);
             return true;
         }
-        if (cpu.mCycleCounter() == 5) {
+        if constexpr (cycle == 5) {
             cpu.bus_.WriteByte(cpu.sp(), (cpu.pc() & 0xFF00) >> 8, ComponentSource::CPU);
             cpu.sp() -= 1;
             return false;
         }
-        if (cpu.mCycleCounter() == 6) {
+        if constexpr (cycle == 6) {
             cpu.bus_.WriteByte(cpu.sp(), cpu.pc() & 0xFF, ComponentSource::CPU);
             cpu.pc() = word;
             return false;
         }
-        if (cpu.mCycleCounter() == 7) {
+        if constexpr (cycle == 7) {
             cpu.nextInstruction() = cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU);
             return true;
         }
@@ -358,38 +404,39 @@ private:
         return true;
     }
 
+    template<uint8_t cycle>
     bool RETUnconditional(CPUType &cpu) {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             word = cpu.bus_.ReadByte(cpu.sp(), ComponentSource::CPU);
             cpu.sp() += 1;
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             word |= static_cast<uint16_t>(cpu.bus_.ReadByte(cpu.sp(), ComponentSource::CPU)) << 8;
             cpu.sp() += 1;
             return false;
         }
-        if (cpu.mCycleCounter() == 4) {
+        if constexpr (cycle == 4) {
             cpu.pc() = word;
             return false;
         }
-        if (cpu.mCycleCounter() == 5) {
+        if constexpr (cycle == 5) {
             cpu.nextInstruction() = cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU);
             return true;
         }
         return false;
     }
 
-    template<JumpTest test>
+    template<JumpTest test, uint8_t cycle>
     bool RETConditional(CPUType &cpu) {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             if constexpr (test == JumpTest::NotZero) jumpCondition = !regs_.FlagZero();
             else if constexpr (test == JumpTest::Zero) jumpCondition = regs_.FlagZero();
             else if constexpr (test == JumpTest::Carry) jumpCondition = regs_.FlagCarry();
             else if constexpr (test == JumpTest::NotCarry) jumpCondition = !regs_.FlagCarry();
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             if (jumpCondition) {
                 word = cpu.bus_.ReadByte(cpu.sp(), ComponentSource::CPU);
                 cpu.sp() += 1;
@@ -399,29 +446,30 @@ private:
             cpu.nextInstruction() = cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU);
             return true;
         }
-        if (cpu.mCycleCounter() == 4) {
+        if constexpr (cycle == 4) {
             word |= static_cast<uint16_t>(cpu.bus_.ReadByte(cpu.sp(), ComponentSource::CPU)) << 8;
             cpu.sp() += 1;
             return false;
         }
-        if (cpu.mCycleCounter() == 5) {
+        if constexpr (cycle == 5) {
             cpu.pc() = word;
             return false;
         }
-        if (cpu.mCycleCounter() == 6) {
+        if constexpr (cycle == 6) {
             cpu.nextInstruction() = cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU);
             return true;
         }
         return false;
     }
 
+    template<uint8_t cycle>
     bool JRUnconditional(CPUType &cpu) {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             signedByte = std::bit_cast<int8_t>(cpu.bus_.ReadByte(cpu.pc(), ComponentSource::CPU));
             cpu.pc() += 1;
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             const uint16_t next = cpu.pc();
             if (signedByte >= 0) {
                 cpu.pc() = next + static_cast<uint16_t>(signedByte);
@@ -430,16 +478,16 @@ private:
             }
             return false;
         }
-        if (cpu.mCycleCounter() == 4) {
+        if constexpr (cycle == 4) {
             cpu.nextInstruction() = cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU);
             return true;
         }
         return false;
     }
 
-    template<JumpTest test>
+    template<JumpTest test, uint8_t cycle>
     bool JR(CPUType &cpu) {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             signedByte = std::bit_cast<int8_t>(cpu.bus_.ReadByte(cpu.pc(), ComponentSource::CPU));
             cpu.pc() += 1;
             if constexpr (test == JumpTest::NotZero) jumpCondition = !regs_.FlagZero();
@@ -448,7 +496,7 @@ private:
             else if constexpr (test == JumpTest::NotCarry) jumpCondition = !regs_.FlagCarry();
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             const uint16_t next = cpu.pc();
             if (jumpCondition) {
                 if (signedByte >= 0) {
@@ -461,43 +509,44 @@ private:
             cpu.nextInstruction() = cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU);
             return true;
         }
-        if (cpu.mCycleCounter() == 4) {
+        if constexpr (cycle == 4) {
             cpu.nextInstruction() = cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU);
             return true;
         }
         return false;
     }
 
+    template<uint8_t cycle>
     bool JPUnconditional(CPUType &cpu) {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             word = cpu.bus_.ReadByte(cpu.pc(), ComponentSource::CPU);
             cpu.pc() += 1;
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             word |= static_cast<uint16_t>(cpu.bus_.ReadByte(cpu.pc(), ComponentSource::CPU)) << 8;
             cpu.pc() += 1;
             return false;
         }
-        if (cpu.mCycleCounter() == 4) {
+        if constexpr (cycle == 4) {
             cpu.pc() = word;
             return false;
         }
-        if (cpu.mCycleCounter() == 5) {
+        if constexpr (cycle == 5) {
             cpu.nextInstruction() = cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU);
             return true;
         }
         return false;
     }
 
-    template<JumpTest test>
+    template<JumpTest test, uint8_t cycle>
     bool JP(CPUType &cpu) {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             word = cpu.bus_.ReadByte(cpu.pc(), ComponentSource::CPU);
             cpu.pc() += 1;
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             word |= static_cast<uint16_t>(cpu.bus_.ReadByte(cpu.pc(), ComponentSource::CPU)) << 8;
             cpu.pc() += 1;
             if constexpr (test == JumpTest::NotZero) jumpCondition = !regs_.FlagZero();
@@ -506,7 +555,7 @@ private:
             else if constexpr (test == JumpTest::NotCarry) jumpCondition = !regs_.FlagCarry();
             return false;
         }
-        if (cpu.mCycleCounter() == 4) {
+        if constexpr (cycle == 4) {
             if (jumpCondition) {
                 cpu.pc() = word;
                 return false;
@@ -514,7 +563,7 @@ private:
             cpu.nextInstruction() = cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU);
             return true;
         }
-        if (cpu.mCycleCounter() == 5) {
+        if constexpr (cycle == 5) {
             cpu.nextInstruction() = cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU);
             return true;
         }
@@ -572,12 +621,13 @@ private:
         return true;
     }
 
+    template<uint8_t cycle>
     bool DECIndirect(CPUType &cpu) {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             byte = cpu.bus_.ReadByte(regs_.GetHL(), ComponentSource::CPU);
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             regs_.SetHalf((byte & 0xF) == 0x00);
             const uint8_t newValue = byte - 1;
             regs_.SetZero(newValue == 0);
@@ -585,16 +635,16 @@ private:
             cpu.bus_.WriteByte(regs_.GetHL(), newValue, ComponentSource::CPU);
             return false;
         }
-        if (cpu.mCycleCounter() == 4) {
+        if constexpr (cycle == 4) {
             cpu.nextInstruction() = cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU);
             return true;
         }
         return false;
     }
 
-    template<Arithmetic16Target target>
+    template<Arithmetic16Target target, uint8_t cycle>
     bool DEC16(CPUType &cpu) {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             if constexpr (target == Arithmetic16Target::BC) {
                 word = regs_.GetBC();
                 cpu.bus_.HandleOAMCorruption(word, CorruptionType::Write);
@@ -613,7 +663,7 @@ private:
             }
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             cpu.nextInstruction() = cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU);
             return true;
         }
@@ -633,12 +683,13 @@ private:
         return true;
     }
 
+    template<uint8_t cycle>
     bool INCIndirect(CPUType &cpu) {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             byte = cpu.bus_.ReadByte(regs_.GetHL(), ComponentSource::CPU);
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             regs_.SetHalf((byte & 0xF) == 0xF);
             const uint8_t newValue = byte + 1;
             regs_.SetZero(newValue == 0);
@@ -646,16 +697,16 @@ private:
             cpu.bus_.WriteByte(regs_.GetHL(), newValue, ComponentSource::CPU);
             return false;
         }
-        if (cpu.mCycleCounter() == 4) {
+        if constexpr (cycle == 4) {
             cpu.nextInstruction() = cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU);
             return true;
         }
         return false;
     }
 
-    template<Arithmetic16Target target>
+    template<Arithmetic16Target target, uint8_t cycle>
     bool INC16(CPUType &cpu) {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             if constexpr (target == Arithmetic16Target::BC) {
                 word = regs_.GetBC();
                 cpu.bus_.HandleOAMCorruption(word, CorruptionType::Write);
@@ -674,7 +725,7 @@ private:
             }
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             cpu.nextInstruction() = cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU);
             return true;
         }
@@ -691,14 +742,14 @@ private:
         return true;
     }
 
-    template<Register source>
+    template<Register source, uint8_t cycle>
     bool LDRegisterImmediate(CPUType &cpu) {
         constexpr auto targetReg = GetRegisterPtr<source>();
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             byte = cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU);
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             regs_.*targetReg = byte;
             cpu.nextInstruction() = cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU);
             return true;
@@ -706,14 +757,14 @@ private:
         return false;
     }
 
-    template<Register source>
+    template<Register source, uint8_t cycle>
     bool LDRegisterIndirect(CPUType &cpu) {
         constexpr auto targetReg = GetRegisterPtr<source>();
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             byte = cpu.bus_.ReadByte(regs_.GetHL(), ComponentSource::CPU);
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             regs_.*targetReg = byte;
             cpu.nextInstruction() = cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU);
             return true;
@@ -721,43 +772,45 @@ private:
         return false;
     }
 
-    template<Register source>
+    template<Register source, uint8_t cycle>
     bool LDAddrRegister(CPUType &cpu) {
         constexpr auto sourceReg = GetRegisterPtr<source>();
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             const uint8_t sourceValue = regs_.*sourceReg;
             cpu.bus_.WriteByte(regs_.GetHL(), sourceValue, ComponentSource::CPU);
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             cpu.nextInstruction() = cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU);
             return true;
         }
         return false;
     }
 
+    template<uint8_t cycle>
     bool LDAddrImmediate(CPUType &cpu) {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             byte = cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU);
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             cpu.bus_.WriteByte(regs_.GetHL(), byte, ComponentSource::CPU);
             return false;
         }
-        if (cpu.mCycleCounter() == 4) {
+        if constexpr (cycle == 4) {
             cpu.nextInstruction() = cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU);
             return true;
         }
         return false;
     }
 
+    template<uint8_t cycle>
     bool LDAccumulatorBC(CPUType &cpu) {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             byte = cpu.bus_.ReadByte(regs_.GetBC(), ComponentSource::CPU);
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             regs_.a = byte;
             cpu.nextInstruction() = cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU);
             return true;
@@ -765,12 +818,13 @@ private:
         return false;
     }
 
+    template<uint8_t cycle>
     bool LDAccumulatorDE(CPUType &cpu) {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             byte = cpu.bus_.ReadByte(regs_.GetDE(), ComponentSource::CPU);
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             regs_.a = byte;
             cpu.nextInstruction() = cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU);
             return true;
@@ -778,68 +832,72 @@ private:
         return false;
     }
 
+    template<uint8_t cycle>
     bool LDFromAccBC(CPUType &cpu) const {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             cpu.bus_.WriteByte(regs_.GetBC(), regs_.a, ComponentSource::CPU);
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             cpu.nextInstruction() = cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU);
             return true;
         }
         return false;
     }
 
+    template<uint8_t cycle>
     bool LDFromAccDE(CPUType &cpu) const {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             cpu.bus_.WriteByte(regs_.GetDE(), regs_.a, ComponentSource::CPU);
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             cpu.nextInstruction() = cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU);
             return true;
         }
         return false;
     }
 
+    template<uint8_t cycle>
     bool LDAccumulatorDirect(CPUType &cpu) {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             word = cpu.bus_.ReadByte(cpu.pc(), ComponentSource::CPU);
             cpu.pc() += 1;
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             word |= static_cast<uint16_t>(cpu.bus_.ReadByte(cpu.pc(), ComponentSource::CPU)) << 8;
             cpu.pc() += 1;
             return false;
         }
-        if (cpu.mCycleCounter() == 4) {
+        if constexpr (cycle == 4) {
             regs_.a = cpu.bus_.ReadByte(word, ComponentSource::CPU);
             return false;
         }
-        if (cpu.mCycleCounter() == 5) {
+        if constexpr (cycle == 5) {
             cpu.nextInstruction() = cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU);
             return true;
         }
         return false;
     }
 
+    template<uint8_t cycle>
     bool LDFromAccumulatorDirect(CPUType &cpu) {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             word = cpu.bus_.ReadByte(cpu.pc(), ComponentSource::CPU);
             cpu.pc() += 1;
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             word |= static_cast<uint16_t>(cpu.bus_.ReadByte(cpu.pc(), ComponentSource::CPU)) << 8;
             cpu.pc() += 1;
             return false;
         }
-        if (cpu.mCycleCounter() == 4) {
+        if constexpr (cycle == 4) {
             cpu.bus_.WriteByte(word, regs_.a, ComponentSource::CPU);
             return false;
         }
-        if (cpu.mCycleCounter() == 5) {
+        if constexpr (cycle == 5) {
             cpu.nextInstruction() = cpu.bus_.ReadByte(cpu.pc(), ComponentSource::CPU);
             cpu.pc() += 1;
             return true;
@@ -847,14 +905,15 @@ private:
         return false;
     }
 
+    template<uint8_t cycle>
     bool LDAccumulatorIndirectDec(CPUType &cpu) {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             byte = cpu.bus_.ReadByte(regs_.GetHL(), ComponentSource::CPU);
             cpu.bus_.HandleOAMCorruption(regs_.GetHL(), CorruptionType::ReadWrite);
             regs_.SetHL(regs_.GetHL() - 1);
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             regs_.a = byte;
             cpu.nextInstruction() = cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU);
             return true;
@@ -862,8 +921,9 @@ private:
         return false;
     }
 
+    template<uint8_t cycle>
     bool LDFromAccumulatorIndirectDec(CPUType &cpu) {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             word = regs_.GetHL();
             cpu.bus_.HandleOAMCorruption(word, CorruptionType::Write);
             cpu.bus_.WriteByte(word, regs_.a, ComponentSource::CPU);
@@ -871,21 +931,22 @@ private:
             regs_.SetHL(word - 1);
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             cpu.nextInstruction() = cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU);
             return true;
         }
         return false;
     }
 
+    template<uint8_t cycle>
     bool LDAccumulatorIndirectInc(CPUType &cpu) {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             byte = cpu.bus_.ReadByte(regs_.GetHL(), ComponentSource::CPU);
             cpu.bus_.HandleOAMCorruption(regs_.GetHL(), CorruptionType::ReadWrite);
             regs_.SetHL(regs_.GetHL() + 1);
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             regs_.a = byte;
             cpu.nextInstruction() = cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU);
             return true;
@@ -893,8 +954,9 @@ private:
         return false;
     }
 
+    template<uint8_t cycle>
     bool LDFromAccumulatorIndirectInc(CPUType &cpu) {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             word = regs_.GetHL();
             cpu.bus_.HandleOAMCorruption(word, CorruptionType::Write);
             cpu.bus_.WriteByte(word, regs_.a, ComponentSource::CPU);
@@ -902,54 +964,57 @@ private:
             regs_.SetHL(word + 1);
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             cpu.nextInstruction() = cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU);
             return true;
         }
         return false;
     }
 
+    template<uint8_t cycle>
     bool LoadFromAccumulatorIndirectC(CPUType &cpu) const {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             const uint16_t c = 0xFF00 | static_cast<uint16_t>(regs_.c);
             cpu.bus_.WriteByte(c, regs_.a, ComponentSource::CPU);
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             cpu.nextInstruction() = cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU);
             return true;
         }
         return false;
     }
 
+    template<uint8_t cycle>
     bool LoadFromAccumulatorDirectA(CPUType &cpu) {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             word = static_cast<uint16_t>(cpu.bus_.ReadByte(cpu.pc(), ComponentSource::CPU));
             cpu.pc() += 1;
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             cpu.bus_.WriteByte(static_cast<uint16_t>(0xFF00) | word, regs_.a, ComponentSource::CPU);
             return false;
         }
-        if (cpu.mCycleCounter() == 4) {
+        if constexpr (cycle == 4) {
             cpu.nextInstruction() = cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU);
             return true;
         }
         return false;
     }
 
+    template<uint8_t cycle>
     bool LoadAccumulatorA(CPUType &cpu) {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             byte = cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU);
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             word = 0xFF00 | static_cast<uint16_t>(byte);
             byte = cpu.bus_.ReadByte(word, ComponentSource::CPU);
             return false;
         }
-        if (cpu.mCycleCounter() == 4) {
+        if constexpr (cycle == 4) {
             cpu.nextInstruction() = cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU);
             regs_.a = byte;
             return true;
@@ -957,12 +1022,13 @@ private:
         return false;
     }
 
+    template<uint8_t cycle>
     bool LoadAccumulatorIndirectC(CPUType &cpu) {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             byte = cpu.bus_.ReadByte(0xFF00 | static_cast<uint16_t>(regs_.c), ComponentSource::CPU);
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             regs_.a = byte;
             cpu.nextInstruction() = cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU);
             return true;
@@ -970,17 +1036,17 @@ private:
         return false;
     }
 
-    template<LoadWordTarget target>
+    template<LoadWordTarget target, uint8_t cycle>
     bool LD16Register(CPUType &cpu) {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             word = cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU);
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             word |= static_cast<uint16_t>(cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU)) << 8;
             return false;
         }
-        if (cpu.mCycleCounter() == 4) {
+        if constexpr (cycle == 4) {
             if constexpr (target == LoadWordTarget::HL) regs_.SetHL(word);
             else if constexpr (target == LoadWordTarget::SP) cpu.sp() = word;
             else if constexpr (target == LoadWordTarget::BC) regs_.SetBC(word);
@@ -991,45 +1057,47 @@ private:
         return false;
     }
 
+    template<uint8_t cycle>
     bool LD16FromStack(CPUType &cpu) {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             word = cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU);
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             word |= static_cast<uint16_t>(cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU)) << 8;
             return false;
         }
-        if (cpu.mCycleCounter() == 4) {
+        if constexpr (cycle == 4) {
             cpu.bus_.WriteByte(word, cpu.sp() & 0xFF, ComponentSource::CPU);
             word += 1;
             return false;
         }
-        if (cpu.mCycleCounter() == 5) {
+        if constexpr (cycle == 5) {
             cpu.bus_.WriteByte(word, cpu.sp() >> 8, ComponentSource::CPU);
             return false;
         }
-        if (cpu.mCycleCounter() == 6) {
+        if constexpr (cycle == 6) {
             cpu.nextInstruction() = cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU);
             return true;
         }
         return false;
     }
 
+    template<uint8_t cycle>
     bool LD16StackAdjusted(CPUType &cpu) {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             word = static_cast<uint16_t>(static_cast<int16_t>(static_cast<int8_t>(
                 cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU))));
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             regs_.SetCarry((cpu.sp() & 0xFF) + (word & 0xFF) > 0xFF);
             regs_.SetHalf((cpu.sp() & 0xF) + (word & 0xF) > 0xF);
             regs_.SetSubtract(false);
             regs_.SetZero(false);
             return false;
         }
-        if (cpu.mCycleCounter() == 4) {
+        if constexpr (cycle == 4) {
             regs_.SetHL(cpu.sp() + word);
             cpu.nextInstruction() = cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU);
             return true;
@@ -1037,26 +1105,27 @@ private:
         return false;
     }
 
+    template<uint8_t cycle>
     bool LD16Stack(CPUType &cpu) const {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             cpu.sp() = regs_.GetHL();
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             cpu.nextInstruction() = cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU);
             return true;
         }
         return false;
     }
 
-    template<StackTarget target>
+    template<StackTarget target, uint8_t cycle>
     bool PUSH(CPUType &cpu) {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             cpu.bus_.HandleOAMCorruption(cpu.sp(), CorruptionType::Write);
             cpu.sp() -= 1;
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             cpu.bus_.HandleOAMCorruption(cpu.sp(), CorruptionType::Write);
             if constexpr (target == StackTarget::BC) word = regs_.GetBC();
             if constexpr (target == StackTarget::DE) word = regs_.GetDE();
@@ -1066,33 +1135,33 @@ private:
             cpu.sp() -= 1;
             return false;
         }
-        if (cpu.mCycleCounter() == 4) {
+        if constexpr (cycle == 4) {
             cpu.bus_.HandleOAMCorruption(cpu.sp(), CorruptionType::Write);
             cpu.bus_.WriteByte(cpu.sp(), word & 0xFF, ComponentSource::CPU);
             return false;
         }
-        if (cpu.mCycleCounter() == 5) {
+        if constexpr (cycle == 5) {
             cpu.nextInstruction() = cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU);
             return true;
         }
         return false;
     }
 
-    template<StackTarget target>
+    template<StackTarget target, uint8_t cycle>
     bool POP(CPUType &cpu) {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             cpu.bus_.HandleOAMCorruption(cpu.sp(), CorruptionType::ReadWrite);
             word = cpu.bus_.ReadByte(cpu.sp(), ComponentSource::CPU);
             cpu.sp() += 1;
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             cpu.bus_.HandleOAMCorruption(cpu.sp(), CorruptionType::Read);
             word |= static_cast<uint16_t>(cpu.bus_.ReadByte(cpu.sp(), ComponentSource::CPU)) << 8;
             cpu.sp() += 1;
             return false;
         }
-        if (cpu.mCycleCounter() == 4) {
+        if constexpr (cycle == 4) {
             if constexpr (target == StackTarget::BC) regs_.SetBC(word);
             if constexpr (target == StackTarget::DE) regs_.SetDE(word);
             if constexpr (target == StackTarget::HL) regs_.SetHL(word);
@@ -1116,12 +1185,13 @@ private:
         return true;
     }
 
+    template<uint8_t cycle>
     bool CPIndirect(CPUType &cpu) {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             byte = cpu.bus_.ReadByte(regs_.GetHL(), ComponentSource::CPU);
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             const uint8_t new_value = regs_.a - byte;
             regs_.SetCarry(regs_.a < byte);
             regs_.SetHalf((regs_.a & 0xF) < (byte & 0xF));
@@ -1133,12 +1203,13 @@ private:
         return false;
     }
 
+    template<uint8_t cycle>
     bool CPImmediate(CPUType &cpu) {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             byte = cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU);
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             const uint8_t new_value = regs_.a - byte;
             regs_.SetCarry(regs_.a < byte);
             regs_.SetHalf((regs_.a & 0xF) < (byte & 0xF));
@@ -1163,12 +1234,13 @@ private:
         return true;
     }
 
+    template<uint8_t cycle>
     bool ORIndirect(CPUType &cpu) {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             byte = cpu.bus_.ReadByte(regs_.GetHL(), ComponentSource::CPU);
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             regs_.a |= byte;
             regs_.SetZero(regs_.a == 0);
             regs_.SetSubtract(false);
@@ -1180,12 +1252,13 @@ private:
         return false;
     }
 
+    template<uint8_t cycle>
     bool ORImmediate(CPUType &cpu) {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             byte = cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU);
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             regs_.a |= byte;
             regs_.SetZero(regs_.a == 0);
             regs_.SetSubtract(false);
@@ -1210,12 +1283,13 @@ private:
         return true;
     }
 
+    template<uint8_t cycle>
     bool XORIndirect(CPUType &cpu) {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             byte = cpu.bus_.ReadByte(regs_.GetHL(), ComponentSource::CPU);
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             regs_.a ^= byte;
             regs_.SetZero(regs_.a == 0);
             regs_.SetSubtract(false);
@@ -1227,12 +1301,13 @@ private:
         return false;
     }
 
+    template<uint8_t cycle>
     bool XORImmediate(CPUType &cpu) {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             byte = cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU);
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             regs_.a ^= byte;
             regs_.SetZero(regs_.a == 0);
             regs_.SetSubtract(false);
@@ -1257,12 +1332,13 @@ private:
         return true;
     }
 
+    template<uint8_t cycle>
     bool ANDIndirect(CPUType &cpu) {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             byte = cpu.bus_.ReadByte(regs_.GetHL(), ComponentSource::CPU);
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             regs_.a &= byte;
             regs_.SetZero(regs_.a == 0);
             regs_.SetSubtract(false);
@@ -1274,12 +1350,13 @@ private:
         return false;
     }
 
+    template<uint8_t cycle>
     bool ANDImmediate(CPUType &cpu) {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             byte = cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU);
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             regs_.a &= byte;
             regs_.SetZero(regs_.a == 0);
             regs_.SetSubtract(false);
@@ -1305,12 +1382,13 @@ private:
         return true;
     }
 
+    template<uint8_t cycle>
     bool SUBIndirect(CPUType &cpu) {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             byte = cpu.bus_.ReadByte(regs_.GetHL(), ComponentSource::CPU);
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             const uint8_t new_value = regs_.a - byte;
             regs_.SetCarry(regs_.a < byte);
             regs_.SetHalf((regs_.a & 0xF) < (byte & 0xF));
@@ -1323,12 +1401,13 @@ private:
         return false;
     }
 
+    template<uint8_t cycle>
     bool SUBImmediate(CPUType &cpu) {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             byte = cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU);
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             const uint8_t new_value = regs_.a - byte;
             regs_.SetCarry(regs_.a < byte);
             regs_.SetHalf((regs_.a & 0xF) < (byte & 0xF));
@@ -1356,18 +1435,19 @@ private:
         return true;
     }
 
+    template<uint8_t cycle>
     bool RRCAddr(CPUType &cpu) {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             byte = cpu.bus_.ReadByte(regs_.GetHL(), ComponentSource::CPU);
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             regs_.SetCarry(byte & 0x01);
             byte = regs_.FlagCarry() ? 0x80 | byte >> 1 : byte >> 1;
             cpu.bus_.WriteByte(regs_.GetHL(), byte, ComponentSource::CPU);
             return false;
         }
-        if (cpu.mCycleCounter() == 4) {
+        if constexpr (cycle == 4) {
             regs_.SetZero(byte == 0);
             regs_.SetSubtract(false);
             regs_.SetHalf(false);
@@ -1392,18 +1472,19 @@ private:
         return true;
     }
 
+    template<uint8_t cycle>
     bool RRAddr(CPUType &cpu) {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             byte = cpu.bus_.ReadByte(regs_.GetHL(), ComponentSource::CPU);
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             word = (byte & 0x01) == 0x01; // hack for storing carry
             byte = regs_.FlagCarry() ? 0x80 | (byte >> 1) : byte >> 1;
             cpu.bus_.WriteByte(regs_.GetHL(), byte, ComponentSource::CPU);
             return false;
         }
-        if (cpu.mCycleCounter() == 4) {
+        if constexpr (cycle == 4) {
             regs_.SetCarry(word);
             regs_.SetZero(byte == 0);
             regs_.SetSubtract(false);
@@ -1428,18 +1509,19 @@ private:
         return true;
     }
 
+    template<uint8_t cycle>
     bool SLAAddr(CPUType &cpu) {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             byte = cpu.bus_.ReadByte(regs_.GetHL(), ComponentSource::CPU);
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             regs_.SetCarry((byte & 0x80) != 0);
             byte <<= 1;
             cpu.bus_.WriteByte(regs_.GetHL(), byte, ComponentSource::CPU);
             return false;
         }
-        if (cpu.mCycleCounter() == 4) {
+        if constexpr (cycle == 4) {
             regs_.SetZero(byte == 0);
             regs_.SetSubtract(false);
             regs_.SetHalf(false);
@@ -1464,19 +1546,20 @@ private:
         return true;
     }
 
+    template<uint8_t cycle>
     bool RLCAddr(CPUType &cpu) {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             byte = cpu.bus_.ReadByte(regs_.GetHL(), ComponentSource::CPU);
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             const uint8_t old = byte & 0x80 ? 1 : 0;
             regs_.SetCarry(old != 0);
             byte = byte << 1 | old;
             cpu.bus_.WriteByte(regs_.GetHL(), byte, ComponentSource::CPU);
             return false;
         }
-        if (cpu.mCycleCounter() == 4) {
+        if constexpr (cycle == 4) {
             regs_.SetZero(byte == 0);
             regs_.SetSubtract(false);
             regs_.SetHalf(false);
@@ -1501,19 +1584,20 @@ private:
         return true;
     }
 
+    template<uint8_t cycle>
     bool RLAddr(CPUType &cpu) {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             byte = cpu.bus_.ReadByte(regs_.GetHL(), ComponentSource::CPU);
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             const uint8_t oldCarry = regs_.FlagCarry() ? 1 : 0;
             regs_.SetCarry((byte & 0x80) != 0);
             byte = (byte << 1) | oldCarry;
             cpu.bus_.WriteByte(regs_.GetHL(), byte, ComponentSource::CPU);
             return false;
         }
-        if (cpu.mCycleCounter() == 4) {
+        if constexpr (cycle == 4) {
             regs_.SetZero(byte == 0);
             regs_.SetSubtract(false);
             regs_.SetHalf(false);
@@ -1537,18 +1621,19 @@ private:
         return true;
     }
 
+    template<uint8_t cycle>
     bool SRAAddr(CPUType &cpu) {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             byte = cpu.bus_.ReadByte(regs_.GetHL(), ComponentSource::CPU);
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             regs_.SetCarry((byte & 0x01) != 0);
             byte = (byte >> 1) | (byte & 0x80);
             cpu.bus_.WriteByte(regs_.GetHL(), byte, ComponentSource::CPU);
             return false;
         }
-        if (cpu.mCycleCounter() == 4) {
+        if constexpr (cycle == 4) {
             regs_.SetZero(byte == 0);
             regs_.SetSubtract(false);
             regs_.SetHalf(false);
@@ -1572,17 +1657,18 @@ private:
         return true;
     }
 
+    template<uint8_t cycle>
     bool SWAPAddr(CPUType &cpu) {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             byte = cpu.bus_.ReadByte(regs_.GetHL(), ComponentSource::CPU);
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             byte = (byte >> 4) | (byte << 4);
             cpu.bus_.WriteByte(regs_.GetHL(), byte, ComponentSource::CPU);
             return false;
         }
-        if (cpu.mCycleCounter() == 4) {
+        if constexpr (cycle == 4) {
             regs_.SetZero(byte == 0);
             regs_.SetCarry(false);
             regs_.SetSubtract(false);
@@ -1607,18 +1693,19 @@ private:
         return true;
     }
 
+    template<uint8_t cycle>
     bool SRLAddr(CPUType &cpu) {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             byte = cpu.bus_.ReadByte(regs_.GetHL(), ComponentSource::CPU);
             regs_.SetCarry((byte & 0x01) != 0);
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             byte = byte >> 1;
             cpu.bus_.WriteByte(regs_.GetHL(), byte, ComponentSource::CPU);
             return false;
         }
-        if (cpu.mCycleCounter() == 4) {
+        if constexpr (cycle == 4) {
             regs_.SetZero(byte == 0);
             regs_.SetSubtract(false);
             regs_.SetHalf(false);
@@ -1641,13 +1728,13 @@ private:
     }
 
     /* M4 -- prefixed, M3 fetches byte */
-    template<int bit>
+    template<int bit, uint8_t cycle>
     bool BITAddr(CPUType &cpu) {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             byte = cpu.bus_.ReadByte(regs_.GetHL(), ComponentSource::CPU);
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             regs_.SetZero((byte & (1 << bit)) == 0);
             regs_.SetSubtract(false);
             regs_.SetHalf(true);
@@ -1667,18 +1754,18 @@ private:
         return true;
     }
 
-    template<int bit>
+    template<int bit, uint8_t cycle>
     bool RESAddr(CPUType &cpu) {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             byte = cpu.bus_.ReadByte(regs_.GetHL(), ComponentSource::CPU);
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             byte &= ~(1 << bit);
             cpu.bus_.WriteByte(regs_.GetHL(), byte, ComponentSource::CPU);
             return false;
         }
-        if (cpu.mCycleCounter() == 4) {
+        if constexpr (cycle == 4) {
             cpu.nextInstruction() = cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU);
             return true;
         }
@@ -1695,18 +1782,18 @@ private:
         return true;
     }
 
-    template<int bit>
+    template<int bit, uint8_t cycle>
     bool SETAddr(CPUType &cpu) {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             byte = cpu.bus_.ReadByte(regs_.GetHL(), ComponentSource::CPU);
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             byte |= 1 << bit;
             cpu.bus_.WriteByte(regs_.GetHL(), byte, ComponentSource::CPU);
             return false;
         }
-        if (cpu.mCycleCounter() == 4) {
+        if constexpr (cycle == 4) {
             cpu.nextInstruction() = cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU);
             return true;
         }
@@ -1728,12 +1815,13 @@ private:
         return true;
     }
 
+    template<uint8_t cycle>
     bool SBCIndirect(CPUType &cpu) {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             byte = cpu.bus_.ReadByte(regs_.GetHL(), ComponentSource::CPU);
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             const uint8_t flag_carry = regs_.FlagCarry() ? 1 : 0;
             const uint8_t r = regs_.a - byte - flag_carry;
             regs_.SetCarry(regs_.a < byte + static_cast<uint16_t>(flag_carry));
@@ -1747,12 +1835,13 @@ private:
         return false;
     }
 
+    template<uint8_t cycle>
     bool SBCImmediate(CPUType &cpu) {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             byte = cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU);
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             const uint8_t flag_carry = regs_.FlagCarry() ? 1 : 0;
             const uint8_t r = regs_.a - byte - flag_carry;
             regs_.SetCarry(regs_.a < byte + static_cast<uint16_t>(flag_carry));
@@ -1781,12 +1870,13 @@ private:
         return true;
     }
 
+    template<uint8_t cycle>
     bool ADCIndirect(CPUType &cpu) {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             byte = cpu.bus_.ReadByte(regs_.GetHL(), ComponentSource::CPU);
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             const uint8_t flag_carry = regs_.FlagCarry() ? 1 : 0;
             const uint8_t r = regs_.a + byte + flag_carry;
             regs_.SetCarry(static_cast<uint16_t>(regs_.a) + byte + static_cast<uint16_t>(flag_carry) > 0xFF);
@@ -1800,12 +1890,13 @@ private:
         return false;
     }
 
+    template<uint8_t cycle>
     bool ADCImmediate(CPUType &cpu) {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             byte = cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU);
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             const uint8_t flag_carry = regs_.FlagCarry() ? 1 : 0;
             const uint8_t r = regs_.a + byte + flag_carry;
             regs_.SetCarry(static_cast<uint16_t>(regs_.a) + byte + static_cast<uint16_t>(flag_carry) > 0xFF);
@@ -1819,16 +1910,16 @@ private:
         return false;
     }
 
-    template<Arithmetic16Target target>
+    template<Arithmetic16Target target, uint8_t cycle>
     bool ADD16(CPUType &cpu) {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             if constexpr (target == Arithmetic16Target::BC) word = regs_.GetBC();
             if constexpr (target == Arithmetic16Target::DE) word = regs_.GetDE();
             if constexpr (target == Arithmetic16Target::HL) word = regs_.GetHL();
             if constexpr (target == Arithmetic16Target::SP) word = cpu.sp();
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             const uint16_t reg = regs_.GetHL();
             const uint16_t sum = reg + word;
 
@@ -1858,12 +1949,13 @@ private:
         return true;
     }
 
+    template<uint8_t cycle>
     bool ADDIndirect(CPUType &cpu) {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             byte = cpu.bus_.ReadByte(regs_.GetHL(), ComponentSource::CPU);
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             const uint8_t a = regs_.a;
             const uint8_t new_value = a + byte;
             regs_.SetCarry(static_cast<uint16_t>(a) + static_cast<uint16_t>(byte) > 0xFF);
@@ -1877,12 +1969,13 @@ private:
         return false;
     }
 
+    template<uint8_t cycle>
     bool ADDImmediate(CPUType &cpu) {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             byte = cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU);
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             const uint8_t a = regs_.a;
             const uint8_t new_value = a + byte;
             regs_.SetCarry(static_cast<uint16_t>(a) + static_cast<uint16_t>(byte) > 0xFF);
@@ -1896,24 +1989,25 @@ private:
         return false;
     }
 
+    template<uint8_t cycle>
     bool ADDSigned(CPUType &cpu) {
-        if (cpu.mCycleCounter() == 2) {
+        if constexpr (cycle == 2) {
             word = static_cast<uint16_t>(static_cast<int16_t>(static_cast<int8_t>(
                 cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU))));
             return false;
         }
-        if (cpu.mCycleCounter() == 3) {
+        if constexpr (cycle == 3) {
             word2 = cpu.sp();
             return false;
         }
-        if (cpu.mCycleCounter() == 4) {
+        if constexpr (cycle == 4) {
             regs_.SetCarry(((word2 & 0xFF) + (word & 0xFF)) > 0xFF);
             regs_.SetHalf(((word2 & 0xF) + (word & 0xF)) > 0xF);
             regs_.SetSubtract(false);
             regs_.SetZero(false);
             return false;
         }
-        if (cpu.mCycleCounter() == 5) {
+        if constexpr (cycle == 5) {
             cpu.sp() = word2 + word;
             cpu.nextInstruction() = cpu.bus_.ReadByte(cpu.pc()++, ComponentSource::CPU);
             return true;
@@ -1921,518 +2015,529 @@ private:
         return false;
     }
 
-    const std::array<WrappedFunction, 256> prefixedTable = [this] {
-        std::array<WrappedFunction, 256> table{};
-        table[0x00] = [this](CPUType &cpu) -> bool { return this->RLC<Register::B>(cpu); };
-        table[0x01] = [this](CPUType &cpu) -> bool { return this->RLC<Register::C>(cpu); };
-        table[0x02] = [this](CPUType &cpu) -> bool { return this->RLC<Register::D>(cpu); };
-        table[0x03] = [this](CPUType &cpu) -> bool { return this->RLC<Register::E>(cpu); };
-        table[0x04] = [this](CPUType &cpu) -> bool { return this->RLC<Register::H>(cpu); };
-        table[0x05] = [this](CPUType &cpu) -> bool { return this->RLC<Register::L>(cpu); };
-        table[0x06] = [this](CPUType &cpu) -> bool { return this->RLCAddr(cpu); };
-        table[0x07] = [this](CPUType &cpu) -> bool { return this->RLC<Register::A>(cpu); };
-        table[0x08] = [this](CPUType &cpu) -> bool { return this->RRC<Register::B>(cpu); };
-        table[0x09] = [this](CPUType &cpu) -> bool { return this->RRC<Register::C>(cpu); };
-        table[0x0A] = [this](CPUType &cpu) -> bool { return this->RRC<Register::D>(cpu); };
-        table[0x0B] = [this](CPUType &cpu) -> bool { return this->RRC<Register::E>(cpu); };
-        table[0x0C] = [this](CPUType &cpu) -> bool { return this->RRC<Register::H>(cpu); };
-        table[0x0D] = [this](CPUType &cpu) -> bool { return this->RRC<Register::L>(cpu); };
-        table[0x0E] = [this](CPUType &cpu) -> bool { return this->RRCAddr(cpu); };
-        table[0x0F] = [this](CPUType &cpu) -> bool { return this->RRC<Register::A>(cpu); };
-        table[0x10] = [this](CPUType &cpu) -> bool { return this->RL<Register::B>(cpu); };
-        table[0x11] = [this](CPUType &cpu) -> bool { return this->RL<Register::C>(cpu); };
-        table[0x12] = [this](CPUType &cpu) -> bool { return this->RL<Register::D>(cpu); };
-        table[0x13] = [this](CPUType &cpu) -> bool { return this->RL<Register::E>(cpu); };
-        table[0x14] = [this](CPUType &cpu) -> bool { return this->RL<Register::H>(cpu); };
-        table[0x15] = [this](CPUType &cpu) -> bool { return this->RL<Register::L>(cpu); };
-        table[0x16] = [this](CPUType &cpu) -> bool { return this->RLAddr(cpu); };
-        table[0x17] = [this](CPUType &cpu) -> bool { return this->RL<Register::A>(cpu); };
-        table[0x18] = [this](CPUType &cpu) -> bool { return this->RR<Register::B>(cpu); };
-        table[0x19] = [this](CPUType &cpu) -> bool { return this->RR<Register::C>(cpu); };
-        table[0x1A] = [this](CPUType &cpu) -> bool { return this->RR<Register::D>(cpu); };
-        table[0x1B] = [this](CPUType &cpu) -> bool { return this->RR<Register::E>(cpu); };
-        table[0x1C] = [this](CPUType &cpu) -> bool { return this->RR<Register::H>(cpu); };
-        table[0x1D] = [this](CPUType &cpu) -> bool { return this->RR<Register::L>(cpu); };
-        table[0x1E] = [this](CPUType &cpu) -> bool { return this->RRAddr(cpu); };
-        table[0x1F] = [this](CPUType &cpu) -> bool { return this->RR<Register::A>(cpu); };
-        table[0x20] = [this](CPUType &cpu) -> bool { return this->SLA<Register::B>(cpu); };
-        table[0x21] = [this](CPUType &cpu) -> bool { return this->SLA<Register::C>(cpu); };
-        table[0x22] = [this](CPUType &cpu) -> bool { return this->SLA<Register::D>(cpu); };
-        table[0x23] = [this](CPUType &cpu) -> bool { return this->SLA<Register::E>(cpu); };
-        table[0x24] = [this](CPUType &cpu) -> bool { return this->SLA<Register::H>(cpu); };
-        table[0x25] = [this](CPUType &cpu) -> bool { return this->SLA<Register::L>(cpu); };
-        table[0x26] = [this](CPUType &cpu) -> bool { return this->SLAAddr(cpu); };
-        table[0x27] = [this](CPUType &cpu) -> bool { return this->SLA<Register::A>(cpu); };
-        table[0x28] = [this](CPUType &cpu) -> bool { return this->SRA<Register::B>(cpu); };
-        table[0x29] = [this](CPUType &cpu) -> bool { return this->SRA<Register::C>(cpu); };
-        table[0x2A] = [this](CPUType &cpu) -> bool { return this->SRA<Register::D>(cpu); };
-        table[0x2B] = [this](CPUType &cpu) -> bool { return this->SRA<Register::E>(cpu); };
-        table[0x2C] = [this](CPUType &cpu) -> bool { return this->SRA<Register::H>(cpu); };
-        table[0x2D] = [this](CPUType &cpu) -> bool { return this->SRA<Register::L>(cpu); };
-        table[0x2E] = [this](CPUType &cpu) -> bool { return this->SRAAddr(cpu); };
-        table[0x2F] = [this](CPUType &cpu) -> bool { return this->SRA<Register::A>(cpu); };
-        table[0x30] = [this](CPUType &cpu) -> bool { return this->SWAP<Register::B>(cpu); };
-        table[0x31] = [this](CPUType &cpu) -> bool { return this->SWAP<Register::C>(cpu); };
-        table[0x32] = [this](CPUType &cpu) -> bool { return this->SWAP<Register::D>(cpu); };
-        table[0x33] = [this](CPUType &cpu) -> bool { return this->SWAP<Register::E>(cpu); };
-        table[0x34] = [this](CPUType &cpu) -> bool { return this->SWAP<Register::H>(cpu); };
-        table[0x35] = [this](CPUType &cpu) -> bool { return this->SWAP<Register::L>(cpu); };
-        table[0x36] = [this](CPUType &cpu) -> bool { return this->SWAPAddr(cpu); };
-        table[0x37] = [this](CPUType &cpu) -> bool { return this->SWAP<Register::A>(cpu); };
-        table[0x38] = [this](CPUType &cpu) -> bool { return this->SRL<Register::B>(cpu); };
-        table[0x39] = [this](CPUType &cpu) -> bool { return this->SRL<Register::C>(cpu); };
-        table[0x3A] = [this](CPUType &cpu) -> bool { return this->SRL<Register::D>(cpu); };
-        table[0x3B] = [this](CPUType &cpu) -> bool { return this->SRL<Register::E>(cpu); };
-        table[0x3C] = [this](CPUType &cpu) -> bool { return this->SRL<Register::H>(cpu); };
-        table[0x3D] = [this](CPUType &cpu) -> bool { return this->SRL<Register::L>(cpu); };
-        table[0x3E] = [this](CPUType &cpu) -> bool { return this->SRLAddr(cpu); };
-        table[0x3F] = [this](CPUType &cpu) -> bool { return this->SRL<Register::A>(cpu); };
-        table[0x40] = [this](CPUType &cpu) -> bool { return this->BIT<Register::B, 0>(cpu); };
-        table[0x41] = [this](CPUType &cpu) -> bool { return this->BIT<Register::C, 0>(cpu); };
-        table[0x42] = [this](CPUType &cpu) -> bool { return this->BIT<Register::D, 0>(cpu); };
-        table[0x43] = [this](CPUType &cpu) -> bool { return this->BIT<Register::E, 0>(cpu); };
-        table[0x44] = [this](CPUType &cpu) -> bool { return this->BIT<Register::H, 0>(cpu); };
-        table[0x45] = [this](CPUType &cpu) -> bool { return this->BIT<Register::L, 0>(cpu); };
-        table[0x46] = [this](CPUType &cpu) -> bool { return this->BITAddr<0>(cpu); };
-        table[0x47] = [this](CPUType &cpu) -> bool { return this->BIT<Register::A, 0>(cpu); };
-        table[0x48] = [this](CPUType &cpu) -> bool { return this->BIT<Register::B, 1>(cpu); };
-        table[0x49] = [this](CPUType &cpu) -> bool { return this->BIT<Register::C, 1>(cpu); };
-        table[0x4A] = [this](CPUType &cpu) -> bool { return this->BIT<Register::D, 1>(cpu); };
-        table[0x4B] = [this](CPUType &cpu) -> bool { return this->BIT<Register::E, 1>(cpu); };
-        table[0x4C] = [this](CPUType &cpu) -> bool { return this->BIT<Register::H, 1>(cpu); };
-        table[0x4D] = [this](CPUType &cpu) -> bool { return this->BIT<Register::L, 1>(cpu); };
-        table[0x4E] = [this](CPUType &cpu) -> bool { return this->BITAddr<1>(cpu); };
-        table[0x4F] = [this](CPUType &cpu) -> bool { return this->BIT<Register::A, 1>(cpu); };
-        table[0x50] = [this](CPUType &cpu) -> bool { return this->BIT<Register::B, 2>(cpu); };
-        table[0x51] = [this](CPUType &cpu) -> bool { return this->BIT<Register::C, 2>(cpu); };
-        table[0x52] = [this](CPUType &cpu) -> bool { return this->BIT<Register::D, 2>(cpu); };
-        table[0x53] = [this](CPUType &cpu) -> bool { return this->BIT<Register::E, 2>(cpu); };
-        table[0x54] = [this](CPUType &cpu) -> bool { return this->BIT<Register::H, 2>(cpu); };
-        table[0x55] = [this](CPUType &cpu) -> bool { return this->BIT<Register::L, 2>(cpu); };
-        table[0x56] = [this](CPUType &cpu) -> bool { return this->BITAddr<2>(cpu); };
-        table[0x57] = [this](CPUType &cpu) -> bool { return this->BIT<Register::A, 2>(cpu); };
-        table[0x58] = [this](CPUType &cpu) -> bool { return this->BIT<Register::B, 3>(cpu); };
-        table[0x59] = [this](CPUType &cpu) -> bool { return this->BIT<Register::C, 3>(cpu); };
-        table[0x5A] = [this](CPUType &cpu) -> bool { return this->BIT<Register::D, 3>(cpu); };
-        table[0x5B] = [this](CPUType &cpu) -> bool { return this->BIT<Register::E, 3>(cpu); };
-        table[0x5C] = [this](CPUType &cpu) -> bool { return this->BIT<Register::H, 3>(cpu); };
-        table[0x5D] = [this](CPUType &cpu) -> bool { return this->BIT<Register::L, 3>(cpu); };
-        table[0x5E] = [this](CPUType &cpu) -> bool { return this->BITAddr<3>(cpu); };
-        table[0x5F] = [this](CPUType &cpu) -> bool { return this->BIT<Register::A, 3>(cpu); };
-        table[0x60] = [this](CPUType &cpu) -> bool { return this->BIT<Register::B, 4>(cpu); };
-        table[0x61] = [this](CPUType &cpu) -> bool { return this->BIT<Register::C, 4>(cpu); };
-        table[0x62] = [this](CPUType &cpu) -> bool { return this->BIT<Register::D, 4>(cpu); };
-        table[0x63] = [this](CPUType &cpu) -> bool { return this->BIT<Register::E, 4>(cpu); };
-        table[0x64] = [this](CPUType &cpu) -> bool { return this->BIT<Register::H, 4>(cpu); };
-        table[0x65] = [this](CPUType &cpu) -> bool { return this->BIT<Register::L, 4>(cpu); };
-        table[0x66] = [this](CPUType &cpu) -> bool { return this->BITAddr<4>(cpu); };
-        table[0x67] = [this](CPUType &cpu) -> bool { return this->BIT<Register::A, 4>(cpu); };
-        table[0x68] = [this](CPUType &cpu) -> bool { return this->BIT<Register::B, 5>(cpu); };
-        table[0x69] = [this](CPUType &cpu) -> bool { return this->BIT<Register::C, 5>(cpu); };
-        table[0x6A] = [this](CPUType &cpu) -> bool { return this->BIT<Register::D, 5>(cpu); };
-        table[0x6B] = [this](CPUType &cpu) -> bool { return this->BIT<Register::E, 5>(cpu); };
-        table[0x6C] = [this](CPUType &cpu) -> bool { return this->BIT<Register::H, 5>(cpu); };
-        table[0x6D] = [this](CPUType &cpu) -> bool { return this->BIT<Register::L, 5>(cpu); };
-        table[0x6E] = [this](CPUType &cpu) -> bool { return this->BITAddr<5>(cpu); };
-        table[0x6F] = [this](CPUType &cpu) -> bool { return this->BIT<Register::A, 5>(cpu); };
-        table[0x70] = [this](CPUType &cpu) -> bool { return this->BIT<Register::B, 6>(cpu); };
-        table[0x71] = [this](CPUType &cpu) -> bool { return this->BIT<Register::C, 6>(cpu); };
-        table[0x72] = [this](CPUType &cpu) -> bool { return this->BIT<Register::D, 6>(cpu); };
-        table[0x73] = [this](CPUType &cpu) -> bool { return this->BIT<Register::E, 6>(cpu); };
-        table[0x74] = [this](CPUType &cpu) -> bool { return this->BIT<Register::H, 6>(cpu); };
-        table[0x75] = [this](CPUType &cpu) -> bool { return this->BIT<Register::L, 6>(cpu); };
-        table[0x76] = [this](CPUType &cpu) -> bool { return this->BITAddr<6>(cpu); };
-        table[0x77] = [this](CPUType &cpu) -> bool { return this->BIT<Register::A, 6>(cpu); };
-        table[0x78] = [this](CPUType &cpu) -> bool { return this->BIT<Register::B, 7>(cpu); };
-        table[0x79] = [this](CPUType &cpu) -> bool { return this->BIT<Register::C, 7>(cpu); };
-        table[0x7A] = [this](CPUType &cpu) -> bool { return this->BIT<Register::D, 7>(cpu); };
-        table[0x7B] = [this](CPUType &cpu) -> bool { return this->BIT<Register::E, 7>(cpu); };
-        table[0x7C] = [this](CPUType &cpu) -> bool { return this->BIT<Register::H, 7>(cpu); };
-        table[0x7D] = [this](CPUType &cpu) -> bool { return this->BIT<Register::L, 7>(cpu); };
-        table[0x7E] = [this](CPUType &cpu) -> bool { return this->BITAddr<7>(cpu); };
-        table[0x7F] = [this](CPUType &cpu) -> bool { return this->BIT<Register::A, 7>(cpu); };
-        table[0x80] = [this](CPUType &cpu) -> bool { return this->RES<Register::B, 0>(cpu); };
-        table[0x81] = [this](CPUType &cpu) -> bool { return this->RES<Register::C, 0>(cpu); };
-        table[0x82] = [this](CPUType &cpu) -> bool { return this->RES<Register::D, 0>(cpu); };
-        table[0x83] = [this](CPUType &cpu) -> bool { return this->RES<Register::E, 0>(cpu); };
-        table[0x84] = [this](CPUType &cpu) -> bool { return this->RES<Register::H, 0>(cpu); };
-        table[0x85] = [this](CPUType &cpu) -> bool { return this->RES<Register::L, 0>(cpu); };
-        table[0x86] = [this](CPUType &cpu) -> bool { return this->RESAddr<0>(cpu); };
-        table[0x87] = [this](CPUType &cpu) -> bool { return this->RES<Register::A, 0>(cpu); };
-        table[0x88] = [this](CPUType &cpu) -> bool { return this->RES<Register::B, 1>(cpu); };
-        table[0x89] = [this](CPUType &cpu) -> bool { return this->RES<Register::C, 1>(cpu); };
-        table[0x8A] = [this](CPUType &cpu) -> bool { return this->RES<Register::D, 1>(cpu); };
-        table[0x8B] = [this](CPUType &cpu) -> bool { return this->RES<Register::E, 1>(cpu); };
-        table[0x8C] = [this](CPUType &cpu) -> bool { return this->RES<Register::H, 1>(cpu); };
-        table[0x8D] = [this](CPUType &cpu) -> bool { return this->RES<Register::L, 1>(cpu); };
-        table[0x8E] = [this](CPUType &cpu) -> bool { return this->RESAddr<1>(cpu); };
-        table[0x8F] = [this](CPUType &cpu) -> bool { return this->RES<Register::A, 1>(cpu); };
-        table[0x90] = [this](CPUType &cpu) -> bool { return this->RES<Register::B, 2>(cpu); };
-        table[0x91] = [this](CPUType &cpu) -> bool { return this->RES<Register::C, 2>(cpu); };
-        table[0x92] = [this](CPUType &cpu) -> bool { return this->RES<Register::D, 2>(cpu); };
-        table[0x93] = [this](CPUType &cpu) -> bool { return this->RES<Register::E, 2>(cpu); };
-        table[0x94] = [this](CPUType &cpu) -> bool { return this->RES<Register::H, 2>(cpu); };
-        table[0x95] = [this](CPUType &cpu) -> bool { return this->RES<Register::L, 2>(cpu); };
-        table[0x96] = [this](CPUType &cpu) -> bool { return this->RESAddr<2>(cpu); };
-        table[0x97] = [this](CPUType &cpu) -> bool { return this->RES<Register::A, 2>(cpu); };
-        table[0x98] = [this](CPUType &cpu) -> bool { return this->RES<Register::B, 3>(cpu); };
-        table[0x99] = [this](CPUType &cpu) -> bool { return this->RES<Register::C, 3>(cpu); };
-        table[0x9A] = [this](CPUType &cpu) -> bool { return this->RES<Register::D, 3>(cpu); };
-        table[0x9B] = [this](CPUType &cpu) -> bool { return this->RES<Register::E, 3>(cpu); };
-        table[0x9C] = [this](CPUType &cpu) -> bool { return this->RES<Register::H, 3>(cpu); };
-        table[0x9D] = [this](CPUType &cpu) -> bool { return this->RES<Register::L, 3>(cpu); };
-        table[0x9E] = [this](CPUType &cpu) -> bool { return this->RESAddr<3>(cpu); };
-        table[0x9F] = [this](CPUType &cpu) -> bool { return this->RES<Register::A, 3>(cpu); };
-        table[0xA0] = [this](CPUType &cpu) -> bool { return this->RES<Register::B, 4>(cpu); };
-        table[0xA1] = [this](CPUType &cpu) -> bool { return this->RES<Register::C, 4>(cpu); };
-        table[0xA2] = [this](CPUType &cpu) -> bool { return this->RES<Register::D, 4>(cpu); };
-        table[0xA3] = [this](CPUType &cpu) -> bool { return this->RES<Register::E, 4>(cpu); };
-        table[0xA4] = [this](CPUType &cpu) -> bool { return this->RES<Register::H, 4>(cpu); };
-        table[0xA5] = [this](CPUType &cpu) -> bool { return this->RES<Register::L, 4>(cpu); };
-        table[0xA6] = [this](CPUType &cpu) -> bool { return this->RESAddr<4>(cpu); };
-        table[0xA7] = [this](CPUType &cpu) -> bool { return this->RES<Register::A, 4>(cpu); };
-        table[0xA8] = [this](CPUType &cpu) -> bool { return this->RES<Register::B, 5>(cpu); };
-        table[0xA9] = [this](CPUType &cpu) -> bool { return this->RES<Register::C, 5>(cpu); };
-        table[0xAA] = [this](CPUType &cpu) -> bool { return this->RES<Register::D, 5>(cpu); };
-        table[0xAB] = [this](CPUType &cpu) -> bool { return this->RES<Register::E, 5>(cpu); };
-        table[0xAC] = [this](CPUType &cpu) -> bool { return this->RES<Register::H, 5>(cpu); };
-        table[0xAD] = [this](CPUType &cpu) -> bool { return this->RES<Register::L, 5>(cpu); };
-        table[0xAE] = [this](CPUType &cpu) -> bool { return this->RESAddr<5>(cpu); };
-        table[0xAF] = [this](CPUType &cpu) -> bool { return this->RES<Register::A, 5>(cpu); };
-        table[0xB0] = [this](CPUType &cpu) -> bool { return this->RES<Register::B, 6>(cpu); };
-        table[0xB1] = [this](CPUType &cpu) -> bool { return this->RES<Register::C, 6>(cpu); };
-        table[0xB2] = [this](CPUType &cpu) -> bool { return this->RES<Register::D, 6>(cpu); };
-        table[0xB3] = [this](CPUType &cpu) -> bool { return this->RES<Register::E, 6>(cpu); };
-        table[0xB4] = [this](CPUType &cpu) -> bool { return this->RES<Register::H, 6>(cpu); };
-        table[0xB5] = [this](CPUType &cpu) -> bool { return this->RES<Register::L, 6>(cpu); };
-        table[0xB6] = [this](CPUType &cpu) -> bool { return this->RESAddr<6>(cpu); };
-        table[0xB7] = [this](CPUType &cpu) -> bool { return this->RES<Register::A, 6>(cpu); };
-        table[0xB8] = [this](CPUType &cpu) -> bool { return this->RES<Register::B, 7>(cpu); };
-        table[0xB9] = [this](CPUType &cpu) -> bool { return this->RES<Register::C, 7>(cpu); };
-        table[0xBA] = [this](CPUType &cpu) -> bool { return this->RES<Register::D, 7>(cpu); };
-        table[0xBB] = [this](CPUType &cpu) -> bool { return this->RES<Register::E, 7>(cpu); };
-        table[0xBC] = [this](CPUType &cpu) -> bool { return this->RES<Register::H, 7>(cpu); };
-        table[0xBD] = [this](CPUType &cpu) -> bool { return this->RES<Register::L, 7>(cpu); };
-        table[0xBE] = [this](CPUType &cpu) -> bool { return this->RESAddr<7>(cpu); };
-        table[0xBF] = [this](CPUType &cpu) -> bool { return this->RES<Register::A, 7>(cpu); };
-        table[0xC0] = [this](CPUType &cpu) -> bool { return this->SET<Register::B, 0>(cpu); };
-        table[0xC1] = [this](CPUType &cpu) -> bool { return this->SET<Register::C, 0>(cpu); };
-        table[0xC2] = [this](CPUType &cpu) -> bool { return this->SET<Register::D, 0>(cpu); };
-        table[0xC3] = [this](CPUType &cpu) -> bool { return this->SET<Register::E, 0>(cpu); };
-        table[0xC4] = [this](CPUType &cpu) -> bool { return this->SET<Register::H, 0>(cpu); };
-        table[0xC5] = [this](CPUType &cpu) -> bool { return this->SET<Register::L, 0>(cpu); };
-        table[0xC6] = [this](CPUType &cpu) -> bool { return this->SETAddr<0>(cpu); };
-        table[0xC7] = [this](CPUType &cpu) -> bool { return this->SET<Register::A, 0>(cpu); };
-        table[0xC8] = [this](CPUType &cpu) -> bool { return this->SET<Register::B, 1>(cpu); };
-        table[0xC9] = [this](CPUType &cpu) -> bool { return this->SET<Register::C, 1>(cpu); };
-        table[0xCA] = [this](CPUType &cpu) -> bool { return this->SET<Register::D, 1>(cpu); };
-        table[0xCB] = [this](CPUType &cpu) -> bool { return this->SET<Register::E, 1>(cpu); };
-        table[0xCC] = [this](CPUType &cpu) -> bool { return this->SET<Register::H, 1>(cpu); };
-        table[0xCD] = [this](CPUType &cpu) -> bool { return this->SET<Register::L, 1>(cpu); };
-        table[0xCE] = [this](CPUType &cpu) -> bool { return this->SETAddr<1>(cpu); };
-        table[0xCF] = [this](CPUType &cpu) -> bool { return this->SET<Register::A, 1>(cpu); };
-        table[0xD0] = [this](CPUType &cpu) -> bool { return this->SET<Register::B, 2>(cpu); };
-        table[0xD1] = [this](CPUType &cpu) -> bool { return this->SET<Register::C, 2>(cpu); };
-        table[0xD2] = [this](CPUType &cpu) -> bool { return this->SET<Register::D, 2>(cpu); };
-        table[0xD3] = [this](CPUType &cpu) -> bool { return this->SET<Register::E, 2>(cpu); };
-        table[0xD4] = [this](CPUType &cpu) -> bool { return this->SET<Register::H, 2>(cpu); };
-        table[0xD5] = [this](CPUType &cpu) -> bool { return this->SET<Register::L, 2>(cpu); };
-        table[0xD6] = [this](CPUType &cpu) -> bool { return this->SETAddr<2>(cpu); };
-        table[0xD7] = [this](CPUType &cpu) -> bool { return this->SET<Register::A, 2>(cpu); };
-        table[0xD8] = [this](CPUType &cpu) -> bool { return this->SET<Register::B, 3>(cpu); };
-        table[0xD9] = [this](CPUType &cpu) -> bool { return this->SET<Register::C, 3>(cpu); };
-        table[0xDA] = [this](CPUType &cpu) -> bool { return this->SET<Register::D, 3>(cpu); };
-        table[0xDB] = [this](CPUType &cpu) -> bool { return this->SET<Register::E, 3>(cpu); };
-        table[0xDC] = [this](CPUType &cpu) -> bool { return this->SET<Register::H, 3>(cpu); };
-        table[0xDD] = [this](CPUType &cpu) -> bool { return this->SET<Register::L, 3>(cpu); };
-        table[0xDE] = [this](CPUType &cpu) -> bool { return this->SETAddr<3>(cpu); };
-        table[0xDF] = [this](CPUType &cpu) -> bool { return this->SET<Register::A, 3>(cpu); };
-        table[0xE0] = [this](CPUType &cpu) -> bool { return this->SET<Register::B, 4>(cpu); };
-        table[0xE1] = [this](CPUType &cpu) -> bool { return this->SET<Register::C, 4>(cpu); };
-        table[0xE2] = [this](CPUType &cpu) -> bool { return this->SET<Register::D, 4>(cpu); };
-        table[0xE3] = [this](CPUType &cpu) -> bool { return this->SET<Register::E, 4>(cpu); };
-        table[0xE4] = [this](CPUType &cpu) -> bool { return this->SET<Register::H, 4>(cpu); };
-        table[0xE5] = [this](CPUType &cpu) -> bool { return this->SET<Register::L, 4>(cpu); };
-        table[0xE6] = [this](CPUType &cpu) -> bool { return this->SETAddr<4>(cpu); };
-        table[0xE7] = [this](CPUType &cpu) -> bool { return this->SET<Register::A, 4>(cpu); };
-        table[0xE8] = [this](CPUType &cpu) -> bool { return this->SET<Register::B, 5>(cpu); };
-        table[0xE9] = [this](CPUType &cpu) -> bool { return this->SET<Register::C, 5>(cpu); };
-        table[0xEA] = [this](CPUType &cpu) -> bool { return this->SET<Register::D, 5>(cpu); };
-        table[0xEB] = [this](CPUType &cpu) -> bool { return this->SET<Register::E, 5>(cpu); };
-        table[0xEC] = [this](CPUType &cpu) -> bool { return this->SET<Register::H, 5>(cpu); };
-        table[0xED] = [this](CPUType &cpu) -> bool { return this->SET<Register::L, 5>(cpu); };
-        table[0xEE] = [this](CPUType &cpu) -> bool { return this->SETAddr<5>(cpu); };
-        table[0xEF] = [this](CPUType &cpu) -> bool { return this->SET<Register::A, 5>(cpu); };
-        table[0xF0] = [this](CPUType &cpu) -> bool { return this->SET<Register::B, 6>(cpu); };
-        table[0xF1] = [this](CPUType &cpu) -> bool { return this->SET<Register::C, 6>(cpu); };
-        table[0xF2] = [this](CPUType &cpu) -> bool { return this->SET<Register::D, 6>(cpu); };
-        table[0xF3] = [this](CPUType &cpu) -> bool { return this->SET<Register::E, 6>(cpu); };
-        table[0xF4] = [this](CPUType &cpu) -> bool { return this->SET<Register::H, 6>(cpu); };
-        table[0xF5] = [this](CPUType &cpu) -> bool { return this->SET<Register::L, 6>(cpu); };
-        table[0xF6] = [this](CPUType &cpu) -> bool { return this->SETAddr<6>(cpu); };
-        table[0xF7] = [this](CPUType &cpu) -> bool { return this->SET<Register::A, 6>(cpu); };
-        table[0xF8] = [this](CPUType &cpu) -> bool { return this->SET<Register::B, 7>(cpu); };
-        table[0xF9] = [this](CPUType &cpu) -> bool { return this->SET<Register::C, 7>(cpu); };
-        table[0xFA] = [this](CPUType &cpu) -> bool { return this->SET<Register::D, 7>(cpu); };
-        table[0xFB] = [this](CPUType &cpu) -> bool { return this->SET<Register::E, 7>(cpu); };
-        table[0xFC] = [this](CPUType &cpu) -> bool { return this->SET<Register::H, 7>(cpu); };
-        table[0xFD] = [this](CPUType &cpu) -> bool { return this->SET<Register::L, 7>(cpu); };
-        table[0xFE] = [this](CPUType &cpu) -> bool { return this->SETAddr<7>(cpu); };
-        table[0xFF] = [this](CPUType &cpu) -> bool { return this->SET<Register::A, 7>(cpu); };
+    static constexpr std::array<StepRow, 256> prefixedSteps = [] {
+        std::array<StepRow, 256> table{};
+        table[0x00] = Single<&Instructions::RLC<Register::B>>();
+        table[0x01] = Single<&Instructions::RLC<Register::C>>();
+        table[0x02] = Single<&Instructions::RLC<Register::D>>();
+        table[0x03] = Single<&Instructions::RLC<Register::E>>();
+        table[0x04] = Single<&Instructions::RLC<Register::H>>();
+        table[0x05] = Single<&Instructions::RLC<Register::L>>();
+        table[0x06] = Cycled([]<uint8_t C> { return &Instructions::RLCAddr<C>; });
+        table[0x07] = Single<&Instructions::RLC<Register::A>>();
+        table[0x08] = Single<&Instructions::RRC<Register::B>>();
+        table[0x09] = Single<&Instructions::RRC<Register::C>>();
+        table[0x0A] = Single<&Instructions::RRC<Register::D>>();
+        table[0x0B] = Single<&Instructions::RRC<Register::E>>();
+        table[0x0C] = Single<&Instructions::RRC<Register::H>>();
+        table[0x0D] = Single<&Instructions::RRC<Register::L>>();
+        table[0x0E] = Cycled([]<uint8_t C> { return &Instructions::RRCAddr<C>; });
+        table[0x0F] = Single<&Instructions::RRC<Register::A>>();
+        table[0x10] = Single<&Instructions::RL<Register::B>>();
+        table[0x11] = Single<&Instructions::RL<Register::C>>();
+        table[0x12] = Single<&Instructions::RL<Register::D>>();
+        table[0x13] = Single<&Instructions::RL<Register::E>>();
+        table[0x14] = Single<&Instructions::RL<Register::H>>();
+        table[0x15] = Single<&Instructions::RL<Register::L>>();
+        table[0x16] = Cycled([]<uint8_t C> { return &Instructions::RLAddr<C>; });
+        table[0x17] = Single<&Instructions::RL<Register::A>>();
+        table[0x18] = Single<&Instructions::RR<Register::B>>();
+        table[0x19] = Single<&Instructions::RR<Register::C>>();
+        table[0x1A] = Single<&Instructions::RR<Register::D>>();
+        table[0x1B] = Single<&Instructions::RR<Register::E>>();
+        table[0x1C] = Single<&Instructions::RR<Register::H>>();
+        table[0x1D] = Single<&Instructions::RR<Register::L>>();
+        table[0x1E] = Cycled([]<uint8_t C> { return &Instructions::RRAddr<C>; });
+        table[0x1F] = Single<&Instructions::RR<Register::A>>();
+        table[0x20] = Single<&Instructions::SLA<Register::B>>();
+        table[0x21] = Single<&Instructions::SLA<Register::C>>();
+        table[0x22] = Single<&Instructions::SLA<Register::D>>();
+        table[0x23] = Single<&Instructions::SLA<Register::E>>();
+        table[0x24] = Single<&Instructions::SLA<Register::H>>();
+        table[0x25] = Single<&Instructions::SLA<Register::L>>();
+        table[0x26] = Cycled([]<uint8_t C> { return &Instructions::SLAAddr<C>; });
+        table[0x27] = Single<&Instructions::SLA<Register::A>>();
+        table[0x28] = Single<&Instructions::SRA<Register::B>>();
+        table[0x29] = Single<&Instructions::SRA<Register::C>>();
+        table[0x2A] = Single<&Instructions::SRA<Register::D>>();
+        table[0x2B] = Single<&Instructions::SRA<Register::E>>();
+        table[0x2C] = Single<&Instructions::SRA<Register::H>>();
+        table[0x2D] = Single<&Instructions::SRA<Register::L>>();
+        table[0x2E] = Cycled([]<uint8_t C> { return &Instructions::SRAAddr<C>; });
+        table[0x2F] = Single<&Instructions::SRA<Register::A>>();
+        table[0x30] = Single<&Instructions::SWAP<Register::B>>();
+        table[0x31] = Single<&Instructions::SWAP<Register::C>>();
+        table[0x32] = Single<&Instructions::SWAP<Register::D>>();
+        table[0x33] = Single<&Instructions::SWAP<Register::E>>();
+        table[0x34] = Single<&Instructions::SWAP<Register::H>>();
+        table[0x35] = Single<&Instructions::SWAP<Register::L>>();
+        table[0x36] = Cycled([]<uint8_t C> { return &Instructions::SWAPAddr<C>; });
+        table[0x37] = Single<&Instructions::SWAP<Register::A>>();
+        table[0x38] = Single<&Instructions::SRL<Register::B>>();
+        table[0x39] = Single<&Instructions::SRL<Register::C>>();
+        table[0x3A] = Single<&Instructions::SRL<Register::D>>();
+        table[0x3B] = Single<&Instructions::SRL<Register::E>>();
+        table[0x3C] = Single<&Instructions::SRL<Register::H>>();
+        table[0x3D] = Single<&Instructions::SRL<Register::L>>();
+        table[0x3E] = Cycled([]<uint8_t C> { return &Instructions::SRLAddr<C>; });
+        table[0x3F] = Single<&Instructions::SRL<Register::A>>();
+        table[0x40] = Single<&Instructions::BIT<Register::B, 0>>();
+        table[0x41] = Single<&Instructions::BIT<Register::C, 0>>();
+        table[0x42] = Single<&Instructions::BIT<Register::D, 0>>();
+        table[0x43] = Single<&Instructions::BIT<Register::E, 0>>();
+        table[0x44] = Single<&Instructions::BIT<Register::H, 0>>();
+        table[0x45] = Single<&Instructions::BIT<Register::L, 0>>();
+        table[0x46] = Cycled([]<uint8_t C> { return &Instructions::BITAddr<0, C>; });
+        table[0x47] = Single<&Instructions::BIT<Register::A, 0>>();
+        table[0x48] = Single<&Instructions::BIT<Register::B, 1>>();
+        table[0x49] = Single<&Instructions::BIT<Register::C, 1>>();
+        table[0x4A] = Single<&Instructions::BIT<Register::D, 1>>();
+        table[0x4B] = Single<&Instructions::BIT<Register::E, 1>>();
+        table[0x4C] = Single<&Instructions::BIT<Register::H, 1>>();
+        table[0x4D] = Single<&Instructions::BIT<Register::L, 1>>();
+        table[0x4E] = Cycled([]<uint8_t C> { return &Instructions::BITAddr<1, C>; });
+        table[0x4F] = Single<&Instructions::BIT<Register::A, 1>>();
+        table[0x50] = Single<&Instructions::BIT<Register::B, 2>>();
+        table[0x51] = Single<&Instructions::BIT<Register::C, 2>>();
+        table[0x52] = Single<&Instructions::BIT<Register::D, 2>>();
+        table[0x53] = Single<&Instructions::BIT<Register::E, 2>>();
+        table[0x54] = Single<&Instructions::BIT<Register::H, 2>>();
+        table[0x55] = Single<&Instructions::BIT<Register::L, 2>>();
+        table[0x56] = Cycled([]<uint8_t C> { return &Instructions::BITAddr<2, C>; });
+        table[0x57] = Single<&Instructions::BIT<Register::A, 2>>();
+        table[0x58] = Single<&Instructions::BIT<Register::B, 3>>();
+        table[0x59] = Single<&Instructions::BIT<Register::C, 3>>();
+        table[0x5A] = Single<&Instructions::BIT<Register::D, 3>>();
+        table[0x5B] = Single<&Instructions::BIT<Register::E, 3>>();
+        table[0x5C] = Single<&Instructions::BIT<Register::H, 3>>();
+        table[0x5D] = Single<&Instructions::BIT<Register::L, 3>>();
+        table[0x5E] = Cycled([]<uint8_t C> { return &Instructions::BITAddr<3, C>; });
+        table[0x5F] = Single<&Instructions::BIT<Register::A, 3>>();
+        table[0x60] = Single<&Instructions::BIT<Register::B, 4>>();
+        table[0x61] = Single<&Instructions::BIT<Register::C, 4>>();
+        table[0x62] = Single<&Instructions::BIT<Register::D, 4>>();
+        table[0x63] = Single<&Instructions::BIT<Register::E, 4>>();
+        table[0x64] = Single<&Instructions::BIT<Register::H, 4>>();
+        table[0x65] = Single<&Instructions::BIT<Register::L, 4>>();
+        table[0x66] = Cycled([]<uint8_t C> { return &Instructions::BITAddr<4, C>; });
+        table[0x67] = Single<&Instructions::BIT<Register::A, 4>>();
+        table[0x68] = Single<&Instructions::BIT<Register::B, 5>>();
+        table[0x69] = Single<&Instructions::BIT<Register::C, 5>>();
+        table[0x6A] = Single<&Instructions::BIT<Register::D, 5>>();
+        table[0x6B] = Single<&Instructions::BIT<Register::E, 5>>();
+        table[0x6C] = Single<&Instructions::BIT<Register::H, 5>>();
+        table[0x6D] = Single<&Instructions::BIT<Register::L, 5>>();
+        table[0x6E] = Cycled([]<uint8_t C> { return &Instructions::BITAddr<5, C>; });
+        table[0x6F] = Single<&Instructions::BIT<Register::A, 5>>();
+        table[0x70] = Single<&Instructions::BIT<Register::B, 6>>();
+        table[0x71] = Single<&Instructions::BIT<Register::C, 6>>();
+        table[0x72] = Single<&Instructions::BIT<Register::D, 6>>();
+        table[0x73] = Single<&Instructions::BIT<Register::E, 6>>();
+        table[0x74] = Single<&Instructions::BIT<Register::H, 6>>();
+        table[0x75] = Single<&Instructions::BIT<Register::L, 6>>();
+        table[0x76] = Cycled([]<uint8_t C> { return &Instructions::BITAddr<6, C>; });
+        table[0x77] = Single<&Instructions::BIT<Register::A, 6>>();
+        table[0x78] = Single<&Instructions::BIT<Register::B, 7>>();
+        table[0x79] = Single<&Instructions::BIT<Register::C, 7>>();
+        table[0x7A] = Single<&Instructions::BIT<Register::D, 7>>();
+        table[0x7B] = Single<&Instructions::BIT<Register::E, 7>>();
+        table[0x7C] = Single<&Instructions::BIT<Register::H, 7>>();
+        table[0x7D] = Single<&Instructions::BIT<Register::L, 7>>();
+        table[0x7E] = Cycled([]<uint8_t C> { return &Instructions::BITAddr<7, C>; });
+        table[0x7F] = Single<&Instructions::BIT<Register::A, 7>>();
+        table[0x80] = Single<&Instructions::RES<Register::B, 0>>();
+        table[0x81] = Single<&Instructions::RES<Register::C, 0>>();
+        table[0x82] = Single<&Instructions::RES<Register::D, 0>>();
+        table[0x83] = Single<&Instructions::RES<Register::E, 0>>();
+        table[0x84] = Single<&Instructions::RES<Register::H, 0>>();
+        table[0x85] = Single<&Instructions::RES<Register::L, 0>>();
+        table[0x86] = Cycled([]<uint8_t C> { return &Instructions::RESAddr<0, C>; });
+        table[0x87] = Single<&Instructions::RES<Register::A, 0>>();
+        table[0x88] = Single<&Instructions::RES<Register::B, 1>>();
+        table[0x89] = Single<&Instructions::RES<Register::C, 1>>();
+        table[0x8A] = Single<&Instructions::RES<Register::D, 1>>();
+        table[0x8B] = Single<&Instructions::RES<Register::E, 1>>();
+        table[0x8C] = Single<&Instructions::RES<Register::H, 1>>();
+        table[0x8D] = Single<&Instructions::RES<Register::L, 1>>();
+        table[0x8E] = Cycled([]<uint8_t C> { return &Instructions::RESAddr<1, C>; });
+        table[0x8F] = Single<&Instructions::RES<Register::A, 1>>();
+        table[0x90] = Single<&Instructions::RES<Register::B, 2>>();
+        table[0x91] = Single<&Instructions::RES<Register::C, 2>>();
+        table[0x92] = Single<&Instructions::RES<Register::D, 2>>();
+        table[0x93] = Single<&Instructions::RES<Register::E, 2>>();
+        table[0x94] = Single<&Instructions::RES<Register::H, 2>>();
+        table[0x95] = Single<&Instructions::RES<Register::L, 2>>();
+        table[0x96] = Cycled([]<uint8_t C> { return &Instructions::RESAddr<2, C>; });
+        table[0x97] = Single<&Instructions::RES<Register::A, 2>>();
+        table[0x98] = Single<&Instructions::RES<Register::B, 3>>();
+        table[0x99] = Single<&Instructions::RES<Register::C, 3>>();
+        table[0x9A] = Single<&Instructions::RES<Register::D, 3>>();
+        table[0x9B] = Single<&Instructions::RES<Register::E, 3>>();
+        table[0x9C] = Single<&Instructions::RES<Register::H, 3>>();
+        table[0x9D] = Single<&Instructions::RES<Register::L, 3>>();
+        table[0x9E] = Cycled([]<uint8_t C> { return &Instructions::RESAddr<3, C>; });
+        table[0x9F] = Single<&Instructions::RES<Register::A, 3>>();
+        table[0xA0] = Single<&Instructions::RES<Register::B, 4>>();
+        table[0xA1] = Single<&Instructions::RES<Register::C, 4>>();
+        table[0xA2] = Single<&Instructions::RES<Register::D, 4>>();
+        table[0xA3] = Single<&Instructions::RES<Register::E, 4>>();
+        table[0xA4] = Single<&Instructions::RES<Register::H, 4>>();
+        table[0xA5] = Single<&Instructions::RES<Register::L, 4>>();
+        table[0xA6] = Cycled([]<uint8_t C> { return &Instructions::RESAddr<4, C>; });
+        table[0xA7] = Single<&Instructions::RES<Register::A, 4>>();
+        table[0xA8] = Single<&Instructions::RES<Register::B, 5>>();
+        table[0xA9] = Single<&Instructions::RES<Register::C, 5>>();
+        table[0xAA] = Single<&Instructions::RES<Register::D, 5>>();
+        table[0xAB] = Single<&Instructions::RES<Register::E, 5>>();
+        table[0xAC] = Single<&Instructions::RES<Register::H, 5>>();
+        table[0xAD] = Single<&Instructions::RES<Register::L, 5>>();
+        table[0xAE] = Cycled([]<uint8_t C> { return &Instructions::RESAddr<5, C>; });
+        table[0xAF] = Single<&Instructions::RES<Register::A, 5>>();
+        table[0xB0] = Single<&Instructions::RES<Register::B, 6>>();
+        table[0xB1] = Single<&Instructions::RES<Register::C, 6>>();
+        table[0xB2] = Single<&Instructions::RES<Register::D, 6>>();
+        table[0xB3] = Single<&Instructions::RES<Register::E, 6>>();
+        table[0xB4] = Single<&Instructions::RES<Register::H, 6>>();
+        table[0xB5] = Single<&Instructions::RES<Register::L, 6>>();
+        table[0xB6] = Cycled([]<uint8_t C> { return &Instructions::RESAddr<6, C>; });
+        table[0xB7] = Single<&Instructions::RES<Register::A, 6>>();
+        table[0xB8] = Single<&Instructions::RES<Register::B, 7>>();
+        table[0xB9] = Single<&Instructions::RES<Register::C, 7>>();
+        table[0xBA] = Single<&Instructions::RES<Register::D, 7>>();
+        table[0xBB] = Single<&Instructions::RES<Register::E, 7>>();
+        table[0xBC] = Single<&Instructions::RES<Register::H, 7>>();
+        table[0xBD] = Single<&Instructions::RES<Register::L, 7>>();
+        table[0xBE] = Cycled([]<uint8_t C> { return &Instructions::RESAddr<7, C>; });
+        table[0xBF] = Single<&Instructions::RES<Register::A, 7>>();
+        table[0xC0] = Single<&Instructions::SET<Register::B, 0>>();
+        table[0xC1] = Single<&Instructions::SET<Register::C, 0>>();
+        table[0xC2] = Single<&Instructions::SET<Register::D, 0>>();
+        table[0xC3] = Single<&Instructions::SET<Register::E, 0>>();
+        table[0xC4] = Single<&Instructions::SET<Register::H, 0>>();
+        table[0xC5] = Single<&Instructions::SET<Register::L, 0>>();
+        table[0xC6] = Cycled([]<uint8_t C> { return &Instructions::SETAddr<0, C>; });
+        table[0xC7] = Single<&Instructions::SET<Register::A, 0>>();
+        table[0xC8] = Single<&Instructions::SET<Register::B, 1>>();
+        table[0xC9] = Single<&Instructions::SET<Register::C, 1>>();
+        table[0xCA] = Single<&Instructions::SET<Register::D, 1>>();
+        table[0xCB] = Single<&Instructions::SET<Register::E, 1>>();
+        table[0xCC] = Single<&Instructions::SET<Register::H, 1>>();
+        table[0xCD] = Single<&Instructions::SET<Register::L, 1>>();
+        table[0xCE] = Cycled([]<uint8_t C> { return &Instructions::SETAddr<1, C>; });
+        table[0xCF] = Single<&Instructions::SET<Register::A, 1>>();
+        table[0xD0] = Single<&Instructions::SET<Register::B, 2>>();
+        table[0xD1] = Single<&Instructions::SET<Register::C, 2>>();
+        table[0xD2] = Single<&Instructions::SET<Register::D, 2>>();
+        table[0xD3] = Single<&Instructions::SET<Register::E, 2>>();
+        table[0xD4] = Single<&Instructions::SET<Register::H, 2>>();
+        table[0xD5] = Single<&Instructions::SET<Register::L, 2>>();
+        table[0xD6] = Cycled([]<uint8_t C> { return &Instructions::SETAddr<2, C>; });
+        table[0xD7] = Single<&Instructions::SET<Register::A, 2>>();
+        table[0xD8] = Single<&Instructions::SET<Register::B, 3>>();
+        table[0xD9] = Single<&Instructions::SET<Register::C, 3>>();
+        table[0xDA] = Single<&Instructions::SET<Register::D, 3>>();
+        table[0xDB] = Single<&Instructions::SET<Register::E, 3>>();
+        table[0xDC] = Single<&Instructions::SET<Register::H, 3>>();
+        table[0xDD] = Single<&Instructions::SET<Register::L, 3>>();
+        table[0xDE] = Cycled([]<uint8_t C> { return &Instructions::SETAddr<3, C>; });
+        table[0xDF] = Single<&Instructions::SET<Register::A, 3>>();
+        table[0xE0] = Single<&Instructions::SET<Register::B, 4>>();
+        table[0xE1] = Single<&Instructions::SET<Register::C, 4>>();
+        table[0xE2] = Single<&Instructions::SET<Register::D, 4>>();
+        table[0xE3] = Single<&Instructions::SET<Register::E, 4>>();
+        table[0xE4] = Single<&Instructions::SET<Register::H, 4>>();
+        table[0xE5] = Single<&Instructions::SET<Register::L, 4>>();
+        table[0xE6] = Cycled([]<uint8_t C> { return &Instructions::SETAddr<4, C>; });
+        table[0xE7] = Single<&Instructions::SET<Register::A, 4>>();
+        table[0xE8] = Single<&Instructions::SET<Register::B, 5>>();
+        table[0xE9] = Single<&Instructions::SET<Register::C, 5>>();
+        table[0xEA] = Single<&Instructions::SET<Register::D, 5>>();
+        table[0xEB] = Single<&Instructions::SET<Register::E, 5>>();
+        table[0xEC] = Single<&Instructions::SET<Register::H, 5>>();
+        table[0xED] = Single<&Instructions::SET<Register::L, 5>>();
+        table[0xEE] = Cycled([]<uint8_t C> { return &Instructions::SETAddr<5, C>; });
+        table[0xEF] = Single<&Instructions::SET<Register::A, 5>>();
+        table[0xF0] = Single<&Instructions::SET<Register::B, 6>>();
+        table[0xF1] = Single<&Instructions::SET<Register::C, 6>>();
+        table[0xF2] = Single<&Instructions::SET<Register::D, 6>>();
+        table[0xF3] = Single<&Instructions::SET<Register::E, 6>>();
+        table[0xF4] = Single<&Instructions::SET<Register::H, 6>>();
+        table[0xF5] = Single<&Instructions::SET<Register::L, 6>>();
+        table[0xF6] = Cycled([]<uint8_t C> { return &Instructions::SETAddr<6, C>; });
+        table[0xF7] = Single<&Instructions::SET<Register::A, 6>>();
+        table[0xF8] = Single<&Instructions::SET<Register::B, 7>>();
+        table[0xF9] = Single<&Instructions::SET<Register::C, 7>>();
+        table[0xFA] = Single<&Instructions::SET<Register::D, 7>>();
+        table[0xFB] = Single<&Instructions::SET<Register::E, 7>>();
+        table[0xFC] = Single<&Instructions::SET<Register::H, 7>>();
+        table[0xFD] = Single<&Instructions::SET<Register::L, 7>>();
+        table[0xFE] = Cycled([]<uint8_t C> { return &Instructions::SETAddr<7, C>; });
+        table[0xFF] = Single<&Instructions::SET<Register::A, 7>>();
         return table;
     }();
 
-    const std::array<WrappedFunction, 256> nonPrefixedTable = [this] {
-        std::array<WrappedFunction, 256> table{};
-        table[0x00] = [this](CPUType &cpu) -> bool { return this->NOP(cpu); };
-        table[0x01] = [this](CPUType &cpu) -> bool { return this->LD16Register<LoadWordTarget::BC>(cpu); };
-        table[0x02] = [this](CPUType &cpu) -> bool { return this->LDFromAccBC(cpu); };
-        table[0x03] = [this](CPUType &cpu) -> bool { return this->INC16<Arithmetic16Target::BC>(cpu); };
-        table[0x04] = [this](CPUType &cpu) -> bool { return this->INCRegister<Register::B>(cpu); };
-        table[0x05] = [this](CPUType &cpu) -> bool { return this->DECRegister<Register::B>(cpu); };
-        table[0x06] = [this](CPUType &cpu) -> bool { return this->LDRegisterImmediate<Register::B>(cpu); };
-        table[0x07] = [this](CPUType &cpu) -> bool { return this->RLCA(cpu); };
-        table[0x08] = [this](CPUType &cpu) -> bool { return this->LD16FromStack(cpu); };
-        table[0x09] = [this](CPUType &cpu) -> bool { return this->ADD16<Arithmetic16Target::BC>(cpu); };
-        table[0x10] = [this](CPUType &cpu) -> bool { return this->STOP(cpu); };
-        table[0x0A] = [this](CPUType &cpu) -> bool { return this->LDAccumulatorBC(cpu); };
-        table[0x0B] = [this](CPUType &cpu) -> bool { return this->DEC16<Arithmetic16Target::BC>(cpu); };
-        table[0x0C] = [this](CPUType &cpu) -> bool { return this->INCRegister<Register::C>(cpu); };
-        table[0x0D] = [this](CPUType &cpu) -> bool { return this->DECRegister<Register::C>(cpu); };
-        table[0x0E] = [this](CPUType &cpu) -> bool { return this->LDRegisterImmediate<Register::C>(cpu); };
-        table[0x0F] = [this](CPUType &cpu) -> bool { return this->RRCA(cpu); };
-        table[0x11] = [this](CPUType &cpu) -> bool { return this->LD16Register<LoadWordTarget::DE>(cpu); };
-        table[0x12] = [this](CPUType &cpu) -> bool { return this->LDFromAccDE(cpu); };
-        table[0x13] = [this](CPUType &cpu) -> bool { return this->INC16<Arithmetic16Target::DE>(cpu); };
-        table[0x14] = [this](CPUType &cpu) -> bool { return this->INCRegister<Register::D>(cpu); };
-        table[0x15] = [this](CPUType &cpu) -> bool { return this->DECRegister<Register::D>(cpu); };
-        table[0x16] = [this](CPUType &cpu) -> bool { return this->LDRegisterImmediate<Register::D>(cpu); };
-        table[0x17] = [this](CPUType &cpu) -> bool { return this->RLA(cpu); };
-        table[0x18] = [this](CPUType &cpu) -> bool { return this->JRUnconditional(cpu); };
-        table[0x19] = [this](CPUType &cpu) -> bool { return this->ADD16<Arithmetic16Target::DE>(cpu); };
-        table[0x1A] = [this](CPUType &cpu) -> bool { return this->LDAccumulatorDE(cpu); };
-        table[0x1B] = [this](CPUType &cpu) -> bool { return this->DEC16<Arithmetic16Target::DE>(cpu); };
-        table[0x1C] = [this](CPUType &cpu) -> bool { return this->INCRegister<Register::E>(cpu); };
-        table[0x1D] = [this](CPUType &cpu) -> bool { return this->DECRegister<Register::E>(cpu); };
-        table[0x1E] = [this](CPUType &cpu) -> bool { return this->LDRegisterImmediate<Register::E>(cpu); };
-        table[0x1F] = [this](CPUType &cpu) -> bool { return this->RRA(cpu); };
-        table[0x20] = [this](CPUType &cpu) -> bool { return this->JR<JumpTest::NotZero>(cpu); };
-        table[0x21] = [this](CPUType &cpu) -> bool { return this->LD16Register<LoadWordTarget::HL>(cpu); };
-        table[0x22] = [this](CPUType &cpu) -> bool { return this->LDFromAccumulatorIndirectInc(cpu); };
-        table[0x23] = [this](CPUType &cpu) -> bool { return this->INC16<Arithmetic16Target::HL>(cpu); };
-        table[0x24] = [this](CPUType &cpu) -> bool { return this->INCRegister<Register::H>(cpu); };
-        table[0x25] = [this](CPUType &cpu) -> bool { return this->DECRegister<Register::H>(cpu); };
-        table[0x26] = [this](CPUType &cpu) -> bool { return this->LDRegisterImmediate<Register::H>(cpu); };
-        table[0x27] = [this](CPUType &cpu) -> bool { return this->DAA(cpu); };
-        table[0x28] = [this](CPUType &cpu) -> bool { return this->JR<JumpTest::Zero>(cpu); };
-        table[0x29] = [this](CPUType &cpu) -> bool { return this->ADD16<Arithmetic16Target::HL>(cpu); };
-        table[0x2A] = [this](CPUType &cpu) -> bool { return this->LDAccumulatorIndirectInc(cpu); };
-        table[0x2B] = [this](CPUType &cpu) -> bool { return this->DEC16<Arithmetic16Target::HL>(cpu); };
-        table[0x2C] = [this](CPUType &cpu) -> bool { return this->INCRegister<Register::L>(cpu); };
-        table[0x2D] = [this](CPUType &cpu) -> bool { return this->DECRegister<Register::L>(cpu); };
-        table[0x2E] = [this](CPUType &cpu) -> bool { return this->LDRegisterImmediate<Register::L>(cpu); };
-        table[0x2F] = [this](CPUType &cpu) -> bool { return this->CPL(cpu); };
-        table[0x30] = [this](CPUType &cpu) -> bool { return this->JR<JumpTest::NotCarry>(cpu); };
-        table[0x31] = [this](CPUType &cpu) -> bool { return this->LD16Register<LoadWordTarget::SP>(cpu); };
-        table[0x32] = [this](CPUType &cpu) -> bool { return this->LDFromAccumulatorIndirectDec(cpu); };
-        table[0x33] = [this](CPUType &cpu) -> bool { return this->INC16<Arithmetic16Target::SP>(cpu); };
-        table[0x34] = [this](CPUType &cpu) -> bool { return this->INCIndirect(cpu); };
-        table[0x35] = [this](CPUType &cpu) -> bool { return this->DECIndirect(cpu); };
-        table[0x36] = [this](CPUType &cpu) -> bool { return this->LDAddrImmediate(cpu); };
-        table[0x37] = [this](CPUType &cpu) -> bool { return this->SCF(cpu); };
-        table[0x38] = [this](CPUType &cpu) -> bool { return this->JR<JumpTest::Carry>(cpu); };
-        table[0x39] = [this](CPUType &cpu) -> bool { return this->ADD16<Arithmetic16Target::SP>(cpu); };
-        table[0x3A] = [this](CPUType &cpu) -> bool { return this->LDAccumulatorIndirectDec(cpu); };
-        table[0x3B] = [this](CPUType &cpu) -> bool { return this->DEC16<Arithmetic16Target::SP>(cpu); };
-        table[0x3C] = [this](CPUType &cpu) -> bool { return this->INCRegister<Register::A>(cpu); };
-        table[0x3D] = [this](CPUType &cpu) -> bool { return this->DECRegister<Register::A>(cpu); };
-        table[0x3E] = [this](CPUType &cpu) -> bool { return this->LDRegisterImmediate<Register::A>(cpu); };
-        table[0x3F] = [this](CPUType &cpu) -> bool { return this->CCF(cpu); };
-        table[0x40] = [this](CPUType &cpu) -> bool { return this->LDRegister<Register::B, Register::B>(cpu); };
-        table[0x41] = [this](CPUType &cpu) -> bool { return this->LDRegister<Register::B, Register::C>(cpu); };
-        table[0x42] = [this](CPUType &cpu) -> bool { return this->LDRegister<Register::B, Register::D>(cpu); };
-        table[0x43] = [this](CPUType &cpu) -> bool { return this->LDRegister<Register::B, Register::E>(cpu); };
-        table[0x44] = [this](CPUType &cpu) -> bool { return this->LDRegister<Register::B, Register::H>(cpu); };
-        table[0x45] = [this](CPUType &cpu) -> bool { return this->LDRegister<Register::B, Register::L>(cpu); };
-        table[0x46] = [this](CPUType &cpu) -> bool { return this->LDRegisterIndirect<Register::B>(cpu); };
-        table[0x47] = [this](CPUType &cpu) -> bool { return this->LDRegister<Register::B, Register::A>(cpu); };
-        table[0x48] = [this](CPUType &cpu) -> bool { return this->LDRegister<Register::C, Register::B>(cpu); };
-        table[0x49] = [this](CPUType &cpu) -> bool { return this->LDRegister<Register::C, Register::C>(cpu); };
-        table[0x4A] = [this](CPUType &cpu) -> bool { return this->LDRegister<Register::C, Register::D>(cpu); };
-        table[0x4B] = [this](CPUType &cpu) -> bool { return this->LDRegister<Register::C, Register::E>(cpu); };
-        table[0x4C] = [this](CPUType &cpu) -> bool { return this->LDRegister<Register::C, Register::H>(cpu); };
-        table[0x4D] = [this](CPUType &cpu) -> bool { return this->LDRegister<Register::C, Register::L>(cpu); };
-        table[0x4E] = [this](CPUType &cpu) -> bool { return this->LDRegisterIndirect<Register::C>(cpu); };
-        table[0x4F] = [this](CPUType &cpu) -> bool { return this->LDRegister<Register::C, Register::A>(cpu); };
-        table[0x50] = [this](CPUType &cpu) -> bool { return this->LDRegister<Register::D, Register::B>(cpu); };
-        table[0x51] = [this](CPUType &cpu) -> bool { return this->LDRegister<Register::D, Register::C>(cpu); };
-        table[0x52] = [this](CPUType &cpu) -> bool { return this->LDRegister<Register::D, Register::D>(cpu); };
-        table[0x53] = [this](CPUType &cpu) -> bool { return this->LDRegister<Register::D, Register::E>(cpu); };
-        table[0x54] = [this](CPUType &cpu) -> bool { return this->LDRegister<Register::D, Register::H>(cpu); };
-        table[0x55] = [this](CPUType &cpu) -> bool { return this->LDRegister<Register::D, Register::L>(cpu); };
-        table[0x56] = [this](CPUType &cpu) -> bool { return this->LDRegisterIndirect<Register::D>(cpu); };
-        table[0x57] = [this](CPUType &cpu) -> bool { return this->LDRegister<Register::D, Register::A>(cpu); };
-        table[0x58] = [this](CPUType &cpu) -> bool { return this->LDRegister<Register::E, Register::B>(cpu); };
-        table[0x59] = [this](CPUType &cpu) -> bool { return this->LDRegister<Register::E, Register::C>(cpu); };
-        table[0x5A] = [this](CPUType &cpu) -> bool { return this->LDRegister<Register::E, Register::D>(cpu); };
-        table[0x5B] = [this](CPUType &cpu) -> bool { return this->LDRegister<Register::E, Register::E>(cpu); };
-        table[0x5C] = [this](CPUType &cpu) -> bool { return this->LDRegister<Register::E, Register::H>(cpu); };
-        table[0x5D] = [this](CPUType &cpu) -> bool { return this->LDRegister<Register::E, Register::L>(cpu); };
-        table[0x5E] = [this](CPUType &cpu) -> bool { return this->LDRegisterIndirect<Register::E>(cpu); };
-        table[0x5F] = [this](CPUType &cpu) -> bool { return this->LDRegister<Register::E, Register::A>(cpu); };
-        table[0x60] = [this](CPUType &cpu) -> bool { return this->LDRegister<Register::H, Register::B>(cpu); };
-        table[0x61] = [this](CPUType &cpu) -> bool { return this->LDRegister<Register::H, Register::C>(cpu); };
-        table[0x62] = [this](CPUType &cpu) -> bool { return this->LDRegister<Register::H, Register::D>(cpu); };
-        table[0x63] = [this](CPUType &cpu) -> bool { return this->LDRegister<Register::H, Register::E>(cpu); };
-        table[0x64] = [this](CPUType &cpu) -> bool { return this->LDRegister<Register::H, Register::H>(cpu); };
-        table[0x65] = [this](CPUType &cpu) -> bool { return this->LDRegister<Register::H, Register::L>(cpu); };
-        table[0x66] = [this](CPUType &cpu) -> bool { return this->LDRegisterIndirect<Register::H>(cpu); };
-        table[0x67] = [this](CPUType &cpu) -> bool { return this->LDRegister<Register::H, Register::A>(cpu); };
-        table[0x68] = [this](CPUType &cpu) -> bool { return this->LDRegister<Register::L, Register::B>(cpu); };
-        table[0x69] = [this](CPUType &cpu) -> bool { return this->LDRegister<Register::L, Register::C>(cpu); };
-        table[0x6A] = [this](CPUType &cpu) -> bool { return this->LDRegister<Register::L, Register::D>(cpu); };
-        table[0x6B] = [this](CPUType &cpu) -> bool { return this->LDRegister<Register::L, Register::E>(cpu); };
-        table[0x6C] = [this](CPUType &cpu) -> bool { return this->LDRegister<Register::L, Register::H>(cpu); };
-        table[0x6D] = [this](CPUType &cpu) -> bool { return this->LDRegister<Register::L, Register::L>(cpu); };
-        table[0x6E] = [this](CPUType &cpu) -> bool { return this->LDRegisterIndirect<Register::L>(cpu); };
-        table[0x6F] = [this](CPUType &cpu) -> bool { return this->LDRegister<Register::L, Register::A>(cpu); };
-        table[0x70] = [this](CPUType &cpu) -> bool { return this->LDAddrRegister<Register::B>(cpu); };
-        table[0x71] = [this](CPUType &cpu) -> bool { return this->LDAddrRegister<Register::C>(cpu); };
-        table[0x72] = [this](CPUType &cpu) -> bool { return this->LDAddrRegister<Register::D>(cpu); };
-        table[0x73] = [this](CPUType &cpu) -> bool { return this->LDAddrRegister<Register::E>(cpu); };
-        table[0x74] = [this](CPUType &cpu) -> bool { return this->LDAddrRegister<Register::H>(cpu); };
-        table[0x75] = [this](CPUType &cpu) -> bool { return this->LDAddrRegister<Register::L>(cpu); };
-        table[0x76] = [this](CPUType &cpu) -> bool { return this->HALT(cpu); };
-        table[0x77] = [this](CPUType &cpu) -> bool { return this->LDAddrRegister<Register::A>(cpu); };
-        table[0x78] = [this](CPUType &cpu) -> bool { return this->LDRegister<Register::A, Register::B>(cpu); };
-        table[0x79] = [this](CPUType &cpu) -> bool { return this->LDRegister<Register::A, Register::C>(cpu); };
-        table[0x7A] = [this](CPUType &cpu) -> bool { return this->LDRegister<Register::A, Register::D>(cpu); };
-        table[0x7B] = [this](CPUType &cpu) -> bool { return this->LDRegister<Register::A, Register::E>(cpu); };
-        table[0x7C] = [this](CPUType &cpu) -> bool { return this->LDRegister<Register::A, Register::H>(cpu); };
-        table[0x7D] = [this](CPUType &cpu) -> bool { return this->LDRegister<Register::A, Register::L>(cpu); };
-        table[0x7E] = [this](CPUType &cpu) -> bool { return this->LDRegisterIndirect<Register::A>(cpu); };
-        table[0x7F] = [this](CPUType &cpu) -> bool { return this->LDRegister<Register::A, Register::A>(cpu); };
-        table[0x80] = [this](CPUType &cpu) -> bool { return this->ADDRegister<Register::B>(cpu); };
-        table[0x81] = [this](CPUType &cpu) -> bool { return this->ADDRegister<Register::C>(cpu); };
-        table[0x82] = [this](CPUType &cpu) -> bool { return this->ADDRegister<Register::D>(cpu); };
-        table[0x83] = [this](CPUType &cpu) -> bool { return this->ADDRegister<Register::E>(cpu); };
-        table[0x84] = [this](CPUType &cpu) -> bool { return this->ADDRegister<Register::H>(cpu); };
-        table[0x85] = [this](CPUType &cpu) -> bool { return this->ADDRegister<Register::L>(cpu); };
-        table[0x86] = [this](CPUType &cpu) -> bool { return this->ADDIndirect(cpu); };
-        table[0x87] = [this](CPUType &cpu) -> bool { return this->ADDRegister<Register::A>(cpu); };
-        table[0x88] = [this](CPUType &cpu) -> bool { return this->ADCRegister<Register::B>(cpu); };
-        table[0x89] = [this](CPUType &cpu) -> bool { return this->ADCRegister<Register::C>(cpu); };
-        table[0x8A] = [this](CPUType &cpu) -> bool { return this->ADCRegister<Register::D>(cpu); };
-        table[0x8B] = [this](CPUType &cpu) -> bool { return this->ADCRegister<Register::E>(cpu); };
-        table[0x8C] = [this](CPUType &cpu) -> bool { return this->ADCRegister<Register::H>(cpu); };
-        table[0x8D] = [this](CPUType &cpu) -> bool { return this->ADCRegister<Register::L>(cpu); };
-        table[0x8E] = [this](CPUType &cpu) -> bool { return this->ADCIndirect(cpu); };
-        table[0x8F] = [this](CPUType &cpu) -> bool { return this->ADCRegister<Register::A>(cpu); };
-        table[0x90] = [this](CPUType &cpu) -> bool { return this->SUB<Register::B>(cpu); };
-        table[0x91] = [this](CPUType &cpu) -> bool { return this->SUB<Register::C>(cpu); };
-        table[0x92] = [this](CPUType &cpu) -> bool { return this->SUB<Register::D>(cpu); };
-        table[0x93] = [this](CPUType &cpu) -> bool { return this->SUB<Register::E>(cpu); };
-        table[0x94] = [this](CPUType &cpu) -> bool { return this->SUB<Register::H>(cpu); };
-        table[0x95] = [this](CPUType &cpu) -> bool { return this->SUB<Register::L>(cpu); };
-        table[0x96] = [this](CPUType &cpu) -> bool { return this->SUBIndirect(cpu); };
-        table[0x97] = [this](CPUType &cpu) -> bool { return this->SUB<Register::A>(cpu); };
-        table[0x98] = [this](CPUType &cpu) -> bool { return this->SBCRegister<Register::B>(cpu); };
-        table[0x99] = [this](CPUType &cpu) -> bool { return this->SBCRegister<Register::C>(cpu); };
-        table[0x9A] = [this](CPUType &cpu) -> bool { return this->SBCRegister<Register::D>(cpu); };
-        table[0x9B] = [this](CPUType &cpu) -> bool { return this->SBCRegister<Register::E>(cpu); };
-        table[0x9C] = [this](CPUType &cpu) -> bool { return this->SBCRegister<Register::H>(cpu); };
-        table[0x9D] = [this](CPUType &cpu) -> bool { return this->SBCRegister<Register::L>(cpu); };
-        table[0x9E] = [this](CPUType &cpu) -> bool { return this->SBCIndirect(cpu); };
-        table[0x9F] = [this](CPUType &cpu) -> bool { return this->SBCRegister<Register::A>(cpu); };
-        table[0xA0] = [this](CPUType &cpu) -> bool { return this->AND<Register::B>(cpu); };
-        table[0xA1] = [this](CPUType &cpu) -> bool { return this->AND<Register::C>(cpu); };
-        table[0xA2] = [this](CPUType &cpu) -> bool { return this->AND<Register::D>(cpu); };
-        table[0xA3] = [this](CPUType &cpu) -> bool { return this->AND<Register::E>(cpu); };
-        table[0xA4] = [this](CPUType &cpu) -> bool { return this->AND<Register::H>(cpu); };
-        table[0xA5] = [this](CPUType &cpu) -> bool { return this->AND<Register::L>(cpu); };
-        table[0xA6] = [this](CPUType &cpu) -> bool { return this->ANDIndirect(cpu); };
-        table[0xA7] = [this](CPUType &cpu) -> bool { return this->AND<Register::A>(cpu); };
-        table[0xA8] = [this](CPUType &cpu) -> bool { return this->XORRegister<Register::B>(cpu); };
-        table[0xA9] = [this](CPUType &cpu) -> bool { return this->XORRegister<Register::C>(cpu); };
-        table[0xAA] = [this](CPUType &cpu) -> bool { return this->XORRegister<Register::D>(cpu); };
-        table[0xAB] = [this](CPUType &cpu) -> bool { return this->XORRegister<Register::E>(cpu); };
-        table[0xAC] = [this](CPUType &cpu) -> bool { return this->XORRegister<Register::H>(cpu); };
-        table[0xAD] = [this](CPUType &cpu) -> bool { return this->XORRegister<Register::L>(cpu); };
-        table[0xAE] = [this](CPUType &cpu) -> bool { return this->XORIndirect(cpu); };
-        table[0xAF] = [this](CPUType &cpu) -> bool { return this->XORRegister<Register::A>(cpu); };
-        table[0xB0] = [this](CPUType &cpu) -> bool { return this->ORRegister<Register::B>(cpu); };
-        table[0xB1] = [this](CPUType &cpu) -> bool { return this->ORRegister<Register::C>(cpu); };
-        table[0xB2] = [this](CPUType &cpu) -> bool { return this->ORRegister<Register::D>(cpu); };
-        table[0xB3] = [this](CPUType &cpu) -> bool { return this->ORRegister<Register::E>(cpu); };
-        table[0xB4] = [this](CPUType &cpu) -> bool { return this->ORRegister<Register::H>(cpu); };
-        table[0xB5] = [this](CPUType &cpu) -> bool { return this->ORRegister<Register::L>(cpu); };
-        table[0xB6] = [this](CPUType &cpu) -> bool { return this->ORIndirect(cpu); };
-        table[0xB7] = [this](CPUType &cpu) -> bool { return this->ORRegister<Register::A>(cpu); };
-        table[0xB8] = [this](CPUType &cpu) -> bool { return this->CPRegister<Register::B>(cpu); };
-        table[0xB9] = [this](CPUType &cpu) -> bool { return this->CPRegister<Register::C>(cpu); };
-        table[0xBA] = [this](CPUType &cpu) -> bool { return this->CPRegister<Register::D>(cpu); };
-        table[0xBB] = [this](CPUType &cpu) -> bool { return this->CPRegister<Register::E>(cpu); };
-        table[0xBC] = [this](CPUType &cpu) -> bool { return this->CPRegister<Register::H>(cpu); };
-        table[0xBD] = [this](CPUType &cpu) -> bool { return this->CPRegister<Register::L>(cpu); };
-        table[0xBE] = [this](CPUType &cpu) -> bool { return this->CPIndirect(cpu); };
-        table[0xBF] = [this](CPUType &cpu) -> bool { return this->CPRegister<Register::A>(cpu); };
-        table[0xC0] = [this](CPUType &cpu) -> bool { return this->RETConditional<JumpTest::NotZero>(cpu); };
-        table[0xC1] = [this](CPUType &cpu) -> bool { return this->POP<StackTarget::BC>(cpu); };
-        table[0xC2] = [this](CPUType &cpu) -> bool { return this->JP<JumpTest::NotZero>(cpu); };
-        table[0xC3] = [this](CPUType &cpu) -> bool { return this->JPUnconditional(cpu); };
-        table[0xC4] = [this](CPUType &cpu) -> bool { return this->CALL<JumpTest::NotZero>(cpu); };
-        table[0xC5] = [this](CPUType &cpu) -> bool { return this->PUSH<StackTarget::BC>(cpu); };
-        table[0xC6] = [this](CPUType &cpu) -> bool { return this->ADDImmediate(cpu); };
-        table[0xC7] = [this](CPUType &cpu) -> bool { return this->RST<RSTTarget::H00>(cpu); };
-        table[0xC8] = [this](CPUType &cpu) -> bool { return this->RETConditional<JumpTest::Zero>(cpu); };
-        table[0xC9] = [this](CPUType &cpu) -> bool { return this->RETUnconditional(cpu); };
-        table[0xCA] = [this](CPUType &cpu) -> bool { return this->JP<JumpTest::Zero>(cpu); };
-        table[0xCB] = [this](CPUType &cpu) -> bool { return this->PREFIX(cpu); };
-        table[0xCC] = [this](CPUType &cpu) -> bool { return this->CALL<JumpTest::Zero>(cpu); };
-        table[0xCD] = [this](CPUType &cpu) -> bool { return this->CALLUnconditional(cpu); };
-        table[0xCE] = [this](CPUType &cpu) -> bool { return this->ADCImmediate(cpu); };
-        table[0xCF] = [this](CPUType &cpu) -> bool { return this->RST<RSTTarget::H08>(cpu); };
-        table[0xD0] = [this](CPUType &cpu) -> bool { return this->RETConditional<JumpTest::NotCarry>(cpu); };
-        table[0xD1] = [this](CPUType &cpu) -> bool { return this->POP<StackTarget::DE>(cpu); };
-        table[0xD2] = [this](CPUType &cpu) -> bool { return this->JP<JumpTest::NotCarry>(cpu); };
-        table[0xD4] = [this](CPUType &cpu) -> bool { return this->CALL<JumpTest::NotCarry>(cpu); };
-        table[0xD5] = [this](CPUType &cpu) -> bool { return this->PUSH<StackTarget::DE>(cpu); };
-        table[0xD6] = [this](CPUType &cpu) -> bool { return this->SUBImmediate(cpu); };
-        table[0xD7] = [this](CPUType &cpu) -> bool { return this->RST<RSTTarget::H10>(cpu); };
-        table[0xD8] = [this](CPUType &cpu) -> bool { return this->RETConditional<JumpTest::Carry>(cpu); };
-        table[0xD9] = [this](CPUType &cpu) -> bool { return this->RETI(cpu); };
-        table[0xDA] = [this](CPUType &cpu) -> bool { return this->JP<JumpTest::Carry>(cpu); };
-        table[0xDC] = [this](CPUType &cpu) -> bool { return this->CALL<JumpTest::Carry>(cpu); };
-        table[0xDE] = [this](CPUType &cpu) -> bool { return this->SBCImmediate(cpu); };
-        table[0xDF] = [this](CPUType &cpu) -> bool { return this->RST<RSTTarget::H18>(cpu); };
-        table[0xE0] = [this](CPUType &cpu) -> bool { return this->LoadFromAccumulatorDirectA(cpu); };
-        table[0xE1] = [this](CPUType &cpu) -> bool { return this->POP<StackTarget::HL>(cpu); };
-        table[0xE2] = [this](CPUType &cpu) -> bool { return this->LoadFromAccumulatorIndirectC(cpu); };
-        table[0xE5] = [this](CPUType &cpu) -> bool { return this->PUSH<StackTarget::HL>(cpu); };
-        table[0xE6] = [this](CPUType &cpu) -> bool { return this->ANDImmediate(cpu); };
-        table[0xE7] = [this](CPUType &cpu) -> bool { return this->RST<RSTTarget::H20>(cpu); };
-        table[0xE8] = [this](CPUType &cpu) -> bool { return this->ADDSigned(cpu); };
-        table[0xE9] = [this](CPUType &cpu) -> bool { return this->JPHL(cpu); };
-        table[0xEA] = [this](CPUType &cpu) -> bool { return this->LDFromAccumulatorDirect(cpu); };
-        table[0xEE] = [this](CPUType &cpu) -> bool { return this->XORImmediate(cpu); };
-        table[0xEF] = [this](CPUType &cpu) -> bool { return this->RST<RSTTarget::H28>(cpu); };
-        table[0xF0] = [this](CPUType &cpu) -> bool { return this->LoadAccumulatorA(cpu); };
-        table[0xF1] = [this](CPUType &cpu) -> bool { return this->POP<StackTarget::AF>(cpu); };
-        table[0xF2] = [this](CPUType &cpu) -> bool { return this->LoadAccumulatorIndirectC(cpu); };
-        table[0xF3] = [this](CPUType &cpu) -> bool { return this->DI(cpu); };
-        table[0xF5] = [this](CPUType &cpu) -> bool { return this->PUSH<StackTarget::AF>(cpu); };
-        table[0xF6] = [this](CPUType &cpu) -> bool { return this->ORImmediate(cpu); };
-        table[0xF7] = [this](CPUType &cpu) -> bool { return this->RST<RSTTarget::H30>(cpu); };
-        table[0xF8] = [this](CPUType &cpu) -> bool { return this->LD16StackAdjusted(cpu); };
-        table[0xF9] = [this](CPUType &cpu) -> bool { return this->LD16Stack(cpu); };
-        table[0xFA] = [this](CPUType &cpu) -> bool { return this->LDAccumulatorDirect(cpu); };
-        table[0xFB] = [this](CPUType &cpu) -> bool { return this->EI(cpu); };
-        table[0xFE] = [this](CPUType &cpu) -> bool { return this->CPImmediate(cpu); };
-        table[0xFF] = [this](CPUType &cpu) -> bool { return this->RST<RSTTarget::H38>(cpu); };
+    static constexpr std::array<StepRow, 256> nonPrefixedSteps = [] {
+        std::array<StepRow, 256> table{};
+        table[0x00] = Single<&Instructions::NOP>();
+        table[0x01] = Cycled([]<uint8_t C> { return &Instructions::LD16Register<LoadWordTarget::BC, C>; });
+        table[0x02] = Cycled([]<uint8_t C> { return &Instructions::LDFromAccBC<C>; });
+        table[0x03] = Cycled([]<uint8_t C> { return &Instructions::INC16<Arithmetic16Target::BC, C>; });
+        table[0x04] = Single<&Instructions::INCRegister<Register::B>>();
+        table[0x05] = Single<&Instructions::DECRegister<Register::B>>();
+        table[0x06] = Cycled([]<uint8_t C> { return &Instructions::LDRegisterImmediate<Register::B, C>; });
+        table[0x07] = Single<&Instructions::RLCA>();
+        table[0x08] = Cycled([]<uint8_t C> { return &Instructions::LD16FromStack<C>; });
+        table[0x09] = Cycled([]<uint8_t C> { return &Instructions::ADD16<Arithmetic16Target::BC, C>; });
+        table[0x10] = Single<&Instructions::STOP>();
+        table[0x0A] = Cycled([]<uint8_t C> { return &Instructions::LDAccumulatorBC<C>; });
+        table[0x0B] = Cycled([]<uint8_t C> { return &Instructions::DEC16<Arithmetic16Target::BC, C>; });
+        table[0x0C] = Single<&Instructions::INCRegister<Register::C>>();
+        table[0x0D] = Single<&Instructions::DECRegister<Register::C>>();
+        table[0x0E] = Cycled([]<uint8_t C> { return &Instructions::LDRegisterImmediate<Register::C, C>; });
+        table[0x0F] = Single<&Instructions::RRCA>();
+        table[0x11] = Cycled([]<uint8_t C> { return &Instructions::LD16Register<LoadWordTarget::DE, C>; });
+        table[0x12] = Cycled([]<uint8_t C> { return &Instructions::LDFromAccDE<C>; });
+        table[0x13] = Cycled([]<uint8_t C> { return &Instructions::INC16<Arithmetic16Target::DE, C>; });
+        table[0x14] = Single<&Instructions::INCRegister<Register::D>>();
+        table[0x15] = Single<&Instructions::DECRegister<Register::D>>();
+        table[0x16] = Cycled([]<uint8_t C> { return &Instructions::LDRegisterImmediate<Register::D, C>; });
+        table[0x17] = Single<&Instructions::RLA>();
+        table[0x18] = Cycled([]<uint8_t C> { return &Instructions::JRUnconditional<C>; });
+        table[0x19] = Cycled([]<uint8_t C> { return &Instructions::ADD16<Arithmetic16Target::DE, C>; });
+        table[0x1A] = Cycled([]<uint8_t C> { return &Instructions::LDAccumulatorDE<C>; });
+        table[0x1B] = Cycled([]<uint8_t C> { return &Instructions::DEC16<Arithmetic16Target::DE, C>; });
+        table[0x1C] = Single<&Instructions::INCRegister<Register::E>>();
+        table[0x1D] = Single<&Instructions::DECRegister<Register::E>>();
+        table[0x1E] = Cycled([]<uint8_t C> { return &Instructions::LDRegisterImmediate<Register::E, C>; });
+        table[0x1F] = Single<&Instructions::RRA>();
+        table[0x20] = Cycled([]<uint8_t C> { return &Instructions::JR<JumpTest::NotZero, C>; });
+        table[0x21] = Cycled([]<uint8_t C> { return &Instructions::LD16Register<LoadWordTarget::HL, C>; });
+        table[0x22] = Cycled([]<uint8_t C> { return &Instructions::LDFromAccumulatorIndirectInc<C>; });
+        table[0x23] = Cycled([]<uint8_t C> { return &Instructions::INC16<Arithmetic16Target::HL, C>; });
+        table[0x24] = Single<&Instructions::INCRegister<Register::H>>();
+        table[0x25] = Single<&Instructions::DECRegister<Register::H>>();
+        table[0x26] = Cycled([]<uint8_t C> { return &Instructions::LDRegisterImmediate<Register::H, C>; });
+        table[0x27] = Single<&Instructions::DAA>();
+        table[0x28] = Cycled([]<uint8_t C> { return &Instructions::JR<JumpTest::Zero, C>; });
+        table[0x29] = Cycled([]<uint8_t C> { return &Instructions::ADD16<Arithmetic16Target::HL, C>; });
+        table[0x2A] = Cycled([]<uint8_t C> { return &Instructions::LDAccumulatorIndirectInc<C>; });
+        table[0x2B] = Cycled([]<uint8_t C> { return &Instructions::DEC16<Arithmetic16Target::HL, C>; });
+        table[0x2C] = Single<&Instructions::INCRegister<Register::L>>();
+        table[0x2D] = Single<&Instructions::DECRegister<Register::L>>();
+        table[0x2E] = Cycled([]<uint8_t C> { return &Instructions::LDRegisterImmediate<Register::L, C>; });
+        table[0x2F] = Single<&Instructions::CPL>();
+        table[0x30] = Cycled([]<uint8_t C> { return &Instructions::JR<JumpTest::NotCarry, C>; });
+        table[0x31] = Cycled([]<uint8_t C> { return &Instructions::LD16Register<LoadWordTarget::SP, C>; });
+        table[0x32] = Cycled([]<uint8_t C> { return &Instructions::LDFromAccumulatorIndirectDec<C>; });
+        table[0x33] = Cycled([]<uint8_t C> { return &Instructions::INC16<Arithmetic16Target::SP, C>; });
+        table[0x34] = Cycled([]<uint8_t C> { return &Instructions::INCIndirect<C>; });
+        table[0x35] = Cycled([]<uint8_t C> { return &Instructions::DECIndirect<C>; });
+        table[0x36] = Cycled([]<uint8_t C> { return &Instructions::LDAddrImmediate<C>; });
+        table[0x37] = Single<&Instructions::SCF>();
+        table[0x38] = Cycled([]<uint8_t C> { return &Instructions::JR<JumpTest::Carry, C>; });
+        table[0x39] = Cycled([]<uint8_t C> { return &Instructions::ADD16<Arithmetic16Target::SP, C>; });
+        table[0x3A] = Cycled([]<uint8_t C> { return &Instructions::LDAccumulatorIndirectDec<C>; });
+        table[0x3B] = Cycled([]<uint8_t C> { return &Instructions::DEC16<Arithmetic16Target::SP, C>; });
+        table[0x3C] = Single<&Instructions::INCRegister<Register::A>>();
+        table[0x3D] = Single<&Instructions::DECRegister<Register::A>>();
+        table[0x3E] = Cycled([]<uint8_t C> { return &Instructions::LDRegisterImmediate<Register::A, C>; });
+        table[0x3F] = Single<&Instructions::CCF>();
+        table[0x40] = Single<&Instructions::LDRegister<Register::B, Register::B>>();
+        table[0x41] = Single<&Instructions::LDRegister<Register::B, Register::C>>();
+        table[0x42] = Single<&Instructions::LDRegister<Register::B, Register::D>>();
+        table[0x43] = Single<&Instructions::LDRegister<Register::B, Register::E>>();
+        table[0x44] = Single<&Instructions::LDRegister<Register::B, Register::H>>();
+        table[0x45] = Single<&Instructions::LDRegister<Register::B, Register::L>>();
+        table[0x46] = Cycled([]<uint8_t C> { return &Instructions::LDRegisterIndirect<Register::B, C>; });
+        table[0x47] = Single<&Instructions::LDRegister<Register::B, Register::A>>();
+        table[0x48] = Single<&Instructions::LDRegister<Register::C, Register::B>>();
+        table[0x49] = Single<&Instructions::LDRegister<Register::C, Register::C>>();
+        table[0x4A] = Single<&Instructions::LDRegister<Register::C, Register::D>>();
+        table[0x4B] = Single<&Instructions::LDRegister<Register::C, Register::E>>();
+        table[0x4C] = Single<&Instructions::LDRegister<Register::C, Register::H>>();
+        table[0x4D] = Single<&Instructions::LDRegister<Register::C, Register::L>>();
+        table[0x4E] = Cycled([]<uint8_t C> { return &Instructions::LDRegisterIndirect<Register::C, C>; });
+        table[0x4F] = Single<&Instructions::LDRegister<Register::C, Register::A>>();
+        table[0x50] = Single<&Instructions::LDRegister<Register::D, Register::B>>();
+        table[0x51] = Single<&Instructions::LDRegister<Register::D, Register::C>>();
+        table[0x52] = Single<&Instructions::LDRegister<Register::D, Register::D>>();
+        table[0x53] = Single<&Instructions::LDRegister<Register::D, Register::E>>();
+        table[0x54] = Single<&Instructions::LDRegister<Register::D, Register::H>>();
+        table[0x55] = Single<&Instructions::LDRegister<Register::D, Register::L>>();
+        table[0x56] = Cycled([]<uint8_t C> { return &Instructions::LDRegisterIndirect<Register::D, C>; });
+        table[0x57] = Single<&Instructions::LDRegister<Register::D, Register::A>>();
+        table[0x58] = Single<&Instructions::LDRegister<Register::E, Register::B>>();
+        table[0x59] = Single<&Instructions::LDRegister<Register::E, Register::C>>();
+        table[0x5A] = Single<&Instructions::LDRegister<Register::E, Register::D>>();
+        table[0x5B] = Single<&Instructions::LDRegister<Register::E, Register::E>>();
+        table[0x5C] = Single<&Instructions::LDRegister<Register::E, Register::H>>();
+        table[0x5D] = Single<&Instructions::LDRegister<Register::E, Register::L>>();
+        table[0x5E] = Cycled([]<uint8_t C> { return &Instructions::LDRegisterIndirect<Register::E, C>; });
+        table[0x5F] = Single<&Instructions::LDRegister<Register::E, Register::A>>();
+        table[0x60] = Single<&Instructions::LDRegister<Register::H, Register::B>>();
+        table[0x61] = Single<&Instructions::LDRegister<Register::H, Register::C>>();
+        table[0x62] = Single<&Instructions::LDRegister<Register::H, Register::D>>();
+        table[0x63] = Single<&Instructions::LDRegister<Register::H, Register::E>>();
+        table[0x64] = Single<&Instructions::LDRegister<Register::H, Register::H>>();
+        table[0x65] = Single<&Instructions::LDRegister<Register::H, Register::L>>();
+        table[0x66] = Cycled([]<uint8_t C> { return &Instructions::LDRegisterIndirect<Register::H, C>; });
+        table[0x67] = Single<&Instructions::LDRegister<Register::H, Register::A>>();
+        table[0x68] = Single<&Instructions::LDRegister<Register::L, Register::B>>();
+        table[0x69] = Single<&Instructions::LDRegister<Register::L, Register::C>>();
+        table[0x6A] = Single<&Instructions::LDRegister<Register::L, Register::D>>();
+        table[0x6B] = Single<&Instructions::LDRegister<Register::L, Register::E>>();
+        table[0x6C] = Single<&Instructions::LDRegister<Register::L, Register::H>>();
+        table[0x6D] = Single<&Instructions::LDRegister<Register::L, Register::L>>();
+        table[0x6E] = Cycled([]<uint8_t C> { return &Instructions::LDRegisterIndirect<Register::L, C>; });
+        table[0x6F] = Single<&Instructions::LDRegister<Register::L, Register::A>>();
+        table[0x70] = Cycled([]<uint8_t C> { return &Instructions::LDAddrRegister<Register::B, C>; });
+        table[0x71] = Cycled([]<uint8_t C> { return &Instructions::LDAddrRegister<Register::C, C>; });
+        table[0x72] = Cycled([]<uint8_t C> { return &Instructions::LDAddrRegister<Register::D, C>; });
+        table[0x73] = Cycled([]<uint8_t C> { return &Instructions::LDAddrRegister<Register::E, C>; });
+        table[0x74] = Cycled([]<uint8_t C> { return &Instructions::LDAddrRegister<Register::H, C>; });
+        table[0x75] = Cycled([]<uint8_t C> { return &Instructions::LDAddrRegister<Register::L, C>; });
+        table[0x76] = Single<&Instructions::HALT>();
+        table[0x77] = Cycled([]<uint8_t C> { return &Instructions::LDAddrRegister<Register::A, C>; });
+        table[0x78] = Single<&Instructions::LDRegister<Register::A, Register::B>>();
+        table[0x79] = Single<&Instructions::LDRegister<Register::A, Register::C>>();
+        table[0x7A] = Single<&Instructions::LDRegister<Register::A, Register::D>>();
+        table[0x7B] = Single<&Instructions::LDRegister<Register::A, Register::E>>();
+        table[0x7C] = Single<&Instructions::LDRegister<Register::A, Register::H>>();
+        table[0x7D] = Single<&Instructions::LDRegister<Register::A, Register::L>>();
+        table[0x7E] = Cycled([]<uint8_t C> { return &Instructions::LDRegisterIndirect<Register::A, C>; });
+        table[0x7F] = Single<&Instructions::LDRegister<Register::A, Register::A>>();
+        table[0x80] = Single<&Instructions::ADDRegister<Register::B>>();
+        table[0x81] = Single<&Instructions::ADDRegister<Register::C>>();
+        table[0x82] = Single<&Instructions::ADDRegister<Register::D>>();
+        table[0x83] = Single<&Instructions::ADDRegister<Register::E>>();
+        table[0x84] = Single<&Instructions::ADDRegister<Register::H>>();
+        table[0x85] = Single<&Instructions::ADDRegister<Register::L>>();
+        table[0x86] = Cycled([]<uint8_t C> { return &Instructions::ADDIndirect<C>; });
+        table[0x87] = Single<&Instructions::ADDRegister<Register::A>>();
+        table[0x88] = Single<&Instructions::ADCRegister<Register::B>>();
+        table[0x89] = Single<&Instructions::ADCRegister<Register::C>>();
+        table[0x8A] = Single<&Instructions::ADCRegister<Register::D>>();
+        table[0x8B] = Single<&Instructions::ADCRegister<Register::E>>();
+        table[0x8C] = Single<&Instructions::ADCRegister<Register::H>>();
+        table[0x8D] = Single<&Instructions::ADCRegister<Register::L>>();
+        table[0x8E] = Cycled([]<uint8_t C> { return &Instructions::ADCIndirect<C>; });
+        table[0x8F] = Single<&Instructions::ADCRegister<Register::A>>();
+        table[0x90] = Single<&Instructions::SUB<Register::B>>();
+        table[0x91] = Single<&Instructions::SUB<Register::C>>();
+        table[0x92] = Single<&Instructions::SUB<Register::D>>();
+        table[0x93] = Single<&Instructions::SUB<Register::E>>();
+        table[0x94] = Single<&Instructions::SUB<Register::H>>();
+        table[0x95] = Single<&Instructions::SUB<Register::L>>();
+        table[0x96] = Cycled([]<uint8_t C> { return &Instructions::SUBIndirect<C>; });
+        table[0x97] = Single<&Instructions::SUB<Register::A>>();
+        table[0x98] = Single<&Instructions::SBCRegister<Register::B>>();
+        table[0x99] = Single<&Instructions::SBCRegister<Register::C>>();
+        table[0x9A] = Single<&Instructions::SBCRegister<Register::D>>();
+        table[0x9B] = Single<&Instructions::SBCRegister<Register::E>>();
+        table[0x9C] = Single<&Instructions::SBCRegister<Register::H>>();
+        table[0x9D] = Single<&Instructions::SBCRegister<Register::L>>();
+        table[0x9E] = Cycled([]<uint8_t C> { return &Instructions::SBCIndirect<C>; });
+        table[0x9F] = Single<&Instructions::SBCRegister<Register::A>>();
+        table[0xA0] = Single<&Instructions::AND<Register::B>>();
+        table[0xA1] = Single<&Instructions::AND<Register::C>>();
+        table[0xA2] = Single<&Instructions::AND<Register::D>>();
+        table[0xA3] = Single<&Instructions::AND<Register::E>>();
+        table[0xA4] = Single<&Instructions::AND<Register::H>>();
+        table[0xA5] = Single<&Instructions::AND<Register::L>>();
+        table[0xA6] = Cycled([]<uint8_t C> { return &Instructions::ANDIndirect<C>; });
+        table[0xA7] = Single<&Instructions::AND<Register::A>>();
+        table[0xA8] = Single<&Instructions::XORRegister<Register::B>>();
+        table[0xA9] = Single<&Instructions::XORRegister<Register::C>>();
+        table[0xAA] = Single<&Instructions::XORRegister<Register::D>>();
+        table[0xAB] = Single<&Instructions::XORRegister<Register::E>>();
+        table[0xAC] = Single<&Instructions::XORRegister<Register::H>>();
+        table[0xAD] = Single<&Instructions::XORRegister<Register::L>>();
+        table[0xAE] = Cycled([]<uint8_t C> { return &Instructions::XORIndirect<C>; });
+        table[0xAF] = Single<&Instructions::XORRegister<Register::A>>();
+        table[0xB0] = Single<&Instructions::ORRegister<Register::B>>();
+        table[0xB1] = Single<&Instructions::ORRegister<Register::C>>();
+        table[0xB2] = Single<&Instructions::ORRegister<Register::D>>();
+        table[0xB3] = Single<&Instructions::ORRegister<Register::E>>();
+        table[0xB4] = Single<&Instructions::ORRegister<Register::H>>();
+        table[0xB5] = Single<&Instructions::ORRegister<Register::L>>();
+        table[0xB6] = Cycled([]<uint8_t C> { return &Instructions::ORIndirect<C>; });
+        table[0xB7] = Single<&Instructions::ORRegister<Register::A>>();
+        table[0xB8] = Single<&Instructions::CPRegister<Register::B>>();
+        table[0xB9] = Single<&Instructions::CPRegister<Register::C>>();
+        table[0xBA] = Single<&Instructions::CPRegister<Register::D>>();
+        table[0xBB] = Single<&Instructions::CPRegister<Register::E>>();
+        table[0xBC] = Single<&Instructions::CPRegister<Register::H>>();
+        table[0xBD] = Single<&Instructions::CPRegister<Register::L>>();
+        table[0xBE] = Cycled([]<uint8_t C> { return &Instructions::CPIndirect<C>; });
+        table[0xBF] = Single<&Instructions::CPRegister<Register::A>>();
+        table[0xC0] = Cycled([]<uint8_t C> { return &Instructions::RETConditional<JumpTest::NotZero, C>; });
+        table[0xC1] = Cycled([]<uint8_t C> { return &Instructions::POP<StackTarget::BC, C>; });
+        table[0xC2] = Cycled([]<uint8_t C> { return &Instructions::JP<JumpTest::NotZero, C>; });
+        table[0xC3] = Cycled([]<uint8_t C> { return &Instructions::JPUnconditional<C>; });
+        table[0xC4] = Cycled([]<uint8_t C> { return &Instructions::CALL<JumpTest::NotZero, C>; });
+        table[0xC5] = Cycled([]<uint8_t C> { return &Instructions::PUSH<StackTarget::BC, C>; });
+        table[0xC6] = Cycled([]<uint8_t C> { return &Instructions::ADDImmediate<C>; });
+        table[0xC7] = Cycled([]<uint8_t C> { return &Instructions::RST<RSTTarget::H00, C>; });
+        table[0xC8] = Cycled([]<uint8_t C> { return &Instructions::RETConditional<JumpTest::Zero, C>; });
+        table[0xC9] = Cycled([]<uint8_t C> { return &Instructions::RETUnconditional<C>; });
+        table[0xCA] = Cycled([]<uint8_t C> { return &Instructions::JP<JumpTest::Zero, C>; });
+        table[0xCB] = Single<&Instructions::PREFIX>();
+        table[0xCC] = Cycled([]<uint8_t C> { return &Instructions::CALL<JumpTest::Zero, C>; });
+        table[0xCD] = Cycled([]<uint8_t C> { return &Instructions::CALLUnconditional<C>; });
+        table[0xCE] = Cycled([]<uint8_t C> { return &Instructions::ADCImmediate<C>; });
+        table[0xCF] = Cycled([]<uint8_t C> { return &Instructions::RST<RSTTarget::H08, C>; });
+        table[0xD0] = Cycled([]<uint8_t C> { return &Instructions::RETConditional<JumpTest::NotCarry, C>; });
+        table[0xD1] = Cycled([]<uint8_t C> { return &Instructions::POP<StackTarget::DE, C>; });
+        table[0xD2] = Cycled([]<uint8_t C> { return &Instructions::JP<JumpTest::NotCarry, C>; });
+        table[0xD3] = Single<&Instructions::Illegal>();
+        table[0xD4] = Cycled([]<uint8_t C> { return &Instructions::CALL<JumpTest::NotCarry, C>; });
+        table[0xD5] = Cycled([]<uint8_t C> { return &Instructions::PUSH<StackTarget::DE, C>; });
+        table[0xD6] = Cycled([]<uint8_t C> { return &Instructions::SUBImmediate<C>; });
+        table[0xD7] = Cycled([]<uint8_t C> { return &Instructions::RST<RSTTarget::H10, C>; });
+        table[0xD8] = Cycled([]<uint8_t C> { return &Instructions::RETConditional<JumpTest::Carry, C>; });
+        table[0xD9] = Cycled([]<uint8_t C> { return &Instructions::RETI<C>; });
+        table[0xDA] = Cycled([]<uint8_t C> { return &Instructions::JP<JumpTest::Carry, C>; });
+        table[0xDB] = Single<&Instructions::Illegal>();
+        table[0xDC] = Cycled([]<uint8_t C> { return &Instructions::CALL<JumpTest::Carry, C>; });
+        table[0xDD] = Single<&Instructions::Illegal>();
+        table[0xDE] = Cycled([]<uint8_t C> { return &Instructions::SBCImmediate<C>; });
+        table[0xDF] = Cycled([]<uint8_t C> { return &Instructions::RST<RSTTarget::H18, C>; });
+        table[0xE0] = Cycled([]<uint8_t C> { return &Instructions::LoadFromAccumulatorDirectA<C>; });
+        table[0xE1] = Cycled([]<uint8_t C> { return &Instructions::POP<StackTarget::HL, C>; });
+        table[0xE2] = Cycled([]<uint8_t C> { return &Instructions::LoadFromAccumulatorIndirectC<C>; });
+        table[0xE3] = Single<&Instructions::Illegal>();
+        table[0xE4] = Single<&Instructions::Illegal>();
+        table[0xE5] = Cycled([]<uint8_t C> { return &Instructions::PUSH<StackTarget::HL, C>; });
+        table[0xE6] = Cycled([]<uint8_t C> { return &Instructions::ANDImmediate<C>; });
+        table[0xE7] = Cycled([]<uint8_t C> { return &Instructions::RST<RSTTarget::H20, C>; });
+        table[0xE8] = Cycled([]<uint8_t C> { return &Instructions::ADDSigned<C>; });
+        table[0xE9] = Single<&Instructions::JPHL>();
+        table[0xEA] = Cycled([]<uint8_t C> { return &Instructions::LDFromAccumulatorDirect<C>; });
+        table[0xEB] = Single<&Instructions::Illegal>();
+        table[0xEC] = Single<&Instructions::Illegal>();
+        table[0xED] = Single<&Instructions::Illegal>();
+        table[0xEE] = Cycled([]<uint8_t C> { return &Instructions::XORImmediate<C>; });
+        table[0xEF] = Cycled([]<uint8_t C> { return &Instructions::RST<RSTTarget::H28, C>; });
+        table[0xF0] = Cycled([]<uint8_t C> { return &Instructions::LoadAccumulatorA<C>; });
+        table[0xF1] = Cycled([]<uint8_t C> { return &Instructions::POP<StackTarget::AF, C>; });
+        table[0xF2] = Cycled([]<uint8_t C> { return &Instructions::LoadAccumulatorIndirectC<C>; });
+        table[0xF3] = Single<&Instructions::DI>();
+        table[0xF4] = Single<&Instructions::Illegal>();
+        table[0xF5] = Cycled([]<uint8_t C> { return &Instructions::PUSH<StackTarget::AF, C>; });
+        table[0xF6] = Cycled([]<uint8_t C> { return &Instructions::ORImmediate<C>; });
+        table[0xF7] = Cycled([]<uint8_t C> { return &Instructions::RST<RSTTarget::H30, C>; });
+        table[0xF8] = Cycled([]<uint8_t C> { return &Instructions::LD16StackAdjusted<C>; });
+        table[0xF9] = Cycled([]<uint8_t C> { return &Instructions::LD16Stack<C>; });
+        table[0xFA] = Cycled([]<uint8_t C> { return &Instructions::LDAccumulatorDirect<C>; });
+        table[0xFB] = Single<&Instructions::EI>();
+        table[0xFC] = Single<&Instructions::Illegal>();
+        table[0xFD] = Single<&Instructions::Illegal>();
+        table[0xFE] = Cycled([]<uint8_t C> { return &Instructions::CPImmediate<C>; });
+        table[0xFF] = Cycled([]<uint8_t C> { return &Instructions::RST<RSTTarget::H38, C>; });
         return table;
     }();
 
-    const std::array<std::string, 256> prefixedInstructions = {
+    static constexpr std::array<const char *, 256> prefixedInstructions = {
         "RLC B", "RLC C", "RLC D", "RLC E", "RLC H", "RLC L", "RLC (HL)", "RLC A", "RRC B", "RRC C", "RRC D", "RRC E",
         "RRC H", "RRC L", "RRC (HL)", "RRC A", "RL B", "RL C", "RL D", "RL E", "RL H", "RL L", "RL (HL)", "RL A",
         "RR B", "RR C", "RR D", "RR E", "RR H", "RR L", "RR (HL)", "RR A", "SLA B", "SLA C", "SLA D", "SLA E", "SLA H",
@@ -2461,7 +2566,7 @@ private:
         "SET 7,E", "SET 7,H", "SET 7,L", "SET 7,(HL)", "SET 7,A"
     };
 
-    const std::array<std::string, 256> nonPrefixedInstructions = {
+    static constexpr std::array<const char *, 256> nonPrefixedInstructions = {
         "NOP", "LD BC,d16", "LD (BC),A", "INC BC", "INC B", "DEC B", "LD B,d8", "RLCA", "LD (a16),SP", "ADD HL,BC",
         "LD A,(BC)", "DEC BC", "INC C", "DEC C", "LD C,d8", "RRCA", "STOP", "LD DE,d16", "LD (DE),A", "INC DE", "INC D",
         "DEC D", "LD D,d8", "RLA", "JR r8", "ADD HL,DE", "LD A,(DE)", "DEC DE", "INC E", "DEC E", "LD E,d8", "RRA",
@@ -34,6 +34,11 @@ struct Joypad {
 
     bool LoadState(std::ifstream &f);
 
+    template<typename Archive>
+    void Serialize(Archive &archive) {
+        archive(matrix_, select_, keyPressed_);
+    }
+
 private:
     void UpdateKeyFlag();
 
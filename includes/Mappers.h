@@ -0,0 +1,223 @@
+#ifndef STARGBC_MAPPERS_H
+#define STARGBC_MAPPERS_H
+
+#include <array>
+#include <concepts>
+#include <cstdint>
+
+class Cartridge;
+
+// A mapper is a set of static handlers bound to a Cartridge once, when the
+// cartridge type is known. ROM reads and plain RAM reads never reach the
+// mapper: they go through the page pointers that MapBanks() resolves.
+// ReadByte only sees the external RAM window when it is not plain RAM.
+template<typename T>
+concept MapperLike = requires(Cartridge &cart, const Cartridge &constCart, uint16_t address, uint8_t value)
+{
+    { T::ReadByte(constCart, address) } -> std::same_as<uint8_t>;
+    { T::WriteByte(cart, address, value) } -> std::same_as<void>;
+    { T::MapBanks(cart) } -> std::same_as<void>;
+};
+
+struct NoMapper {
+    static uint8_t ReadByte(const Cartridge &, uint16_t);
+
+    static void WriteByte(Cartridge &, uint16_t, uint8_t);
+
+    static void MapBanks(Cartridge &);
+};
+
+struct MBC1Mapper {
+    static uint8_t ReadByte(const Cartridge &, uint16_t);
+
+    static void WriteByte(Cartridge &, uint16_t, uint8_t);
+
+    static void MapBanks(Cartridge &);
+};
+
+struct MBC2Mapper {
+    static uint8_t ReadByte(const Cartridge &, uint16_t);
+
+    static void WriteByte(Cartridge &, uint16_t, uint8_t);
+
+    static void MapBanks(Cartridge &);
+};
+
+struct MBC3Mapper {
+    static uint8_t ReadByte(const Cartridge &, uint16_t);
+
+    static void WriteByte(Cartridge &, uint16_t, uint8_t);
+
+    static void MapBanks(Cartridge &);
+};
+
+struct MBC5Mapper {
+    static uint8_t ReadByte(const Cartridge &, uint16_t);
+
+    static void WriteByte(Cartridge &, uint16_t, uint8_t);
+
+    static void MapBanks(Cartridge &);
+};
+
+struct MBC6Mapper {
+    static constexpr uint32_t RAM_SIZE = 0x8000;
+    static constexpr uint32_t FLASH_SIZE = 0x100000;
+
+    static uint8_t ReadByte(const Cartridge &, uint16_t);
+
+    static void WriteByte(Cartridge &, uint16_t, uint8_t);
+
+    static void MapBanks(Cartridge &);
+};
+
+struct MBC7Mapper {
+    static constexpr uint32_t EEPROM_SIZE = 0x100;
+
+    static uint8_t ReadByte(const Cartridge &, uint16_t);
+
+    static void WriteByte(Cartridge &, uint16_t, uint8_t);
+
+    static void MapBanks(Cartridge &);
+
+private:
+    static void ClockEeprom(Cartridge &, uint8_t);
+};
+
+struct HuC1Mapper {
+    static uint8_t ReadByte(const Cartridge &, uint16_t);
+
+    static void WriteByte(Cartridge &, uint16_t, uint8_t);
+
+    static void MapBanks(Cartridge &);
+};
+
+struct HuC3Mapper {
+    static uint8_t ReadByte(const Cartridge &, uint16_t);
+
+    static void WriteByte(Cartridge &, uint16_t, uint8_t);
+
+    static void MapBanks(Cartridge &);
+
+private:
+    static void ExecuteCommand(Cartridge &);
+};
+
+struct MMM01Mapper {
+    static uint8_t ReadByte(const Cartridge &, uint16_t);
+
+    static void WriteByte(Cartridge &, uint16_t, uint8_t);
+
+    static void MapBanks(Cartridge &);
+};
+
+struct PocketCameraMapper {
+    static constexpr uint8_t SENSOR_WIDTH = 128;
+    static constexpr uint8_t SENSOR_HEIGHT = 112;
+    static constexpr uint32_t RAM_SIZE = 0x20000;
+
+    static uint8_t ReadByte(const Cartridge &, uint16_t);
+
+    static void WriteByte(Cartridge &, uint16_t, uint8_t);
+
+    static void MapBanks(Cartridge &);
+
+private:
+    static void Capture(Cartridge &);
+};
+
+// Per-mapper registers that the classic MBCs don't have
+struct MBC6State {
+    uint8_t ramBankA{0x00};
+    uint8_t ramBankB{0x01};
+    uint8_t romBankA{0x02};
+    uint8_t romBankB{0x03};
+    bool flashA{false};
+    bool flashB{false};
+    bool flashEnabled{false};
+    bool flashWriteEnabled{false};
+
+    template<typename Archive>
+    void Serialize(Archive &archive) {
+        archive(ramBankA, ramBankB, romBankA, romBankB, flashA, flashB, flashEnabled, flashWriteEnabled);
+    }
+};
+
+struct MBC7State {
+    bool ramEnabled2{false};
+    bool accelLatched{false};
+    uint16_t accelX{0x8000};
+    uint16_t accelY{0x8000};
+    // 93LC56 serial EEPROM
+    bool cs{false};
+    bool clk{false};
+    bool di{false};
+    bool dataOut{true};
+    bool writeEnabled{false};
+    bool readingOut{false};
+    bool awaitingData{false};
+    uint8_t command{0x00};
+    uint8_t address{0x00};
+    uint8_t bitCount{0x00};
+    uint16_t shift{0x0000};
+
+    template<typename Archive>
+    void Serialize(Archive &archive) {
+        archive(ramEnabled2, accelLatched, accelX, accelY);
+        archive(cs, clk, di, dataOut, writeEnabled, readingOut, awaitingData, command, address, bitCount, shift);
+    }
+};
+
+struct HuC3State {
+    uint8_t mode{0x00};
+    uint8_t command{0x00};
+    uint8_t argument{0x00};
+    uint8_t response{0x00};
+    uint8_t address{0x00};
+    std::array<uint8_t, 0x100> memory{};
+
+    template<typename Archive>
+    void Serialize(Archive &archive) {
+        archive(mode, command, argument, response, address, memory);
+    }
+};
+
+struct MMM01State {
+    bool mapped{false};
+    bool modeLocked{false};
+    uint8_t romLow{0x00};
+    uint8_t romMid{0x00};
+    uint8_t romHigh{0x00};
+    uint8_t romMask{0x00};
+    uint8_t ramLow{0x00};
+    uint8_t ramHigh{0x00};
+
+    template<typename Archive>
+    void Serialize(Archive &archive) {
+        archive(mapped, modeLocked, romLow, romMid, romHigh, romMask, ramLow, ramHigh);
+    }
+};
+
+struct CameraState {
+    std::array<uint8_t, 0x36> registers{};
+
+    template<typename Archive>
+    void Serialize(Archive &archive) {
+        archive(registers);
+    }
+};
+
+struct MapperState {
+    MBC6State mbc6{};
+    MBC7State mbc7{};
+    HuC3State huc3{};
+    MMM01State mmm01{};
+    CameraState camera{};
+    bool infraredMode{false};
+
+    template<typename Archive>
+    void Serialize(Archive &archive) {
+        archive(mbc6, mbc7, huc3, mmm01, camera, infraredMode);
+    }
+};
+
+#endif //STARGBC_MAPPERS_H
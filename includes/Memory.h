@@ -15,9 +15,52 @@ struct Memory {
     std::array<uint8_t, 0x80> hram_{};
     uint8_t wramBank_{0x01};
 
+    // WRAM and HRAM split into 256-byte pages, HRAM last. A page is marked
+    // once code in it has been cached; writing to a marked page bumps its
+    // generation so blocks decoded from the old bytes are thrown away.
+    // Plain bytes, so compiled code (BlockJit) can test a mark directly.
+    static constexpr size_t CODE_PAGE_COUNT = 0x8000 / 0x100 + 1;
+    static constexpr size_t HRAM_CODE_PAGE = CODE_PAGE_COUNT - 1;
+
+    std::array<bool, CODE_PAGE_COUNT> codePages_{};
+    std::array<uint32_t, CODE_PAGE_COUNT> codeGenerations_{};
+
+    void WriteWram(const size_t index, const uint8_t value) {
+        wram_[index] = value;
+        if (codePages_[index >> 8]) InvalidateCode(index >> 8);
+    }
+
+    void WriteHram(const size_t index, const uint8_t value) {
+        hram_[index] = value;
+        if (codePages_[HRAM_CODE_PAGE]) InvalidateCode(HRAM_CODE_PAGE);
+    }
+
+    void InvalidateCode(const size_t page) {
+        codePages_[page] = false;
+        ++codeGenerations_[page];
+    }
+
+    // Power-on values, optionally keeping the RAM contents as a reset line
+    // does. Generations carry on so no cached block outlives its bytes.
+    void Reset(const bool clearRam) {
+        wramBank_ = 0x01;
+        if (!clearRam) return;
+        wram_.fill(0);
+        hram_.fill(0);
+        for (size_t page = 0; page < CODE_PAGE_COUNT; ++page) {
+            if (codePages_[page]) InvalidateCode(page);
+        }
+    }
+
     bool SaveState(std::ofstream &stateFile) const;
 
     bool LoadState(std::ifstream &stateFile);
+
+    // The code page marks belong to the block cache, not the machine
+    template<typename Archive>
+    void Serialize(Archive &archive) {
+        archive(wram_, hram_, wramBank_);
+    }
 };
 
 #endif //STARGBC_MEMORY_H
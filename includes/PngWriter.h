@@ -0,0 +1,12 @@
+#ifndef STARGBC_PNGWRITER_H
+#define STARGBC_PNGWRITER_H
+
+#include <cstdint>
+#include <string>
+
+// Writes `pixels` as an 8-bit RGBA PNG. Pixels are in memory order R, G,
+// B, A, as GetScreenData() holds them. The image data is compressed with
+// fixed Huffman codes, or stored as is when that would come out larger.
+void WritePng(const std::string &path, const uint32_t *pixels, uint32_t width, uint32_t height);
+
+#endif //STARGBC_PNGWRITER_H
@@ -1,4 +1,6 @@
 #pragma once
+#include <array>
+
 #include "Common.h"
 
 class RealTimeClock {
@@ -42,10 +44,29 @@ public:
 
     void Update();
 
+    // Calls to Update() before the next tick of the clock
+    [[nodiscard]] uint32_t IdleTicks() const;
+
+    void SkipIdleTicks(uint32_t ticks);
+
+    // Same as `ticks` calls to Update(), a clock second at a time
+    void Advance(uint64_t ticks);
+
+    // Seconds, minutes, hours, day low and day high, as the save file has them
+    [[nodiscard]] std::array<uint8_t, 5> GetRegisters() const;
+
+    // As loading a save file with these registers into a fresh clock
+    void SetRegisters(const std::array<uint8_t, 5> &registers);
+
     void Load(std::ifstream &stateFile);
 
     void Save(std::ofstream &stateFile) const;
 
+    template<typename Archive>
+    void Serialize(Archive &archive) {
+        archive(zeroTime_, halted_, realClock_, latchedClock_, counter_);
+    }
+
     Clock realClock_{};
     Clock latchedClock_{};
     bool realRTC_{false};
@@ -6,6 +6,8 @@
 struct Registers {
     uint8_t a{}, f{}, b{}, c{}, d{}, e{}, h{}, l{};
 
+    bool operator==(const Registers &) const = default;
+
     [[nodiscard]] uint16_t GetAF() const noexcept { return static_cast<uint16_t>(a) << 8 | f; }
 
     [[nodiscard]] uint16_t GetBC() const noexcept { return static_cast<uint16_t>(b) << 8 | c; }
@@ -0,0 +1,58 @@
+#ifndef STARGBC_ROMPROFILER_H
+#define STARGBC_ROMPROFILER_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// M-cycles spent per instruction address, recorded by the CPU as each
+// instruction completes. ROM code is keyed by its offset in the image, so
+// every (bank, address) pair has its own slot in a flat array; anything
+// else (RAM, flash, the bootrom) is keyed by address alone. A prefixed
+// instruction counts under the address of its CB byte. With `sampleEvery`
+// above 1 only every nth instruction is recorded, weighted by n.
+class RomProfiler {
+public:
+    struct Hotspot {
+        bool inRom;
+        uint32_t location; // ROM offset, or address outside ROM
+        uint64_t mCycles;
+        uint64_t executions;
+    };
+
+    RomProfiler(const size_t romSize, const uint32_t sampleEvery) : romCycles_(romSize), romExecutions_(romSize),
+                                                                    sampleEvery_(std::max<uint32_t>(sampleEvery, 1)),
+                                                                    countdown_(sampleEvery_) {
+    }
+
+    // `romOffset` is NO_OFFSET for code outside the ROM image
+    void Record(const size_t romOffset, const uint16_t address, const uint32_t mCycles, const bool completed) {
+        if (--countdown_ != 0) return;
+        countdown_ = sampleEvery_;
+        const bool inRom = romOffset < romCycles_.size();
+        (inRom ? romCycles_[romOffset] : otherCycles_[address]) += uint64_t{mCycles} * sampleEvery_;
+        if (completed) (inRom ? romExecutions_[romOffset] : otherExecutions_[address]) += sampleEvery_;
+        totalCycles_ += uint64_t{mCycles} * sampleEvery_;
+    }
+
+    [[nodiscard]] uint64_t TotalCycles() const { return totalCycles_; }
+
+    [[nodiscard]] uint32_t SampleEvery() const { return sampleEvery_; }
+
+    // The `count` costliest locations, most cycles first
+    [[nodiscard]] std::vector<Hotspot> Hotspots(size_t count) const;
+
+    static constexpr size_t NO_OFFSET = SIZE_MAX;
+
+private:
+    std::vector<uint64_t> romCycles_;
+    std::vector<uint32_t> romExecutions_;
+    std::vector<uint64_t> otherCycles_ = std::vector<uint64_t>(0x10000);
+    std::vector<uint32_t> otherExecutions_ = std::vector<uint32_t>(0x10000);
+    uint64_t totalCycles_{0};
+    uint32_t sampleEvery_;
+    uint32_t countdown_;
+};
+
+#endif //STARGBC_ROMPROFILER_H
@@ -0,0 +1,42 @@
+#ifndef STARGBC_ROMSOURCE_H
+#define STARGBC_ROMSOURCE_H
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+enum class RomContainer {
+    Raw, Gzip, Zip, Zstd
+};
+
+// A ROM file as read from disk. Compressed containers are decoded straight
+// into `data` while the file is read; `crc32` covers the decoded bytes and
+// is updated in the same pass.
+struct RomImage {
+    std::vector<uint8_t> data;
+    uint32_t crc32{0};
+    RomContainer container{RomContainer::Raw};
+};
+
+class RomSource {
+public:
+    // MBC5's 512 banks of 16 KiB, the most any mapper addresses. Load()
+    // stops decoding and throws once a ROM grows past it.
+    static constexpr size_t MAX_ROM_SIZE = size_t{8} << 20;
+
+    // The container is detected from the file's magic bytes, not its name.
+    // Zip archives yield the first .gb/.gbc/.cgb entry.
+    static RomImage Load(const std::string &path);
+
+    // Whether the name looks like something Load() can open
+    [[nodiscard]] static bool IsSupportedPath(std::string_view path);
+
+    // Drops a single-file compression suffix: "game.gb.gz" -> "game.gb"
+    [[nodiscard]] static std::string StripContainerExtension(const std::string &path);
+
+    [[nodiscard]] static uint32_t Crc32(std::span<const uint8_t> bytes, uint32_t crc = 0);
+};
+
+#endif //STARGBC_ROMSOURCE_H
@@ -17,10 +17,20 @@ struct Serial {
 
     void Update();
 
+    // Ticks of Update() before the next bit is shifted out
+    [[nodiscard]] uint32_t IdleTicks() const;
+
+    void SkipIdleTicks(uint32_t ticks);
+
     bool SaveState(std::ofstream &) const;
 
     bool LoadState(std::ifstream &);
 
+    template<typename Archive>
+    void Serialize(Archive &archive) {
+        archive(ticksUntilShift_, ticksPerBit_, data_, control_, bitsShifted_, active_);
+    }
+
     uint16_t ticksUntilShift_{0};
     uint16_t ticksPerBit_{0};
     uint8_t data_{0}; // SB
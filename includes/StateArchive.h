@@ -0,0 +1,177 @@
+#ifndef STARGBC_STATEARCHIVE_H
+#define STARGBC_STATEARCHIVE_H
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Bumped whenever a Serialize() field list changes, so snapshots written by
+// another build are never read back
+static constexpr uint32_t SNAPSHOT_VERSION = 3;
+
+// Snapshots list each component's fields once, in a Serialize(archive)
+// member that both StateWriter and StateReader run, so saving and loading
+// cannot drift apart. Plain data goes out as its raw bytes in host order;
+// snapshots are a cache, not an interchange format.
+namespace state_archive {
+    // Checked first, so a component can hold references and pointers
+    template<typename T, typename Archive>
+    concept HasSerialize = requires(T &value, Archive &archive) { value.Serialize(archive); };
+
+    template<typename T>
+    struct IsArray : std::is_array<T> {
+    };
+
+    template<typename T, size_t N>
+    struct IsArray<std::array<T, N> > : std::true_type {
+    };
+
+    template<typename T>
+    struct IsSequence : std::false_type {
+    };
+
+    template<typename T, typename A>
+    struct IsSequence<std::vector<T, A> > : std::true_type {
+    };
+
+    template<typename T, typename A>
+    struct IsSequence<std::deque<T, A> > : std::true_type {
+    };
+
+    template<typename T>
+    struct IsPair : std::false_type {
+    };
+
+    template<typename A, typename B>
+    struct IsPair<std::pair<A, B> > : std::true_type {
+    };
+
+    // Sequences stored contiguously go out in one copy
+    template<typename T>
+    struct IsContiguous : std::false_type {
+    };
+
+    template<typename T, typename A>
+    struct IsContiguous<std::vector<T, A> > : std::true_type {
+    };
+
+    template<typename A>
+    struct IsContiguous<std::vector<bool, A> > : std::false_type {
+    };
+
+    // Types copied as raw bytes. Padding would make equal states write
+    // different bytes, so a struct with any has to list its fields instead.
+    template<typename T>
+    struct IsPlain : std::bool_constant<std::has_unique_object_representations_v<T> ||
+                                        std::is_floating_point_v<T> > {
+    };
+
+    template<typename T, size_t N>
+    struct IsPlain<std::array<T, N> > : IsPlain<T> {
+    };
+
+    template<typename T, size_t N>
+    struct IsPlain<T[N]> : IsPlain<T> {
+    };
+}
+
+class StateWriter {
+public:
+    static constexpr bool LOADING = false;
+
+    explicit StateWriter(std::vector<uint8_t> &out) : out_(out) {
+    }
+
+    template<typename... T>
+    void operator()(const T &... values) {
+        (Write(values), ...);
+    }
+
+private:
+    template<typename T>
+    void Write(const T &value) {
+        if constexpr (state_archive::HasSerialize<T, StateWriter>) {
+            // Serialize() is shared with StateReader so it cannot be const;
+            // through a writer it only reads
+            const_cast<T &>(value).Serialize(*this);
+        } else if constexpr (state_archive::IsPlain<T>::value) {
+            const auto *bytes = reinterpret_cast<const uint8_t *>(&value);
+            out_.insert(out_.end(), bytes, bytes + sizeof(T));
+        } else if constexpr (state_archive::IsSequence<T>::value) {
+            Write(static_cast<uint32_t>(value.size()));
+            if constexpr (state_archive::IsContiguous<T>::value &&
+                          state_archive::IsPlain<typename T::value_type>::value) {
+                const auto *bytes = reinterpret_cast<const uint8_t *>(value.data());
+                out_.insert(out_.end(), bytes, bytes + value.size() * sizeof(typename T::value_type));
+            } else {
+                for (const auto &element: value) Write(element);
+            }
+        } else if constexpr (state_archive::IsPair<T>::value) {
+            Write(value.first);
+            Write(value.second);
+        } else {
+            static_assert(state_archive::IsArray<T>::value, "Needs a Serialize() member listing its fields");
+            for (const auto &element: value) Write(element);
+        }
+    }
+
+    std::vector<uint8_t> &out_;
+};
+
+class StateReader {
+public:
+    static constexpr bool LOADING = true;
+
+    explicit StateReader(const std::span<const uint8_t> in) : in_(in) {
+    }
+
+    template<typename... T>
+    void operator()(T &... values) {
+        (Read(values), ...);
+    }
+
+    [[nodiscard]] bool AtEnd() const { return pos_ == in_.size(); }
+
+private:
+    template<typename T>
+    void Read(T &value) {
+        if constexpr (state_archive::HasSerialize<T, StateReader>) {
+            value.Serialize(*this);
+        } else if constexpr (state_archive::IsPlain<T>::value) {
+            if (in_.size() - pos_ < sizeof(T)) throw std::runtime_error("Snapshot is truncated");
+            std::memcpy(&value, in_.data() + pos_, sizeof(T));
+            pos_ += sizeof(T);
+        } else if constexpr (state_archive::IsSequence<T>::value) {
+            uint32_t size = 0;
+            Read(size);
+            value.clear();
+            value.resize(size);
+            if constexpr (state_archive::IsContiguous<T>::value &&
+                          state_archive::IsPlain<typename T::value_type>::value) {
+                const size_t bytes = value.size() * sizeof(typename T::value_type);
+                if (in_.size() - pos_ < bytes) throw std::runtime_error("Snapshot is truncated");
+                std::memcpy(value.data(), in_.data() + pos_, bytes);
+                pos_ += bytes;
+            } else {
+                for (auto &element: value) Read(element);
+            }
+        } else if constexpr (state_archive::IsPair<T>::value) {
+            Read(value.first);
+            Read(value.second);
+        } else {
+            static_assert(state_archive::IsArray<T>::value, "Needs a Serialize() member listing its fields");
+            for (auto &element: value) Read(element);
+        }
+    }
+
+    std::span<const uint8_t> in_;
+    size_t pos_{0};
+};
+
+#endif //STARGBC_STATEARCHIVE_H
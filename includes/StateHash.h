@@ -0,0 +1,13 @@
+#ifndef STARGBC_STATEHASH_H
+#define STARGBC_STATEHASH_H
+
+#include <cstddef>
+#include <cstdint>
+
+// XXH64 (xxhash.com), bit-for-bit. Four independent lanes over 32-byte
+// stripes keep the multipliers busy in parallel, so a machine's worth of
+// RAM hashes at memory speed. Chain calls through `seed` to hash several
+// buffers as one.
+[[nodiscard]] uint64_t XXHash64(const void *data, size_t size, uint64_t seed = 0);
+
+#endif //STARGBC_STATEHASH_H
@@ -23,6 +23,12 @@ public:
 
     void Tick(Speed);
 
+    // Ticks that can pass before TIMA overflows or the frame sequencer
+    // steps, and the matching bulk advance
+    [[nodiscard]] uint32_t IdleTicks(Speed) const;
+
+    void SkipIdleTicks(uint32_t ticks);
+
     void WriteByte(uint16_t, uint8_t, Speed);
 
     [[nodiscard]] uint8_t ReadByte(uint16_t) const;
@@ -42,6 +48,11 @@ public:
     bool SaveState(std::ofstream &) const;
 
     bool LoadState(std::ifstream &);
+
+    template<typename Archive>
+    void Serialize(Archive &archive) {
+        archive(tma, tima, tac, overflowDelay, divCounter, overflowPending, reloadActive);
+    }
 };
 
 #endif //STARGBC_TIMER_H
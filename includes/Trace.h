@@ -0,0 +1,82 @@
+#ifndef STARGBC_TRACE_H
+#define STARGBC_TRACE_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// Scoped timing zones, compiled in with -DSTARGBC_TRACE (the CMake option of
+// the same name). Without it TRACE_ZONE expands to nothing and its argument
+// is never evaluated. Each thread records into its own ring buffer, keeping
+// the most recent events; WriteChromeTrace() dumps every thread's ring as
+// Chrome trace JSON, for chrome://tracing or ui.perfetto.dev.
+#ifdef STARGBC_TRACE
+#define STARGBC_TRACE_JOIN2(a, b) a##b
+#define STARGBC_TRACE_JOIN(a, b) STARGBC_TRACE_JOIN2(a, b)
+#define TRACE_ZONE(name) const trace::Zone STARGBC_TRACE_JOIN(traceZone, __LINE__){name}
+#else
+#define TRACE_ZONE(name) static_cast<void>(0)
+#endif
+
+namespace trace {
+#ifdef STARGBC_TRACE
+    inline constexpr bool ENABLED = true;
+#else
+    inline constexpr bool ENABLED = false;
+#endif
+
+    // Events kept per thread; older ones are overwritten
+    inline constexpr size_t RING_CAPACITY = size_t{1} << 18;
+
+    // `name` must outlive the trace, in practice a string literal
+    void Record(const char *name, uint64_t beginNs, uint64_t endNs);
+
+    [[nodiscard]] inline uint64_t NowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    class Zone {
+    public:
+        explicit Zone(const char *name) : name_(name), begin_(NowNs()) {
+        }
+
+        Zone(const Zone &) = delete;
+
+        Zone &operator=(const Zone &) = delete;
+
+        ~Zone() { Record(name_, begin_, NowNs()); }
+
+    private:
+        const char *name_;
+        uint64_t begin_;
+    };
+
+    // A zone over many calls, for work done a dot or a byte at a time.
+    // Begin() does nothing while the span is open; End() records it, if
+    // open, and closes it. Both compile to nothing without STARGBC_TRACE.
+    class Span {
+    public:
+        void Begin() {
+            if constexpr (ENABLED) {
+                if (begin_ == 0) begin_ = NowNs();
+            }
+        }
+
+        void End(const char *name) {
+            if constexpr (ENABLED) {
+                if (begin_ != 0) Record(name, begin_, NowNs());
+                begin_ = 0;
+            }
+        }
+
+    private:
+        uint64_t begin_{0};
+    };
+
+    // Safe while other threads are still recording: events overwritten
+    // during the dump are left out rather than written torn
+    void WriteChromeTrace(const std::string &path);
+}
+
+#endif //STARGBC_TRACE_H
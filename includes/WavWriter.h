@@ -0,0 +1,73 @@
+#ifndef STARGBC_WAVWRITER_H
+#define STARGBC_WAVWRITER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Streams interleaved stereo samples, as Gameboy::ReadAudioSamples gives
+// them, into a 32-bit float WAV file. Write() only copies into a block;
+// full blocks are written out by a background thread, so rendering runs
+// at emulation speed rather than disk speed. Nothing is ever dropped: if
+// the thread is a whole queue of blocks behind, Write() waits for it.
+class WavWriter {
+public:
+    static constexpr size_t BLOCK_FRAMES = 16384;
+
+    WavWriter(const std::string &path, uint32_t sampleRate, size_t queueBlocks = 8);
+
+    WavWriter(const WavWriter &) = delete;
+
+    WavWriter &operator=(const WavWriter &) = delete;
+
+    // Finish()es, swallowing errors; call Finish() to see them
+    ~WavWriter();
+
+    // `frames` stereo pairs
+    void Write(const float *samples, size_t frames);
+
+    // Writes what is left, fills in the header's sizes and closes the file.
+    // Throws if anything failed to write.
+    void Finish();
+
+    [[nodiscard]] uint64_t FramesWritten() const { return frames_; }
+
+private:
+    void Run();
+
+    void Submit(); // hands block_ to the worker
+
+    const std::string path_;
+    const uint32_t sampleRate_;
+    const size_t queueBlocks_;
+    std::ofstream file_;
+    std::vector<float> block_;
+    uint64_t frames_{0};
+    bool finished_{false};
+
+    std::mutex mutex_;
+    std::condition_variable ready_; // a block was queued, or finishing
+    std::condition_variable written_; // a block was written
+    std::deque<std::vector<float> > queue_;
+    std::vector<std::vector<float> > spare_; // written blocks, for reuse
+    bool stopping_{false};
+    std::string error_;
+    std::thread worker_;
+};
+
+// A whole WAV file of 32-bit float samples, as WavWriter writes them, or
+// of 16-bit PCM, converted to float
+struct WavAudio {
+    uint32_t sampleRate{0};
+    uint16_t channels{0};
+    std::vector<float> samples; // interleaved
+
+    static WavAudio Read(const std::string &path);
+};
+
+#endif //STARGBC_WAVWRITER_H
@@ -0,0 +1,283 @@
+#ifndef STARGBC_X64EMITTER_H
+#define STARGBC_X64EMITTER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <utility>
+#include <vector>
+
+// Just enough of an x86-64 assembler for BlockJit: the instruction forms it
+// uses, rel32 labels, and a cold section emitted after the hot code so the
+// rarely taken paths stay out of its way
+namespace x64 {
+    enum Reg : uint8_t { RAX, RCX, RDX, RBX, RSP, RBP, RSI, RDI, R8, R9, R10, R11, R12, R13, R14, R15, NO_REG = 0xFF };
+
+    // Condition codes as they go into Jcc and SETcc
+    enum Cond : uint8_t { B = 0x2, AE = 0x3, E = 0x4, NE = 0x5, BE = 0x6, A = 0x7 };
+
+    // The /digit of the 0x80/0x81/0x83 group, and opcode / 8 of the r/m forms
+    enum class Alu : uint8_t { Add, Or, Adc, Sbb, And, Sub, Xor, Cmp };
+
+    // The /digit of the 0xC0/0xC1/0xD0 group
+    enum class Shift : uint8_t { Rol, Ror, Rcl, Rcr, Shl, Shr, Sar = 7 };
+
+    // [base + index * scale + disp]
+    struct Mem {
+        Reg base;
+        int32_t disp{0};
+        Reg index{NO_REG};
+        uint8_t scale{1};
+    };
+
+    class Emitter {
+    public:
+        struct Label {
+            size_t id;
+        };
+
+        Label NewLabel() {
+            labels_.push_back(UNBOUND);
+            return {labels_.size() - 1};
+        }
+
+        void Bind(const Label label) { labels_[label.id] = code_.size(); }
+
+        // Code for a rarely taken path, emitted by Finish() after the rest
+        void Cold(std::function<void()> body) { cold_.push_back(std::move(body)); }
+
+        // Emits the cold section and resolves the jumps. Empty if a label
+        // was never bound.
+        std::vector<uint8_t> Finish() {
+            // A cold path may queue more of them
+            for (size_t i = 0; i < cold_.size(); ++i) {
+                const std::function<void()> body = std::move(cold_[i]);
+                body();
+            }
+            for (const auto &[at, label]: fixups_) {
+                if (labels_[label] == UNBOUND) return {};
+                const auto rel = static_cast<int32_t>(static_cast<int64_t>(labels_[label]) - static_cast<int64_t>(at + 4));
+                for (int i = 0; i < 4; ++i) code_[at + i] = static_cast<uint8_t>(static_cast<uint32_t>(rel) >> 8 * i);
+            }
+            return std::move(code_);
+        }
+
+        // mov r32, imm32 (zero-extends)
+        void MovImm(const Reg dst, const uint32_t imm) {
+            if (dst >= R8) Byte(0x41);
+            Byte(0xB8 + (dst & 7));
+            Imm(imm, 4);
+        }
+
+        void MovImm64(const Reg dst, const uint64_t imm) {
+            Byte(0x48 | (dst >> 3));
+            Byte(0xB8 + (dst & 7));
+            Imm(imm, 8);
+        }
+
+        void Mov(const Reg dst, const Reg src) { Encode(false, false, {0x89}, src, dst, false); }
+        void Mov64(const Reg dst, const Reg src) { Encode(false, true, {0x89}, src, dst, false); }
+
+        // movzx r32, byte/word
+        void Load8(const Reg dst, const Mem &src) { Encode(false, false, {0x0F, 0xB6}, dst, src, false); }
+        void Load16(const Reg dst, const Mem &src) { Encode(false, false, {0x0F, 0xB7}, dst, src, false); }
+        void Load64(const Reg dst, const Mem &src) { Encode(false, true, {0x8B}, dst, src, false); }
+
+        // movzx r32, r8
+        void Movzx8(const Reg dst, const Reg src) { Encode(false, false, {0x0F, 0xB6}, dst, src, IsByteHigh(src)); }
+
+        void Store8(const Mem &dst, const Reg src) { Encode(false, false, {0x88}, src, dst, IsByteHigh(src)); }
+        void Store16(const Mem &dst, const Reg src) { Encode(true, false, {0x89}, src, dst, false); }
+
+        void Store8(const Mem &dst, const uint8_t imm) {
+            Encode(false, false, {0xC6}, 0, dst, false);
+            Imm(imm, 1);
+        }
+
+        void Store16(const Mem &dst, const uint16_t imm) {
+            Encode(true, false, {0xC7}, 0, dst, false);
+            Imm(imm, 2);
+        }
+
+        // 8-bit ALU ops: dst op= src
+        void Alu8(const Alu op, const Reg dst, const Reg src) {
+            Encode(false, false, {static_cast<uint8_t>(static_cast<uint8_t>(op) * 8)}, src, dst,
+                   IsByteHigh(src) || IsByteHigh(dst));
+        }
+
+        void Alu8(const Alu op, const Reg dst, const Mem &src) {
+            Encode(false, false, {static_cast<uint8_t>(static_cast<uint8_t>(op) * 8 + 2)}, dst, src, IsByteHigh(dst));
+        }
+
+        void Alu8(const Alu op, const Reg dst, const uint8_t imm) {
+            Encode(false, false, {0x80}, static_cast<uint8_t>(op), dst, IsByteHigh(dst));
+            Imm(imm, 1);
+        }
+
+        void Alu8(const Alu op, const Mem &dst, const uint8_t imm) {
+            Encode(false, false, {0x80}, static_cast<uint8_t>(op), dst, false);
+            Imm(imm, 1);
+        }
+
+        void Alu8(const Alu op, const Mem &dst, const Reg src) {
+            Encode(false, false, {static_cast<uint8_t>(static_cast<uint8_t>(op) * 8)}, src, dst, IsByteHigh(src));
+        }
+
+        void Alu32(const Alu op, const Reg dst, const Reg src) {
+            Encode(false, false, {static_cast<uint8_t>(static_cast<uint8_t>(op) * 8 + 1)}, src, dst, false);
+        }
+
+        void Alu32(const Alu op, const Reg dst, const int32_t imm) { AluImm(false, op, dst, imm); }
+
+        void Alu64(const Alu op, const Reg dst, const int32_t imm) { AluImm(true, op, dst, imm); }
+
+        void Inc8(const Reg reg) { Encode(false, false, {0xFE}, 0, reg, IsByteHigh(reg)); }
+        void Dec8(const Reg reg) { Encode(false, false, {0xFE}, 1, reg, IsByteHigh(reg)); }
+        void Inc8(const Mem &mem) { Encode(false, false, {0xFE}, 0, mem, false); }
+        void Dec8(const Mem &mem) { Encode(false, false, {0xFE}, 1, mem, false); }
+        void Inc32(const Mem &mem) { Encode(false, false, {0xFF}, 0, mem, false); }
+        void Not8(const Mem &mem) { Encode(false, false, {0xF6}, 2, mem, false); }
+
+        void Test8(const Reg a, const Reg b) { Encode(false, false, {0x84}, b, a, IsByteHigh(a) || IsByteHigh(b)); }
+
+        void Test8(const Reg reg, const uint8_t imm) {
+            Encode(false, false, {0xF6}, 0, reg, IsByteHigh(reg));
+            Imm(imm, 1);
+        }
+
+        void Test8(const Mem &mem, const uint8_t imm) {
+            Encode(false, false, {0xF6}, 0, mem, false);
+            Imm(imm, 1);
+        }
+
+        void Shift8(const Shift op, const Reg reg, const uint8_t count) { ShiftImm({0xD0}, {0xC0}, op, reg, count, IsByteHigh(reg)); }
+        void Shift8(const Shift op, const Mem &mem, const uint8_t count) { ShiftImm({0xD0}, {0xC0}, op, mem, count, false); }
+        void Shift32(const Shift op, const Reg reg, const uint8_t count) { ShiftImm({0xD1}, {0xC1}, op, reg, count, false); }
+
+        // rol r16, 8: swaps the bytes of a register pair
+        void Swap16(const Reg reg) {
+            Encode(true, false, {0xC1}, 0, reg, false);
+            Imm(8, 1);
+        }
+
+        // Only ever a 32-bit result
+        void Lea(const Reg dst, const Mem &src) { Encode(false, false, {0x8D}, dst, src, false); }
+
+        void Setcc(const Cond cond, const Reg dst) { Encode(false, false, {0x0F, static_cast<uint8_t>(0x90 + cond)}, 0, dst, IsByteHigh(dst)); }
+
+        // bt r32, imm8: CF = that bit
+        void Bt32(const Reg reg, const uint8_t bit) {
+            Encode(false, false, {0x0F, 0xBA}, 4, reg, false);
+            Imm(bit, 1);
+        }
+
+        // lahf, then movzx dst, ah (dst below R8, so no REX hides AH)
+        void LoadFlags(const Reg dst) {
+            Byte(0x9F);
+            Byte(0x0F);
+            Byte(0xB6);
+            Byte(0xC0 | (dst & 7) << 3 | 4);
+        }
+
+        void Jcc(const Cond cond, const Label target) {
+            Byte(0x0F);
+            Byte(0x80 + cond);
+            Fixup(target);
+        }
+
+        void Jmp(const Label target) {
+            Byte(0xE9);
+            Fixup(target);
+        }
+
+        // Through RAX, which the System V ABI leaves to the caller
+        void Call(const void *function) {
+            MovImm64(RAX, reinterpret_cast<uint64_t>(function));
+            Byte(0xFF);
+            Byte(0xD0);
+        }
+
+        void Push(const Reg reg) {
+            if (reg >= R8) Byte(0x41);
+            Byte(0x50 + (reg & 7));
+        }
+
+        void Pop(const Reg reg) {
+            if (reg >= R8) Byte(0x41);
+            Byte(0x58 + (reg & 7));
+        }
+
+        void Ret() { Byte(0xC3); }
+
+    private:
+        static constexpr size_t UNBOUND = SIZE_MAX;
+
+        // SPL, BPL, SIL and DIL need a REX prefix to not mean AH..BH
+        static bool IsByteHigh(const Reg reg) { return reg >= RSP && reg <= RDI; }
+
+        void Byte(const uint8_t byte) { code_.push_back(byte); }
+
+        void Imm(const uint64_t value, const int bytes) {
+            for (int i = 0; i < bytes; ++i) Byte(static_cast<uint8_t>(value >> 8 * i));
+        }
+
+        void Fixup(const Label target) {
+            fixups_.emplace_back(code_.size(), target.id);
+            Imm(0, 4);
+        }
+
+        void Prefixes(const bool word, const bool wide, const uint8_t reg, const uint8_t index, const uint8_t base,
+                      const bool forceRex) {
+            if (word) Byte(0x66);
+            const uint8_t rex = (wide ? 0x08 : 0) | (reg >> 3 & 1) << 2 | (index >> 3 & 1) << 1 | (base >> 3 & 1);
+            if (rex || forceRex) Byte(0x40 | rex);
+        }
+
+        void Encode(const bool word, const bool wide, const std::initializer_list<uint8_t> opcode, const uint8_t reg,
+                    const Reg rm, const bool forceRex) {
+            Prefixes(word, wide, reg, 0, rm, forceRex);
+            for (const uint8_t byte: opcode) Byte(byte);
+            Byte(0xC0 | (reg & 7) << 3 | (rm & 7));
+        }
+
+        void Encode(const bool word, const bool wide, const std::initializer_list<uint8_t> opcode, const uint8_t reg,
+                    const Mem &mem, const bool forceRex) {
+            const bool indexed = mem.index != NO_REG;
+            Prefixes(word, wide, reg, indexed ? mem.index : 0, mem.base, forceRex);
+            for (const uint8_t byte: opcode) Byte(byte);
+            const uint8_t base = mem.base & 7;
+            // RBP/R13 as a base with mod 00 would mean RIP-relative
+            const uint8_t mod = mem.disp == 0 && base != 5 ? 0 : mem.disp == static_cast<int8_t>(mem.disp) ? 1 : 2;
+            if (indexed || base == 4) {
+                Byte(mod << 6 | (reg & 7) << 3 | 4);
+                const uint8_t scale = mem.scale == 8 ? 3 : mem.scale == 4 ? 2 : mem.scale == 2 ? 1 : 0;
+                Byte(scale << 6 | (indexed ? mem.index & 7 : 4) << 3 | base);
+            } else {
+                Byte(mod << 6 | (reg & 7) << 3 | base);
+            }
+            if (mod == 1) Imm(static_cast<uint32_t>(mem.disp), 1);
+            if (mod == 2) Imm(static_cast<uint32_t>(mem.disp), 4);
+        }
+
+        void AluImm(const bool wide, const Alu op, const Reg dst, const int32_t imm) {
+            const bool small = imm == static_cast<int8_t>(imm);
+            Encode(false, wide, {static_cast<uint8_t>(small ? 0x83 : 0x81)}, static_cast<uint8_t>(op), dst, false);
+            Imm(static_cast<uint32_t>(imm), small ? 1 : 4);
+        }
+
+        template<typename Operand>
+        void ShiftImm(const std::initializer_list<uint8_t> once, const std::initializer_list<uint8_t> counted,
+                      const Shift op, const Operand &operand, const uint8_t count, const bool forceRex) {
+            Encode(false, false, count == 1 ? once : counted, static_cast<uint8_t>(op), operand, forceRex);
+            if (count != 1) Imm(count, 1);
+        }
+
+        std::vector<uint8_t> code_;
+        std::vector<size_t> labels_;
+        std::vector<std::pair<size_t, size_t> > fixups_;
+        std::vector<std::function<void()> > cold_;
+    };
+}
+
+#endif //STARGBC_X64EMITTER_H
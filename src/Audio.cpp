@@ -1,6 +1,8 @@
 #include "Audio.h"
+#include "Trace.h"
 #include <cmath>
 #include <set>
+#include <stdexcept>
 #include <string>
 
 void Audio::TickFrameSequencer() {
@@ -58,6 +60,16 @@ void Audio::Tick() {
     GenerateSample();
 }
 
+void Audio::SetSampleRate(const uint32_t rate) {
+    if (rate < MIN_AUDIO_SAMPLE_RATE || rate > MAX_AUDIO_SAMPLE_RATE) {
+        throw std::runtime_error("Sample rate " + std::to_string(rate) + " is outside " +
+                                 std::to_string(MIN_AUDIO_SAMPLE_RATE) + "-" + std::to_string(MAX_AUDIO_SAMPLE_RATE));
+    }
+    sampleRate = rate;
+    cyclesPerSample = APU_CLOCK_RATE / rate;
+    highpassRate = std::pow(0.999958, cyclesPerSample);
+}
+
 void Audio::WriteAudioControl(const uint8_t value, const bool divBit4High) {
     const bool wasEnabled = audioEnabled;
     audioEnabled = (value & 0x80) != 0;
@@ -637,34 +649,39 @@ uint8_t Channel4::GetDigitalOutput() const {
     return (~lfsr & 1) ? envelope.currentVolume : 0;
 }
 
-void Audio::InitBandLimitedTable() {
-    constexpr double a0 = 7938.0 / 18608.0;
-    constexpr double a1 = 9240.0 / 18608.0;
-    constexpr double a2 = 1430.0 / 18608.0;
+const Audio::BandLimitedTable &Audio::BandLimitedSteps() {
+    static const BandLimitedTable table = [] {
+        constexpr double a0 = 7938.0 / 18608.0;
+        constexpr double a1 = 9240.0 / 18608.0;
+        constexpr double a2 = 1430.0 / 18608.0;
 
-    for (int phase = 0; phase < BL_PHASES; phase++) {
-        double sum = 0.0;
-        for (int i = 0; i < BL_WIDTH; i++) {
-            constexpr double lowpass = 0.9375;
-            const double x = static_cast<double>(i - BL_WIDTH / 2) +
-                             static_cast<double>(phase) / BL_PHASES;
-            const double angle = x * M_PI * lowpass;
+        BandLimitedTable steps{};
+        for (int phase = 0; phase < BL_PHASES; phase++) {
+            double sum = 0.0;
+            for (int i = 0; i < BL_WIDTH; i++) {
+                constexpr double lowpass = 0.9375;
+                const double x = static_cast<double>(i - BL_WIDTH / 2) +
+                                 static_cast<double>(phase) / BL_PHASES;
+                const double angle = x * M_PI * lowpass;
 
-            const double sinc = (std::abs(angle) < 1e-10) ? 1.0 : std::sin(angle) / angle;
+                const double sinc = (std::abs(angle) < 1e-10) ? 1.0 : std::sin(angle) / angle;
 
-            const double windowAngle = M_PI * (static_cast<double>(i) + 0.5) / BL_WIDTH;
-            const double window = a0 - a1 * std::cos(windowAngle) + a2 * std::cos(2.0 * windowAngle);
+                const double windowAngle = M_PI * (static_cast<double>(i) + 0.5) / BL_WIDTH;
+                const double window = a0 - a1 * std::cos(windowAngle) + a2 * std::cos(2.0 * windowAngle);
 
-            blSteps[phase][i] = sinc * window;
-            sum += blSteps[phase][i];
-        }
+                steps[phase][i] = sinc * window;
+                sum += steps[phase][i];
+            }
 
-        if (sum > 0.0) {
-            for (int i = 0; i < BL_WIDTH; i++) {
-                blSteps[phase][i] /= sum;
+            if (sum > 0.0) {
+                for (int i = 0; i < BL_WIDTH; i++) {
+                    steps[phase][i] /= sum;
+                }
             }
         }
-    }
+        return steps;
+    }();
+    return table;
 }
 
 void Audio::BandLimitedUpdate(const int channel, const double left, const double right, const int phase) {
@@ -680,7 +697,7 @@ void Audio::BandLimitedUpdate(const int channel, const double left, const double
     bl.lastLeft = left;
     bl.lastRight = right;
 
-    const auto &kernel = blSteps[phase];
+    const auto &kernel = (*blSteps)[phase];
     for (int i = 0; i < BL_WIDTH; i++) {
         const int idx = (bl.pos + i) & (BL_BUFFER_SIZE - 1);
         bl.bufferLeft[idx] += deltaLeft * kernel[i];
@@ -706,7 +723,7 @@ void Audio::GenerateSample() {
         return (15.0 - digital * 2.0) / 15.0;
     };
 
-    const int phase = static_cast<int>((sampleCounter / CYCLES_PER_SAMPLE) * BL_PHASES) & (BL_PHASES - 1);
+    const int phase = static_cast<int>((sampleCounter / cyclesPerSample) * BL_PHASES) & (BL_PHASES - 1);
     auto getChannelOutput = [&](const int ch, const double output, const bool enabled, const bool dacEnabled,
                                 const uint8_t leftMask, const uint8_t rightMask) {
         const double val = dac(output, enabled && dacEnabled);
@@ -727,12 +744,14 @@ void Audio::GenerateSample() {
     getChannelOutput(3, ch4.currentOutput, ch4.enabled, ch4.dacEnabled, 0x80, 0x08);
 
     sampleCounter += 1.0;
-    if (sampleCounter < CYCLES_PER_SAMPLE) {
+    if (sampleCounter < cyclesPerSample) {
         return;
     }
-    sampleCounter -= CYCLES_PER_SAMPLE;
+    sampleCounter -= cyclesPerSample;
+    TRACE_ZONE("Audio::GenerateSample");
 
     if (samplesAvailable >= AUDIO_BUFFER_SIZE) {
+        ++samplesDropped;
         for (int i = 0; i < 4; i++) {
             double dummy1, dummy2;
             BandLimitedRead(i, dummy1, dummy2);
@@ -761,6 +780,7 @@ void Audio::GenerateSample() {
     sampleBuffer[bufferWritePos * 2 + 1] = static_cast<float>(outRight);
     bufferWritePos = (bufferWritePos + 1) % AUDIO_BUFFER_SIZE;
     samplesAvailable++;
+    ++samplesProduced;
 }
 
 size_t Audio::ReadSamples(float *output, const size_t numSamples) {
@@ -0,0 +1,61 @@
+#include "BootStateCache.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <random>
+
+#include "RomSource.h"
+#include "StateArchive.h"
+
+namespace {
+    struct EntryHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t size;
+        uint32_t crc;
+    };
+}
+
+std::string BootStateCache::Key::FileName() const {
+    char name[48];
+    std::snprintf(name, sizeof(name), "boot-%08x-%08x-%s.state", bootromCrc, headerCrc,
+                  hardware == Hardware::CGB ? "cgb" : "dmg");
+    return name;
+}
+
+BootStateCache::Key BootStateCache::MakeKey(const std::span<const uint8_t> bootrom,
+                                            const std::span<const uint8_t> header, const Hardware hardware) {
+    return {RomSource::Crc32(bootrom), RomSource::Crc32(header), hardware};
+}
+
+std::optional<std::vector<uint8_t> > BootStateCache::Load(const Key &key) const {
+    std::ifstream file(directory_ / key.FileName(), std::ios::binary);
+    if (!file.is_open()) return std::nullopt;
+
+    EntryHeader header{};
+    if (!file.read(reinterpret_cast<char *>(&header), sizeof(header))) return std::nullopt;
+    if (header.magic != MAGIC || header.version != SNAPSHOT_VERSION) return std::nullopt;
+
+    std::vector<uint8_t> snapshot(std::istreambuf_iterator<char>(file), {});
+    if (snapshot.size() != header.size || RomSource::Crc32(snapshot) != header.crc) return std::nullopt;
+    return snapshot;
+}
+
+void BootStateCache::Store(const Key &key, const std::span<const uint8_t> snapshot) const {
+    std::filesystem::create_directories(directory_);
+    const std::filesystem::path path = directory_ / key.FileName();
+    std::filesystem::path temporary = path;
+    temporary += "." + std::to_string(std::random_device{}()) + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) throw std::runtime_error("Could not open " + temporary.string());
+        const EntryHeader header{
+            MAGIC, SNAPSHOT_VERSION, static_cast<uint32_t>(snapshot.size()), RomSource::Crc32(snapshot)
+        };
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char *>(snapshot.data()), static_cast<std::streamsize>(snapshot.size()));
+        if (!file) throw std::runtime_error("Could not write " + temporary.string());
+    }
+    std::filesystem::rename(temporary, path);
+}
@@ -2,6 +2,14 @@
 
 #include <algorithm>
 
+
+std::shared_ptr<const std::vector<uint8_t> > Bus::LoadBootrom(const std::string &path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) throw std::runtime_error("Could not open bootrom " + path);
+    return std::make_shared<const std::vector<uint8_t> >(std::istreambuf_iterator<char>(file),
+                                                         std::istreambuf_iterator<char>());
+}
+
 uint8_t Bus::ReadDMASource(const uint16_t src) {
     const uint8_t page = src >> 8;
     uint8_t returnValue{};
@@ -29,23 +37,34 @@ void Bus::WriteOAM(const uint16_t address, const uint8_t value) const {
 }
 
 uint8_t Bus::ReadByte(const uint16_t address, const ComponentSource source) const {
+    if (NeedsSync(address, source)) syncHook_(syncContext_);
     if (address >= 0xFE00 && address <= 0xFE9F && dma_.transferActive && dma_.ticks > DMA::STARTUP_CYCLES) return 0xFF;
     if (source == ComponentSource::CPU && dma_.transferActive && (address < 0xFF80 || address > 0xFFFE)) return dmaReadByte;
+    return ReadMapped(address, true);
+}
+
+uint8_t Bus::PeekByte(const uint16_t address) const {
+    return ReadMapped(address, false);
+}
+
+uint8_t Bus::ReadMapped(const uint16_t address, const bool countAccess) const {
     switch (address) {
         case 0x0000 ... 0x7FFF: {
             if (bootromRunning) {
                 if (gpu_.hardware == Hardware::CGB && (address < 0x100 || address > 0x1FF)) {
-                    return bootrom[address];
+                    return (*bootrom)[address];
                 }
 
                 if (gpu_.hardware == Hardware::DMG && address < 0x100) {
-                    return bootrom[address];
+                    return (*bootrom)[address];
                 }
             }
             return cartridge_.ReadByte(address);
         }
         case 0x8000 ... 0x9FFF: return gpu_.ReadVRAM(address);
-        case 0xA000 ... 0xBFFF: return cartridge_.ReadByte(address);
+        case 0xA000 ... 0xBFFF:
+            if (countAccess) ++accessEpoch_;
+            return cartridge_.ReadByte(address);
         case 0xC000 ... 0xCFFF: return memory_.wram_[address - 0xC000];
         case 0xD000 ... 0xDFFF: return memory_.wram_[address - 0xD000 + 0x1000 * memory_.wramBank_];
         case 0xE000 ... 0xEFFF: return memory_.wram_[address - 0xE000];
@@ -53,9 +72,13 @@ uint8_t Bus::ReadByte(const uint16_t address, const ComponentSource source) cons
         case 0xFE00 ... 0xFEFF: return address < 0xFEA0 ? ReadOAM(address) : 0xFF;
         case 0xFF00: return joypad_.GetJoypadState() | 0xC0;
         case 0xFF01 ... 0xFF02: return serial_.ReadSerial(address);
-        case 0xFF04 ... 0xFF07: return timer_.ReadByte(address);
+        case 0xFF04 ... 0xFF07:
+            if (countAccess) ++accessEpoch_;
+            return timer_.ReadByte(address);
         case 0xFF0F: return interrupts_.interruptFlag | 0xE0;
-        case 0xFF10 ... 0xFF3F: return audio_.ReadByte(address);
+        case 0xFF10 ... 0xFF3F:
+            if (countAccess) ++accessEpoch_;
+            return audio_.ReadByte(address);
         case 0xFF40 ... 0xFF4F: {
             if (address == 0xFF4D) {
                 if (gpu_.hardware == Hardware::DMG) return 0xFF;
@@ -70,8 +93,10 @@ uint8_t Bus::ReadByte(const uint16_t address, const ComponentSource source) cons
         case 0xFF50 ... 0xFF55: return gpu_.hdma.ReadHDMA(address, gpu_.hardware == Hardware::CGB);
         case 0xFF68 ... 0xFF6C: return gpu_.ReadRegisters(address);
         case 0xFF70: return gpu_.hardware == Hardware::CGB ? memory_.wramBank_ : 0xFF;
-        case 0xFF76: return gpu_.hardware == Hardware::CGB ? audio_.ReadPCM12() : 0xFF;
-        case 0xFF77: return gpu_.hardware == Hardware::CGB ? audio_.ReadPCM34() : 0xFF;
+        case 0xFF76 ... 0xFF77:
+            if (countAccess) ++accessEpoch_;
+            if (gpu_.hardware != Hardware::CGB) return 0xFF;
+            return address == 0xFF76 ? audio_.ReadPCM12() : audio_.ReadPCM34();
         case 0xFF80 ... 0xFFFE: return memory_.hram_[address - 0xFF80];
         case 0xFFFF: return interrupts_.interruptEnable;
         default: return 0xFF;
@@ -79,8 +104,10 @@ uint8_t Bus::ReadByte(const uint16_t address, const ComponentSource source) cons
 }
 
 void Bus::WriteByte(const uint16_t address, const uint8_t value, const ComponentSource source) {
+    if (NeedsSync(address, source)) syncHook_(syncContext_);
     if (address >= 0xFE00 && address <= 0xFE9F && dma_.transferActive && dma_.ticks > DMA::STARTUP_CYCLES) return;
     if (source == ComponentSource::CPU && dma_.transferActive && (address < 0xFF80 || address > 0xFFFE)) return;
+    ++accessEpoch_;
     switch (address) {
         case 0x0000 ... 0x7FFF: cartridge_.WriteByte(address, value);
             break;
@@ -88,13 +115,13 @@ void Bus::WriteByte(const uint16_t address, const uint8_t value, const Component
             break;
         case 0xA000 ... 0xBFFF: cartridge_.WriteByte(address, value);
             break;
-        case 0xC000 ... 0xCFFF: memory_.wram_[address - 0xC000] = value;
+        case 0xC000 ... 0xCFFF: memory_.WriteWram(address - 0xC000, value);
             break;
-        case 0xD000 ... 0xDFFF: memory_.wram_[address - 0xD000 + 0x1000 * memory_.wramBank_] = value;
+        case 0xD000 ... 0xDFFF: memory_.WriteWram(address - 0xD000 + 0x1000 * memory_.wramBank_, value);
             break;
-        case 0xE000 ... 0xEFFF: memory_.wram_[address - 0xE000] = value;
+        case 0xE000 ... 0xEFFF: memory_.WriteWram(address - 0xE000, value);
             break;
-        case 0xF000 ... 0xFDFF: memory_.wram_[address - 0xF000 + 0x1000 * memory_.wramBank_] = value;
+        case 0xF000 ... 0xFDFF: memory_.WriteWram(address - 0xF000 + 0x1000 * memory_.wramBank_, value);
             break;
         case 0xFE00 ... 0xFE9F: WriteOAM(address, value);
             break;
@@ -120,7 +147,7 @@ void Bus::WriteByte(const uint16_t address, const uint8_t value, const Component
             break;
         case 0xFF70: memory_.wramBank_ = (value & 0x07) ? value : 1;
             break;
-        case 0xFF80 ... 0xFFFE: memory_.hram_[address - 0xFF80] = value;
+        case 0xFF80 ... 0xFFFE: memory_.WriteHram(address - 0xFF80, value);
             break;
         case 0xFFFF: interrupts_.interruptEnable = value;
             break;
@@ -138,6 +165,7 @@ void Bus::UpdateDMA() {
             dma_.currentByte = 0;
         }
         if (!dma_.transferActive) { return; }
+        ++oamDmaMCycles;
         if (dma_.restartPending && --dma_.restartCountdown == 0) {
             dma_.restartPending = false;
             dma_.startAddress = dma_.pendingStart;
@@ -155,6 +183,15 @@ void Bus::UpdateDMA() {
     }
 }
 
+bool Bus::DMAIdle() const {
+    return !dma_.transferActive && !dma_.transferComplete &&
+           (!gpu_.hdma.hdmaActive || gpu_.hardware == Hardware::DMG);
+}
+
+void Bus::SkipIdleDMATicks(const uint32_t ticks) {
+    dma_.dmaTickCounter = static_cast<uint8_t>((dma_.dmaTickCounter + ticks) % 4);
+}
+
 void Bus::RunHDMA() const {
     if (!gpu_.hdma.hdmaActive || gpu_.hardware == Hardware::DMG) {
         return;
@@ -162,6 +199,7 @@ void Bus::RunHDMA() const {
 
     switch (gpu_.hdma.hdmaMode) {
         case HDMAMode::GDMA: {
+            gpu_.hdmaSpan.Begin();
             if (gpu_.hdma.step == HDMAStep::Read) {
                 gpu_.hdma.byte = ReadHDMASource(gpu_.hdma.hdmaSource);
                 gpu_.hdma.step = HDMAStep::Write;
@@ -177,7 +215,10 @@ void Bus::RunHDMA() const {
                     gpu_.hdma.hdma5 = gpu_.hdma.hdmaRemain > 0 ? (gpu_.hdma.hdmaRemain - 1) : 0xFF;
                 }
             }
-            if (gpu_.hdma.hdmaRemain == 0) gpu_.hdma.hdmaActive = false;
+            if (gpu_.hdma.hdmaRemain == 0) {
+                gpu_.hdma.hdmaActive = false;
+                gpu_.EndHdmaSpan();
+            }
             return;
         }
         case HDMAMode::HDMA: {
@@ -205,6 +246,7 @@ void Bus::RunHDMA() const {
 
             // We're actively transferring
             gpu_.hdma.transferringBlock = true;
+            gpu_.hdmaSpan.Begin();
 
             if (gpu_.hdma.step == HDMAStep::Read) {
                 gpu_.hdma.byte = ReadHDMASource(gpu_.hdma.hdmaSource);
@@ -222,6 +264,7 @@ void Bus::RunHDMA() const {
                     gpu_.hdma.bytesThisBlock = 0;
                     gpu_.hdma.hdmaRemain -= 1;
                     gpu_.hdma.hdma5 = gpu_.hdma.hdmaRemain > 0 ? (gpu_.hdma.hdmaRemain - 1) : 0xFF;
+                    gpu_.EndHdmaSpan();
                 }
             }
             if (gpu_.hdma.hdmaRemain == 0x00) gpu_.hdma.hdmaActive = false;
@@ -1,56 +1,125 @@
 #include "Cartridge.h"
 #include "Common.h"
+#include "RomSource.h"
+#include "StateArchive.h"
+#include "Trace.h"
 
 #include <algorithm>
 #include <cstring>
 #include <fstream>
 #include <span>
 
-void Cartridge::ReadFile(const std::string &file) {
-    std::ifstream ifs(file, std::ios::binary);
-    if (!ifs.is_open()) {
-        throw std::runtime_error("Could not open file " + file);
-    }
-    std::vector<uint8_t> buffer(std::istreambuf_iterator<char>(ifs), {});
-    gameRom_ = std::move(buffer);
+std::shared_ptr<const RomImage> Cartridge::LoadRom(const std::string &path) {
+    auto image = std::make_shared<RomImage>(RomSource::Load(path));
+    // Every ROM page must be fully backed by data for the cached page pointers
+    image->data.resize(std::max<size_t>(0x8000, (image->data.size() + 0x3FFF) & ~size_t{0x3FFF}), 0xFF);
+    ReadLayout(image->data);
+    return image;
 }
 
 std::string Cartridge::RemoveExtension(const std::string &filename) {
-    const size_t lastdot = filename.find_last_of('.');
-    return lastdot == std::string::npos ? filename : filename.substr(0, lastdot);
+    // "game.gb.gz" saves to "game.sav", same as "game.gb"
+    const std::string name = RomSource::StripContainerExtension(filename);
+    const size_t lastdot = name.find_last_of('.');
+    return lastdot == std::string::npos ? name : name.substr(0, lastdot);
+}
+
+void Cartridge::Insert(const std::string &romLocation, std::shared_ptr<const RomImage> rom, const bool loadSave) {
+    // Throws on a header we cannot run, before anything of the old game is touched
+    const Layout layout = ReadLayout(rom->data);
+    rom_ = std::move(rom);
+    // The clock is the cartridge's; the save file restores it if it ran
+    rtc_ = RealTimeClock(rtc_.realRTC_);
+    rtc_.RecalculateZeroTime();
+    gameRom_ = rom_->data;
+    romBankCount = gameRom_.size() / 0x4000;
+    lowRomMask = std::bit_width(romBankCount) - 1;
+    savepath_ = RemoveExtension(romLocation).append(".sav");
+    mbc = layout.mbc;
+    hasRumble_ = layout.rumble;
+    gameRamSize = layout.ramSize;
+    if (loadSave && layout.battery && gameRamSize) { LoadRam(gameRamSize); } else { gameRam_.assign(gameRamSize, 0); }
+    // Blank EEPROM and flash read back as all ones
+    const auto erase = [](const std::span<uint8_t> cells) {
+        if (std::ranges::all_of(cells, [](const uint8_t b) { return b == 0; })) std::ranges::fill(cells, 0xFF);
+    };
+    if (mbc == MBC::MBC7) erase(gameRam_);
+    if (mbc == MBC::MBC6) erase(std::span(gameRam_).subspan(MBC6Mapper::RAM_SIZE));
+    ramDirty_ = false;
+    ResetBankRegisters();
+    ramBankCount = gameRam_.size() / 0x2000;
+    multicart = IsLikelyMulticart();
+    InstallMapper();
+}
+
+void Cartridge::SetGameRam(const std::span<const uint8_t> ram) {
+    if (ram.size() != gameRam_.size()) throw std::runtime_error("Save RAM is the wrong size for this cartridge");
+    std::ranges::copy(ram, gameRam_.begin());
+}
+
+void Cartridge::Reset() {
+    ResetBankRegisters();
+    mapHandler_(*this);
 }
 
-void Cartridge::LoadRam(const uint16_t size) {
+void Cartridge::ResetBankRegisters() {
+    romBank = 0x01;
+    ramBank = 0x00;
+    bank1 = 0x01;
+    bank2 = 0x00;
+    mode = 0x00;
+    ramEnabled = false;
+    prevRamEnable_ = false;
+    if (rumbleOn_ && rumbleCallback_) rumbleCallback_(false);
+    rumbleOn_ = false;
+    mapperState_ = {};
+}
+
+void Cartridge::LoadRam(const uint32_t size) {
     std::ifstream ifs(savepath_, std::ios::binary);
     if (!ifs.is_open()) {
-        gameRam_.resize(size, 0);
+        gameRam_.assign(size, 0);
         return;
     }
     rtc_.Load(ifs);
     std::vector<uint8_t> buffer(std::istreambuf_iterator<char>(ifs), {});
     gameRam_ = std::move(buffer);
+    gameRam_.resize(size, 0);
     ifs.close();
 }
 
-void Cartridge::DetermineMBC() {
-    auto provisionRam = [&](const uint16_t sz, const bool load) {
-        gameRamSize = sz;
-        if (load && gameRamSize) { LoadRam(sz); } else { gameRam_.assign(sz, 0); }
+Cartridge::Layout Cartridge::ReadLayout(const std::span<const uint8_t> rom) {
+    Layout layout;
+    auto provisionRam = [&](const uint32_t sz, const bool battery) {
+        layout.ramSize = sz;
+        layout.battery = battery;
     };
 
-    mbc = [&]() -> MBC {
+    // MMM01 dumps keep the menu (and the only valid header) in the last 32 KiB
+    const size_t menuHeader = rom.size() - 0x8000;
+    const bool mmm01 = rom[menuHeader + 0x147] >= 0x0B && rom[menuHeader + 0x147] <= 0x0D;
+    const uint8_t cartType = mmm01 ? rom[menuHeader + 0x147] : rom[0x147];
+    const uint8_t ramSize = mmm01 ? rom[menuHeader + 0x149] : rom[0x149];
+
+    layout.mbc = [&]() -> MBC {
         using enum MBC;
-        switch (gameRom_[0x147]) {
+        switch (cartType) {
             case 0x00: return None;
+            case 0x08: // +RAM
+                provisionRam(GetRamSize(ramSize), false);
+                return None;
+            case 0x09: // +RAM +Battery
+                provisionRam(GetRamSize(ramSize), true);
+                return None;
 
             /* MBC1 */
             case 0x01: return MBC1;
             case 0x02: {
-                provisionRam(GetRamSize(gameRom_[0x149]), false);
+                provisionRam(GetRamSize(ramSize), false);
                 return MBC1;
             }
             case 0x03: {
-                provisionRam(GetRamSize(gameRom_[0x149]), true);
+                provisionRam(GetRamSize(ramSize), true);
                 return MBC1;
             }
 
@@ -64,112 +133,97 @@ void Cartridge::DetermineMBC() {
                 return MBC2;
             }
 
+            /* MMM01 */
+            case 0x0B: return MMM01;
+            case 0x0C: // +RAM
+                provisionRam(GetRamSize(ramSize), false);
+                return MMM01;
+            case 0x0D: // +RAM +Battery
+                provisionRam(GetRamSize(ramSize), true);
+                return MMM01;
+
             /* MBC3 */
             case 0x0F: // +Timer +Battery (no RAM)
             case 0x11: // plain MBC3
                 return MBC3;
             case 0x10: // +Timer +RAM +Battery
             case 0x13: // +RAM +Battery
-                provisionRam(GetRamSize(gameRom_[0x149]), true);
+                provisionRam(GetRamSize(ramSize), true);
                 return MBC3;
             case 0x12: // +RAM
-                provisionRam(GetRamSize(gameRom_[0x149]), false);
+                provisionRam(GetRamSize(ramSize), false);
                 return MBC3;
 
             /* MBC5 */
             case 0x19: return MBC5;
             case 0x1A: // +RAM
-                provisionRam(GetRamSize(gameRom_[0x149]), false);
+                provisionRam(GetRamSize(ramSize), false);
                 return MBC5;
             case 0x1B: // +RAM +Battery
-                provisionRam(GetRamSize(gameRom_[0x149]), true);
+                provisionRam(GetRamSize(ramSize), true);
                 return MBC5;
             case 0x1C: // +Rumble
-                hasRumble_ = true;
+                layout.rumble = true;
                 return MBC5;
             case 0x1D: // +Rumble +RAM
-                hasRumble_ = true;
-                provisionRam(GetRamSize(gameRom_[0x149]), false);
+                layout.rumble = true;
+                provisionRam(GetRamSize(ramSize), false);
                 return MBC5;
             case 0x1E: // +Rumble +RAM +Battery
-                hasRumble_ = true;
-                provisionRam(GetRamSize(gameRom_[0x149]), true);
+                layout.rumble = true;
+                provisionRam(GetRamSize(ramSize), true);
                 return MBC5;
-            default: throw FatalErrorException("Unsupported MBC: " + std::to_string(gameRom_[0x147]));
+
+            /* MBC6: 32 KiB SRAM followed by 1 MiB flash, both battery backed */
+            case 0x20:
+                provisionRam(MBC6Mapper::RAM_SIZE + MBC6Mapper::FLASH_SIZE, true);
+                return MBC6;
+
+            /* MBC7: 93LC56 EEPROM + accelerometer */
+            case 0x22:
+                provisionRam(MBC7Mapper::EEPROM_SIZE, true);
+                return MBC7;
+
+            case 0xFC: // Pocket Camera
+                provisionRam(PocketCameraMapper::RAM_SIZE, true);
+                return PocketCamera;
+            case 0xFE: // HuC3 +RTC +RAM +Battery
+                provisionRam(GetRamSize(ramSize), true);
+                return HuC3;
+            case 0xFF: // HuC1 +RAM +Battery
+                provisionRam(GetRamSize(ramSize), true);
+                return HuC1;
+            default: throw FatalErrorException("Unsupported MBC: " + std::to_string(cartType));
         }
     }();
 
-    switch (gameRom_[0x147]) {
-        case 0x00:
-            mbc = MBC::None;
+    return layout;
+}
+
+void Cartridge::InstallMapper() {
+    switch (mbc) {
+        case MBC::None: Install<NoMapper>();
             break;
-        case 0x01:
-            mbc = MBC::MBC1;
+        case MBC::MBC1: Install<MBC1Mapper>();
             break;
-        case 0x02: {
-            mbc = MBC::MBC1;
-            const uint16_t ramSize = GetRamSize(gameRom_[0x149]);
-            gameRamSize = ramSize;
-            gameRam_ = std::vector<uint8_t>(ramSize);
-        }
-        case 0x03: {
-            mbc = MBC::MBC1;
-            const uint16_t ramSize = GetRamSize(gameRom_[0x149]);
-            gameRamSize = ramSize;
-            gameRam_.reserve(ramSize);
-            LoadRam(ramSize);
+        case MBC::MBC2: Install<MBC2Mapper>();
             break;
-        }
-        case 0x05:
-            mbc = MBC::MBC2;
-            gameRamSize = 0x200;
-            gameRam_ = std::vector<uint8_t>(0x200);
+        case MBC::MBC3: Install<MBC3Mapper>();
             break;
-        case 0x06:
-            mbc = MBC::MBC2;
-            gameRamSize = 0x200;
-            LoadRam(0x200);
+        case MBC::MBC5: Install<MBC5Mapper>();
             break;
-        case 0x0F:
-        case 0x11:
-            mbc = MBC::MBC3;
+        case MBC::MBC6: Install<MBC6Mapper>();
             break;
-        case 0x10:
-        case 0x13: {
-            mbc = MBC::MBC3;
-            const uint16_t ramSize = GetRamSize(gameRom_[0x149]);
-            gameRamSize = ramSize;
-            LoadRam(ramSize);
+        case MBC::MBC7: Install<MBC7Mapper>();
             break;
-        }
-        case 0x12: {
-            mbc = MBC::MBC3;
-            const uint16_t ramSize = GetRamSize(gameRom_[0x149]);
-            gameRamSize = ramSize;
-            gameRam_ = std::vector<uint8_t>(ramSize);
+        case MBC::HuC1: Install<HuC1Mapper>();
             break;
-        }
-
-        /* MCB5 versions */
-        case 0x19:
-            mbc = MBC::MBC5;
+        case MBC::HuC3: Install<HuC3Mapper>();
             break;
-        case 0x1A: {
-            mbc = MBC::MBC5;
-            const uint16_t ramSize = GetRamSize(gameRom_[0x149]);
-            gameRamSize = ramSize;
-            gameRam_ = std::vector<uint8_t>(ramSize);
+        case MBC::MMM01: Install<MMM01Mapper>();
             break;
-        }
-        case 0x1B: {
-            mbc = MBC::MBC5;
-            const uint16_t ramSize = GetRamSize(gameRom_[0x149]);
-            gameRamSize = ramSize;
-            LoadRam(ramSize);
+        case MBC::PocketCamera: Install<PocketCameraMapper>();
             break;
-        }
-        default:
-            throw FatalErrorException("Unsupported MBC: " + std::to_string(gameRom_[0x147]));
     }
 }
 
@@ -211,8 +265,9 @@ bool Cartridge::IsLikelyMulticart() const {
     return false;
 }
 
-uint8_t Cartridge::BankBitmask() const {
-    return lowRomMask >= 8 ? 0xFF : static_cast<uint8_t>((1 << lowRomMask) - 1);
+uint16_t Cartridge::BankBitmask() const {
+    // Up to the 512 banks of an 8 MiB MBC5 ROM
+    return static_cast<uint16_t>((1u << lowRomMask) - 1);
 }
 
 uint32_t Cartridge::GetRamSize(const uint8_t byte) {
@@ -251,7 +306,8 @@ uint32_t Cartridge::HandleRamBank() const {
 }
 
 void Cartridge::Save() const {
-    if (mbc == MBC::None || gameRamSize == 0) return;
+    if (gameRamSize == 0 || !saveWritable_) return;
+    TRACE_ZONE("Cartridge::Save");
 
     std::ofstream file(savepath_, std::ios::binary | std::ios::trunc);
     if (!file.is_open()) throw std::runtime_error("Could not open " + savepath_);
@@ -261,212 +317,58 @@ void Cartridge::Save() const {
 }
 
 uint8_t Cartridge::ReadByte(const uint16_t address) const {
-    switch (mbc) {
-        case MBC::None: return ReadByteNone(address);
-        case MBC::MBC1: return ReadByteMBC1(address);
-        case MBC::MBC2: return ReadByteMBC2(address);
-        case MBC::MBC3: return ReadByteMBC3(address);
-        case MBC::MBC5: return ReadByteMBC5(address);
-        default: throw UnreachableCodeException("Unsupported MBC");
-    }
-}
-
-uint8_t Cartridge::ReadByteNone(const uint16_t address) const {
-    return gameRom_[address];
-}
-
-uint8_t Cartridge::ReadByteMBC1(const uint16_t address) const {
-    switch (address) {
-        case 0x0000 ... 0x3FFF: return gameRom_[((HandleRomBank(address) * 0x4000) + address) % gameRom_.size()];
-        case 0x4000 ... 0x7FFF: return gameRom_[(HandleRomBank(address) * 0x4000) | (address & 0x3FFF)];
-        case 0xA000 ... 0xBFFF: {
-            if (!ramEnabled || gameRamSize == 0) return 0xFF;
-            const size_t bank = HandleRamBank();
-            const size_t offset = (address - 0xA000) + bank * 0x2000;
-            if (offset >= gameRamSize) return 0xFF;
-            return gameRam_[offset];
-        }
-        default: return 0xFF;
-    }
-}
-
-uint8_t Cartridge::ReadByteMBC2(const uint16_t address) const {
-    switch (address) {
-        case 0x0000 ... 0x3FFF:
-            return gameRom_[address];
-        case 0x4000 ... 0x7FFF:
-            return gameRom_[(bank1 & 0xF & BankBitmask()) * 0x4000ULL | (address & 0x3FFF)];
-        case 0xA000 ... 0xBFFF: {
-            if (!ramEnabled || gameRamSize == 0) return 0xFF;
-            const uint8_t lower = gameRam_[(address - 0xA000) % gameRam_.size()] & 0x0F;
-            return 0xF0 | lower;
-        }
-        default: return 0xFF;
+    if (address < 0x8000) return romPages_[address >> 13][address & 0x1FFF];
+    if (address >= 0xA000 && address <= 0xBFFF) {
+        if (const uint8_t *page = ramPages_[(address >> 12) & 0x01]) return page[address & 0x0FFF];
     }
+    return readHandler_(*this, address);
 }
 
-uint8_t Cartridge::ReadByteMBC3(const uint16_t address) const {
-    switch (address) {
-        case 0x0000 ... 0x3FFF:
-            return gameRom_[address];
-        case 0x4000 ... 0x7FFF:
-            return gameRom_[static_cast<uint64_t>(romBank & BankBitmask()) * 0x4000ULL + (address - 0x4000)];
-        case 0xA000 ... 0xBFFF: {
-            if (!ramEnabled) return 0xFF;
-            if (ramBank <= 0x03 && gameRamSize > 0) {
-                return gameRam_[static_cast<uint64_t>(ramBank) * 0x2000ULL + (address - 0xA000)];
-            }
-            return rtc_.ReadRTC(ramBank);
-        }
-        default: return 0xFF;
-    }
-}
-
-uint8_t Cartridge::ReadByteMBC5(const uint16_t address) const {
-    switch (address) {
-        case 0x0000 ... 0x3FFF: return gameRom_[address];
-        case 0x4000 ... 0x7FFF: return gameRom_[static_cast<uint64_t>(romBank & BankBitmask()) * 0x4000ULL + (address - 0x4000)];
-        case 0xA000 ... 0xBFFF: return ramEnabled && gameRamSize > 0
-                                           ? gameRam_[static_cast<uint64_t>(ramBank) * 0x2000ULL + (address - 0xA000)]
-                                           : 0xFF;
-        default: return 0xFF;
+void Cartridge::WriteByte(const uint16_t address, const uint8_t value) {
+    writeHandler_(*this, address, value);
+    if (address < 0x8000) {
+        const auto romPages = romPages_;
+        const auto ramPages = ramPages_;
+        mapHandler_(*this);
+        if (romPages != romPages_ || ramPages != ramPages_) ++bankSwitches;
     }
 }
 
-void Cartridge::WriteByte(const uint16_t address, const uint8_t value) {
-    switch (mbc) {
-        case MBC::None: break;
-        case MBC::MBC1: WriteByteMBC1(address, value);
-            break;
-        case MBC::MBC2: WriteByteMBC2(address, value);
-            break;
-        case MBC::MBC3: WriteByteMBC3(address, value);
-            break;
-        case MBC::MBC5: WriteByteMBC5(address, value);
-            break;
-    }
+size_t Cartridge::RomPageOffset(const uint16_t address) const {
+    const auto page = reinterpret_cast<uintptr_t>(romPages_[address >> 13]);
+    const auto rom = reinterpret_cast<uintptr_t>(gameRom_.data());
+    return page >= rom && page < rom + gameRom_.size() ? page - rom : NO_ROM_OFFSET;
 }
 
-void Cartridge::WriteByteMBC1(const uint16_t address, const uint8_t value) {
-    switch (address) {
-        case 0x0000 ... 0x1FFF: {
-            const bool newEnable = (value & 0x0F) == 0x0A;
-            HandleRamEnableEdge(newEnable);
-            ramEnabled = newEnable;
-        }
-        break;
-        case 0x2000 ... 0x3FFF: {
-            bank1 = value & 0x1F;
-            if (bank1 == 0) bank1 = 1;
-        }
-        break;
-        case 0x4000 ... 0x5FFF:
-            bank2 = value & 0x03;
-            break;
-        case 0x6000 ... 0x7FFF:
-            mode = value & 0x01;
-            break;
-        case 0xA000 ... 0xBFFF:
-            if (ramEnabled && gameRamSize > 0) {
-                gameRam_[(HandleRamBank() * 0x2000ULL + (address - 0xA000))] = value;
-                ramDirty_ = true;
-            }
-            break;
-        default:
-            break;
-    }
+void Cartridge::MapRom(const size_t bank0, const size_t bankN) {
+    const uint8_t *rom0 = gameRom_.data() + (bank0 % romBankCount) * 0x4000ULL;
+    const uint8_t *romN = gameRom_.data() + (bankN % romBankCount) * 0x4000ULL;
+    romPages_ = {rom0, rom0 + 0x2000, romN, romN + 0x2000};
 }
 
-void Cartridge::WriteByteMBC2(const uint16_t address, const uint8_t value) {
-    switch (address) {
-        case 0x0000 ... 0x3FFF: {
-            if ((address & 0x100) == 0x00) {
-                const bool newEnable = (value & 0xF) == 0x0A;
-                HandleRamEnableEdge(newEnable);
-                ramEnabled = newEnable;
-            } else {
-                bank1 = value & 0x0F; // romb analogous to bank1
-                if (bank1 == 0) bank1 = 1;
-            }
-            break;
-        }
-        case 0xA000 ... 0xBFFF: {
-            if (ramEnabled && gameRamSize > 0) {
-                gameRam_[(address - 0xA000) % gameRam_.size()] = value & 0xF;
-                ramDirty_ = true;
-            }
-        }
-        break;
-        default: break;
+void Cartridge::MapRam(const bool enabled, const size_t bank) {
+    const size_t ramSize = std::min<size_t>(gameRamSize, gameRam_.size());
+    if (!enabled || (bank + 1) * 0x2000ULL > ramSize) {
+        UnmapRam();
+        return;
     }
+    uint8_t *ram = gameRam_.data() + bank * 0x2000ULL;
+    ramPages_ = {ram, ram + 0x1000};
 }
 
-void Cartridge::WriteByteMBC3(const uint16_t address, const uint8_t value) {
-    switch (address) {
-        case 0x0000 ... 0x1FFF: {
-            const bool newEnable = (value & 0x0F) == 0x0A;
-            HandleRamEnableEdge(newEnable);
-            ramEnabled = newEnable;
-        }
-        break;
-        case 0x2000 ... 0x3FFF:
-            romBank = value ? value : 1;
-            break;
-        case 0x4000 ... 0x5FFF:
-            ramBank = value & 0x0F;
-            break;
-        case 0x6000 ... 0x7FFF:
-            std::memcpy(&rtc_.latchedClock_, &rtc_.realClock_, sizeof(rtc_.latchedClock_));
-            break;
-        case 0xA000 ... 0xBFFF:
-            if (ramEnabled) {
-                ramDirty_ = true;
-                if (ramBank <= 0x03 && gameRamSize > 0) {
-                    gameRam_[static_cast<uint64_t>(ramBank) * 0x2000ULL + (address - 0xA000)] = value;
-                } else {
-                    rtc_.WriteRTC(ramBank, value);
-                }
-            }
-            break;
-        default:
-            break;
-    }
+void Cartridge::UnmapRam() {
+    ramPages_ = {nullptr, nullptr};
 }
 
-void Cartridge::WriteByteMBC5(const uint16_t address, const uint8_t value) {
-    switch (address) {
-        case 0x0000 ... 0x1FFF: {
-            const bool newEnable = (value & 0x0F) == 0x0A;
-            HandleRamEnableEdge(newEnable);
-            ramEnabled = newEnable;
-        }
-        break;
-        case 0x2000 ... 0x2FFF:
-            romBank = romBank & 0x100 | value;
-            break;
-        case 0x3000 ... 0x3FFF:
-            romBank = romBank & 0xFF | (value & 0x01) << 8;
-            break;
-        case 0x4000 ... 0x5FFF: {
-            const bool rumbleRequest = (value & 0x10) != 0;
-            ramBank = value & 0x0F;
-            if (hasRumble_ && rumbleRequest != rumbleOn_) {
-                rumbleOn_ = rumbleRequest;
-                if (rumbleCallback_) rumbleCallback_(rumbleOn_);
-            }
-        }
-        break;
-        case 0xA000 ... 0xBFFF:
-            if (ramEnabled && gameRamSize != 0) {
-                gameRam_[ramBank * 0x2000ULL + address - 0xA000] = value;
-                ramDirty_ = true;
-            }
-            break;
-        default: break;
-    }
+bool Cartridge::WriteRamPage(const uint16_t address, const uint8_t value) {
+    uint8_t *page = ramPages_[(address >> 12) & 0x01];
+    if (!page) return false;
+    page[address & 0x0FFF] = value;
+    ramDirty_ = true;
+    return true;
 }
 
-inline void Cartridge::HandleRamEnableEdge(const bool enable) {
+void Cartridge::HandleRamEnableEdge(const bool enable) {
     if (prevRamEnable_ && !enable && ramDirty_) {
         Save();
         ramDirty_ = false;
@@ -488,6 +390,10 @@ bool Cartridge::SaveState(std::ofstream &stateFile) const {
         stateFile.write(reinterpret_cast<const char *>(&mbc), sizeof(mbc));
         stateFile.write(reinterpret_cast<const char *>(&ramDirty_), sizeof(ramDirty_));
         stateFile.write(reinterpret_cast<const char *>(&prevRamEnable_), sizeof(prevRamEnable_));
+        std::vector<uint8_t> mapper;
+        StateWriter writer(mapper);
+        writer(mapperState_);
+        stateFile.write(reinterpret_cast<const char *>(mapper.data()), static_cast<std::streamsize>(mapper.size()));
         rtc_.Save(stateFile);
         return true;
     } catch ([[maybe_unused]] const std::exception &e) {
@@ -508,7 +414,15 @@ bool Cartridge::LoadState(std::ifstream &stateFile) {
         stateFile.read(reinterpret_cast<char *>(&mbc), sizeof(mbc));
         stateFile.read(reinterpret_cast<char *>(&ramDirty_), sizeof(ramDirty_));
         stateFile.read(reinterpret_cast<char *>(&prevRamEnable_), sizeof(prevRamEnable_));
+        // The mapper registers serialize to the same size whatever their values
+        std::vector<uint8_t> mapper;
+        StateWriter writer(mapper);
+        writer(mapperState_);
+        stateFile.read(reinterpret_cast<char *>(mapper.data()), static_cast<std::streamsize>(mapper.size()));
+        StateReader reader(mapper);
+        reader(mapperState_);
         rtc_.Load(stateFile);
+        mapHandler_(*this);
         return true;
     } catch ([[maybe_unused]] const std::exception &e) {
         return false;
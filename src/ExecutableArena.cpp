@@ -0,0 +1,57 @@
+#include "ExecutableArena.h"
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef STARGBC_JIT_X64
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+ExecutableArena::ExecutableArena(const size_t capacity) {
+#ifdef STARGBC_JIT_X64
+    void *base = mmap(nullptr, capacity, PROT_READ | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) return; // Commit() then reports the arena as full
+    base_ = static_cast<uint8_t *>(base);
+    capacity_ = capacity;
+#else
+    static_cast<void>(capacity);
+#endif
+}
+
+ExecutableArena::~ExecutableArena() {
+#ifdef STARGBC_JIT_X64
+    if (base_) munmap(base_, capacity_);
+#endif
+}
+
+bool ExecutableArena::Supported() {
+#ifdef STARGBC_JIT_X64
+    return true;
+#else
+    return false;
+#endif
+}
+
+const void *ExecutableArena::Commit(const std::span<const uint8_t> code) {
+#ifdef STARGBC_JIT_X64
+    static constexpr size_t ALIGNMENT = 16;
+    const size_t start = (used_ + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    if (!base_ || code.size() > capacity_ - std::min(start, capacity_)) return nullptr;
+    // Only the pages the code lands on change protection
+    const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    uint8_t *first = base_ + start / pageSize * pageSize;
+    const auto length = static_cast<size_t>(base_ + start + code.size() - first);
+    if (mprotect(first, length, PROT_READ | PROT_WRITE) != 0) return nullptr;
+    std::memcpy(base_ + start, code.data(), code.size());
+    if (mprotect(first, length, PROT_READ | PROT_EXEC) != 0) {
+        used_ = capacity_; // treat as full rather than hand out code that cannot run
+        return nullptr;
+    }
+    used_ = start + code.size();
+    return base_ + start;
+#else
+    static_cast<void>(code);
+    return nullptr;
+#endif
+}
@@ -0,0 +1,132 @@
+#include "FrameCapture.h"
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <stdexcept>
+
+#include "PngWriter.h"
+
+FrameCapture::FrameCapture(std::string path, const Format format, const size_t poolFrames)
+    : path_(std::move(path)), format_(format), poolFrames_(std::max<size_t>(poolFrames, 1)),
+      pool_(poolFrames_ * FRAME_PIXELS), slotFrame_(poolFrames_) {
+    if (format_ == Format::Png) {
+        std::filesystem::create_directories(path_);
+    } else {
+        out_ = path_ == "-" ? stdout : std::fopen(path_.c_str(), "wb");
+        if (!out_) throw std::runtime_error("Could not open " + path_);
+        if (format_ == Format::Y4m) {
+            // 4194304 Hz over 70224 cycles a frame, about 59.73 fps
+            std::fprintf(out_, "YUV4MPEG2 W%d H%d F4194304:70224 Ip A1:1 C444\n", SCREEN_WIDTH, SCREEN_HEIGHT);
+            planes_.resize(FRAME_PIXELS * 3);
+        }
+    }
+    worker_ = std::thread([this] { Run(); });
+}
+
+FrameCapture::~FrameCapture() {
+    stopping_.store(true, std::memory_order_release);
+    wake_.fetch_add(1, std::memory_order_release);
+    wake_.notify_one();
+    worker_.join();
+    if (out_ == stdout) std::fflush(out_);
+    else if (out_) std::fclose(out_);
+}
+
+FrameCapture::Format FrameCapture::FormatOf(const std::string &path) {
+    const std::string extension = std::filesystem::path(path).extension().string();
+    if (path == "-" || extension == ".y4m") return Format::Y4m;
+    if (extension == ".rgba") return Format::Rgba;
+    return Format::Png;
+}
+
+bool FrameCapture::Submit(const uint32_t *pixels) {
+    const uint64_t frame = submitted_++;
+    const uint64_t head = head_.load(std::memory_order_relaxed);
+    if (failed_.load(std::memory_order_acquire) || head - tail_.load(std::memory_order_acquire) == poolFrames_) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    const size_t slot = head % poolFrames_;
+    std::memcpy(&pool_[slot * FRAME_PIXELS], pixels, FRAME_PIXELS * sizeof(uint32_t));
+    slotFrame_[slot] = frame;
+    head_.store(head + 1, std::memory_order_release);
+    wake_.fetch_add(1, std::memory_order_release);
+    wake_.notify_one();
+    return true;
+}
+
+FrameCapture::Stats FrameCapture::GetStats() const {
+    return {
+        submitted_, written_.load(std::memory_order_relaxed), dropped_.load(std::memory_order_relaxed)
+    };
+}
+
+std::string FrameCapture::Error() const {
+    return failed_.load(std::memory_order_acquire) ? error_ : std::string{};
+}
+
+void FrameCapture::Run() {
+    uint64_t tail = 0;
+    while (true) {
+        // Read before looking for work, so a Submit() after the check still wakes us
+        const uint32_t wake = wake_.load(std::memory_order_acquire);
+        const bool stopping = stopping_.load(std::memory_order_acquire);
+        const uint64_t head = head_.load(std::memory_order_acquire);
+        for (; tail < head; ++tail) {
+            const size_t slot = tail % poolFrames_;
+            if (!failed_.load(std::memory_order_relaxed)) {
+                try {
+                    Write(&pool_[slot * FRAME_PIXELS], slotFrame_[slot]);
+                    written_.fetch_add(1, std::memory_order_relaxed);
+                } catch (const std::exception &e) {
+                    error_ = e.what();
+                    failed_.store(true, std::memory_order_release);
+                }
+            }
+            if (failed_.load(std::memory_order_relaxed)) dropped_.fetch_add(1, std::memory_order_relaxed);
+            tail_.store(tail + 1, std::memory_order_release);
+        }
+        if (stopping) return;
+        wake_.wait(wake, std::memory_order_acquire);
+    }
+}
+
+void FrameCapture::Write(const uint32_t *pixels, const uint64_t frame) {
+    switch (format_) {
+        case Format::Png: {
+            char name[32];
+            std::snprintf(name, sizeof(name), "frame-%08llu.png", static_cast<unsigned long long>(frame));
+            WritePng((std::filesystem::path(path_) / name).string(), pixels, SCREEN_WIDTH, SCREEN_HEIGHT);
+            return;
+        }
+        case Format::Y4m:
+            WriteY4mFrame(pixels);
+            return;
+        case Format::Rgba:
+            if (std::fwrite(pixels, sizeof(uint32_t), FRAME_PIXELS, out_) != FRAME_PIXELS) {
+                throw std::runtime_error("Could not write " + path_);
+            }
+            return;
+    }
+}
+
+void FrameCapture::WriteY4mFrame(const uint32_t *pixels) {
+    // BT.601 studio range, the default every YUV4MPEG reader assumes
+    const auto *rgba = reinterpret_cast<const uint8_t *>(pixels);
+    uint8_t *y = planes_.data();
+    uint8_t *u = y + FRAME_PIXELS;
+    uint8_t *v = u + FRAME_PIXELS;
+    for (size_t i = 0; i < FRAME_PIXELS; i++) {
+        const int r = rgba[i * 4];
+        const int g = rgba[i * 4 + 1];
+        const int b = rgba[i * 4 + 2];
+        y[i] = static_cast<uint8_t>(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+        u[i] = static_cast<uint8_t>(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+        v[i] = static_cast<uint8_t>(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+    }
+    if (std::fputs("FRAME\n", out_) == EOF || std::fwrite(planes_.data(), 1, planes_.size(), out_) != planes_.size()) {
+        throw std::runtime_error("Could not write " + path_);
+    }
+}
@@ -0,0 +1,52 @@
+#include "FrameHashLog.h"
+
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+    constexpr uint32_t MAGIC = 0x48424753; // "SGBH"
+    constexpr uint32_t FORMAT_VERSION = 1;
+
+    struct LogHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t romCrc32;
+        uint32_t interval;
+        uint64_t count;
+    };
+}
+
+void FrameHashLog::Write(const std::string &path) const {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) throw std::runtime_error("Could not open " + path);
+    const LogHeader header{MAGIC, FORMAT_VERSION, romCrc32_, interval_, hashes_.size()};
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(hashes_.data()),
+               static_cast<std::streamsize>(hashes_.size() * sizeof(uint64_t)));
+    if (!file) throw std::runtime_error("Could not write " + path);
+}
+
+FrameHashLog FrameHashLog::Read(const std::string &path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) throw std::runtime_error("Could not open " + path);
+    LogHeader header{};
+    if (!file.read(reinterpret_cast<char *>(&header), sizeof(header)) || header.magic != MAGIC) {
+        throw std::runtime_error(path + " is not a frame hash log");
+    }
+    if (header.version != FORMAT_VERSION) throw std::runtime_error(path + " is from another version");
+    // The count has to match the rest of the file before anything is allocated for it
+    const std::streamoff start = file.tellg();
+    file.seekg(0, std::ios::end);
+    const auto remaining = static_cast<uint64_t>(file.tellg() - start);
+    if (header.count > remaining / sizeof(uint64_t)) throw std::runtime_error(path + " is truncated");
+    if (header.count * sizeof(uint64_t) != remaining) throw std::runtime_error(path + " is damaged");
+    file.seekg(start);
+
+    FrameHashLog log(header.romCrc32, header.interval);
+    log.hashes_.resize(header.count);
+    if (!file.read(reinterpret_cast<char *>(log.hashes_.data()),
+                   static_cast<std::streamsize>(header.count * sizeof(uint64_t)))) {
+        throw std::runtime_error(path + " is truncated");
+    }
+    return log;
+}
@@ -2,11 +2,39 @@
 
 #include "GPU.h"
 #include "Common.h"
+#include "Trace.h"
 
 static constexpr uint8_t expand5(const uint8_t c) noexcept {
     return static_cast<uint8_t>(c << 3 | c >> 2);
 }
 
+// Colour-corrected RGBA for every RGB555 value. Built at compile time, so it
+// lives in read-only data shared by every GPU in the process.
+static constexpr auto kCgbColorLut = [] {
+    std::array<uint32_t, 0x8000> lut{};
+    for (uint32_t rgb = 0; rgb < lut.size(); ++rgb) {
+        const uint32_t r5 = rgb & 0x1F;
+        const uint32_t g5 = rgb >> 5 & 0x1F;
+        const uint32_t b5 = rgb >> 10 & 0x1F;
+
+        const auto corrR5 = static_cast<uint8_t>((26 * r5 + 4 * g5 + 2 * b5) >> 5);
+        const auto corrG5 = static_cast<uint8_t>((6 * r5 + 24 * g5 + 2 * b5) >> 5);
+        const auto corrB5 = static_cast<uint8_t>((2 * r5 + 4 * g5 + 26 * b5) >> 5);
+
+        lut[rgb] = 0xFF000000u |
+                   static_cast<uint32_t>(expand5(corrB5)) << 16 |
+                   static_cast<uint32_t>(expand5(corrG5)) << 8 |
+                   expand5(corrR5);
+    }
+    return lut;
+}();
+
+static constexpr std::array<const char *, 4> MODE_ZONES = {"GPU HBlank", "GPU VBlank", "GPU OAM scan", "GPU Drawing"};
+
+static uint32_t CorrectedColor(const std::array<uint8_t, 3> &rgb) {
+    return kCgbColorLut[(rgb[0] & 0x1F) | (rgb[1] & 0x1F) << 5 | (rgb[2] & 0x1F) << 10];
+}
+
 bool GPU::LCDDisabled() const {
     return !Bit<LCDC_ENABLE_BIT>(lcdc);
 }
@@ -29,6 +57,52 @@ uint8_t GPU::GetOAMScanRow() const {
     return scanlineCounter / 4;
 }
 
+uint32_t GPU::IdleDots() const {
+    if (interrupts_.interruptSetDelay > 0) return 0;
+    if (LCDDisabled()) return IDLE_UNBOUNDED;
+
+    const bool coincidence = currentLine == lyc;
+    if (stat.coincidenceFlag != coincidence) return 0;
+    if (coincidence && stat.enableLYInterrupt && !statTriggered) return 0;
+    switch (stat.mode) {
+        case GPUMode::MODE_0:
+            if (stat.enableM0Interrupt && !statTriggered) return 0;
+            break;
+        case GPUMode::MODE_1:
+            if (stat.enableM1Interrupt && !statTriggered) return 0;
+            break;
+        default: return 0;
+    }
+
+    const uint32_t scanlineDuration = SCANLINE_CYCLES - (shortenScanline ? 4 : 0);
+    return scanlineCounter + 1 < scanlineDuration ? scanlineDuration - scanlineCounter - 1 : 0;
+}
+
+void GPU::SkipIdleDots(const uint32_t dots) {
+    if (LCDDisabled()) return;
+    scanlineCounter += dots;
+    modeDots[static_cast<size_t>(stat.mode)] += dots;
+}
+
+void GPU::TraceMode() {
+    if constexpr (trace::ENABLED) {
+        if (stat.mode != tracedMode_) {
+            modeSpan_.End(MODE_ZONES[static_cast<size_t>(tracedMode_)]);
+            tracedMode_ = stat.mode;
+        }
+        modeSpan_.Begin();
+    }
+}
+
+void GPU::EndHdmaSpan() {
+    hdmaSpan.End(hdma.hdmaMode == HDMAMode::GDMA ? "HDMA general-purpose transfer" : "HDMA HBlank block");
+}
+
+void GPU::EndTraceSpans() {
+    modeSpan_.End(MODE_ZONES[static_cast<size_t>(tracedMode_)]);
+    EndHdmaSpan();
+}
+
 void GPU::Update() {
     if (interrupts_.interruptSetDelay > 0) {
         interrupts_.interruptSetDelay--;
@@ -39,8 +113,11 @@ void GPU::Update() {
     }
 
     if (LCDDisabled()) {
+        modeSpan_.End(MODE_ZONES[static_cast<size_t>(tracedMode_)]);
         return;
     }
+    TraceMode();
+    ++modeDots[static_cast<size_t>(stat.mode)];
 
     if (currentLine == lyc) {
         stat.coincidenceFlag = true;
@@ -430,54 +507,12 @@ uint16_t GPU::CalculateSpriteDataAddress(const Sprite &sprite) {
 
 uint32_t GPU::GetSpriteColor(const uint8_t color, const uint8_t palette) const {
     if (hardware != Hardware::CGB) return DMG_SHADE[(palette >> (color * 2)) & 0x03];
-
-    const uint8_t red = obpd[palette][color][0];
-    const uint8_t green = obpd[palette][color][1];
-    const uint8_t blue = obpd[palette][color][2];
-
-    const auto r5 = static_cast<uint8_t>(red & 0x1F);
-    const auto g5 = static_cast<uint8_t>(green & 0x1F);
-    const auto b5 = static_cast<uint8_t>(blue & 0x1F);
-
-    const auto corrR5 = static_cast<uint8_t>((26 * r5 + 4 * g5 + 2 * b5) >> 5);
-    const auto corrG5 = static_cast<uint8_t>((6 * r5 + 24 * g5 + 2 * b5) >> 5);
-    const auto corrB5 = static_cast<uint8_t>((2 * r5 + 4 * g5 + 26 * b5) >> 5);
-
-    const uint8_t r = expand5(corrR5);
-    const uint8_t g = expand5(corrG5);
-    const uint8_t b = expand5(corrB5);
-
-    const uint32_t rgba = 0xFF000000u |
-                          (static_cast<uint32_t>(b) << 16) |
-                          (static_cast<uint32_t>(g) << 8) |
-                          r;
-    return rgba;
+    return CorrectedColor(obpd[palette][color]);
 }
 
 uint32_t GPU::GetBackgroundColor(const uint8_t color, const uint8_t palette) const {
     if (hardware != Hardware::CGB) return DMG_SHADE[(backgroundPalette >> (color * 2)) & 0x03];
-
-    const uint8_t red = bgpd[palette][color][0];
-    const uint8_t green = bgpd[palette][color][1];
-    const uint8_t blue = bgpd[palette][color][2];
-
-    const auto r5 = static_cast<uint8_t>(red & 0x1F);
-    const auto g5 = static_cast<uint8_t>(green & 0x1F);
-    const auto b5 = static_cast<uint8_t>(blue & 0x1F);
-
-    const auto corrR5 = static_cast<uint8_t>((26 * r5 + 4 * g5 + 2 * b5) >> 5);
-    const auto corrG5 = static_cast<uint8_t>((6 * r5 + 24 * g5 + 2 * b5) >> 5);
-    const auto corrB5 = static_cast<uint8_t>((2 * r5 + 4 * g5 + 26 * b5) >> 5);
-
-    const uint8_t r = expand5(corrR5);
-    const uint8_t g = expand5(corrG5);
-    const uint8_t b = expand5(corrB5);
-
-    const uint32_t rgba = 0xFF000000u |
-                          (static_cast<uint32_t>(b) << 16) |
-                          (static_cast<uint32_t>(g) << 8) |
-                          r;
-    return rgba;
+    return CorrectedColor(bgpd[palette][color]);
 }
 
 Attributes GPU::GetAttrsFrom(const uint8_t byte) {
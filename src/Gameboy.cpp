@@ -1,11 +1,56 @@
 #include "Gameboy.h"
 
+#include <algorithm>
+#include <array>
 #include <map>
 #include <thread>
 #include <chrono>
+#include <string_view>
+
+#include "BootStateCache.h"
+#include "StateHash.h"
+#include "StateArchive.h"
+#include "Trace.h"
 
 static constexpr uint32_t kFrameCyclesDMG = 70224;
 static constexpr uint32_t kFrameCyclesCGB = kFrameCyclesDMG * 2;
+// A bootrom still running after this long has locked up (e.g. on a bad logo)
+static constexpr uint64_t kBootCycleLimit = kFrameCyclesCGB * 60ull * 10;
+
+// Components hold references to each other, so they are rebuilt where
+// they are rather than assigned
+template<typename T, typename... Args>
+static void Reconstruct(T &component, Args &&... args) {
+    std::destroy_at(&component);
+    std::construct_at(&component, std::forward<Args>(args)...);
+}
+
+// Fills the operand placeholders of a mnemonic ("LD A,d8", "JR NZ,r8")
+// from the bytes after the opcode
+static std::string DisassembleOperands(std::string mnemonic, const uint8_t low, const uint8_t high) {
+    static constexpr std::array<std::string_view, 5> PLACEHOLDERS = {"d16", "a16", "d8", "a8", "r8"};
+    for (const std::string_view placeholder: PLACEHOLDERS) {
+        const size_t at = mnemonic.find(placeholder);
+        if (at == std::string::npos) continue;
+        char operand[8];
+        if (placeholder[1] == '1') {
+            std::snprintf(operand, sizeof(operand), "$%04X", low | high << 8);
+        } else if (placeholder == "r8") {
+            std::snprintf(operand, sizeof(operand), "%+d", static_cast<int8_t>(low));
+        } else {
+            std::snprintf(operand, sizeof(operand), "$%02X", low);
+        }
+        return mnemonic.replace(at, placeholder.size(), operand);
+    }
+    return mnemonic;
+}
+
+SharedResources SharedResources::Load(const GameboySettings &settings) {
+    return {
+        .rom = Cartridge::LoadRom(settings.romName),
+        .bootrom = settings.biosPath.empty() ? nullptr : Bus::LoadBootrom(settings.biosPath),
+    };
+}
 
 bool Gameboy::ShouldRender() const {
     // const bool value = bus->gpu_->vblank;
@@ -17,18 +62,249 @@ void Gameboy::Save() const {
     cartridge_.Save();
 }
 
+void Gameboy::Reset(const ResetKind kind) {
+    const bool hard = kind == ResetKind::Hard;
+    std::shared_ptr<const std::vector<uint8_t> > bootrom = bus_.bootrom;
+    cartridge_.Reset();
+    interrupts_ = {};
+    registers_ = {};
+    dma_ = {};
+    Reconstruct(joypad_, interrupts_);
+    const uint32_t sampleRate = audio_.GetSampleRate();
+    Reconstruct(audio_, sampleRate);
+    memory_.Reset(hard);
+    Reconstruct(timer_, audio_, interrupts_);
+    Reconstruct(serial_, interrupts_);
+    if (hard) {
+        Reconstruct(gpu_, interrupts_);
+    } else {
+        const auto vram = gpu_.vram;
+        const auto oam = gpu_.oam;
+        Reconstruct(gpu_, interrupts_);
+        gpu_.vram = vram;
+        gpu_.oam = oam;
+    }
+    Reconstruct(bus_, joypad_, memory_, timer_, cartridge_, serial_, dma_, audio_, interrupts_, gpu_);
+    if (fastCore_) bus_.SetSyncHook(&Gameboy::SyncPeripherals, this);
+
+    if (coroutineCore_) coroutineCore_->Cancel();
+    Reconstruct(cpu_, mode_, bootrom, bus_, interrupts_, registers_);
+    if (coroutineCore_) cpu_.UseCoroutineCore(coroutineCore_.get());
+    if (profiler_) cpu_.UseProfiler(profiler_.get());
+    Reconstruct(instructions_, registers_, interrupts_);
+    if (idleLoops_) Reconstruct(*idleLoops_, registers_, interrupts_, CGB_CYCLES_PER_SECOND);
+
+    EndMovie();
+    if (frameHashes_) SetFrameHashing(frameHashes_->Interval());
+    instructionsRetired_ = 0;
+    framesRun_ = 0;
+    masterCycles = 0;
+    fastFrameBudget_ = 0;
+    peripheralDebt_ = 0;
+    frameProgress_ = 0;
+    // The cached boot starts from cleared RAM
+    if (hard && bootrom && !bootStateCache_.empty()) BootThroughCache(bootStateCache_, *bootrom);
+}
+
+void Gameboy::LoadRom(const std::string &path) {
+    std::shared_ptr<const RomImage> rom = Cartridge::LoadRom(path);
+    Save();
+    romPath_ = path;
+    cartridge_.Insert(romPath_, std::move(rom));
+    // Blocks are keyed by ROM offset, so they belong to the old game
+    if (blockCache_) blockCache_->Clear();
+    if (jit_) jit_->Clear();
+    if (profiler_) profiler_ = std::make_unique<RomProfiler>(cartridge_.Rom()->data.size(), profiler_->SampleEvery());
+    Reset(ResetKind::Hard);
+}
+
+// A copy through the snapshot archive: every component lists its state
+// once, and one that holds references gets them bound to its own
+// instance. The code caches start out empty and fill again.
+std::unique_ptr<Gameboy> Gameboy::Fork() const {
+    GameboySettings settings;
+    settings.romName = romPath_;
+    settings.biosPath = biosPath_;
+    settings.mode = mode_;
+    settings.realRTC = realRTC_;
+    settings.unthrottled = !throttleSpeed_;
+    settings.readOnlySave = true;
+    settings.cpuCore = coroutineCore_ ? CpuCore::Coroutine : CpuCore::StepTable;
+    settings.fastCore = fastCore_;
+    settings.blockCache = blockCache_ != nullptr;
+    settings.jit = jit_ != nullptr;
+    settings.idleLoops = idleLoops_ != nullptr;
+    settings.audioSampleRate = audio_.GetSampleRate();
+    // No boot cache and no save file: the state comes from here instead
+    auto child = std::make_unique<Gameboy>(settings, SharedResources{cartridge_.Rom(), bus_.bootrom}, false);
+    child->bootStateCache_ = bootStateCache_;
+    child->speedMultiplier_ = speedMultiplier_;
+    child->paused_ = paused_;
+
+    // Kept between forks: growing a fresh buffer costs more than the copy
+    thread_local std::vector<uint8_t> snapshot;
+    snapshot.clear();
+    WriteSnapshot(snapshot);
+    child->ReadSnapshot(snapshot);
+    return child;
+}
+
+void Gameboy::WriteSnapshot(std::vector<uint8_t> &out) const {
+    StateWriter writer(out);
+    SerializeMachine(*this, writer);
+    writer(rtc_, cartridge_);
+}
+
+void Gameboy::ReadSnapshot(const std::span<const uint8_t> in) {
+    StateReader reader(in);
+    SerializeMachine(*this, reader);
+    reader(rtc_, cartridge_);
+}
+
+void Gameboy::WriteProfileReport(std::FILE *out, const size_t count) const {
+    if (!profiler_) return;
+    const std::vector<uint8_t> &rom = cartridge_.Rom()->data;
+    const double total = static_cast<double>(std::max<uint64_t>(profiler_->TotalCycles(), 1));
+    std::fprintf(out, "%12s %7s %10s  %-9s %s\n", "M-cycles", "share", "runs", "location", "instruction");
+    for (const RomProfiler::Hotspot &spot: profiler_->Hotspots(count)) {
+        // Code outside ROM is disassembled from what is there now
+        const auto byteAt = [&](const uint32_t i) -> uint8_t {
+            if (spot.inRom) return spot.location + i < rom.size() ? rom[spot.location + i] : 0xFF;
+            return PeekByte(static_cast<uint16_t>(spot.location + i));
+        };
+        char location[16];
+        if (spot.inRom) {
+            const uint32_t bank = spot.location / 0x4000;
+            std::snprintf(location, sizeof(location), "%02X:%04X", bank, (bank ? 0x4000 : 0) + spot.location % 0x4000);
+        } else {
+            std::snprintf(location, sizeof(location), "--:%04X", spot.location);
+        }
+        const uint8_t opcode = byteAt(0);
+        const std::string mnemonic = opcode == 0xCB
+                                         ? instructions_.GetMnemonic(0xCB00 | byteAt(1))
+                                         : DisassembleOperands(instructions_.GetMnemonic(opcode), byteAt(1), byteAt(2));
+        std::fprintf(out, "%12llu %6.2f%% %10llu  %-9s %s\n", static_cast<unsigned long long>(spot.mCycles),
+                     100.0 * static_cast<double>(spot.mCycles) / total,
+                     static_cast<unsigned long long>(spot.executions), location, mnemonic.c_str());
+    }
+}
+
+// While a movie plays it is the only input
 void Gameboy::KeyUp(const Keys key) {
+    if (playback_) return;
     joypad_.KeyUp(key);
+    if (recording_) RecordKey(key, false);
 }
 
 void Gameboy::KeyDown(const Keys key) {
+    if (playback_) return;
     joypad_.KeyDown(key);
+    if (recording_) RecordKey(key, true);
+}
+
+void Gameboy::SetKeys(const uint8_t pressed) {
+    const uint8_t held = static_cast<uint8_t>(~joypad_.GetMatrix());
+    for (uint8_t bit = 0x01; bit != 0; bit <<= 1) {
+        if ((pressed ^ held) & bit) {
+            pressed & bit ? KeyDown(static_cast<Keys>(bit)) : KeyUp(static_cast<Keys>(bit));
+        }
+    }
+}
+
+uint64_t Gameboy::CycleCount() const {
+    // Between frames the fast core's budget is zero, or minus what it overran
+    const auto overrun = static_cast<uint64_t>(std::max<int64_t>(-fastFrameBudget_, 0));
+    return framesRun_ * kFrameCyclesCGB + frameProgress_ + overrun;
+}
+
+void Gameboy::StartRecording(const bool fromPowerOn) {
+    if (fromPowerOn) Reset(ResetKind::Hard);
+    EndMovie();
+    auto movie = std::make_unique<InputMovie>();
+    movie->romCrc32 = GetRomCrc32();
+    rtc_.realRTC_ = false;
+    if (fromPowerOn) {
+        movie->sram.assign(cartridge_.GameRam().begin(), cartridge_.GameRam().end());
+        movie->rtc = rtc_.GetRegisters();
+    } else {
+        movie->start = InputMovie::Start::Snapshot;
+        WriteSnapshot(movie->snapshot);
+    }
+    movieStartCycle_ = CycleCount();
+    recording_ = std::move(movie);
+}
+
+InputMovie Gameboy::StopRecording() {
+    if (!recording_) throw std::runtime_error("Not recording a movie");
+    InputMovie movie = std::move(*recording_);
+    movie.length = CycleCount() - movieStartCycle_;
+    EndMovie();
+    return movie;
+}
+
+void Gameboy::RecordKey(const Keys key, const bool down) {
+    recording_->events.push_back({CycleCount() - movieStartCycle_, static_cast<uint8_t>(key), down});
+}
+
+void Gameboy::PlayMovie(InputMovie movie) {
+    if (movie.romCrc32 != GetRomCrc32()) throw std::runtime_error("The movie was recorded with another ROM");
+    const bool powerOn = movie.start == InputMovie::Start::PowerOn;
+    if (powerOn && movie.sram.size() != cartridge_.GameRam().size()) {
+        throw std::runtime_error("The movie's save RAM is the wrong size for this cartridge");
+    }
+    // Also drops what the coroutine core and idle-loop detector were in
+    // the middle of, which a snapshot does not hold
+    Reset(ResetKind::Hard);
+    if (powerOn) {
+        cartridge_.SetGameRam(movie.sram);
+        rtc_.SetRegisters(movie.rtc);
+    } else {
+        ReadSnapshot(movie.snapshot);
+    }
+    rtc_.realRTC_ = false;
+    cartridge_.SetSaveWritable(false);
+    movieStartCycle_ = CycleCount();
+    playbackEvent_ = 0;
+    playback_ = std::make_unique<InputMovie>(std::move(movie));
+    ApplyMovieInput();
+}
+
+bool Gameboy::IsPlayingMovie() const {
+    return playback_ && CycleCount() - movieStartCycle_ < playback_->length;
+}
+
+void Gameboy::ApplyMovieInput() {
+    const uint64_t now = CycleCount() - movieStartCycle_;
+    const std::vector<InputMovie::Event> &events = playback_->events;
+    for (; playbackEvent_ < events.size() && events[playbackEvent_].cycle <= now; ++playbackEvent_) {
+        const auto key = static_cast<Keys>(events[playbackEvent_].key);
+        events[playbackEvent_].down ? joypad_.KeyDown(key) : joypad_.KeyUp(key);
+    }
+    if (now >= playback_->length) EndMovie();
+}
+
+void Gameboy::EndMovie() {
+    recording_.reset();
+    playback_.reset();
+    if (rtc_.realRTC_ != realRTC_) {
+        // Carries on from the time it shows rather than jumping
+        rtc_.realRTC_ = realRTC_;
+        rtc_.RecalculateZeroTime();
+    }
+}
+
+uint8_t Gameboy::PeekByte(const uint16_t address) const {
+    return bus_.PeekByte(address);
 }
 
 const uint32_t *Gameboy::GetScreenData() const {
     return gpu_.GetScreenData();
 }
 
+uint64_t Gameboy::ScreenHash() const {
+    return XXHash64(GetScreenData(), SCREEN_WIDTH * SCREEN_HEIGHT * sizeof(uint32_t));
+}
+
 void Gameboy::ToggleSpeed() {
     speedMultiplier_ = speedMultiplier_ == 1 ? 4 : 1;
 }
@@ -59,6 +335,12 @@ void Gameboy::AdvanceFrame() {
             return;
         }
     }
+    TickPeripherals(speedDivider);
+    if (masterCycles % speedDivider == 0) cpu_.ExecuteMicroOp(instructions_, gpu_.hdma.ShouldHaltCPU());
+    masterCycles++;
+}
+
+void Gameboy::TickPeripherals(const uint32_t speedDivider) {
     if (masterCycles % speedDivider == 0) timer_.Tick(bus_.speed);
     if (masterCycles % RTC_CLOCK_DIVIDER == 0) rtc_.Update();
     if (masterCycles % AUDIO_CLOCK_DIVIDER == 0) audio_.Tick();
@@ -66,11 +348,304 @@ void Gameboy::AdvanceFrame() {
     if (masterCycles % speedDivider == 0) bus_.UpdateDMA();
     if (masterCycles % GRAPHICS_CLOCK_DIVIDER == 0) gpu_.Update();
     if (masterCycles % 2 == 0) bus_.RunHDMA();
-    if (masterCycles % speedDivider == 0) cpu_.ExecuteMicroOp(instructions_, gpu_.hdma.ShouldHaltCPU());
-    masterCycles++;
+}
+
+void Gameboy::CatchUpPeripherals() {
+    const uint32_t speedDivider = bus_.speed == Speed::Regular ? 2 : 1;
+    // Blocks count their M-cycles in the CPU rather than adding to the debt
+    if (const uint32_t blockCycles = cpu_.TakeBlockCycles()) {
+        peripheralDebt_ += blockCycles * speedDivider * 4;
+        fastFrameBudget_ -= blockCycles * speedDivider * 4;
+    }
+    for (; peripheralDebt_ > 0; --peripheralDebt_) {
+        if (masterCycles == CGB_CYCLES_PER_SECOND) masterCycles = 0;
+        // Every peripheral runs on even cycles at regular speed
+        if (speedDivider == 1 || masterCycles % 2 == 0) TickPeripherals(speedDivider);
+        masterCycles++;
+    }
+}
+
+void Gameboy::AdvanceMasterCycles(const uint32_t cycles) {
+    if (cycles == 0) return;
+    if (masterCycles == CGB_CYCLES_PER_SECOND) masterCycles = 0;
+    masterCycles = (masterCycles + cycles - 1) % CGB_CYCLES_PER_SECOND + 1;
+}
+
+// Master cycles from now in which nothing can raise an interrupt or change
+// a polled register: no PPU line end or STAT source, no TIMA overflow or
+// frame sequencer step, no serial shift or RTC second, and no DMA running.
+// Always a whole number of dots.
+uint32_t Gameboy::IdleCyclesAhead() const {
+    if (masterCycles % 2 != 0 || !bus_.DMAIdle()) return 0;
+    // Timer, serial and OAM DMA tick at CPU speed, the rest once per dot
+    const uint32_t ticksPerDot = bus_.speed == Speed::Regular ? 1 : 2;
+    const uint32_t dots = std::min({
+        gpu_.IdleDots(), rtc_.IdleTicks(),
+        timer_.IdleTicks(bus_.speed) / ticksPerDot, serial_.IdleTicks() / ticksPerDot
+    });
+    return std::min(dots, IDLE_UNBOUNDED / 2) * 2;
+}
+
+// Advances every component through `cycles` (at most IdleCyclesAhead())
+// exactly as cycle-by-cycle ticking would leave it. Audio is the one
+// component still ticked per dot.
+void Gameboy::FastForward(const uint32_t cycles) {
+    const uint32_t ticksPerDot = bus_.speed == Speed::Regular ? 1 : 2;
+    const uint32_t dots = cycles / 2;
+    timer_.SkipIdleTicks(dots * ticksPerDot);
+    serial_.SkipIdleTicks(dots * ticksPerDot);
+    bus_.SkipIdleDMATicks(dots * ticksPerDot);
+    rtc_.SkipIdleTicks(dots);
+    gpu_.SkipIdleDots(dots);
+    for (uint32_t i = 0; i < dots; ++i) audio_.Tick();
+    // The fast core does not pace the CPU by T-cycles
+    if (!fastCore_) cpu_.SkipIdleCycles(dots * ticksPerDot);
+    AdvanceMasterCycles(cycles);
+}
+
+// Jumps a HALT with nothing pending straight to just before the next event.
+// Returns the master cycles skipped, a multiple of `granularity` and at
+// most `limit`.
+uint32_t Gameboy::SkipIdleHalt(const uint32_t limit, const uint32_t granularity) {
+    if (!cpu_.IdleInHalt()) return 0;
+    uint32_t cycles = std::min(limit, IdleCyclesAhead());
+    cycles -= cycles % granularity;
+    if (cycles > 0) {
+        FastForward(cycles);
+        cpu_.haltedMCycles += cycles / (bus_.speed == Speed::Regular ? 8 : 4);
+    }
+    return cycles;
+}
+
+// Skips whole iterations of a busy-wait loop once IdleLoopDetector has
+// proven it repeats. Called with the CPU at a loop point.
+uint32_t Gameboy::SkipIdleLoop(const uint32_t limit) {
+    if (!cpu_.CanRunBlock()) return 0;
+    if (fastCore_) CatchUpPeripherals();
+    const uint32_t now = masterCycles == CGB_CYCLES_PER_SECOND ? 0 : masterCycles;
+    const uint32_t cycles = idleLoops_->Observe(cpu_, now, limit, [this] { return IdleCyclesAhead(); });
+    if (cycles > 0) FastForward(cycles);
+    return cycles;
+}
+
+// The boot is stepped cycle by cycle whatever the core, so a restored
+// instance is in exactly the state one that emulated it would be. The
+// snapshot is taken at the first instruction boundary after the bootrom
+// unmaps itself, with the opcode at 0x100 fetched.
+void Gameboy::BootThroughCache(const std::string &directory, const std::vector<uint8_t> &bootrom) {
+    std::array<uint8_t, 0x50> header{};
+    for (uint16_t i = 0; i < header.size(); ++i) header[i] = cartridge_.ReadByte(0x100 + i);
+    const BootStateCache cache(directory);
+    const BootStateCache::Key key = BootStateCache::MakeKey(bootrom, header, gpu_.hardware);
+
+    uint64_t bootCycles = 0;
+    if (const auto cached = cache.Load(key)) {
+        StateReader reader(*cached);
+        reader(bootCycles);
+        SerializeMachine(*this, reader);
+        // The clock keeps the save file's time and runs through the boot
+        rtc_.Advance((bootCycles + 1) / 2);
+    } else {
+        for (; bus_.bootromRunning || !cpu_.BetweenInstructions(); ++bootCycles) {
+            if (bootCycles == kBootCycleLimit) return;
+            AdvanceFrame();
+        }
+        frameProgress_ = static_cast<uint32_t>(bootCycles % kFrameCyclesCGB);
+
+        std::vector<uint8_t> snapshot;
+        StateWriter writer(snapshot);
+        writer(bootCycles);
+        SerializeMachine(*this, writer);
+        try {
+            cache.Store(key, snapshot);
+        } catch (const std::exception &e) {
+            std::fprintf(stderr, "Failed to cache boot state: %s\n", e.what());
+        }
+    }
+}
+
+void Gameboy::RunFrameFast() {
+    // An instruction that crosses the end of the frame is paid back next frame
+    fastFrameBudget_ += kFrameCyclesCGB - std::exchange(frameProgress_, 0);
+    while (fastFrameBudget_ > 0) {
+        if (cpu_.stopped()) {
+            CatchUpPeripherals();
+            if (!bus_.joypad_.KeyPressed()) {
+                // Nothing ticks in STOP and keys only change between frames
+                AdvanceMasterCycles(static_cast<uint32_t>(fastFrameBudget_));
+                fastFrameBudget_ = 0;
+                break;
+            }
+            cpu_.stopped() = false;
+        }
+
+        // Whole halted M-cycles, so the CPU wakes on the same one it would
+        // have stepping through them
+        if (cpu_.IdleInHalt()) {
+            CatchUpPeripherals();
+            const uint32_t cost = bus_.speed == Speed::Regular ? 8 : 4;
+            const auto limit = static_cast<uint32_t>(std::min<int64_t>(fastFrameBudget_, UINT32_MAX));
+            if (const uint32_t skipped = SkipIdleHalt(limit, cost)) {
+                fastFrameBudget_ -= skipped;
+                continue;
+            }
+        }
+
+        // Busy-wait loops are observed at each block entry, or at their jump
+        // when running instruction by instruction
+        if (idleLoops_ && (blockCache_ || IdleLoopDetector<CPU<Bus> >::IsLoopPoint(cpu_.currentInstruction))) {
+            const auto limit = static_cast<uint32_t>(std::min<int64_t>(fastFrameBudget_, UINT32_MAX));
+            if (const uint32_t skipped = SkipIdleLoop(limit)) {
+                fastFrameBudget_ -= skipped;
+                continue;
+            }
+        }
+
+        // A cached block runs with the peripherals synced only at its ends
+        // and at I/O accesses, so interrupts are taken at block boundaries
+        if (blockCache_) {
+            CatchUpPeripherals();
+            if (auto *block = cpu_.CanRunBlock() ? blockCache_->Lookup(cpu_) : nullptr;
+                block && block->mCycles * (bus_.speed == Speed::Regular ? 8 : 4) <= fastFrameBudget_) {
+                // Compiled code runs what it can and RunBlock the rest; the
+                // profiler needs every instruction to go through the CPU
+                const uint8_t native = jit_ && !profiler_ ? jit_->Run(*block, instructions_) : 0;
+                const uint8_t ran = cpu_.RunBlock(instructions_, *block, native);
+                CatchUpPeripherals();
+                if (ran > 0) continue;
+            }
+        }
+
+        StepFast();
+    }
+    CatchUpPeripherals();
+}
+
+// Only the first M-cycle syncs up front; later ones run ahead of the
+// peripherals unless the bus hook catches them up for an I/O access
+void Gameboy::StepFast() {
+    bool boundary = false;
+    for (bool first = true; !boundary; first = false) {
+        const uint32_t cost = bus_.speed == Speed::Regular ? 8 : 4;
+        peripheralDebt_ += cost;
+        fastFrameBudget_ -= cost;
+        if (first) CatchUpPeripherals();
+        boundary = cpu_.StepMCycle(instructions_, gpu_.hdma.ShouldHaltCPU());
+    }
+}
+
+bool Gameboy::StepInstruction() {
+    const uint64_t before = cpu_.instructionCount;
+    if (fastCore_) {
+        // The budget goes negative and the next frame pays it back
+        for (const int64_t limit = fastFrameBudget_ - kFrameCyclesCGB; fastFrameBudget_ > limit;) {
+            if (cpu_.stopped()) {
+                CatchUpPeripherals();
+                if (!bus_.joypad_.KeyPressed()) return false;
+                cpu_.stopped() = false;
+            }
+            StepFast();
+            if (cpu_.instructionCount != before) {
+                CatchUpPeripherals();
+                return true;
+            }
+        }
+        return false;
+    }
+    for (uint32_t i = 0; i < kFrameCyclesCGB; ++i) {
+        AdvanceFrame();
+        ++frameProgress_;
+        if (cpu_.instructionCount != before) return true;
+    }
+    return false;
+}
+
+StateView Gameboy::GetStateView() const {
+    StateView view;
+    const uint16_t sp = cpu_.sp();
+    const uint16_t pc = cpu_.pc();
+    view.cpu = {
+        registers_.a, registers_.f, registers_.b, registers_.c, registers_.d, registers_.e, registers_.h, registers_.l,
+        static_cast<uint8_t>(sp >> 8), static_cast<uint8_t>(sp), static_cast<uint8_t>(pc >> 8),
+        static_cast<uint8_t>(pc), interrupts_.interruptMasterEnable, interrupts_.interruptEnable,
+        interrupts_.interruptFlag
+    };
+    for (uint16_t i = 0; i < view.io.size(); i++) view.io[i] = PeekByte(static_cast<uint16_t>(0xFF00 + i));
+    view.memory = {{
+        {"WRAM", memory_.wram_}, {"HRAM", memory_.hram_}, {"VRAM", gpu_.vram}, {"OAM", gpu_.oam},
+        {"SRAM", cartridge_.GameRam()},
+    }};
+    return view;
+}
+
+uint64_t StateView::Hash() const {
+    uint64_t hash = XXHash64(cpu.data(), cpu.size());
+    hash = XXHash64(io.data(), io.size(), hash);
+    for (const Region &region: memory) hash = XXHash64(region.bytes.data(), region.bytes.size(), hash);
+    return hash;
+}
+
+void Gameboy::RunFrame() {
+    TRACE_ZONE("Gameboy::RunFrame");
+    const auto start = std::chrono::steady_clock::now();
+    if (playback_) ApplyMovieInput();
+    if (fastCore_) {
+        RunFrameFast();
+    } else {
+        RunFrameAccurate();
+    }
+    gpu_.EndTraceSpans();
+    ++framesRun_;
+    if (frameHashes_) frameHashes_->Record(framesRun_, ScreenHash());
+    GatherFrameStats(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+}
+
+void Gameboy::GatherFrameStats(const double hostSeconds) {
+    instructionsRetired_ += cpu_.instructionCount;
+    frameStats_ = {
+        .instructions = std::exchange(cpu_.instructionCount, 0),
+        .haltedMCycles = std::exchange(cpu_.haltedMCycles, 0),
+        .hdmaStallMCycles = std::exchange(cpu_.hdmaStallMCycles, 0),
+        .oamDmaMCycles = std::exchange(bus_.oamDmaMCycles, 0),
+        .ppuModeDots = std::exchange(gpu_.modeDots, {}),
+        .interrupts = std::exchange(cpu_.interruptCounts, {}),
+        .bankSwitches = std::exchange(cartridge_.bankSwitches, 0),
+        .samplesProduced = std::exchange(audio_.samplesProduced, 0),
+        .samplesDropped = std::exchange(audio_.samplesDropped, 0),
+        .hostSeconds = hostSeconds,
+    };
+}
+
+void Gameboy::RunFrameAccurate() {
+    uint32_t i = std::exchange(frameProgress_, 0);
+    while (i < kFrameCyclesCGB) {
+        if (cpu_.stopped() && !bus_.joypad_.KeyPressed()) {
+            // Nothing ticks in STOP and keys only change between frames
+            AdvanceMasterCycles(kFrameCyclesCGB - i);
+            break;
+        }
+        if (const uint32_t skipped = SkipIdleHalt(kFrameCyclesCGB - i, 2)) {
+            i += skipped;
+            continue;
+        }
+        // Loop points are observed once per instruction, on the first even
+        // cycle after the M-cycle that fetched the jump
+        if (idleLoops_ && masterCycles % 2 == 0 && cpu_.AtMCycleStart() &&
+            IdleLoopDetector<CPU<Bus> >::IsLoopPoint(cpu_.currentInstruction)) {
+            if (const uint32_t skipped = SkipIdleLoop(kFrameCyclesCGB - i)) {
+                i += skipped;
+                continue;
+            }
+        }
+        AdvanceFrame();
+        i++;
+    }
+    // Instructions stepped between frames can run past the whole next one
+    if (i > kFrameCyclesCGB) frameProgress_ = i - kFrameCyclesCGB;
 }
 
 void Gameboy::UpdateEmulator() {
+    TRACE_ZONE("Gameboy::UpdateEmulator");
     if (paused_) {
         return;
     }
@@ -79,9 +654,7 @@ void Gameboy::UpdateEmulator() {
     static constexpr auto kFramePeriod = std::chrono::microseconds{16'667}; // ≈ 60 FPS (16.667 ms)
     const auto frameStart = clock::now();
 
-    for (uint32_t i = 0; i < kFrameCyclesCGB; i++) {
-        AdvanceFrame();
-    }
+    RunFrame();
 
     const auto elapsed = clock::now() - frameStart;
     if (const auto effectiveFrameTime = kFramePeriod / speedMultiplier_; throttleSpeed_ && elapsed < effectiveFrameTime)
@@ -0,0 +1,36 @@
+#include "GameboyFactory.h"
+
+GameboyBatch::GameboyBatch(const size_t count, const GameboySettings &settings, const SharedResources &resources)
+    : storage_(static_cast<std::byte *>(::operator new[](count * STRIDE, std::align_val_t{ALIGNMENT}))) {
+    // count_ tracks constructed instances so a throwing constructor only
+    // unwinds the ones that exist
+    try {
+        for (; count_ < count; ++count_) {
+            new(storage_.get() + count_ * STRIDE) Gameboy(settings, resources);
+        }
+    } catch (...) {
+        Destroy();
+        throw;
+    }
+}
+
+GameboyBatch::GameboyBatch(GameboyBatch &&other) noexcept : storage_(std::move(other.storage_)),
+                                                             count_(std::exchange(other.count_, 0)) {
+}
+
+GameboyBatch &GameboyBatch::operator=(GameboyBatch &&other) noexcept {
+    if (this != &other) {
+        Destroy();
+        storage_ = std::move(other.storage_);
+        count_ = std::exchange(other.count_, 0);
+    }
+    return *this;
+}
+
+GameboyBatch::~GameboyBatch() {
+    Destroy();
+}
+
+void GameboyBatch::Destroy() {
+    while (count_ > 0) (*this)[--count_].~Gameboy();
+}
@@ -0,0 +1,121 @@
+#include "GameboyPool.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+GameboyPool::GameboyPool(const GameboyFactory &factory, const size_t instances, size_t threads)
+    : batch_(factory.CreateBatch(instances)),
+      framebuffers_(instances * PoolOutputs::FRAME_PIXELS),
+      rewards_(instances) {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    const size_t chunks = (instances + CHUNK - 1) / CHUNK;
+    threads = std::clamp<size_t>(threads, 1, std::max<size_t>(chunks, 1));
+
+    partitions_ = std::make_unique<Partition[]>(threads);
+    for (size_t i = 0; i < threads; ++i) {
+        partitions_[i].begin = chunks * i / threads;
+        partitions_[i].end = chunks * (i + 1) / threads;
+    }
+
+    workers_.reserve(threads - 1);
+    for (size_t id = 1; id < threads; ++id) {
+        workers_.emplace_back(&GameboyPool::WorkerLoop, this, id);
+    }
+}
+
+GameboyPool::~GameboyPool() {
+    {
+        std::lock_guard lock(mutex_);
+        stopping_ = true;
+    }
+    startCv_.notify_all();
+    for (auto &worker: workers_) worker.join();
+}
+
+void GameboyPool::SetObservedAddresses(std::vector<uint16_t> addresses) {
+    observed_ = std::move(addresses);
+    // Each instance's row is padded to whole cache lines
+    observationStride_ = (observed_.size() + GameboyBatch::ALIGNMENT - 1) & ~(GameboyBatch::ALIGNMENT - 1);
+    observations_.assign(batch_.size() * observationStride_, 0);
+}
+
+PoolOutputs GameboyPool::Step(const std::span<const uint8_t> inputs) {
+    if (inputs.size() != batch_.size()) {
+        throw std::invalid_argument("GameboyPool::Step needs one input per instance");
+    }
+    inputs_ = inputs;
+    for (size_t i = 0; i < ThreadCount(); ++i) {
+        partitions_[i].next.store(partitions_[i].begin, std::memory_order_relaxed);
+    }
+    {
+        std::lock_guard lock(mutex_);
+        pending_ = workers_.size();
+        ++generation_;
+    }
+    startCv_.notify_all();
+
+    RunPartitions(0);
+
+    std::unique_lock lock(mutex_);
+    doneCv_.wait(lock, [this] { return pending_ == 0; });
+    if (error_) std::rethrow_exception(std::exchange(error_, nullptr));
+
+    return {
+        .instances = batch_.size(),
+        .observationStride = observationStride_,
+        .framebuffers = framebuffers_,
+        .rewards = rewards_,
+        .observations = observations_,
+    };
+}
+
+void GameboyPool::WorkerLoop(const size_t id) {
+    uint64_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock lock(mutex_);
+            startCv_.wait(lock, [&] { return stopping_ || generation_ != seen; });
+            if (stopping_) return;
+            seen = generation_;
+        }
+        RunPartitions(id);
+        {
+            std::lock_guard lock(mutex_);
+            --pending_;
+        }
+        doneCv_.notify_one();
+    }
+}
+
+void GameboyPool::RunPartitions(const size_t id) {
+    // Own partition first, then steal from the others in turn. Owner and
+    // thieves both claim chunks with fetch_add, so each runs exactly once.
+    const size_t count = ThreadCount();
+    for (size_t offset = 0; offset < count; ++offset) {
+        Partition &partition = partitions_[(id + offset) % count];
+        for (size_t chunk = partition.next.fetch_add(1, std::memory_order_relaxed);
+             chunk < partition.end;
+             chunk = partition.next.fetch_add(1, std::memory_order_relaxed)) {
+            const size_t last = std::min(batch_.size(), (chunk + 1) * CHUNK);
+            try {
+                for (size_t index = chunk * CHUNK; index < last; ++index) StepInstance(index);
+            } catch (...) {
+                std::lock_guard lock(mutex_);
+                if (!error_) error_ = std::current_exception();
+            }
+        }
+    }
+}
+
+void GameboyPool::StepInstance(const size_t index) {
+    Gameboy &gameboy = batch_[index];
+    gameboy.SetKeys(inputs_[index]);
+    gameboy.RunFrame();
+
+    std::memcpy(framebuffers_.data() + index * PoolOutputs::FRAME_PIXELS, gameboy.GetScreenData(),
+                PoolOutputs::FRAME_PIXELS * sizeof(uint32_t));
+    uint8_t *observed = observations_.data() + index * observationStride_;
+    for (size_t i = 0; i < observed_.size(); ++i) observed[i] = gameboy.PeekByte(observed_[i]);
+    rewards_[index] = reward_ ? reward_(gameboy, index) : 0.0f;
+}
@@ -0,0 +1,97 @@
+#include "InputMovie.h"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#include "RomSource.h"
+#include "StateArchive.h"
+
+namespace {
+    constexpr uint32_t MAGIC = 0x4D424753; // "SGBM"
+    constexpr uint32_t FORMAT_VERSION = 1;
+    constexpr size_t EVENT_SIZE = sizeof(uint64_t) + 2;
+
+    struct MovieHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t romCrc32;
+        uint32_t start;
+        uint32_t snapshotVersion;
+        uint32_t sramSize;
+        uint32_t snapshotSize;
+        uint32_t eventCount;
+        uint32_t payloadCrc;
+        uint32_t reserved;
+        uint64_t length;
+    };
+
+    void Append(std::vector<uint8_t> &out, const void *data, const size_t size) {
+        const auto *bytes = static_cast<const uint8_t *>(data);
+        out.insert(out.end(), bytes, bytes + size);
+    }
+}
+
+void InputMovie::Write(const std::string &path) const {
+    std::vector<uint8_t> payload;
+    Append(payload, sram.data(), sram.size());
+    Append(payload, rtc.data(), rtc.size());
+    Append(payload, snapshot.data(), snapshot.size());
+    for (const auto &[cycle, key, down]: events) {
+        Append(payload, &cycle, sizeof(cycle));
+        payload.push_back(key);
+        payload.push_back(down);
+    }
+    const MovieHeader header{
+        MAGIC, FORMAT_VERSION, romCrc32, static_cast<uint32_t>(start), SNAPSHOT_VERSION,
+        static_cast<uint32_t>(sram.size()), static_cast<uint32_t>(snapshot.size()),
+        static_cast<uint32_t>(events.size()), RomSource::Crc32(payload), 0, length
+    };
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) throw std::runtime_error("Could not open " + path);
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(payload.data()), static_cast<std::streamsize>(payload.size()));
+    if (!file) throw std::runtime_error("Could not write " + path);
+}
+
+InputMovie InputMovie::Read(const std::string &path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) throw std::runtime_error("Could not open " + path);
+    MovieHeader header{};
+    if (!file.read(reinterpret_cast<char *>(&header), sizeof(header)) || header.magic != MAGIC) {
+        throw std::runtime_error(path + " is not a movie");
+    }
+    if (header.version != FORMAT_VERSION) throw std::runtime_error(path + " is from another version");
+    // The header is not covered by the CRC
+    if (header.start > static_cast<uint32_t>(Start::Snapshot)) throw std::runtime_error(path + " is damaged");
+    const std::vector<uint8_t> payload(std::istreambuf_iterator<char>(file), {});
+    const size_t expected = size_t{header.sramSize} + 5 + header.snapshotSize + size_t{header.eventCount} * EVENT_SIZE;
+    if (payload.size() != expected || RomSource::Crc32(payload) != header.payloadCrc) {
+        throw std::runtime_error(path + " is damaged");
+    }
+
+    InputMovie movie;
+    movie.romCrc32 = header.romCrc32;
+    movie.start = static_cast<Start>(header.start);
+    movie.length = header.length;
+    if (movie.start == Start::Snapshot && header.snapshotVersion != SNAPSHOT_VERSION) {
+        throw std::runtime_error(path + " starts from a snapshot another build wrote");
+    }
+    const uint8_t *at = payload.data();
+    movie.sram.assign(at, at + header.sramSize);
+    at += header.sramSize;
+    std::memcpy(movie.rtc.data(), at, movie.rtc.size());
+    at += movie.rtc.size();
+    movie.snapshot.assign(at, at + header.snapshotSize);
+    at += header.snapshotSize;
+    movie.events.resize(header.eventCount);
+    for (auto &[cycle, key, down]: movie.events) {
+        std::memcpy(&cycle, at, sizeof(cycle));
+        key = at[sizeof(cycle)];
+        down = at[sizeof(cycle) + 1] != 0;
+        at += EVENT_SIZE;
+    }
+    return movie;
+}
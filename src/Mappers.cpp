@@ -0,0 +1,721 @@
+#include "Mappers.h"
+#include "Cartridge.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+/* No MBC */
+
+uint8_t NoMapper::ReadByte(const Cartridge &, uint16_t) {
+    return 0xFF;
+}
+
+void NoMapper::WriteByte(Cartridge &cart, const uint16_t address, const uint8_t value) {
+    if (address >= 0xA000 && address <= 0xBFFF) cart.WriteRamPage(address, value);
+}
+
+void NoMapper::MapBanks(Cartridge &cart) {
+    cart.MapRom(0, 1);
+    cart.MapRam(true, 0);
+}
+
+/* MBC1 */
+
+uint8_t MBC1Mapper::ReadByte(const Cartridge &cart, const uint16_t address) {
+    // Only reached for RAM smaller than one 8 KiB bank (or disabled)
+    if (!cart.ramEnabled || cart.gameRamSize == 0) return 0xFF;
+    const uint32_t offset = (address - 0xA000) + cart.HandleRamBank() * 0x2000;
+    if (offset >= cart.gameRamSize || offset >= cart.gameRam_.size()) return 0xFF;
+    return cart.gameRam_[offset];
+}
+
+void MBC1Mapper::WriteByte(Cartridge &cart, const uint16_t address, const uint8_t value) {
+    switch (address) {
+        case 0x0000 ... 0x1FFF: {
+            const bool newEnable = (value & 0x0F) == 0x0A;
+            cart.HandleRamEnableEdge(newEnable);
+            cart.ramEnabled = newEnable;
+        }
+        break;
+        case 0x2000 ... 0x3FFF: {
+            cart.bank1 = value & 0x1F;
+            if (cart.bank1 == 0) cart.bank1 = 1;
+        }
+        break;
+        case 0x4000 ... 0x5FFF:
+            cart.bank2 = value & 0x03;
+            break;
+        case 0x6000 ... 0x7FFF:
+            cart.mode = value & 0x01;
+            break;
+        case 0xA000 ... 0xBFFF:
+            if (cart.ramEnabled && cart.gameRamSize > 0) {
+                const uint64_t offset = cart.HandleRamBank() * 0x2000ULL + (address - 0xA000);
+                if (offset < cart.gameRam_.size()) {
+                    cart.gameRam_[offset] = value;
+                    cart.ramDirty_ = true;
+                }
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+void MBC1Mapper::MapBanks(Cartridge &cart) {
+    cart.MapRom(cart.HandleRomBank(0x0000), cart.HandleRomBank(0x4000));
+    cart.MapRam(cart.ramEnabled, cart.HandleRamBank());
+}
+
+/* MBC2 */
+
+uint8_t MBC2Mapper::ReadByte(const Cartridge &cart, const uint16_t address) {
+    // 512 half-bytes of built-in RAM, upper nibble open bus
+    if (!cart.ramEnabled || cart.gameRamSize == 0) return 0xFF;
+    return 0xF0 | (cart.gameRam_[(address - 0xA000) % cart.gameRam_.size()] & 0x0F);
+}
+
+void MBC2Mapper::WriteByte(Cartridge &cart, const uint16_t address, const uint8_t value) {
+    switch (address) {
+        case 0x0000 ... 0x3FFF: {
+            if ((address & 0x100) == 0x00) {
+                const bool newEnable = (value & 0xF) == 0x0A;
+                cart.HandleRamEnableEdge(newEnable);
+                cart.ramEnabled = newEnable;
+            } else {
+                cart.bank1 = value & 0x0F; // romb analogous to bank1
+                if (cart.bank1 == 0) cart.bank1 = 1;
+            }
+            break;
+        }
+        case 0xA000 ... 0xBFFF: {
+            if (cart.ramEnabled && cart.gameRamSize > 0) {
+                cart.gameRam_[(address - 0xA000) % cart.gameRam_.size()] = value & 0xF;
+                cart.ramDirty_ = true;
+            }
+        }
+        break;
+        default: break;
+    }
+}
+
+void MBC2Mapper::MapBanks(Cartridge &cart) {
+    cart.MapRom(0, cart.bank1 & 0x0F & cart.BankBitmask());
+    cart.UnmapRam();
+}
+
+/* MBC3 */
+
+uint8_t MBC3Mapper::ReadByte(const Cartridge &cart, const uint16_t address) {
+    if (!cart.ramEnabled) return 0xFF;
+    if (cart.ramBank <= 0x03) {
+        const uint64_t offset = cart.ramBank * 0x2000ULL + (address - 0xA000);
+        if (cart.gameRamSize == 0 || offset >= cart.gameRam_.size()) return 0xFF;
+        return cart.gameRam_[offset];
+    }
+    return cart.rtc_.ReadRTC(cart.ramBank);
+}
+
+void MBC3Mapper::WriteByte(Cartridge &cart, const uint16_t address, const uint8_t value) {
+    switch (address) {
+        case 0x0000 ... 0x1FFF: {
+            const bool newEnable = (value & 0x0F) == 0x0A;
+            cart.HandleRamEnableEdge(newEnable);
+            cart.ramEnabled = newEnable;
+        }
+        break;
+        case 0x2000 ... 0x3FFF:
+            cart.romBank = value ? value : 1;
+            break;
+        case 0x4000 ... 0x5FFF:
+            cart.ramBank = value & 0x0F;
+            break;
+        case 0x6000 ... 0x7FFF:
+            std::memcpy(&cart.rtc_.latchedClock_, &cart.rtc_.realClock_, sizeof(cart.rtc_.latchedClock_));
+            break;
+        case 0xA000 ... 0xBFFF:
+            if (cart.ramEnabled) {
+                cart.ramDirty_ = true;
+                if (cart.ramBank <= 0x03 && cart.gameRamSize > 0) {
+                    const uint64_t offset = static_cast<uint64_t>(cart.ramBank) * 0x2000ULL + (address - 0xA000);
+                    if (offset < cart.gameRam_.size()) cart.gameRam_[offset] = value;
+                } else {
+                    cart.rtc_.WriteRTC(cart.ramBank, value);
+                }
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+void MBC3Mapper::MapBanks(Cartridge &cart) {
+    cart.MapRom(0, cart.romBank & cart.BankBitmask());
+    cart.MapRam(cart.ramEnabled && cart.ramBank <= 0x03, cart.ramBank);
+}
+
+/* MBC5 */
+
+uint8_t MBC5Mapper::ReadByte(const Cartridge &cart, const uint16_t address) {
+    // Only reached for RAM smaller than one 8 KiB bank (or disabled)
+    if (!cart.ramEnabled || cart.gameRamSize == 0) return 0xFF;
+    const uint64_t offset = cart.ramBank * 0x2000ULL + (address - 0xA000);
+    return offset < cart.gameRam_.size() ? cart.gameRam_[offset] : 0xFF;
+}
+
+void MBC5Mapper::WriteByte(Cartridge &cart, const uint16_t address, const uint8_t value) {
+    switch (address) {
+        case 0x0000 ... 0x1FFF: {
+            const bool newEnable = (value & 0x0F) == 0x0A;
+            cart.HandleRamEnableEdge(newEnable);
+            cart.ramEnabled = newEnable;
+        }
+        break;
+        case 0x2000 ... 0x2FFF:
+            cart.romBank = (cart.romBank & 0x100) | value;
+            break;
+        case 0x3000 ... 0x3FFF:
+            cart.romBank = (cart.romBank & 0xFF) | (value & 0x01) << 8;
+            break;
+        case 0x4000 ... 0x5FFF: {
+            const bool rumbleRequest = (value & 0x10) != 0;
+            cart.ramBank = value & 0x0F;
+            if (cart.hasRumble_ && rumbleRequest != cart.rumbleOn_) {
+                cart.rumbleOn_ = rumbleRequest;
+                if (cart.rumbleCallback_) cart.rumbleCallback_(cart.rumbleOn_);
+            }
+        }
+        break;
+        case 0xA000 ... 0xBFFF:
+            if (cart.ramEnabled && cart.gameRamSize != 0) {
+                const uint64_t offset = cart.ramBank * 0x2000ULL + (address - 0xA000);
+                if (offset < cart.gameRam_.size()) {
+                    cart.gameRam_[offset] = value;
+                    cart.ramDirty_ = true;
+                }
+            }
+            break;
+        default: break;
+    }
+}
+
+void MBC5Mapper::MapBanks(Cartridge &cart) {
+    cart.MapRom(0, cart.romBank & cart.BankBitmask());
+    cart.MapRam(cart.ramEnabled, cart.ramBank);
+}
+
+/* MBC6: two independently switched 8 KiB ROM/flash windows and two 4 KiB RAM windows */
+
+uint8_t MBC6Mapper::ReadByte(const Cartridge &, uint16_t) {
+    return 0xFF;
+}
+
+void MBC6Mapper::WriteByte(Cartridge &cart, const uint16_t address, const uint8_t value) {
+    auto &state = cart.mapperState_.mbc6;
+    switch (address) {
+        case 0x0000 ... 0x03FF: {
+            const bool newEnable = (value & 0x0F) == 0x0A;
+            cart.HandleRamEnableEdge(newEnable);
+            cart.ramEnabled = newEnable;
+        }
+        break;
+        case 0x0400 ... 0x07FF: state.ramBankA = value & 0x07;
+            break;
+        case 0x0800 ... 0x0BFF: state.ramBankB = value & 0x07;
+            break;
+        case 0x0C00 ... 0x0FFF: state.flashEnabled = value & 0x01;
+            break;
+        case 0x1000: state.flashWriteEnabled = value & 0x01;
+            break;
+        case 0x2000 ... 0x27FF: state.romBankA = value & 0x7F;
+            break;
+        case 0x2800 ... 0x2FFF: state.flashA = value == 0x08;
+            break;
+        case 0x3000 ... 0x37FF: state.romBankB = value & 0x7F;
+            break;
+        case 0x3800 ... 0x3FFF: state.flashB = value == 0x08;
+            break;
+        case 0x4000 ... 0x7FFF: {
+            // Programming can only clear bits; the flash command set (sector
+            // erase, ID mode) is not emulated.
+            const bool windowA = address < 0x6000;
+            if (!(windowA ? state.flashA : state.flashB) || !state.flashEnabled || !state.flashWriteEnabled) break;
+            const uint8_t bank = windowA ? state.romBankA : state.romBankB;
+            const uint32_t offset = (bank * 0x2000U + (address & 0x1FFF)) % FLASH_SIZE;
+            cart.gameRam_[RAM_SIZE + offset] &= value;
+            cart.ramDirty_ = true;
+        }
+        break;
+        case 0xA000 ... 0xBFFF:
+            cart.WriteRamPage(address, value);
+            break;
+        default: break;
+    }
+}
+
+void MBC6Mapper::MapBanks(Cartridge &cart) {
+    const auto &state = cart.mapperState_.mbc6;
+    const auto page = [&](const uint8_t bank, const bool flash) -> const uint8_t * {
+        if (flash && state.flashEnabled) return cart.gameRam_.data() + RAM_SIZE + bank * 0x2000U % FLASH_SIZE;
+        return cart.gameRom_.data() + bank * 0x2000ULL % cart.gameRom_.size();
+    };
+    const uint8_t *rom0 = cart.gameRom_.data();
+    cart.romPages_ = {rom0, rom0 + 0x2000, page(state.romBankA, state.flashA), page(state.romBankB, state.flashB)};
+
+    if (!cart.ramEnabled) {
+        cart.UnmapRam();
+        return;
+    }
+    uint8_t *ram = cart.gameRam_.data();
+    cart.ramPages_ = {ram + state.ramBankA * 0x1000U % RAM_SIZE, ram + state.ramBankB * 0x1000U % RAM_SIZE};
+}
+
+/* MBC7: accelerometer and 93LC56 EEPROM behind a register window at A000-AFFF */
+
+uint8_t MBC7Mapper::ReadByte(const Cartridge &cart, const uint16_t address) {
+    const auto &state = cart.mapperState_.mbc7;
+    if (address >= 0xB000 || !cart.ramEnabled || !state.ramEnabled2) return 0xFF;
+    switch ((address >> 4) & 0x0F) {
+        case 0x2: return state.accelX & 0xFF;
+        case 0x3: return state.accelX >> 8;
+        case 0x4: return state.accelY & 0xFF;
+        case 0x5: return state.accelY >> 8;
+        case 0x6: return 0x00;
+        case 0x8: return state.cs << 7 | state.clk << 6 | state.di << 1 | state.dataOut;
+        default: return 0xFF;
+    }
+}
+
+void MBC7Mapper::WriteByte(Cartridge &cart, const uint16_t address, const uint8_t value) {
+    auto &state = cart.mapperState_.mbc7;
+    switch (address) {
+        case 0x0000 ... 0x1FFF: {
+            const bool newEnable = value == 0x0A;
+            cart.HandleRamEnableEdge(newEnable);
+            cart.ramEnabled = newEnable;
+        }
+        break;
+        case 0x2000 ... 0x3FFF:
+            cart.romBank = value & 0x7F;
+            break;
+        case 0x4000 ... 0x5FFF:
+            state.ramEnabled2 = value == 0x40;
+            break;
+        case 0xA000 ... 0xAFFF: {
+            if (!cart.ramEnabled || !state.ramEnabled2) break;
+            switch ((address >> 4) & 0x0F) {
+                case 0x0:
+                    if (value == 0x55) {
+                        state.accelX = state.accelY = 0x8000;
+                        state.accelLatched = false;
+                    }
+                    break;
+                case 0x1:
+                    if (value == 0xAA && !state.accelLatched) {
+                        // 0x81D0 at rest, roughly 0x70 per g
+                        state.accelX = static_cast<uint16_t>(0x81D0 - std::lround(cart.accelX_ * 0x70));
+                        state.accelY = static_cast<uint16_t>(0x81D0 + std::lround(cart.accelY_ * 0x70));
+                        state.accelLatched = true;
+                    }
+                    break;
+                case 0x8: ClockEeprom(cart, value);
+                    break;
+                default: break;
+            }
+        }
+        break;
+        default: break;
+    }
+}
+
+void MBC7Mapper::MapBanks(Cartridge &cart) {
+    cart.MapRom(0, cart.romBank);
+    cart.UnmapRam();
+}
+
+void MBC7Mapper::ClockEeprom(Cartridge &cart, const uint8_t value) {
+    auto &state = cart.mapperState_.mbc7;
+    const bool cs = value & 0x80;
+    const bool clk = value & 0x40;
+    const bool di = value & 0x02;
+
+    if (!cs || !state.cs) {
+        // Chip select edges restart the serial protocol
+        state.readingOut = state.awaitingData = false;
+        state.bitCount = 0;
+        state.shift = 0;
+    }
+    const bool rising = cs && state.cs && clk && !state.clk;
+    state.cs = cs;
+    state.clk = clk;
+    state.di = di;
+    if (!rising) return;
+
+    auto word = [&](const uint8_t index) -> uint8_t * { return &cart.gameRam_[(index & 0x7F) * 2]; };
+    auto program = [&](const uint8_t index, const uint16_t data) {
+        uint8_t *cell = word(index);
+        cell[0] = data >> 8;
+        cell[1] = data & 0xFF;
+        cart.ramDirty_ = true;
+    };
+
+    if (state.readingOut) {
+        state.dataOut = state.shift & 0x8000;
+        state.shift <<= 1;
+        if (--state.bitCount == 0) {
+            // Sequential read: keep clocking to stream the next word
+            state.address = (state.address + 1) & 0x7F;
+            const uint8_t *cell = word(state.address);
+            state.shift = cell[0] << 8 | cell[1];
+            state.bitCount = 16;
+        }
+        return;
+    }
+
+    if (state.awaitingData) {
+        state.shift = state.shift << 1 | di;
+        if (++state.bitCount < 16) return;
+        if (state.writeEnabled) {
+            if (state.command == 0b01) {
+                program(state.address, state.shift);
+            } else {
+                for (uint8_t i = 0; i < 0x80; ++i) program(i, state.shift);
+            }
+        }
+        state.awaitingData = false;
+        state.dataOut = true;
+        state.bitCount = 0;
+        state.shift = 0;
+        return;
+    }
+
+    // Command: start bit, 2-bit opcode, 8-bit address
+    if (state.bitCount == 0 && !di) return;
+    state.shift = state.shift << 1 | di;
+    if (++state.bitCount < 11) return;
+
+    state.command = (state.shift >> 8) & 0x03;
+    const uint8_t field = state.shift & 0xFF;
+    state.address = field & 0x7F;
+    state.bitCount = 0;
+    state.shift = 0;
+
+    switch (state.command) {
+        case 0b10: {
+            // READ: a dummy zero bit, then the word MSB first
+            const uint8_t *cell = word(state.address);
+            state.shift = cell[0] << 8 | cell[1];
+            state.bitCount = 16;
+            state.readingOut = true;
+            state.dataOut = false;
+        }
+        break;
+        case 0b01: state.awaitingData = true;
+            break;
+        case 0b11:
+            if (state.writeEnabled) program(state.address, 0xFFFF);
+            state.dataOut = true;
+            break;
+        case 0b00:
+            switch (field >> 6) {
+                case 0b00: state.writeEnabled = false; // EWDS
+                    break;
+                case 0b01: state.command = 0b00; // WRAL
+                    state.awaitingData = true;
+                    break;
+                case 0b10: // ERAL
+                    if (state.writeEnabled) for (uint8_t i = 0; i < 0x80; ++i) program(i, 0xFFFF);
+                    state.dataOut = true;
+                    break;
+                case 0b11: state.writeEnabled = true; // EWEN
+                    break;
+                default: break;
+            }
+            break;
+        default: break;
+    }
+}
+
+/* HuC1: MBC1-like banking with an infrared port in place of RAM */
+
+uint8_t HuC1Mapper::ReadByte(const Cartridge &cart, uint16_t) {
+    // No light received
+    if (cart.mapperState_.infraredMode) return 0xC0;
+    return 0xFF;
+}
+
+void HuC1Mapper::WriteByte(Cartridge &cart, const uint16_t address, const uint8_t value) {
+    auto &state = cart.mapperState_;
+    switch (address) {
+        case 0x0000 ... 0x1FFF:
+            state.infraredMode = (value & 0x0F) == 0x0E;
+            cart.HandleRamEnableEdge(!state.infraredMode);
+            break;
+        case 0x2000 ... 0x3FFF:
+            cart.romBank = value & 0x3F;
+            if (cart.romBank == 0) cart.romBank = 1;
+            break;
+        case 0x4000 ... 0x5FFF:
+            cart.ramBank = value & 0x03;
+            break;
+        case 0xA000 ... 0xBFFF:
+            // Writes in IR mode drive the LED, which has no observer here
+            if (!state.infraredMode) cart.WriteRamPage(address, value);
+            break;
+        default: break;
+    }
+}
+
+void HuC1Mapper::MapBanks(Cartridge &cart) {
+    cart.MapRom(0, cart.romBank);
+    cart.MapRam(!cart.mapperState_.infraredMode, cart.ramBank);
+}
+
+/* HuC3: RAM, RTC and speaker behind a nibble-wide command interface */
+
+uint8_t HuC3Mapper::ReadByte(const Cartridge &cart, uint16_t) {
+    const auto &state = cart.mapperState_.huc3;
+    switch (state.mode) {
+        case 0x0C: return 0x80 | state.command << 4 | state.response;
+        case 0x0D: return 0x01; // command finished
+        case 0x0E: return 0xC0; // no IR light
+        default: return 0xFF;
+    }
+}
+
+void HuC3Mapper::WriteByte(Cartridge &cart, const uint16_t address, const uint8_t value) {
+    auto &state = cart.mapperState_.huc3;
+    switch (address) {
+        case 0x0000 ... 0x1FFF: {
+            state.mode = value & 0x0F;
+            const bool newEnable = state.mode == 0x0A;
+            cart.HandleRamEnableEdge(newEnable);
+            cart.ramEnabled = newEnable;
+        }
+        break;
+        case 0x2000 ... 0x3FFF:
+            cart.romBank = value & 0x7F;
+            break;
+        case 0x4000 ... 0x5FFF:
+            cart.ramBank = value & 0x03;
+            break;
+        case 0xA000 ... 0xBFFF:
+            switch (state.mode) {
+                case 0x0A: cart.WriteRamPage(address, value);
+                    break;
+                case 0x0B:
+                    state.command = (value >> 4) & 0x07;
+                    state.argument = value & 0x0F;
+                    break;
+                case 0x0D:
+                    if ((value & 0x01) == 0) ExecuteCommand(cart);
+                    break;
+                default: break;
+            }
+            break;
+        default: break;
+    }
+}
+
+void HuC3Mapper::MapBanks(Cartridge &cart) {
+    const uint8_t mode = cart.mapperState_.huc3.mode;
+    // Mode 0 maps RAM read-only; writes fall through to WriteByte and are dropped
+    cart.MapRom(0, cart.romBank);
+    cart.MapRam(mode == 0x0A || mode == 0x00, cart.ramBank);
+}
+
+void HuC3Mapper::ExecuteCommand(Cartridge &cart) {
+    auto &state = cart.mapperState_.huc3;
+    auto &clock = cart.rtc_.realClock_;
+    switch (state.command) {
+        case 0x1: state.response = state.memory[state.address++] & 0x0F;
+            break;
+        case 0x3: state.memory[state.address++] = state.argument;
+            break;
+        case 0x4: state.address = (state.address & 0xF0) | state.argument;
+            break;
+        case 0x5: state.address = (state.address & 0x0F) | state.argument << 4;
+            break;
+        case 0x6:
+            switch (state.argument) {
+                case 0x0: {
+                    // Minute of day and day counter, 12 bits each, low nibble first
+                    const uint16_t minutes = clock.hours_ * 60 + clock.minutes_;
+                    const uint16_t days = clock.dayLower_ | (clock.dayUpper_ & 0x01) << 8;
+                    for (int i = 0; i < 3; ++i) {
+                        state.memory[i] = (minutes >> (i * 4)) & 0x0F;
+                        state.memory[3 + i] = (days >> (i * 4)) & 0x0F;
+                    }
+                }
+                break;
+                case 0x1: {
+                    uint16_t minutes = 0, days = 0;
+                    for (int i = 0; i < 3; ++i) {
+                        minutes |= (state.memory[i] & 0x0F) << (i * 4);
+                        days |= (state.memory[3 + i] & 0x0F) << (i * 4);
+                    }
+                    minutes %= 24 * 60;
+                    cart.rtc_.WriteRTC(0x08, 0);
+                    cart.rtc_.WriteRTC(0x09, minutes % 60);
+                    cart.rtc_.WriteRTC(0x0A, minutes / 60);
+                    cart.rtc_.WriteRTC(0x0B, days & 0xFF);
+                    cart.rtc_.WriteRTC(0x0C, (clock.dayUpper_ & 0xFE) | ((days >> 8) & 0x01));
+                }
+                break;
+                case 0x2: state.response = 0x1;
+                    break;
+                default: break;
+            }
+            break;
+        default: break;
+    }
+}
+
+/* MMM01: multicart menu that locks itself into one game */
+
+uint8_t MMM01Mapper::ReadByte(const Cartridge &, uint16_t) {
+    return 0xFF;
+}
+
+void MMM01Mapper::WriteByte(Cartridge &cart, const uint16_t address, const uint8_t value) {
+    auto &state = cart.mapperState_.mmm01;
+    switch (address) {
+        case 0x0000 ... 0x1FFF: {
+            const bool newEnable = (value & 0x0F) == 0x0A;
+            cart.HandleRamEnableEdge(newEnable);
+            cart.ramEnabled = newEnable;
+            if (!state.mapped && (value & 0x40)) state.mapped = true;
+        }
+        break;
+        case 0x2000 ... 0x3FFF: {
+            // Bits covered by the mask stay with the menu's selection
+            const uint8_t frozen = state.mapped ? state.romMask << 1 : 0x00;
+            state.romLow = (state.romLow & frozen) | (value & 0x1F & ~frozen);
+            if (!state.mapped) state.romMid = (value >> 5) & 0x03;
+        }
+        break;
+        case 0x4000 ... 0x5FFF:
+            state.ramLow = value & 0x03;
+            if (!state.mapped) {
+                state.romHigh = (value >> 2) & 0x03;
+                state.ramHigh = (value >> 4) & 0x03;
+                state.modeLocked = value & 0x40;
+            }
+            break;
+        case 0x6000 ... 0x7FFF:
+            if (!state.modeLocked) cart.mode = value & 0x01;
+            if (!state.mapped) state.romMask = (value >> 2) & 0x0F;
+            break;
+        case 0xA000 ... 0xBFFF:
+            if (cart.ramEnabled) cart.WriteRamPage(address, value);
+            break;
+        default: break;
+    }
+}
+
+void MMM01Mapper::MapBanks(Cartridge &cart) {
+    const auto &state = cart.mapperState_.mmm01;
+    if (!state.mapped) {
+        // The menu lives in the last 32 KiB
+        cart.MapRom(cart.romBankCount - 2, cart.romBankCount - 1);
+        cart.UnmapRam();
+        return;
+    }
+    const uint8_t frozen = state.romMask << 1;
+    const size_t outer = state.romHigh << 7 | state.romMid << 5;
+    const uint8_t low = (state.romLow & 0x1F) == 0 ? 0x01 : state.romLow;
+    cart.MapRom(outer | (state.romLow & frozen), outer | low);
+    cart.MapRam(cart.ramEnabled, cart.mode ? (state.ramHigh << 2 | state.ramLow) : state.ramHigh << 2);
+}
+
+/* Pocket Camera (MAC-GBD) */
+
+namespace {
+    // Stand-in scene when no sensor source is attached: a lit disc over a
+    // diagonal gradient, enough to exercise exposure and dithering.
+    void SyntheticScene(const std::span<uint8_t> image) {
+        constexpr int w = PocketCameraMapper::SENSOR_WIDTH;
+        constexpr int h = PocketCameraMapper::SENSOR_HEIGHT;
+        for (int y = 0; y < h; ++y) {
+            for (int x = 0; x < w; ++x) {
+                const int dx = x - w / 2, dy = y - h / 2;
+                const bool disc = dx * dx + dy * dy < 32 * 32;
+                image[y * w + x] = disc ? 0xE0 : static_cast<uint8_t>((x + y) * 255 / (w + h));
+            }
+        }
+    }
+}
+
+uint8_t PocketCameraMapper::ReadByte(const Cartridge &cart, const uint16_t address) {
+    if (cart.ramBank & 0x10) {
+        // Only the capture status register reads back
+        return (address & 0x7F) == 0 ? cart.mapperState_.camera.registers[0] & 0x07 : 0x00;
+    }
+    return 0xFF;
+}
+
+void PocketCameraMapper::WriteByte(Cartridge &cart, const uint16_t address, const uint8_t value) {
+    auto &registers = cart.mapperState_.camera.registers;
+    switch (address) {
+        case 0x0000 ... 0x1FFF: {
+            const bool newEnable = (value & 0x0F) == 0x0A;
+            cart.HandleRamEnableEdge(newEnable);
+            cart.ramEnabled = newEnable;
+        }
+        break;
+        case 0x2000 ... 0x3FFF:
+            cart.romBank = value & 0x3F;
+            break;
+        case 0x4000 ... 0x5FFF:
+            cart.ramBank = value & 0x1F;
+            break;
+        case 0xA000 ... 0xBFFF:
+            if (cart.ramBank & 0x10) {
+                const uint8_t reg = address & 0x7F;
+                if (reg >= registers.size()) break;
+                registers[reg] = value;
+                if (reg == 0 && (value & 0x01)) Capture(cart);
+            } else if (cart.ramEnabled) {
+                cart.WriteRamPage(address, value);
+            }
+            break;
+        default: break;
+    }
+}
+
+void PocketCameraMapper::MapBanks(Cartridge &cart) {
+    cart.MapRom(0, cart.romBank);
+    // RAM stays readable while write-protected; the register bank is not RAM
+    cart.MapRam((cart.ramBank & 0x10) == 0, cart.ramBank & 0x0F);
+}
+
+void PocketCameraMapper::Capture(Cartridge &cart) {
+    auto &registers = cart.mapperState_.camera.registers;
+    std::array<uint8_t, SENSOR_WIDTH * SENSOR_HEIGHT> image{};
+    if (cart.cameraSource_) cart.cameraSource_(image);
+    else SyntheticScene(image);
+
+    // The analog stage is reduced to exposure scaling and optional inversion
+    const uint32_t exposure = registers[2] << 8 | registers[3];
+    const bool invert = registers[4] & 0x08;
+
+    // Output is a 16x14 tile image (2bpp) at RAM offset 0x100
+    uint8_t *out = cart.gameRam_.data() + 0x100;
+    std::memset(out, 0, 16 * 14 * 16);
+    for (int y = 0; y < SENSOR_HEIGHT; ++y) {
+        for (int x = 0; x < SENSOR_WIDTH; ++x) {
+            int level = static_cast<int>(std::min<uint32_t>(255, image[y * SENSOR_WIDTH + x] * exposure / 0x1000));
+            if (invert) level = 255 - level;
+            const uint8_t *thresholds = &registers[6 + ((y & 3) * 4 + (x & 3)) * 3];
+            const uint8_t color = level < thresholds[0] ? 3 : level < thresholds[1] ? 2 : level < thresholds[2] ? 1 : 0;
+            uint8_t *row = out + ((y / 8) * 16 + x / 8) * 16 + (y & 7) * 2;
+            const uint8_t bit = 0x80 >> (x & 7);
+            if (color & 0x01) row[0] |= bit;
+            if (color & 0x02) row[1] |= bit;
+        }
+    }
+    cart.ramDirty_ = true;
+    // Capture completes immediately
+    registers[0] &= 0x06;
+}
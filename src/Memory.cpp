@@ -18,6 +18,7 @@ bool Memory::LoadState(std::ifstream &stateFile) {
         stateFile.read(reinterpret_cast<char *>(wram_.data()), 0x8000);
         stateFile.read(reinterpret_cast<char *>(hram_.data()), 0x80);
         stateFile.read(reinterpret_cast<char *>(&wramBank_), sizeof(wramBank_));
+        for (size_t page = 0; page < CODE_PAGE_COUNT; ++page) InvalidateCode(page);
         return true;
     } catch ([[maybe_unused]] const std::exception &e) {
         return false;
@@ -0,0 +1,204 @@
+#include "PngWriter.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "RomSource.h"
+
+namespace {
+    void PutBigEndian(std::vector<uint8_t> &out, const uint32_t value) {
+        for (int shift = 24; shift >= 0; shift -= 8) out.push_back(static_cast<uint8_t>(value >> shift));
+    }
+
+    // Length, type, data, then a CRC over type and data
+    void PutChunk(std::vector<uint8_t> &out, const char *type, const std::span<const uint8_t> data) {
+        PutBigEndian(out, static_cast<uint32_t>(data.size()));
+        const size_t typeAt = out.size();
+        out.insert(out.end(), type, type + 4);
+        out.insert(out.end(), data.begin(), data.end());
+        PutBigEndian(out, RomSource::Crc32(std::span(out).subspan(typeAt)));
+    }
+
+    uint32_t Adler32(const std::span<const uint8_t> bytes) {
+        uint32_t a = 1;
+        uint32_t b = 0;
+        // 5552 bytes is the most that can be summed before b overflows
+        for (size_t start = 0; start < bytes.size(); start += 5552) {
+            for (const uint8_t byte: bytes.subspan(start, std::min<size_t>(5552, bytes.size() - start))) {
+                a += byte;
+                b += a;
+            }
+            a %= 65521;
+            b %= 65521;
+        }
+        return b << 16 | a;
+    }
+
+    // Deflate packs bits from the least significant end of each byte
+    class BitWriter {
+    public:
+        explicit BitWriter(std::vector<uint8_t> &out) : out_(out) {}
+
+        void Put(const uint32_t value, const int count) {
+            bits_ |= uint64_t{value} << count_;
+            count_ += count;
+            for (; count_ >= 8; count_ -= 8) {
+                out_.push_back(static_cast<uint8_t>(bits_));
+                bits_ >>= 8;
+            }
+        }
+
+        // Huffman codes, unlike everything else, go most significant bit first
+        void PutCode(const uint32_t code, const int length) {
+            uint32_t reversed = 0;
+            for (int i = 0; i < length; i++) reversed |= (code >> i & 1) << (length - 1 - i);
+            Put(reversed, length);
+        }
+
+        void Flush() {
+            if (count_ > 0) out_.push_back(static_cast<uint8_t>(bits_));
+            bits_ = 0;
+            count_ = 0;
+        }
+
+    private:
+        std::vector<uint8_t> &out_;
+        uint64_t bits_{0};
+        int count_{0};
+    };
+
+    constexpr uint16_t LENGTH_BASE[29] = {
+        3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+    };
+    constexpr uint8_t LENGTH_EXTRA[29] = {
+        0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+    };
+    constexpr uint16_t DISTANCE_BASE[30] = {
+        1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097,
+        6145, 8193, 12289, 16385, 24577
+    };
+    constexpr uint8_t DISTANCE_EXTRA[30] = {
+        0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+    };
+
+    // The fixed literal/length code of RFC 1951 3.2.6
+    void PutSymbol(BitWriter &bits, const uint32_t symbol) {
+        if (symbol < 144) bits.PutCode(0x30 + symbol, 8);
+        else if (symbol < 256) bits.PutCode(0x190 + symbol - 144, 9);
+        else if (symbol < 280) bits.PutCode(symbol - 256, 7);
+        else bits.PutCode(0xC0 + symbol - 280, 8);
+    }
+
+    void PutMatch(BitWriter &bits, const uint32_t length, const uint32_t distance) {
+        int code = 28;
+        while (LENGTH_BASE[code] > length) --code;
+        PutSymbol(bits, 257 + code);
+        bits.Put(length - LENGTH_BASE[code], LENGTH_EXTRA[code]);
+        code = 29;
+        while (DISTANCE_BASE[code] > distance) --code;
+        bits.PutCode(code, 5);
+        bits.Put(distance - DISTANCE_BASE[code], DISTANCE_EXTRA[code]);
+    }
+
+    // A single fixed-Huffman block with greedy LZ77 matching. Each hash of
+    // three bytes only remembers where it last occurred, which is enough for
+    // the runs of one colour and repeated rows a screen is made of.
+    std::vector<uint8_t> Deflate(const std::span<const uint8_t> data) {
+        constexpr size_t WINDOW = 32768;
+        constexpr size_t MIN_MATCH = 3;
+        constexpr size_t MAX_MATCH = 258;
+        constexpr int HASH_BITS = 15;
+        const auto hash = [&](const size_t at) {
+            const uint32_t key = data[at] << 16 | data[at + 1] << 8 | data[at + 2];
+            return key * 2654435761u >> (32 - HASH_BITS);
+        };
+
+        std::vector<uint8_t> out;
+        BitWriter bits(out);
+        bits.Put(1, 1); // BFINAL
+        bits.Put(1, 2); // fixed Huffman codes
+        std::vector<size_t> last(size_t{1} << HASH_BITS, SIZE_MAX);
+        size_t at = 0;
+        while (at < data.size()) {
+            size_t length = 0;
+            size_t distance = 0;
+            if (at + MIN_MATCH <= data.size()) {
+                const uint32_t key = hash(at);
+                const size_t candidate = last[key];
+                last[key] = at;
+                if (candidate != SIZE_MAX && at - candidate <= WINDOW) {
+                    const size_t limit = std::min(MAX_MATCH, data.size() - at);
+                    while (length < limit && data[candidate + length] == data[at + length]) ++length;
+                    distance = at - candidate;
+                }
+            }
+            if (length < MIN_MATCH) {
+                PutSymbol(bits, data[at++]);
+                continue;
+            }
+            PutMatch(bits, static_cast<uint32_t>(length), static_cast<uint32_t>(distance));
+            for (size_t i = at + 1; i < at + length && i + MIN_MATCH <= data.size(); i++) last[hash(i)] = i;
+            at += length;
+        }
+        PutSymbol(bits, 256); // end of block
+        bits.Flush();
+        return out;
+    }
+
+    // Stored blocks, for data that fixed codes would make larger
+    std::vector<uint8_t> Store(const std::span<const uint8_t> data) {
+        std::vector<uint8_t> out;
+        size_t at = 0;
+        do {
+            const auto size = static_cast<uint16_t>(std::min<size_t>(data.size() - at, 0xFFFF));
+            out.push_back(at + size == data.size() ? 1 : 0); // BFINAL on the last
+            out.insert(out.end(), {
+                           static_cast<uint8_t>(size), static_cast<uint8_t>(size >> 8),
+                           static_cast<uint8_t>(~size), static_cast<uint8_t>(~size >> 8)
+                       });
+            out.insert(out.end(), data.begin() + static_cast<std::ptrdiff_t>(at),
+                       data.begin() + static_cast<std::ptrdiff_t>(at + size));
+            at += size;
+        } while (at < data.size());
+        return out;
+    }
+}
+
+
+void WritePng(const std::string &path, const uint32_t *pixels, const uint32_t width, const uint32_t height) {
+    // Every row starts with filter type 0 (none)
+    const size_t rowBytes = size_t{width} * 4;
+    std::vector<uint8_t> raw;
+    raw.reserve((rowBytes + 1) * height);
+    const auto *bytes = reinterpret_cast<const uint8_t *>(pixels);
+    for (uint32_t y = 0; y < height; ++y) {
+        raw.push_back(0);
+        raw.insert(raw.end(), bytes + y * rowBytes, bytes + (y + 1) * rowBytes);
+    }
+
+    // zlib stream (RFC 1950) around one deflate stream (RFC 1951)
+    std::vector<uint8_t> zlib = {0x78, 0x01};
+    std::vector<uint8_t> compressed = Deflate(raw);
+    if (compressed.size() >= raw.size()) compressed = Store(raw);
+    zlib.insert(zlib.end(), compressed.begin(), compressed.end());
+    PutBigEndian(zlib, Adler32(raw));
+
+    std::vector<uint8_t> header;
+    PutBigEndian(header, width);
+    PutBigEndian(header, height);
+    header.insert(header.end(), {8, 6, 0, 0, 0}); // 8 bits, RGBA, deflate, no filter set, no interlace
+
+    std::vector<uint8_t> png = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    PutChunk(png, "IHDR", header);
+    PutChunk(png, "IDAT", zlib);
+    PutChunk(png, "IEND", {});
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) throw std::runtime_error("Could not open " + path);
+    file.write(reinterpret_cast<const char *>(png.data()), static_cast<std::streamsize>(png.size()));
+    if (!file) throw std::runtime_error("Could not write " + path);
+}
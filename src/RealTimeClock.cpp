@@ -1,5 +1,6 @@
 #include "RealTimeClock.h"
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <fstream>
@@ -34,6 +35,38 @@ void RealTimeClock::Update() {
     }
 }
 
+uint32_t RealTimeClock::IdleTicks() const {
+    if (counter_ >= RTC_TICKS_PER_SECOND) return 0;
+    if (halted_) return IDLE_UNBOUNDED;
+    return static_cast<uint32_t>(RTC_TICKS_PER_SECOND - counter_ - 1);
+}
+
+void RealTimeClock::SkipIdleTicks(const uint32_t ticks) {
+    if (!halted_) counter_ += ticks;
+}
+
+void RealTimeClock::Advance(uint64_t ticks) {
+    while (ticks > 0) {
+        if (const uint64_t idle = std::min<uint64_t>(IdleTicks(), ticks); idle > 0) {
+            SkipIdleTicks(static_cast<uint32_t>(idle));
+            ticks -= idle;
+        } else {
+            Update();
+            --ticks;
+        }
+    }
+}
+
+std::array<uint8_t, 5> RealTimeClock::GetRegisters() const {
+    return {realClock_.seconds_, realClock_.minutes_, realClock_.hours_, realClock_.dayLower_, realClock_.dayUpper_};
+}
+
+void RealTimeClock::SetRegisters(const std::array<uint8_t, 5> &registers) {
+    *this = RealTimeClock(realRTC_);
+    realClock_ = {registers[0], registers[1], registers[2], registers[3], registers[4]};
+    RecalculateZeroTime();
+}
+
 void RealTimeClock::Load(std::ifstream &stateFile) {
     stateFile.read(reinterpret_cast<char *>(&zeroTime_), sizeof(zeroTime_));
     stateFile.read(reinterpret_cast<char *>(&realClock_.seconds_), sizeof(realClock_.seconds_));
@@ -0,0 +1,17 @@
+#include "RomProfiler.h"
+
+std::vector<RomProfiler::Hotspot> RomProfiler::Hotspots(const size_t count) const {
+    std::vector<Hotspot> hotspots;
+    for (size_t i = 0; i < romCycles_.size(); ++i) {
+        if (romCycles_[i]) hotspots.push_back({true, static_cast<uint32_t>(i), romCycles_[i], romExecutions_[i]});
+    }
+    for (size_t i = 0; i < otherCycles_.size(); ++i) {
+        if (otherCycles_[i]) hotspots.push_back({false, static_cast<uint32_t>(i), otherCycles_[i], otherExecutions_[i]});
+    }
+    const auto costlier = [](const Hotspot &a, const Hotspot &b) { return a.mCycles > b.mCycles; };
+    const size_t kept = std::min(count, hotspots.size());
+    std::partial_sort(hotspots.begin(), hotspots.begin() + static_cast<std::ptrdiff_t>(kept), hotspots.end(),
+                      costlier);
+    hotspots.resize(kept);
+    return hotspots;
+}
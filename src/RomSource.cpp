@@ -0,0 +1,463 @@
+#include "RomSource.h"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+
+#ifdef STARGBC_WITH_ZSTD
+#include <zstd.h>
+#endif
+
+namespace {
+    constexpr auto kCrcTable = [] {
+        std::array<uint32_t, 256> table{};
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) c = c & 1 ? 0xEDB88320 ^ (c >> 1) : c >> 1;
+            table[i] = c;
+        }
+        return table;
+    }();
+
+    [[noreturn]] void Corrupt(const std::string &what) {
+        throw std::runtime_error("Corrupt ROM archive: " + what);
+    }
+
+    void CheckSize(const size_t size) {
+        if (size > RomSource::MAX_ROM_SIZE) throw std::runtime_error("ROM is larger than 8 MiB");
+    }
+
+    bool EndsWithNoCase(const std::string_view str, const std::string_view suffix) {
+        return str.size() >= suffix.size() &&
+               std::ranges::equal(str.substr(str.size() - suffix.size()), suffix,
+                                  [](const char a, const char b) { return std::tolower(a) == std::tolower(b); });
+    }
+
+    bool IsRomName(const std::string_view name) {
+        return EndsWithNoCase(name, ".gb") || EndsWithNoCase(name, ".gbc") || EndsWithNoCase(name, ".cgb");
+    }
+
+    // Buffered byte and LSB-first bit reader over the archive file. Bits are
+    // pulled a byte at a time, so after AlignToByte() the byte position is
+    // exactly where the deflate stream ended.
+    class InputStream {
+    public:
+        explicit InputStream(std::istream &in) : in_(in) {
+        }
+
+        uint8_t Byte() {
+            if (pos_ == len_ && !Refill()) Corrupt("unexpected end of file");
+            return buffer_[pos_++];
+        }
+
+        uint16_t U16() {
+            const uint16_t lo = Byte();
+            return lo | Byte() << 8;
+        }
+
+        uint32_t U32() {
+            const uint32_t lo = U16();
+            return lo | static_cast<uint32_t>(U16()) << 16;
+        }
+
+        void Skip(size_t count) {
+            while (count--) Byte();
+        }
+
+        // Appends `count` bytes to `out`
+        void Read(std::vector<uint8_t> &out, size_t count) {
+            while (count) {
+                if (pos_ == len_ && !Refill()) Corrupt("unexpected end of file");
+                const size_t chunk = std::min(count, len_ - pos_);
+                out.insert(out.end(), buffer_.begin() + pos_, buffer_.begin() + pos_ + chunk);
+                pos_ += chunk;
+                count -= chunk;
+            }
+        }
+
+        uint32_t Bits(const int count) {
+            while (bitCount_ < count) {
+                bitBuffer_ |= static_cast<uint32_t>(Byte()) << bitCount_;
+                bitCount_ += 8;
+            }
+            const uint32_t value = bitBuffer_ & ((1U << count) - 1);
+            bitBuffer_ >>= count;
+            bitCount_ -= count;
+            return value;
+        }
+
+        void AlignToByte() {
+            bitBuffer_ = 0;
+            bitCount_ = 0;
+        }
+
+        // Hands out whatever is buffered (refilling if empty), for decoders
+        // that consume the file in their own chunks
+        std::span<const uint8_t> Chunk() {
+            if (pos_ == len_) Refill();
+            const std::span<const uint8_t> chunk(buffer_.data() + pos_, len_ - pos_);
+            pos_ = len_;
+            return chunk;
+        }
+
+    private:
+        bool Refill() {
+            in_.read(reinterpret_cast<char *>(buffer_.data()), buffer_.size());
+            len_ = static_cast<size_t>(in_.gcount());
+            pos_ = 0;
+            return len_ != 0;
+        }
+
+        std::istream &in_;
+        std::array<uint8_t, 0x10000> buffer_{};
+        size_t pos_{0};
+        size_t len_{0};
+        uint32_t bitBuffer_{0};
+        int bitCount_{0};
+    };
+
+    // Minimal RFC 1951 decoder. The output vector doubles as the sliding
+    // window since the whole ROM ends up in memory anyway. Decoding stops
+    // once it has appended more than MAX_ROM_SIZE bytes.
+    class Inflater {
+    public:
+        Inflater(InputStream &in, std::vector<uint8_t> &out) : in_(in), out_(out), start_(out.size()),
+                                                                crcPos_(out.size()) {
+        }
+
+        // Returns the CRC32 of everything this call appended
+        uint32_t Run() {
+            bool last;
+            do {
+                last = in_.Bits(1);
+                switch (in_.Bits(2)) {
+                    case 0: Stored();
+                        break;
+                    case 1: Fixed();
+                        break;
+                    case 2: Dynamic();
+                        break;
+                    default: Corrupt("invalid deflate block type");
+                }
+                // Fold the block into the CRC while it is still in cache
+                crc_ = RomSource::Crc32(std::span(out_).subspan(crcPos_), crc_);
+                crcPos_ = out_.size();
+            } while (!last);
+            in_.AlignToByte();
+            return crc_;
+        }
+
+    private:
+        static constexpr int kMaxBits = 15;
+
+        struct Huffman {
+            std::array<uint16_t, kMaxBits + 1> count{};
+            std::array<uint16_t, 288> symbol{};
+        };
+
+        static constexpr std::array<uint16_t, 29> kLengthBase{
+            3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+            35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+        };
+        static constexpr std::array<uint8_t, 29> kLengthExtra{
+            0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+        };
+        static constexpr std::array<uint16_t, 30> kDistBase{
+            1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+            257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+        };
+        static constexpr std::array<uint8_t, 30> kDistExtra{
+            0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+        };
+
+        static void Build(Huffman &h, const std::span<const uint8_t> lengths) {
+            h.count.fill(0);
+            for (const uint8_t len: lengths) ++h.count[len];
+            std::array<uint16_t, kMaxBits + 1> offsets{};
+            for (int len = 1; len < kMaxBits; ++len) offsets[len + 1] = offsets[len] + h.count[len];
+            for (size_t symbol = 0; symbol < lengths.size(); ++symbol) {
+                if (lengths[symbol]) h.symbol[offsets[lengths[symbol]]++] = static_cast<uint16_t>(symbol);
+            }
+        }
+
+        int Decode(const Huffman &h) const {
+            int code = 0, first = 0, index = 0;
+            for (int len = 1; len <= kMaxBits; ++len) {
+                code |= static_cast<int>(in_.Bits(1));
+                const int count = h.count[len];
+                if (code - count < first) return h.symbol[index + (code - first)];
+                index += count;
+                first = (first + count) << 1;
+                code <<= 1;
+            }
+            Corrupt("invalid Huffman code");
+        }
+
+        void Stored() const {
+            in_.AlignToByte();
+            const uint16_t len = in_.U16();
+            if (const uint16_t nlen = in_.U16(); len != static_cast<uint16_t>(~nlen)) Corrupt("stored block length");
+            Grow(len);
+            in_.Read(out_, len);
+        }
+
+        void Fixed() {
+            static const auto tables = [] {
+                std::array<uint8_t, 288 + 30> lengths{};
+                std::fill_n(lengths.begin(), 144, 8);
+                std::fill_n(lengths.begin() + 144, 112, 9);
+                std::fill_n(lengths.begin() + 256, 24, 7);
+                std::fill_n(lengths.begin() + 280, 8, 8);
+                std::fill_n(lengths.begin() + 288, 30, 5);
+                std::pair<Huffman, Huffman> t;
+                Build(t.first, std::span(lengths).first(288));
+                Build(t.second, std::span(lengths).subspan(288));
+                return t;
+            }();
+            Codes(tables.first, tables.second);
+        }
+
+        void Dynamic() {
+            static constexpr std::array<uint8_t, 19> order{16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+            const int nlen = static_cast<int>(in_.Bits(5)) + 257;
+            const int ndist = static_cast<int>(in_.Bits(5)) + 1;
+            const int ncode = static_cast<int>(in_.Bits(4)) + 4;
+            if (nlen > 286 || ndist > 30) Corrupt("too many length or distance codes");
+
+            std::array<uint8_t, 320> lengths{};
+            for (int i = 0; i < ncode; ++i) lengths[order[i]] = in_.Bits(3);
+            Huffman lencode, distcode;
+            Build(lencode, std::span(lengths).first(19));
+
+            for (int i = 0; i < nlen + ndist;) {
+                int symbol = Decode(lencode);
+                if (symbol < 16) {
+                    lengths[i++] = symbol;
+                    continue;
+                }
+                uint8_t repeat = 0;
+                int times;
+                if (symbol == 16) {
+                    if (i == 0) Corrupt("repeat with no previous length");
+                    repeat = lengths[i - 1];
+                    times = 3 + static_cast<int>(in_.Bits(2));
+                } else if (symbol == 17) {
+                    times = 3 + static_cast<int>(in_.Bits(3));
+                } else {
+                    times = 11 + static_cast<int>(in_.Bits(7));
+                }
+                if (i + times > nlen + ndist) Corrupt("too many code lengths");
+                while (times--) lengths[i++] = repeat;
+            }
+            if (lengths[256] == 0) Corrupt("missing end-of-block code");
+
+            Build(lencode, std::span(lengths).first(nlen));
+            Build(distcode, std::span(lengths).subspan(nlen, ndist));
+            Codes(lencode, distcode);
+        }
+
+        void Codes(const Huffman &lencode, const Huffman &distcode) const {
+            for (;;) {
+                int symbol = Decode(lencode);
+                if (symbol < 256) {
+                    Grow(1);
+                    out_.push_back(static_cast<uint8_t>(symbol));
+                    continue;
+                }
+                if (symbol == 256) return;
+                symbol -= 257;
+                if (symbol >= 29) Corrupt("invalid length code");
+                const size_t len = kLengthBase[symbol] + in_.Bits(kLengthExtra[symbol]);
+                const int distSymbol = Decode(distcode);
+                if (distSymbol >= 30) Corrupt("invalid distance code");
+                const size_t dist = kDistBase[distSymbol] + in_.Bits(kDistExtra[distSymbol]);
+                if (dist > out_.size()) Corrupt("distance too far back");
+                Grow(len);
+                // Byte at a time: the copy may overlap what it produces
+                const size_t from = out_.size() - dist;
+                for (size_t i = 0; i < len; ++i) out_.push_back(out_[from + i]);
+            }
+        }
+
+        void Grow(const size_t count) const {
+            CheckSize(out_.size() - start_ + count);
+        }
+
+        InputStream &in_;
+        std::vector<uint8_t> &out_;
+        size_t start_;
+        size_t crcPos_;
+        uint32_t crc_{0};
+    };
+
+    void LoadRaw(InputStream &in, RomImage &image) {
+        for (auto chunk = in.Chunk(); !chunk.empty(); chunk = in.Chunk()) {
+            CheckSize(image.data.size() + chunk.size());
+            image.data.insert(image.data.end(), chunk.begin(), chunk.end());
+            image.crc32 = RomSource::Crc32(chunk, image.crc32);
+        }
+    }
+
+    // RFC 1952, single member
+    void LoadGzip(InputStream &in, RomImage &image) {
+        in.Skip(2);
+        if (in.Byte() != 8) Corrupt("gzip method is not deflate");
+        const uint8_t flags = in.Byte();
+        in.Skip(6); // mtime, xfl, os
+        if (flags & 0x04) in.Skip(in.U16()); // FEXTRA
+        if (flags & 0x08) while (in.Byte() != 0) {} // FNAME
+        if (flags & 0x10) while (in.Byte() != 0) {} // FCOMMENT
+        if (flags & 0x02) in.Skip(2); // FHCRC
+
+        image.crc32 = Inflater(in, image.data).Run();
+        const uint32_t crc = in.U32();
+        const uint32_t size = in.U32();
+        if (crc != image.crc32 || size != static_cast<uint32_t>(image.data.size())) Corrupt("gzip checksum mismatch");
+    }
+
+    // Walks local file headers rather than the central directory so the
+    // archive is read front to back in one go
+    void LoadZip(InputStream &in, RomImage &image) {
+        constexpr uint32_t kLocalHeader = 0x04034B50;
+        constexpr uint32_t kDescriptor = 0x08074B50;
+        std::vector<uint8_t> discard;
+        while (in.U32() == kLocalHeader) {
+            in.Skip(2); // version
+            const uint16_t flags = in.U16();
+            const uint16_t method = in.U16();
+            in.Skip(4); // time, date
+            uint32_t crc = in.U32();
+            const uint32_t compressedSize = in.U32();
+            const uint32_t size = in.U32();
+            const uint16_t nameLength = in.U16();
+            const uint16_t extraLength = in.U16();
+            std::string name(nameLength, '\0');
+            for (char &c: name) c = static_cast<char>(in.Byte());
+            in.Skip(extraLength);
+
+            if (flags & 0x01) Corrupt("encrypted entries are not supported");
+            const bool sizesFollow = flags & 0x08;
+            const bool wanted = IsRomName(name);
+            std::vector<uint8_t> &out = wanted ? image.data : discard;
+            discard.clear();
+
+            // Only entries that give no sizes up front have to be inflated to find their end
+            if (!wanted && !sizesFollow) {
+                in.Skip(compressedSize);
+                continue;
+            }
+            if (!sizesFollow) {
+                // Before reserving what the header claims
+                CheckSize(size);
+                if (method == 0) CheckSize(compressedSize);
+            }
+
+            uint32_t actualCrc = 0;
+            if (method == 0 && !sizesFollow) {
+                out.reserve(size);
+                in.Read(out, compressedSize);
+                actualCrc = RomSource::Crc32(out);
+            } else if (method == 8) {
+                if (!sizesFollow) out.reserve(size);
+                actualCrc = Inflater(in, out).Run();
+            } else if (method == 0) {
+                Corrupt("stored entry without sizes in its header");
+            } else {
+                Corrupt("unsupported zip compression method " + std::to_string(method));
+            }
+
+            if (sizesFollow) {
+                crc = in.U32();
+                if (crc == kDescriptor) crc = in.U32();
+                in.Skip(8);
+            }
+            if (!wanted) continue;
+            if (crc != actualCrc) Corrupt("zip checksum mismatch in " + name);
+            image.crc32 = actualCrc;
+            return;
+        }
+        throw std::runtime_error("No .gb/.gbc ROM found in archive");
+    }
+
+    void LoadZstd(InputStream &in, RomImage &image) {
+#ifdef STARGBC_WITH_ZSTD
+        const std::unique_ptr<ZSTD_DStream, decltype(&ZSTD_freeDStream)> stream(ZSTD_createDStream(), &ZSTD_freeDStream);
+        ZSTD_initDStream(stream.get());
+        const size_t step = ZSTD_DStreamOutSize();
+        size_t pending = 1;
+        for (auto chunk = in.Chunk(); !chunk.empty(); chunk = in.Chunk()) {
+            ZSTD_inBuffer input{chunk.data(), chunk.size(), 0};
+            while (input.pos < input.size) {
+                const size_t start = image.data.size();
+                image.data.resize(start + step);
+                ZSTD_outBuffer output{image.data.data() + start, step, 0};
+                pending = ZSTD_decompressStream(stream.get(), &output, &input);
+                if (ZSTD_isError(pending)) Corrupt(ZSTD_getErrorName(pending));
+                image.data.resize(start + output.pos);
+                CheckSize(image.data.size());
+                image.crc32 = RomSource::Crc32(std::span(image.data).subspan(start), image.crc32);
+            }
+        }
+        if (pending != 0) Corrupt("truncated zstd frame");
+#else
+        (void) in;
+        (void) image;
+        throw std::runtime_error("This build has no zstd support (configure with STARGBC_WITH_ZSTD=ON)");
+#endif
+    }
+}
+
+RomImage RomSource::Load(const std::string &path) {
+    std::ifstream ifs(path, std::ios::binary);
+    if (!ifs.is_open()) {
+        throw std::runtime_error("Could not open file " + path);
+    }
+
+    std::array<uint8_t, 4> magic{};
+    ifs.read(reinterpret_cast<char *>(magic.data()), magic.size());
+    ifs.clear();
+    ifs.seekg(0);
+
+    RomImage image;
+    if (magic[0] == 0x1F && magic[1] == 0x8B) {
+        image.container = RomContainer::Gzip;
+    } else if (magic == std::array<uint8_t, 4>{'P', 'K', 0x03, 0x04}) {
+        image.container = RomContainer::Zip;
+    } else if (magic == std::array<uint8_t, 4>{0x28, 0xB5, 0x2F, 0xFD}) {
+        image.container = RomContainer::Zstd;
+    }
+
+    InputStream in(ifs);
+    switch (image.container) {
+        case RomContainer::Raw: LoadRaw(in, image);
+            break;
+        case RomContainer::Gzip: LoadGzip(in, image);
+            break;
+        case RomContainer::Zip: LoadZip(in, image);
+            break;
+        case RomContainer::Zstd: LoadZstd(in, image);
+            break;
+    }
+    return image;
+}
+
+bool RomSource::IsSupportedPath(const std::string_view path) {
+    return IsRomName(path) || EndsWithNoCase(path, ".zip") || EndsWithNoCase(path, ".gz") ||
+           EndsWithNoCase(path, ".zst");
+}
+
+std::string RomSource::StripContainerExtension(const std::string &path) {
+    for (const std::string_view suffix: {".gz", ".zst"}) {
+        if (EndsWithNoCase(path, suffix)) return path.substr(0, path.size() - suffix.size());
+    }
+    return path;
+}
+
+uint32_t RomSource::Crc32(const std::span<const uint8_t> bytes, uint32_t crc) {
+    crc = ~crc;
+    for (const uint8_t b: bytes) crc = kCrcTable[(crc ^ b) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
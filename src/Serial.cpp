@@ -47,6 +47,15 @@ void Serial::Update() {
     }
 }
 
+uint32_t Serial::IdleTicks() const {
+    if (!active_) return IDLE_UNBOUNDED;
+    return ticksUntilShift_ > 0 ? ticksUntilShift_ - 1u : 0u;
+}
+
+void Serial::SkipIdleTicks(const uint32_t ticks) {
+    if (active_) ticksUntilShift_ = static_cast<uint16_t>(ticksUntilShift_ - ticks);
+}
+
 bool Serial::SaveState(std::ofstream &stateFile) const {
     try {
         if (!stateFile.is_open()) return false;
@@ -0,0 +1,74 @@
+#include "StateHash.h"
+
+#include <bit>
+#include <cstring>
+
+namespace {
+    constexpr uint64_t PRIME1 = 0x9E3779B185EBCA87ULL;
+    constexpr uint64_t PRIME2 = 0xC2B2AE3D27D4EB4FULL;
+    constexpr uint64_t PRIME3 = 0x165667B19E3779F9ULL;
+    constexpr uint64_t PRIME4 = 0x85EBCA77C2B2AE63ULL;
+    constexpr uint64_t PRIME5 = 0x27D4EB2F165667C5ULL;
+
+    // Little-endian loads, as the reference defines them
+    template<typename T>
+    T Load(const uint8_t *p) {
+        T value;
+        if constexpr (std::endian::native == std::endian::little) {
+            std::memcpy(&value, p, sizeof(T));
+        } else {
+            value = 0;
+            for (size_t i = sizeof(T); i-- > 0;) value = static_cast<T>(value << 8 | p[i]);
+        }
+        return value;
+    }
+
+    uint64_t Round(const uint64_t acc, const uint64_t input) {
+        return std::rotl(acc + input * PRIME2, 31) * PRIME1;
+    }
+
+    uint64_t Merge(const uint64_t acc, const uint64_t lane) {
+        return (acc ^ Round(0, lane)) * PRIME1 + PRIME4;
+    }
+}
+
+uint64_t XXHash64(const void *data, const size_t size, const uint64_t seed) {
+    const auto *p = static_cast<const uint8_t *>(data);
+    const uint8_t *const end = p + size;
+    uint64_t hash;
+
+    if (size >= 32) {
+        uint64_t v1 = seed + PRIME1 + PRIME2;
+        uint64_t v2 = seed + PRIME2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - PRIME1;
+        for (const uint8_t *const limit = end - 32; p <= limit; p += 32) {
+            v1 = Round(v1, Load<uint64_t>(p));
+            v2 = Round(v2, Load<uint64_t>(p + 8));
+            v3 = Round(v3, Load<uint64_t>(p + 16));
+            v4 = Round(v4, Load<uint64_t>(p + 24));
+        }
+        hash = std::rotl(v1, 1) + std::rotl(v2, 7) + std::rotl(v3, 12) + std::rotl(v4, 18);
+        hash = Merge(hash, v1);
+        hash = Merge(hash, v2);
+        hash = Merge(hash, v3);
+        hash = Merge(hash, v4);
+    } else {
+        hash = seed + PRIME5;
+    }
+    hash += size;
+
+    for (; p + 8 <= end; p += 8) hash = std::rotl(hash ^ Round(0, Load<uint64_t>(p)), 27) * PRIME1 + PRIME4;
+    if (p + 4 <= end) {
+        hash = std::rotl(hash ^ Load<uint32_t>(p) * PRIME1, 23) * PRIME2 + PRIME3;
+        p += 4;
+    }
+    for (; p < end; ++p) hash = std::rotl(hash ^ *p * PRIME5, 11) * PRIME1;
+
+    hash ^= hash >> 33;
+    hash *= PRIME2;
+    hash ^= hash >> 29;
+    hash *= PRIME3;
+    hash ^= hash >> 32;
+    return hash;
+}
@@ -1,5 +1,7 @@
 #include "Timer.h"
 
+#include <algorithm>
+
 #include "Common.h"
 
 void Timer::Tick(const Speed speed) {
@@ -32,6 +34,31 @@ void Timer::Tick(const Speed speed) {
     }
 }
 
+uint32_t Timer::IdleTicks(const Speed speed) const {
+    if (overflowPending || reloadActive) return 0;
+    // Tick n (from 1) clears `bit` once divCounter + n reaches the next multiple of 2^(bit+1)
+    const auto untilFall = [this](const int bit) {
+        const uint32_t period = 1u << (bit + 1);
+        return period - (divCounter & (period - 1));
+    };
+    uint32_t ticks = untilFall(audio_.IsDMG() || speed == Speed::Regular ? 12 : 13);
+    if (tac & 0x04) {
+        // Increments short of the one that overflows TIMA are skipped over
+        const int bit = TimerBit(tac);
+        ticks = std::min(ticks, untilFall(bit) + (0xFFu - tima) * (1u << (bit + 1)));
+    }
+    return ticks - 1;
+}
+
+void Timer::SkipIdleTicks(const uint32_t ticks) {
+    if (tac & 0x04) {
+        const int shift = TimerBit(tac) + 1;
+        const uint32_t from = divCounter;
+        tima = static_cast<uint8_t>(tima + (((from + ticks) >> shift) - (from >> shift)));
+    }
+    divCounter = static_cast<uint16_t>(divCounter + ticks);
+}
+
 void Timer::WriteByte(const uint16_t address, const uint8_t value, const Speed speed) {
     if (address == 0xFF04) WriteDIV(speed == Speed::Double);
     else if (address == 0xFF05) WriteTIMA(value);
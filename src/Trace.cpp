@@ -0,0 +1,132 @@
+#include "Trace.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace trace {
+    namespace {
+        struct Slot {
+            std::atomic<const char *> name{nullptr};
+            std::atomic<uint64_t> begin{0};
+            std::atomic<uint64_t> end{0};
+        };
+
+        // Written by its thread only. `claimed` moves before a slot is
+        // overwritten and `head` after, so a reader can tell which of the
+        // slots it copied were changed underneath it.
+        struct Ring {
+            explicit Ring(const uint32_t threadId) : threadId(threadId),
+                                                     slots(std::make_unique<Slot[]>(RING_CAPACITY)) {
+            }
+
+            uint32_t threadId;
+            std::unique_ptr<Slot[]> slots;
+            std::atomic<uint64_t> claimed{0};
+            std::atomic<uint64_t> head{0};
+        };
+
+        struct Event {
+            const char *name;
+            uint64_t begin;
+            uint64_t end;
+            uint32_t threadId;
+        };
+
+        // Rings outlive their threads so a dump still sees what they recorded
+        struct Registry {
+            std::mutex mutex;
+            std::vector<std::shared_ptr<Ring> > rings;
+        };
+
+        Registry &GetRegistry() {
+            static Registry registry;
+            return registry;
+        }
+
+        Ring &ThisThreadRing() {
+            thread_local const std::shared_ptr<Ring> ring = [] {
+                Registry &registry = GetRegistry();
+                const std::lock_guard lock(registry.mutex);
+                auto created = std::make_shared<Ring>(static_cast<uint32_t>(registry.rings.size() + 1));
+                registry.rings.push_back(created);
+                return created;
+            }();
+            return *ring;
+        }
+
+        void Collect(const Ring &ring, std::vector<Event> &events) {
+            const uint64_t end = ring.head.load(std::memory_order_acquire);
+            const uint64_t begin = end > RING_CAPACITY ? end - RING_CAPACITY : 0;
+            const size_t first = events.size();
+            for (uint64_t i = begin; i < end; ++i) {
+                const Slot &slot = ring.slots[i & (RING_CAPACITY - 1)];
+                events.push_back({
+                    slot.name.load(std::memory_order_relaxed), slot.begin.load(std::memory_order_relaxed),
+                    slot.end.load(std::memory_order_relaxed), ring.threadId
+                });
+            }
+            // Slots claimed since are the oldest ones copied, and may be torn
+            std::atomic_thread_fence(std::memory_order_acquire);
+            const uint64_t claimed = ring.claimed.load(std::memory_order_relaxed);
+            if (const uint64_t valid = claimed > RING_CAPACITY ? claimed - RING_CAPACITY : 0; valid > begin) {
+                const auto torn = static_cast<std::ptrdiff_t>(std::min(valid, end) - begin);
+                events.erase(events.begin() + static_cast<std::ptrdiff_t>(first),
+                             events.begin() + static_cast<std::ptrdiff_t>(first) + torn);
+            }
+        }
+
+        void WriteEscaped(std::ofstream &file, const char *text) {
+            for (; *text; ++text) {
+                if (*text == '"' || *text == '\\') file.put('\\');
+                file.put(*text);
+            }
+        }
+    }
+
+    void Record(const char *name, const uint64_t beginNs, const uint64_t endNs) {
+        Ring &ring = ThisThreadRing();
+        const uint64_t index = ring.head.load(std::memory_order_relaxed);
+        ring.claimed.store(index + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        Slot &slot = ring.slots[index & (RING_CAPACITY - 1)];
+        slot.name.store(name, std::memory_order_relaxed);
+        slot.begin.store(beginNs, std::memory_order_relaxed);
+        slot.end.store(endNs, std::memory_order_relaxed);
+        ring.head.store(index + 1, std::memory_order_release);
+    }
+
+    void WriteChromeTrace(const std::string &path) {
+        std::vector<Event> events;
+        {
+            Registry &registry = GetRegistry();
+            const std::lock_guard lock(registry.mutex);
+            for (const auto &ring: registry.rings) Collect(*ring, events);
+        }
+
+        std::ofstream file(path, std::ios::trunc);
+        if (!file.is_open()) throw std::runtime_error("Could not open " + path);
+        uint64_t origin = UINT64_MAX;
+        for (const Event &event: events) origin = std::min(origin, event.begin);
+
+        // Complete ("X") events, timestamps in microseconds from the first
+        file << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+        char numbers[96];
+        for (size_t i = 0; i < events.size(); ++i) {
+            const Event &event = events[i];
+            file << (i == 0 ? "\n" : ",\n") << "{\"name\":\"";
+            WriteEscaped(file, event.name);
+            std::snprintf(numbers, sizeof(numbers), "\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                          event.threadId, static_cast<double>(event.begin - origin) / 1000.0,
+                          static_cast<double>(event.end - event.begin) / 1000.0);
+            file << numbers;
+        }
+        file << "\n]}\n";
+        if (!file) throw std::runtime_error("Could not write " + path);
+    }
+}
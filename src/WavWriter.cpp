@@ -0,0 +1,161 @@
+#include "WavWriter.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+
+namespace {
+    constexpr uint16_t FORMAT_PCM = 1;
+    constexpr uint16_t FORMAT_FLOAT = 3;
+    constexpr uint16_t CHANNELS = 2;
+    constexpr size_t HEADER_SIZE = 44;
+
+    void PutLittleEndian(std::vector<uint8_t> &out, const uint32_t value, const int bytes) {
+        for (int i = 0; i < bytes; i++) out.push_back(static_cast<uint8_t>(value >> i * 8));
+    }
+
+    uint32_t GetLittleEndian(const uint8_t *at, const int bytes) {
+        uint32_t value = 0;
+        for (int i = 0; i < bytes; i++) value |= uint32_t{at[i]} << i * 8;
+        return value;
+    }
+
+    // RIFF header with a fmt chunk and the start of the data chunk
+    std::vector<uint8_t> Header(const uint32_t sampleRate, const uint64_t dataBytes) {
+        std::vector<uint8_t> header;
+        header.insert(header.end(), {'R', 'I', 'F', 'F'});
+        PutLittleEndian(header, static_cast<uint32_t>(HEADER_SIZE - 8 + dataBytes), 4);
+        header.insert(header.end(), {'W', 'A', 'V', 'E', 'f', 'm', 't', ' '});
+        PutLittleEndian(header, 16, 4);
+        PutLittleEndian(header, FORMAT_FLOAT, 2);
+        PutLittleEndian(header, CHANNELS, 2);
+        PutLittleEndian(header, sampleRate, 4);
+        PutLittleEndian(header, sampleRate * CHANNELS * sizeof(float), 4);
+        PutLittleEndian(header, CHANNELS * sizeof(float), 2);
+        PutLittleEndian(header, 32, 2);
+        header.insert(header.end(), {'d', 'a', 't', 'a'});
+        PutLittleEndian(header, static_cast<uint32_t>(dataBytes), 4);
+        return header;
+    }
+}
+
+WavWriter::WavWriter(const std::string &path, const uint32_t sampleRate, const size_t queueBlocks)
+    : path_(path), sampleRate_(sampleRate), queueBlocks_(std::max<size_t>(queueBlocks, 1)) {
+    file_.open(path, std::ios::binary | std::ios::trunc);
+    if (!file_.is_open()) throw std::runtime_error("Could not open " + path);
+    // Sizes are filled in by Finish()
+    const std::vector<uint8_t> header = Header(sampleRate, 0);
+    file_.write(reinterpret_cast<const char *>(header.data()), static_cast<std::streamsize>(header.size()));
+    block_.reserve(BLOCK_FRAMES * CHANNELS);
+    for (size_t i = 0; i < queueBlocks_; i++) spare_.emplace_back().reserve(BLOCK_FRAMES * CHANNELS);
+    worker_ = std::thread([this] { Run(); });
+}
+
+WavWriter::~WavWriter() {
+    try {
+        Finish();
+    } catch (const std::exception &) {
+    }
+}
+
+void WavWriter::Write(const float *samples, size_t frames) {
+    frames_ += frames;
+    while (frames > 0) {
+        const size_t take = std::min(frames, BLOCK_FRAMES - block_.size() / CHANNELS);
+        block_.insert(block_.end(), samples, samples + take * CHANNELS);
+        samples += take * CHANNELS;
+        frames -= take;
+        if (block_.size() == BLOCK_FRAMES * CHANNELS) Submit();
+    }
+}
+
+void WavWriter::Submit() {
+    std::unique_lock lock(mutex_);
+    written_.wait(lock, [this] { return !spare_.empty(); });
+    std::vector<float> next = std::move(spare_.back());
+    spare_.pop_back();
+    queue_.push_back(std::move(block_));
+    block_ = std::move(next);
+    block_.clear();
+    lock.unlock();
+    ready_.notify_one();
+}
+
+void WavWriter::Run() {
+    std::unique_lock lock(mutex_);
+    while (true) {
+        ready_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+        if (queue_.empty()) return;
+        std::vector<float> block = std::move(queue_.front());
+        queue_.pop_front();
+        lock.unlock();
+        file_.write(reinterpret_cast<const char *>(block.data()),
+                    static_cast<std::streamsize>(block.size() * sizeof(float)));
+        lock.lock();
+        if (!file_ && error_.empty()) error_ = "Could not write " + path_;
+        spare_.push_back(std::move(block));
+        written_.notify_one();
+    }
+}
+
+void WavWriter::Finish() {
+    if (finished_) return;
+    finished_ = true;
+    if (!block_.empty()) Submit();
+    {
+        std::lock_guard lock(mutex_);
+        stopping_ = true;
+    }
+    ready_.notify_one();
+    worker_.join();
+
+    const uint64_t dataBytes = frames_ * CHANNELS * sizeof(float);
+    if (dataBytes > UINT32_MAX - HEADER_SIZE) throw std::runtime_error(path_ + " is over 4 GB, too long for WAV");
+    const std::vector<uint8_t> header = Header(sampleRate_, dataBytes);
+    file_.seekp(0);
+    file_.write(reinterpret_cast<const char *>(header.data()), static_cast<std::streamsize>(header.size()));
+    file_.close();
+    if (!file_ || !error_.empty()) throw std::runtime_error(error_.empty() ? "Could not write " + path_ : error_);
+}
+
+WavAudio WavAudio::Read(const std::string &path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) throw std::runtime_error("Could not open " + path);
+    const std::vector<uint8_t> bytes(std::istreambuf_iterator<char>(file), {});
+    if (bytes.size() < 12 || std::memcmp(bytes.data(), "RIFF", 4) != 0 || std::memcmp(&bytes[8], "WAVE", 4) != 0) {
+        throw std::runtime_error(path + " is not a WAV file");
+    }
+
+    WavAudio audio;
+    uint16_t format = 0;
+    uint16_t bits = 0;
+    for (size_t at = 12; at + 8 <= bytes.size();) {
+        const uint32_t size = GetLittleEndian(&bytes[at + 4], 4);
+        const uint8_t *body = &bytes[at + 8];
+        if (size > bytes.size() - at - 8) throw std::runtime_error(path + " is damaged");
+        if (std::memcmp(&bytes[at], "fmt ", 4) == 0 && size >= 16) {
+            format = static_cast<uint16_t>(GetLittleEndian(body, 2));
+            audio.channels = static_cast<uint16_t>(GetLittleEndian(body + 2, 2));
+            audio.sampleRate = GetLittleEndian(body + 4, 4);
+            bits = static_cast<uint16_t>(GetLittleEndian(body + 14, 2));
+        } else if (std::memcmp(&bytes[at], "data", 4) == 0) {
+            if (format == FORMAT_FLOAT && bits == 32) {
+                audio.samples.resize(size / sizeof(float));
+                // Little-endian like every host this builds for
+                std::memcpy(audio.samples.data(), body, audio.samples.size() * sizeof(float));
+            } else if (format == FORMAT_PCM && bits == 16) {
+                audio.samples.resize(size / 2);
+                for (size_t i = 0; i < audio.samples.size(); i++) {
+                    const auto sample = static_cast<int16_t>(GetLittleEndian(body + i * 2, 2));
+                    audio.samples[i] = static_cast<float>(sample) / 32768.0f;
+                }
+            } else {
+                throw std::runtime_error(path + " is neither 32-bit float nor 16-bit PCM");
+            }
+            return audio;
+        }
+        at += 8 + size + (size & 1);
+    }
+    throw std::runtime_error(path + " has no data");
+}
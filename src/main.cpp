@@ -9,6 +9,9 @@
 #include <memory>
 #include <Gameboy.h>
 #include <Audio.h>
+#include <FrameCapture.h>
+#include <RomSource.h>
+#include <Trace.h>
 
 constexpr int GB_SCREEN_W = 160;
 constexpr int GB_SCREEN_H = 144;
@@ -26,6 +29,41 @@ static std::unique_ptr<Gameboy> gameboy = nullptr;
 static bool useNearest = true;
 static bool audioEnabled = true;
 static std::vector<float> audioBuffer(AUDIO_BUFFER_FRAMES * 2);
+static std::string tracePath;
+static bool showStats = false;
+static bool profile = false;
+static std::string recordPath;
+static std::string frameHashPath;
+static std::unique_ptr<FrameCapture> videoCapture = nullptr;
+static std::unique_ptr<FrameCapture> screenshots = nullptr;
+
+// Last frame's counters over the picture, at window resolution since the
+// 8px debug font does not fit the 160x144 logical screen
+static void DrawStatsOverlay(const FrameStats &stats) {
+    using ull = unsigned long long;
+    SDL_SetRenderLogicalPresentation(renderer, 0, 0, SDL_LOGICAL_PRESENTATION_DISABLED);
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 160);
+    const SDL_FRect background{0, 0, 8 * 50 + 8, 10 * 6 + 6};
+    SDL_RenderFillRect(renderer, &background);
+    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+    SDL_RenderDebugTextFormat(renderer, 4, 4, "host %.2f ms  instructions %llu", stats.hostSeconds * 1000.0,
+                              static_cast<ull>(stats.instructions));
+    SDL_RenderDebugTextFormat(renderer, 4, 14, "M-cycles halt %llu hdma %llu oam dma %llu",
+                              static_cast<ull>(stats.haltedMCycles), static_cast<ull>(stats.hdmaStallMCycles),
+                              static_cast<ull>(stats.oamDmaMCycles));
+    SDL_RenderDebugTextFormat(renderer, 4, 24, "dots hbl %llu vbl %llu oam %llu draw %llu",
+                              static_cast<ull>(stats.ppuModeDots[0]), static_cast<ull>(stats.ppuModeDots[1]),
+                              static_cast<ull>(stats.ppuModeDots[2]), static_cast<ull>(stats.ppuModeDots[3]));
+    SDL_RenderDebugTextFormat(renderer, 4, 34, "irq vbl %llu stat %llu tim %llu ser %llu joy %llu",
+                              static_cast<ull>(stats.interrupts[0]), static_cast<ull>(stats.interrupts[1]),
+                              static_cast<ull>(stats.interrupts[2]), static_cast<ull>(stats.interrupts[3]),
+                              static_cast<ull>(stats.interrupts[4]));
+    SDL_RenderDebugTextFormat(renderer, 4, 44, "bank switches %llu", static_cast<ull>(stats.bankSwitches));
+    SDL_RenderDebugTextFormat(renderer, 4, 54, "samples %llu dropped %llu", static_cast<ull>(stats.samplesProduced),
+                              static_cast<ull>(stats.samplesDropped));
+    SDL_SetRenderLogicalPresentation(renderer, GB_SCREEN_W, GB_SCREEN_H, SDL_LOGICAL_PRESENTATION_INTEGER_SCALE);
+}
 
 SDL_AppResult SDL_AppInit(void ** /*appstate*/, int argc, char *argv[]) {
     SDL_SetAppMetadata("StarGBC", "0.0.1", "com.srikur.stargbc");
@@ -37,6 +75,8 @@ SDL_AppResult SDL_AppInit(void ** /*appstate*/, int argc, char *argv[]) {
 
     const std::vector<std::string_view> args(argv + 1, argv + argc);
     GameboySettings settings{};
+    std::string playPath;
+    std::string capturePath;
     for (std::size_t i = 0; i < args.size(); ++i) {
         if (args[i] == "--anti-aliasing") {
             useNearest = false;
@@ -50,6 +90,19 @@ SDL_AppResult SDL_AppInit(void ** /*appstate*/, int argc, char *argv[]) {
             settings.unthrottled = true;
         } else if (args[i] == "--realRTC") {
             settings.realRTC = true;
+        } else if (args[i] == "--coroutine-core") {
+            settings.cpuCore = CpuCore::Coroutine;
+        } else if (args[i] == "--fast-core") {
+            settings.fastCore = true;
+        } else if (args[i] == "--block-cache") {
+            settings.fastCore = true;
+            settings.blockCache = true;
+        } else if (args[i] == "--jit") {
+            settings.fastCore = true;
+            settings.blockCache = true;
+            settings.jit = true;
+        } else if (args[i] == "--idle-loops") {
+            settings.idleLoops = true;
         } else if (args[i] == "--bios") {
             if (i + 1 < args.size()) {
                 settings.biosPath = args[++i];
@@ -57,20 +110,76 @@ SDL_AppResult SDL_AppInit(void ** /*appstate*/, int argc, char *argv[]) {
                 std::fprintf(stderr, "Error: --bios requires a path argument\n");
                 return SDL_APP_FAILURE;
             }
-        } else if (i == args.size() - 1 ||
-                   args[i].ends_with(".gb") || args[i].ends_with(".gbc")) {
+        } else if (args[i] == "--boot-cache") {
+            if (i + 1 < args.size()) {
+                settings.bootStateCache = args[++i];
+            } else {
+                std::fprintf(stderr, "Error: --boot-cache requires a directory argument\n");
+                return SDL_APP_FAILURE;
+            }
+        } else if (args[i] == "--trace") {
+            if (i + 1 < args.size()) {
+                tracePath = args[++i];
+                if (!trace::ENABLED) std::fprintf(stderr, "Warning: built without STARGBC_TRACE, the trace will be empty\n");
+            } else {
+                std::fprintf(stderr, "Error: --trace requires a path argument\n");
+                return SDL_APP_FAILURE;
+            }
+        } else if (args[i] == "--profile") {
+            profile = true;
+        } else if (args[i] == "--record") {
+            if (i + 1 < args.size()) {
+                recordPath = args[++i];
+            } else {
+                std::fprintf(stderr, "Error: --record requires a path argument\n");
+                return SDL_APP_FAILURE;
+            }
+        } else if (args[i] == "--frame-hashes") {
+            if (i + 1 < args.size()) {
+                frameHashPath = args[++i];
+            } else {
+                std::fprintf(stderr, "Error: --frame-hashes requires a path argument\n");
+                return SDL_APP_FAILURE;
+            }
+        } else if (args[i] == "--capture") {
+            if (i + 1 < args.size()) {
+                capturePath = args[++i];
+            } else {
+                std::fprintf(stderr, "Error: --capture requires a path argument\n");
+                return SDL_APP_FAILURE;
+            }
+        } else if (args[i] == "--play") {
+            if (i + 1 < args.size()) {
+                playPath = args[++i];
+            } else {
+                std::fprintf(stderr, "Error: --play requires a path argument\n");
+                return SDL_APP_FAILURE;
+            }
+        } else if (i == args.size() - 1 || RomSource::IsSupportedPath(args[i])) {
             settings.romName = args[i];
         } else {
             std::fprintf(stderr, "USAGE: StarGBC [options] romFile\n"
                          "Options:\n"
                          "  --gbc | --gb        force gbc/dmg mode\n"
                          "  --bios <path>       external BIOS ROM\n"
+                         "  --boot-cache <dir>  restore the post-BIOS state from <dir>, caching it there\n"
+                         "  --coroutine-core    run the CPU as one coroutine per instruction\n"
+                         "  --fast-core         whole instructions at a time, not cycle-accurate\n"
+                         "  --block-cache       fast core running cached blocks of decoded code\n"
+                         "  --jit               block cache with hot blocks compiled to x86-64\n"
+                         "  --idle-loops        skip busy-wait loops, reporting cycles saved on exit\n"
+                         "  --trace <file>      write Chrome trace JSON on exit (STARGBC_TRACE builds)\n"
+                         "  --profile           print the costliest instructions on exit\n"
+                         "  --record <file>     record a movie of the keys pressed from power-on\n"
+                         "  --play <file>       play a recorded movie back\n"
+                         "  --frame-hashes <file> log a hash of every frame, written on exit\n"
+                         "  --capture <path>    record video: a .y4m or .rgba file, - for y4m on stdout,\n"
+                         "                      or else a directory of PNGs\n"
                          "  --no-aliasing       nearest-neighbour pixels");
             return SDL_APP_FAILURE;
         }
     }
-    if (settings.romName.empty() || (!settings.romName.ends_with(".gb") &&
-                                     !settings.romName.ends_with(".gbc"))) {
+    if (settings.romName.empty() || !RomSource::IsSupportedPath(settings.romName)) {
         std::fprintf(stderr, "Error: no ROM specified");
         return SDL_APP_FAILURE;
     }
@@ -100,6 +209,18 @@ SDL_AppResult SDL_AppInit(void ** /*appstate*/, int argc, char *argv[]) {
     SDL_SetTextureScaleMode(texture,
                             useNearest ? SDL_SCALEMODE_NEAREST : SDL_SCALEMODE_LINEAR);
     gameboy = Gameboy::init(settings);
+    if (profile) gameboy->SetProfiling(true);
+    try {
+        if (!playPath.empty()) gameboy->PlayMovie(InputMovie::Read(playPath));
+        if (!capturePath.empty()) {
+            videoCapture = std::make_unique<FrameCapture>(capturePath, FrameCapture::FormatOf(capturePath));
+        }
+    } catch (const std::exception &e) {
+        std::fprintf(stderr, "Error: %s\n", e.what());
+        return SDL_APP_FAILURE;
+    }
+    if (!recordPath.empty()) gameboy->StartRecording(true);
+    if (!frameHashPath.empty()) gameboy->SetFrameHashing(1);
 
     SDL_AudioSpec audioSpec{};
     audioSpec.freq = AUDIO_SAMPLE_RATE;
@@ -150,7 +271,34 @@ SDL_AppResult SDL_AppEvent(void *, SDL_Event *event) {
                 case SDLK_R: gameboy->SetPaused(false);
                     break;
                 case SDLK_F2:
-                    gameboy->SaveScreen();
+                    // Shift+F2 keeps the raw .screen dump the test suite compares against
+                    if (event->key.mod & SDL_KMOD_SHIFT) {
+                        gameboy->SaveScreen();
+                        break;
+                    }
+                    try {
+                        if (!screenshots) {
+                            screenshots = std::make_unique<FrameCapture>("screenshots", FrameCapture::Format::Png, 4);
+                        }
+                        if (screenshots->Submit(gameboy->GetScreenData())) {
+                            std::fprintf(stderr, "Saving screenshots/frame-%08llu.png\n",
+                                         static_cast<unsigned long long>(screenshots->GetStats().submitted - 1));
+                        }
+                    } catch (const std::exception &e) {
+                        std::fprintf(stderr, "Failed to save screenshot: %s\n", e.what());
+                    }
+                    break;
+                case SDLK_F3:
+                    showStats = !showStats;
+                    break;
+                case SDLK_F5:
+                    // A reset ends the recording, and a movie cannot replay one
+                    if (gameboy->IsRecording()) {
+                        std::fprintf(stderr, "Not resetting while recording %s; quit to finish the movie\n",
+                                     recordPath.c_str());
+                        break;
+                    }
+                    gameboy->Reset(event->key.mod & SDL_KMOD_SHIFT ? ResetKind::Hard : ResetKind::Soft);
                     break;
                 case SDLK_N:
                     audioEnabled = !audioEnabled;
@@ -227,7 +375,14 @@ SDL_AppResult SDL_AppEvent(void *, SDL_Event *event) {
 }
 
 SDL_AppResult SDL_AppIterate(void *) {
+    // Nothing to emulate until a key is pressed; sleep until SDL has an event
+    if (gameboy->IsIdle() && !gameboy->IsPlayingMovie()) {
+        SDL_WaitEventTimeout(nullptr, 100);
+        return SDL_APP_CONTINUE;
+    }
+
     gameboy->UpdateEmulator();
+    if (videoCapture && !gameboy->IsPaused()) videoCapture->Submit(gameboy->GetScreenData());
 
     if (gameboy->ShouldRender()) {
         SDL_UpdateTexture(texture,
@@ -236,6 +391,7 @@ SDL_AppResult SDL_AppIterate(void *) {
                           GB_SCREEN_W * sizeof(uint32_t));
 
         SDL_RenderTexture(renderer, texture, nullptr, nullptr);
+        if (showStats) DrawStatsOverlay(gameboy->GetFrameStats());
         SDL_RenderPresent(renderer);
     }
 
@@ -262,6 +418,43 @@ SDL_AppResult SDL_AppIterate(void *) {
 }
 
 void SDL_AppQuit(void *, SDL_AppResult) {
+    screenshots.reset();
+    if (videoCapture) {
+        const auto [submitted, written, dropped] = videoCapture->GetStats();
+        const std::string error = videoCapture->Error();
+        videoCapture.reset(); // finishes writing what is queued
+        std::fprintf(stderr, "Captured %llu frames, dropped %llu\n",
+                     static_cast<unsigned long long>(submitted - dropped), static_cast<unsigned long long>(dropped));
+        if (!error.empty()) std::fprintf(stderr, "Capture stopped: %s\n", error.c_str());
+    }
+    if (gameboy) {
+        if (const auto [skips, cycles] = gameboy->GetIdleLoopStats(); skips > 0) {
+            std::fprintf(stderr, "Idle loops: skipped %llu master cycles in %llu runs\n",
+                         static_cast<unsigned long long>(cycles), static_cast<unsigned long long>(skips));
+        }
+        gameboy->WriteProfileReport(stderr, 30);
+        if (gameboy->IsRecording()) {
+            try {
+                gameboy->StopRecording().Write(recordPath);
+            } catch (const std::exception &e) {
+                std::fprintf(stderr, "Failed to write movie: %s\n", e.what());
+            }
+        }
+        if (const FrameHashLog *log = gameboy->GetFrameHashLog()) {
+            try {
+                log->Write(frameHashPath);
+            } catch (const std::exception &e) {
+                std::fprintf(stderr, "Failed to write frame hashes: %s\n", e.what());
+            }
+        }
+    }
+    if (!tracePath.empty()) {
+        try {
+            trace::WriteChromeTrace(tracePath);
+        } catch (const std::exception &e) {
+            std::fprintf(stderr, "Failed to write trace: %s\n", e.what());
+        }
+    }
     if (audioStream) {
         SDL_DestroyAudioStream(audioStream);
         audioStream = nullptr;
@@ -0,0 +1,150 @@
+#ifndef STARGBC_AUDIORENDER_H
+#define STARGBC_AUDIORENDER_H
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <Gameboy.h>
+#include <InputMovie.h>
+#include <WavWriter.h>
+
+// Usage: --render-wav <rom> <wav> [--movie <file>] [--seconds <n>]
+//        [--rate <hz>] [--gbc | --gb] [--bios <path>]
+// Runs unthrottled on the cycle-accurate core and writes everything the
+// APU produced, for audio fixtures that --compare-wav checks later.
+inline int ExecuteRenderWav(const int argc, char **argv) {
+    GameboySettings settings;
+    settings.unthrottled = true;
+    settings.readOnlySave = true;
+    std::string wavPath;
+    std::string moviePath;
+    double seconds = 0.0;
+    for (int i = 2; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--movie" && hasValue) {
+            moviePath = argv[++i];
+        } else if (arg == "--seconds" && hasValue) {
+            seconds = std::stod(argv[++i]);
+        } else if (arg == "--rate" && hasValue) {
+            settings.audioSampleRate = static_cast<uint32_t>(std::stoul(argv[++i]));
+        } else if (arg == "--bios" && hasValue) {
+            settings.biosPath = argv[++i];
+        } else if (arg == "--gbc") {
+            settings.mode = Mode::CGB_GBC;
+        } else if (arg == "--gb") {
+            settings.mode = Mode::DMG;
+        } else if (settings.romName.empty()) {
+            settings.romName = arg;
+        } else {
+            wavPath = arg;
+        }
+    }
+    if (wavPath.empty() || (seconds <= 0.0 && moviePath.empty())) {
+        std::fprintf(stderr, "USAGE: StarGBC_Tests --render-wav <rom> <wav> [options]\n"
+                     "Options:\n"
+                     "  --movie <file>      play a recorded movie; without --seconds, for as long as it lasts\n"
+                     "  --seconds <n>       emulated seconds to render\n"
+                     "  --rate <hz>         sample rate, %d to %d (default %d)\n"
+                     "  --bios <path>       boot through a BIOS first\n"
+                     "  --gbc | --gb        force gbc/dmg mode\n",
+                     MIN_AUDIO_SAMPLE_RATE, MAX_AUDIO_SAMPLE_RATE, AUDIO_SAMPLE_RATE);
+        return EXIT_FAILURE;
+    }
+
+    try {
+        Gameboy gameboy(settings);
+        if (!moviePath.empty()) gameboy.PlayMovie(InputMovie::Read(moviePath));
+        WavWriter wav(wavPath, gameboy.GetAudioSampleRate());
+        // CycleCount() is in master cycles, twice the APU clock
+        const auto endCycle = static_cast<uint64_t>(seconds * APU_CLOCK_RATE * 2);
+        std::vector<float> samples(AUDIO_BUFFER_SIZE * 2);
+        // A movie's snapshot can hold samples from before it started
+        while (gameboy.ReadAudioSamples(samples.data(), AUDIO_BUFFER_SIZE)) {
+        }
+        uint64_t dropped = 0;
+        const auto start = std::chrono::steady_clock::now();
+        while (seconds > 0.0 ? gameboy.CycleCount() < endCycle : gameboy.IsPlayingMovie()) {
+            gameboy.RunFrame();
+            dropped += gameboy.GetFrameStats().samplesDropped;
+            while (const size_t frames = gameboy.ReadAudioSamples(samples.data(), AUDIO_BUFFER_SIZE)) {
+                wav.Write(samples.data(), frames);
+            }
+        }
+        wav.Finish();
+
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        const double rendered = static_cast<double>(wav.FramesWritten()) / gameboy.GetAudioSampleRate();
+        std::printf("Rendered %.2fs of audio at %u Hz to %s in %.2fs (%.0fx real time)\n", rendered,
+                    gameboy.GetAudioSampleRate(), wavPath.c_str(), elapsed.count(), rendered / elapsed.count());
+        if (dropped > 0) {
+            std::fprintf(stderr, "%llu samples were dropped; the render has gaps\n",
+                         static_cast<unsigned long long>(dropped));
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    } catch (const std::exception &e) {
+        std::fprintf(stderr, "Error: %s\n", e.what());
+        return EXIT_FAILURE;
+    }
+}
+
+// Usage: --compare-wav <a> <b> [--tolerance <x>]. Passes if both have the
+// same format and length and no sample differs by more than the tolerance
+// (default 1e-4, to allow for floating-point differences between builds).
+inline int ExecuteCompareWav(const int argc, char **argv) {
+    std::vector<std::string> paths;
+    double tolerance = 1e-4;
+    for (int i = 2; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg == "--tolerance" && i + 1 < argc) {
+            tolerance = std::stod(argv[++i]);
+        } else {
+            paths.emplace_back(arg);
+        }
+    }
+    if (paths.size() != 2) {
+        std::fprintf(stderr, "USAGE: StarGBC_Tests --compare-wav <wav> <wav> [--tolerance <x>]\n");
+        return EXIT_FAILURE;
+    }
+
+    try {
+        const WavAudio a = WavAudio::Read(paths[0]);
+        const WavAudio b = WavAudio::Read(paths[1]);
+        if (a.sampleRate != b.sampleRate || a.channels != b.channels) {
+            std::fprintf(stderr, "The files are %u Hz x%u and %u Hz x%u\n", a.sampleRate, a.channels, b.sampleRate,
+                         b.channels);
+            return EXIT_FAILURE;
+        }
+        const size_t common = std::min(a.samples.size(), b.samples.size());
+        double worst = 0.0;
+        double squares = 0.0;
+        size_t worstAt = 0;
+        size_t over = 0;
+        for (size_t i = 0; i < common; i++) {
+            const double difference = std::abs(static_cast<double>(a.samples[i]) - b.samples[i]);
+            squares += difference * difference;
+            if (difference > tolerance) over++;
+            if (difference > worst) {
+                worst = difference;
+                worstAt = i;
+            }
+        }
+        const double rms = common > 0 ? std::sqrt(squares / static_cast<double>(common)) : 0.0;
+        std::printf("Largest difference %.3g at %.4fs, RMS %.3g; %zu of %zu samples over %.3g\n", worst,
+                    static_cast<double>(worstAt / a.channels) / a.sampleRate, rms, over, common, tolerance);
+        if (a.samples.size() != b.samples.size()) {
+            std::printf("The files hold %zu and %zu samples\n", a.samples.size(), b.samples.size());
+        }
+        return over == 0 && a.samples.size() == b.samples.size() ? EXIT_SUCCESS : EXIT_FAILURE;
+    } catch (const std::exception &e) {
+        std::fprintf(stderr, "Error: %s\n", e.what());
+        return EXIT_FAILURE;
+    }
+}
+
+#endif //STARGBC_AUDIORENDER_H
@@ -0,0 +1,280 @@
+#ifndef STARGBC_BLOCKJITTESTS_H
+#define STARGBC_BLOCKJITTESTS_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <Gameboy.h>
+
+#include "doctest.h"
+#include "SyntheticRoms.h"
+
+// Compiled blocks have to leave the machine as interpreting them does, so
+// each ROM runs on the block cache with and without the JIT and the two are
+// compared every frame. The ROMs are straight-line code picked at random
+// from a seed, looping with interrupts on, so blocks are left at interrupts,
+// I/O accesses, OAM DMA and bank switches as well as at their ends.
+class JitProgram {
+public:
+    JitProgram(const uint32_t seed, const bool cgb) : state_(seed * 2654435761u + 1), cgb_(cgb) {
+    }
+
+    std::vector<uint8_t> Rom() {
+        std::vector<uint8_t> program = {
+            0xF3, 0x31, 0xF0, 0xDF, // di; ld sp,DFF0
+            0x3E, 0x3C, 0xE0, 0x80, 0x3E, 0xC9, 0xE0, 0x81, // inc a; ret at FF80
+            0x3E, 0x3D, 0xEA, 0x00, 0xC3, 0x3E, 0xC9, 0xEA, 0x01, 0xC3, // dec a; ret at C300
+            0x21, 0x00, 0xC1, 0x06, 0xA0, 0x3E, 0x04, 0x22, 0x05, 0x20, 0xFC, // C100-C19F: inc b
+            0x3E, 0x05, 0xE0, 0x07, // ld a,05; ldh (TAC),a
+            0x3E, 0x05, 0xE0, 0xFF, // ld a,05; ldh (IE),a (VBlank, timer)
+            0xFB, // loop: ei
+        };
+        const auto loop = static_cast<uint16_t>(0x150 + program.size() - 1);
+        while (program.size() < 0x2000) Item(program);
+        program.insert(program.end(), {0xC3, static_cast<uint8_t>(loop), static_cast<uint8_t>(loop >> 8)});
+
+        std::vector<uint8_t> rom = MakeTestRom(0x01, 0x00, program, 0x10000);
+        // Interrupts count at C0F0
+        for (const size_t vector: {0x40, 0x50}) {
+            rom[vector] = 0xC3;
+            rom[vector + 1] = 0x00;
+            rom[vector + 2] = 0x3F;
+        }
+        Place(rom, 0x3F00, {0xF5, 0xE5, 0x21, 0xF0, 0xC0, 0x34, 0xE1, 0xF1, 0xD9});
+        Place(rom, 0x08, {0x04, 0xC9}); // rst 08: inc b; ret
+        Place(rom, 0x10, {0x2F, 0xC9}); // rst 10: cpl; ret
+        Place(rom, 0x3E00, {0xC9});
+        Place(rom, 0x3E10, {0x21, 0x00, 0x3E, 0xE9}); // ld hl,3E00; jp hl
+        Place(rom, 0x3E20, {0xD0, 0xC8, 0x3C, 0xC9}); // ret nc; ret z; inc a; ret
+        // Each bank maps the next and runs on in it
+        for (size_t bank = 1; bank < 4; ++bank) {
+            Place(rom, bank * 0x4000 + 0x100, {
+                      0x3E, static_cast<uint8_t>(bank % 3 + 1), 0xEA, 0x00, 0x20, // ld a,next; ld (2000),a
+                      0xC6, static_cast<uint8_t>(bank * 0x10), 0x77, 0xC9, // add a,n; ld (hl),a; ret
+                  });
+        }
+        return rom;
+    }
+
+private:
+    static void Place(std::vector<uint8_t> &rom, const size_t address, const std::vector<uint8_t> &bytes) {
+        std::ranges::copy(bytes, rom.begin() + static_cast<std::ptrdiff_t>(address));
+    }
+
+    uint32_t Next(const uint32_t range) {
+        state_ ^= state_ << 13;
+        state_ ^= state_ >> 17;
+        state_ ^= state_ << 5;
+        return state_ % range;
+    }
+
+    uint8_t Byte() { return static_cast<uint8_t>(Next(0x100)); }
+
+    // Somewhere in WRAM or HRAM clear of the code copied there and of the
+    // OAM DMA source (C100-C19F)
+    uint16_t DataAddress() {
+        switch (Next(5)) {
+            case 0: return static_cast<uint16_t>(0xC000 + Next(0xF0));
+            case 1: return static_cast<uint16_t>(0xC200 + Next(0x100));
+            case 2: return static_cast<uint16_t>(0xC302 + Next(0xFE)); // next to code
+            case 3: return static_cast<uint16_t>(0xD000 + Next(0x1000));
+            default: return static_cast<uint16_t>(0xFF90 + Next(0x6F));
+        }
+    }
+
+    static void Word(std::vector<uint8_t> &out, const uint8_t opcode, const uint16_t value) {
+        out.insert(out.end(), {opcode, static_cast<uint8_t>(value), static_cast<uint8_t>(value >> 8)});
+    }
+
+    void Item(std::vector<uint8_t> &out) {
+        switch (Next(34)) {
+            case 0: case 1: case 2: {
+                const uint8_t opcode = static_cast<uint8_t>(0x80 + Next(0x40));
+                if ((opcode & 0x07) == 6) Word(out, 0x21, DataAddress());
+                out.push_back(opcode);
+                break;
+            }
+            case 3:
+                out.insert(out.end(), {static_cast<uint8_t>(0xC6 | Next(8) << 3), Byte()});
+                break;
+            case 4: case 5: {
+                const auto r = static_cast<uint8_t>(Next(8));
+                if (r == 6) Word(out, 0x21, DataAddress());
+                out.push_back(static_cast<uint8_t>(r << 3 | (Next(2) ? 0x04 : 0x05)));
+                break;
+            }
+            case 6: {
+                const auto r = static_cast<uint8_t>(Next(8));
+                if (r == 6) Word(out, 0x21, DataAddress());
+                out.insert(out.end(), {static_cast<uint8_t>(r << 3 | 0x06), Byte()});
+                break;
+            }
+            case 7: {
+                // ld r,r' and ld r,(hl) / ld (hl),r
+                const auto dst = static_cast<uint8_t>(Next(8)), src = static_cast<uint8_t>(Next(8));
+                if (dst == 6 && src == 6) break;
+                if (dst == 6 || src == 6) Word(out, 0x21, DataAddress());
+                out.push_back(static_cast<uint8_t>(0x40 | dst << 3 | src));
+                break;
+            }
+            case 8: case 9: {
+                const uint8_t cb = Byte();
+                if ((cb & 0x07) == 6) Word(out, 0x21, DataAddress());
+                out.insert(out.end(), {0xCB, cb});
+                break;
+            }
+            case 10: {
+                static constexpr uint8_t ONE_BYTE[] = {0x07, 0x0F, 0x17, 0x1F, 0x27, 0x2F, 0x37, 0x3F};
+                out.push_back(ONE_BYTE[Next(8)]);
+                break;
+            }
+            case 11:
+                out.push_back(static_cast<uint8_t>(0x09 | Next(4) << 4)); // add hl,rr
+                break;
+            case 12:
+                out.push_back(static_cast<uint8_t>(0x03 | Next(3) << 4 | Next(2) << 3)); // inc/dec bc, de, hl
+                if (Next(4) == 0) out.insert(out.end(), {0x33, 0x3B}); // inc sp; dec sp
+                break;
+            case 13:
+                out.push_back(static_cast<uint8_t>(0xC5 | Next(4) << 4)); // push
+                if (Next(2)) out.push_back(static_cast<uint8_t>(0x80 | Next(8) << 3 | Next(6))); // alu a,r between
+                out.push_back(static_cast<uint8_t>(0xC1 | Next(4) << 4)); // pop
+                break;
+            case 14:
+                Word(out, 0x21, DataAddress());
+                out.push_back(static_cast<uint8_t>(0x22 | Next(2) << 4 | Next(2) << 3)); // ld (hl+/-),a / ld a,(hl+/-)
+                break;
+            case 15: {
+                const bool de = Next(2);
+                Word(out, de ? 0x11 : 0x01, DataAddress());
+                out.push_back(static_cast<uint8_t>((de ? 0x12 : 0x02) | Next(2) << 3));
+                break;
+            }
+            case 16: {
+                // HRAM, or I/O that has the peripherals catch up
+                static constexpr uint8_t IO_READS[] = {0x04, 0x05, 0x0F, 0x41, 0x44};
+                static constexpr uint8_t IO_WRITES[] = {0x42, 0x43, 0x0F};
+                switch (Next(4)) {
+                    case 0: out.insert(out.end(), {0xE0, static_cast<uint8_t>(0x90 + Next(0x6F))});
+                        break;
+                    case 1: out.insert(out.end(), {0xF0, static_cast<uint8_t>(0x90 + Next(0x6F))});
+                        break;
+                    case 2: out.insert(out.end(), {0xF0, IO_READS[Next(5)]});
+                        break;
+                    default: out.insert(out.end(), {0xE0, IO_WRITES[Next(3)]});
+                }
+                break;
+            }
+            case 17: {
+                const bool rom = Next(4) == 0;
+                Word(out, rom ? 0xFA : Next(2) ? 0xEA : 0xFA, rom ? static_cast<uint16_t>(0x4000 + Next(2)) : DataAddress());
+                break;
+            }
+            case 18:
+                out.insert(out.end(), {0x0E, Next(2) ? static_cast<uint8_t>(0x90 + Next(0x6F)) : uint8_t{0x44},
+                                       static_cast<uint8_t>(Next(2) ? 0xF2 : 0xE2)});
+                break;
+            case 19: {
+                const uint8_t e = Byte();
+                if (Next(2)) out.insert(out.end(), {0xE8, e, 0xE8, static_cast<uint8_t>(-e)}); // add sp,e; add sp,-e
+                else out.insert(out.end(), {0xF8, e}); // ld hl,sp+e
+                break;
+            }
+            case 20:
+                Word(out, 0x08, static_cast<uint16_t>(0xC200 + Next(0xFF))); // ld (nn),sp
+                break;
+            case 21:
+                out.push_back(0xF3); // di
+                break;
+            case 22: {
+                std::vector<uint8_t> skipped;
+                Item(skipped);
+                if (skipped.size() > 0x7F) break;
+                out.insert(out.end(), {static_cast<uint8_t>(0x20 | Next(4) << 3), static_cast<uint8_t>(skipped.size())});
+                out.insert(out.end(), skipped.begin(), skipped.end());
+                break;
+            }
+            case 23:
+                switch (Next(5)) {
+                    case 0: Word(out, 0xCD, 0x3E20);
+                        break;
+                    case 1: Word(out, static_cast<uint8_t>(0xC4 | Next(4) << 3), 0x3E20); // call cc
+                        break;
+                    case 2: Word(out, 0xCD, 0x3E10);
+                        break;
+                    default: out.push_back(Next(2) ? 0xCF : 0xD7); // rst 08 / rst 10
+                }
+                break;
+            case 24:
+                Word(out, 0x21, DataAddress());
+                Word(out, 0xCD, 0x4100); // the banked routine, which switches banks under itself
+                break;
+            case 25:
+                Word(out, 0xCD, Next(2) ? 0xFF80 : 0xC300);
+                break;
+            case 26:
+                if (Next(8) == 0) {
+                    // OAM DMA started from here. While it runs the CPU
+                    // fetches what it copies, INC B, and slides over the NOPs.
+                    out.insert(out.end(), {0xF3, 0x3E, 0xC1, 0xE0, 0x46});
+                    out.insert(out.end(), 180, 0x00);
+                }
+                break;
+            case 27:
+                // 16-bit registers through OAM, for the DMG OAM bug
+                out.insert(out.end(), {0xF3, 0x21, static_cast<uint8_t>(Next(0xA0)), 0xFE, 0x23, 0x2A, 0x2B, 0x22});
+                out.insert(out.end(), {0x31, 0x90, 0xFE, 0xC5, 0xD1, 0x31, 0xF0, 0xDF}); // push/pop there
+                break;
+            case 28:
+                if (cgb_) out.insert(out.end(), {0x3E, static_cast<uint8_t>(Next(8)), 0xE0, 0x70}); // WRAM bank
+                break;
+            case 29:
+                // Rewrites the code in RAM, invalidating its blocks
+                out.insert(out.end(), {0x3E, 0x3C, 0xE0, 0x80});
+                Word(out, 0xEA, 0xC300);
+                break;
+            case 30:
+                out.insert(out.end(), {0x21, 0xF0, 0xDF, 0xF9}); // ld hl,DFF0; ld sp,hl
+                break;
+            default: {
+                // ld a,n and an ALU op that ends in zero half the time, for Z
+                const bool zero = Next(2);
+                const auto alu = static_cast<uint8_t>(Next(8)); // add adc sub sbc and xor or cp
+                const uint8_t a = zero && alu == 6 ? 0x00 : Byte();
+                uint8_t operand = Byte();
+                if (zero) operand = alu <= 1 ? static_cast<uint8_t>(-a) : alu == 4 || alu == 6 ? 0x00 : a;
+                out.insert(out.end(), {0x3E, a, static_cast<uint8_t>(0xC6 | alu << 3), operand});
+            }
+        }
+    }
+
+    uint32_t state_;
+    bool cgb_;
+};
+
+TEST_CASE("block jit: compiled blocks leave the machine as interpreted ones do") {
+    for (const Mode mode: {Mode::DMG, Mode::CGB_GBC}) {
+        for (uint32_t seed = 1; seed <= 4; ++seed) {
+            GameboySettings settings;
+            settings.romName = WriteTempFile("stargbc-jit.gb", JitProgram(seed, mode != Mode::DMG).Rom());
+            settings.mode = mode;
+            settings.unthrottled = true;
+            settings.readOnlySave = true;
+            settings.fastCore = true;
+            settings.blockCache = true;
+            Gameboy interpreted(settings);
+            settings.jit = true;
+            Gameboy compiled(settings);
+            for (int frame = 0; frame < 30; ++frame) {
+                interpreted.RunFrame();
+                compiled.RunFrame();
+                REQUIRE(compiled.CycleCount() == interpreted.CycleCount());
+                REQUIRE(compiled.GetStateView().Hash() == interpreted.GetStateView().Hash());
+            }
+            CHECK(interpreted.PeekByte(0xC0F0) != 0x00);
+        }
+    }
+}
+
+#endif //STARGBC_BLOCKJITTESTS_H
@@ -0,0 +1,87 @@
+#ifndef STARGBC_BOOTSTATECACHETESTS_H
+#define STARGBC_BOOTSTATECACHETESTS_H
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <BootStateCache.h>
+#include <Gameboy.h>
+
+#include "doctest.h"
+#include "SyntheticRoms.h"
+
+// A DMG bootrom that turns the LCD on, counts BC down from 0400 so the
+// handover lands mid-frame, leaves a mark at C000 and slides through NOPs
+// to 0100
+static std::vector<uint8_t> TestBootrom() {
+    std::vector<uint8_t> bootrom(0x100, 0x00);
+    const std::vector<uint8_t> program = {
+        0x31, 0xFE, 0xFF, // ld sp,FFFE
+        0x3E, 0x91, 0xE0, 0x40, // ld a,91; ldh (LCDC),a
+        0x01, 0x00, 0x04, // ld bc,0400
+        0x0B, // wait: dec bc
+        0x78, 0xB1, // ld a,b; or c
+        0x20, 0xFB, // jr nz,wait
+        0x21, 0x00, 0xC0, 0x36, 0x42, // ld hl,C000; ld (hl),42
+        0x06, 0x5A, // ld b,5A
+    };
+    std::ranges::copy(program, bootrom.begin());
+    return bootrom;
+}
+
+TEST_CASE("boot state cache: a restored boot runs on exactly as an emulated one") {
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "stargbc-boot-cache";
+    std::filesystem::remove_all(directory);
+    const std::vector<uint8_t> rom = MakeTestRom(0x00, 0x00, {
+                                                     0x21, 0x01, 0xC0, 0x34, // loop: ld hl,C001; inc (hl)
+                                                     0x18, 0xFA, // jr loop
+                                                 });
+    const std::vector<uint8_t> bootrom = TestBootrom();
+    GameboySettings settings;
+    settings.romName = WriteTempFile("stargbc-boot.gb", rom);
+    settings.biosPath = WriteTempFile("stargbc-boot.bin", bootrom);
+    settings.mode = Mode::DMG;
+    settings.unthrottled = true;
+    settings.readOnlySave = true;
+
+    Gameboy emulated(settings);
+    settings.bootStateCache = directory.string();
+    Gameboy stored(settings);
+    const BootStateCache cache(directory);
+    const BootStateCache::Key key = BootStateCache::MakeKey(bootrom, std::span(rom).subspan(0x100, 0x50),
+                                                            Hardware::DMG);
+    REQUIRE(cache.Load(key).has_value());
+    Gameboy restored(settings);
+
+    // A damaged entry is a miss, and the boot is emulated and stored again
+    const std::filesystem::path entry = directory / key.FileName();
+    std::ifstream in(entry, std::ios::binary);
+    std::vector<uint8_t> bytes(std::istreambuf_iterator<char>(in), {});
+    in.close();
+    bytes.back() ^= 0x5A;
+    std::ofstream out(entry, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    out.close();
+    CHECK_FALSE(cache.Load(key).has_value());
+    Gameboy rebooted(settings);
+    CHECK(cache.Load(key).has_value());
+
+    for (int frame = 0; frame < 3; ++frame) {
+        for (Gameboy *gameboy: {&emulated, &stored, &restored, &rebooted}) gameboy->RunFrame();
+        for (const Gameboy *gameboy: {&stored, &restored, &rebooted}) {
+            CHECK(gameboy->CycleCount() == emulated.CycleCount());
+            CHECK(gameboy->GetStateView().Hash() == emulated.GetStateView().Hash());
+        }
+    }
+    CHECK(emulated.PeekByte(0xC000) == 0x42);
+    CHECK(emulated.PeekByte(0xC001) != 0x00);
+    std::filesystem::remove_all(directory);
+}
+
+#endif //STARGBC_BOOTSTATECACHETESTS_H
@@ -0,0 +1,51 @@
+#ifndef STARGBC_BUSTESTS_H
+#define STARGBC_BUSTESTS_H
+
+#include <Bus.h>
+#include <Cartridge.h>
+
+#include "doctest.h"
+#include "SyntheticRoms.h"
+
+// A bus over freshly constructed hardware and an MBC1 + 8 KiB RAM cartridge
+struct BusFixture {
+    Interrupts interrupts{};
+    Joypad joypad{interrupts};
+    Memory memory{};
+    Audio audio{};
+    Timer timer{audio, interrupts};
+    Serial serial{interrupts};
+    DMA dma{};
+    GPU gpu{interrupts};
+    RealTimeClock rtc{false};
+    std::string romPath = WriteTempFile("stargbc-bus.gb", MakeTestRom(0x02, 0x02, {}));
+    Cartridge cartridge{romPath, Cartridge::LoadRom(romPath), rtc};
+    Bus bus{joypad, memory, timer, cartridge, serial, dma, audio, interrupts, gpu};
+
+    BusFixture() {
+        cartridge.SetSaveWritable(false);
+    }
+};
+
+TEST_CASE("bus: peeking reads what the CPU would without counting an access") {
+    BusFixture fixture;
+    Bus &bus = fixture.bus;
+    bus.WriteByte(0x0000, 0x0A, ComponentSource::CPU); // enable cartridge RAM
+    bus.WriteByte(0xA000, 0x5A, ComponentSource::CPU);
+    bus.WriteByte(0xC123, 0xA5, ComponentSource::CPU);
+
+    // Reads of the timers, the APU and cartridge RAM count
+    uint32_t epoch = bus.AccessEpoch();
+    for (const uint16_t address: {0xA000, 0xFF04, 0xFF26}) {
+        CHECK(bus.ReadByte(static_cast<uint16_t>(address), ComponentSource::CPU) == bus.PeekByte(static_cast<uint16_t>(address)));
+        CHECK(bus.AccessEpoch() == ++epoch);
+    }
+
+    epoch = bus.AccessEpoch();
+    for (uint32_t address = 0; address <= 0xFFFF; address++) static_cast<void>(bus.PeekByte(static_cast<uint16_t>(address)));
+    CHECK(bus.AccessEpoch() == epoch);
+    CHECK(bus.PeekByte(0xA000) == 0x5A);
+    CHECK(bus.PeekByte(0xC123) == 0xA5);
+}
+
+#endif //STARGBC_BUSTESTS_H
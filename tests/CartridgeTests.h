@@ -0,0 +1,48 @@
+#ifndef STARGBC_CARTRIDGETESTS_H
+#define STARGBC_CARTRIDGETESTS_H
+
+#include <string>
+#include <tuple>
+
+#include <Gameboy.h>
+
+#include "doctest.h"
+#include "SyntheticRoms.h"
+
+// A 32 KiB ROM with the given header type and RAM size bytes. Its program
+// enables cartridge RAM and increments the byte at A000 forever.
+static std::string WriteCounterRom(const std::string &name, const uint8_t type, const uint8_t ramSize) {
+    return WriteTempFile(name, MakeTestRom(type, ramSize, {
+                                               0x3E, 0x0A, // ld a,0A
+                                               0xEA, 0x00, 0x00, // ld (0000),a
+                                               0x21, 0x00, 0xA0, // ld hl,A000
+                                               0x34, // inc (hl)
+                                               0x18, 0xFD, // jr -3
+                                           }));
+}
+
+TEST_CASE("cartridge: a ROM that cannot be loaded leaves the running game alone") {
+    GameboySettings settings;
+    settings.romName = WriteCounterRom("stargbc-counter.gb", 0x02, 0x02); // MBC1 + 8 KiB RAM
+    settings.mode = Mode::DMG;
+    settings.unthrottled = true;
+    settings.readOnlySave = true;
+    Gameboy gameboy(settings);
+    gameboy.RunFrame();
+    const uint32_t crc = gameboy.GetRomCrc32();
+
+    for (const auto &[name, type, ramSize]: {
+             std::tuple<const char *, uint8_t, uint8_t>{"stargbc-bad-mbc.gb", 0x04, 0x00}, // no such mapper
+             std::tuple<const char *, uint8_t, uint8_t>{"stargbc-bad-ram.gb", 0x02, 0x07}, // no such RAM size
+         }) {
+        CHECK_THROWS(gameboy.LoadRom(WriteCounterRom(name, type, ramSize)));
+        CHECK(gameboy.GetRomCrc32() == crc);
+        // Still mapped and still counting in the old game's save RAM
+        CHECK(gameboy.PeekByte(0x0147) == 0x02);
+        const uint8_t before = gameboy.PeekByte(0xA000);
+        gameboy.RunFrame();
+        CHECK(gameboy.PeekByte(0xA000) != before);
+    }
+}
+
+#endif //STARGBC_CARTRIDGETESTS_H
@@ -0,0 +1,54 @@
+#ifndef STARGBC_COROUTINECORETESTS_H
+#define STARGBC_COROUTINECORETESTS_H
+
+#include <optional>
+#include <stdexcept>
+
+#include "CPU.inl"
+#include "CoroutineCore.h"
+#include "FlatBus.h"
+
+#include "doctest.h"
+
+// Flat memory whose writes to `fault` throw, as a failing save would
+struct FaultingBus : FlatBus {
+    void WriteByte(const uint16_t address, const uint8_t value, const ComponentSource source) {
+        if (address == fault) throw std::runtime_error("bus fault");
+        FlatBus::WriteByte(address, value, source);
+    }
+
+    std::optional<uint16_t> fault;
+};
+
+TEST_CASE("coroutine core: an access that throws frees the frame slot") {
+    FaultingBus bus;
+    Interrupts interrupts;
+    Registers registers;
+    CPU<FaultingBus> cpu(Mode::DMG, nullptr, bus, interrupts, registers);
+    Instructions<CPU<FaultingBus> > instructions(registers, interrupts);
+    CoroutineCore<CPU<FaultingBus> > core(registers, interrupts);
+    // Steps `opcode` to completion; its operand, if any, is at 0100
+    const auto run = [&](const uint8_t opcode) {
+        cpu.pc(0x0100);
+        while (!core.Step(instructions, opcode, false, cpu)) {
+        }
+    };
+    bus.memory[0x0100] = 0x00;
+    bus.memory[0x0101] = 0xC0;
+    registers.SetHL(0xC000);
+    registers.a = 0x42;
+
+    bus.fault = 0xC000;
+    CHECK_THROWS(run(0x77)); // ld (hl),a writes as the coroutine starts
+    CHECK_THROWS(run(0xEA)); // ld (C000),a writes on a resume
+
+    bus.fault.reset();
+    CHECK_NOTHROW(run(0x77));
+    CHECK(bus.memory[0xC000] == 0x42);
+    registers.a = 0x24;
+    CHECK_NOTHROW(run(0xEA));
+    CHECK(bus.memory[0xC000] == 0x24);
+    CHECK(core.ArenaGrowths() == 0);
+}
+
+#endif //STARGBC_COROUTINECORETESTS_H
@@ -0,0 +1,74 @@
+#ifndef STARGBC_FRAMEHASHLOGTESTS_H
+#define STARGBC_FRAMEHASHLOGTESTS_H
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <FrameHashLog.h>
+#include <Gameboy.h>
+
+#include "doctest.h"
+#include "SyntheticRoms.h"
+
+TEST_CASE("frame hash log: written and read back") {
+    FrameHashLog log(0xCAFEF00D, 3);
+    for (uint64_t frame = 1; frame <= 10; ++frame) log.Record(frame, frame * 0x0101010101010101);
+    CHECK((log.Hashes() == std::vector<uint64_t>{0x0303030303030303, 0x0606060606060606, 0x0909090909090909}));
+    CHECK(log.FrameOf(2) == 9);
+
+    const std::string path = WriteTempFile("stargbc-hashes.sgbh", {});
+    log.Write(path);
+    const FrameHashLog read = FrameHashLog::Read(path);
+    CHECK(read.RomCrc32() == log.RomCrc32());
+    CHECK(read.Interval() == log.Interval());
+    CHECK(read.Hashes() == log.Hashes());
+}
+
+TEST_CASE("frame hash log: a count that does not match the file is refused") {
+    const std::string path = WriteTempFile("stargbc-truncated.sgbh", {});
+    FrameHashLog log(0xCAFEF00D, 1);
+    for (uint64_t frame = 1; frame <= 4; ++frame) log.Record(frame, frame);
+    log.Write(path);
+    const auto size = std::filesystem::file_size(path);
+
+    std::filesystem::resize_file(path, size - 1);
+    CHECK_THROWS_WITH(FrameHashLog::Read(path), path + " is truncated");
+    log.Write(path);
+    std::ofstream(path, std::ios::binary | std::ios::app).put(0x00);
+    CHECK_THROWS_WITH(FrameHashLog::Read(path), path + " is damaged");
+
+    // A count no file could hold fails before anything is allocated for it
+    log.Write(path);
+    constexpr uint64_t count = uint64_t{1} << 61;
+    std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+    file.seekp(16); // after the magic, version, ROM CRC and interval
+    file.write(reinterpret_cast<const char *>(&count), sizeof(count));
+    file.close();
+    CHECK_THROWS_WITH(FrameHashLog::Read(path), path + " is truncated");
+
+    std::filesystem::resize_file(path, 8);
+    CHECK_THROWS_WITH(FrameHashLog::Read(path), path + " is not a frame hash log");
+}
+
+TEST_CASE("frame hash log: hashing logs the screen every interval") {
+    GameboySettings settings;
+    settings.romName = WriteTempFile("stargbc-screen.gb", MakeTestRom(0x00, 0x00, {0x18, 0xFE})); // jr -2
+    settings.mode = Mode::DMG;
+    settings.unthrottled = true;
+    settings.readOnlySave = true;
+    Gameboy gameboy(settings);
+    gameboy.SetFrameHashing(2);
+    std::vector<uint64_t> expected;
+    for (int frame = 1; frame <= 6; ++frame) {
+        gameboy.RunFrame();
+        if (frame % 2 == 0) expected.push_back(gameboy.ScreenHash());
+    }
+    REQUIRE(gameboy.GetFrameHashLog() != nullptr);
+    CHECK(gameboy.GetFrameHashLog()->Hashes() == expected);
+    CHECK(gameboy.GetFrameHashLog()->RomCrc32() == gameboy.GetRomCrc32());
+}
+
+#endif //STARGBC_FRAMEHASHLOGTESTS_H
@@ -0,0 +1,156 @@
+#ifndef STARGBC_FRAMEHASHES_H
+#define STARGBC_FRAMEHASHES_H
+
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include <FrameHashLog.h>
+#include <Gameboy.h>
+#include <InputMovie.h>
+#include <PngWriter.h>
+
+// Usage: --frame-hashes <rom> <log> [--movie <file>] [--frames <n>]
+//        [--every <n>] [--png <dir>] [--max-png <n>] [--update] [--gbc | --gb] [--bios <path>]
+// Without the log (or with --update) the run is recorded as the golden
+// one. Otherwise the run is checked against it frame by frame, and the
+// frames that differ are written out as PNGs.
+inline int ExecuteFrameHashes(const int argc, char **argv) {
+    GameboySettings settings;
+    settings.unthrottled = true;
+    settings.readOnlySave = true;
+    std::string logPath;
+    std::string moviePath;
+    std::filesystem::path pngDirectory = ".";
+    uint64_t frames = 3600;
+    uint32_t every = 1;
+    size_t maxPng = 20;
+    bool update = false;
+    for (int i = 2; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--movie" && hasValue) {
+            moviePath = argv[++i];
+        } else if (arg == "--frames" && hasValue) {
+            frames = std::stoull(argv[++i]);
+        } else if (arg == "--every" && hasValue) {
+            every = static_cast<uint32_t>(std::stoul(argv[++i]));
+        } else if (arg == "--png" && hasValue) {
+            pngDirectory = argv[++i];
+        } else if (arg == "--max-png" && hasValue) {
+            maxPng = std::stoull(argv[++i]);
+        } else if (arg == "--bios" && hasValue) {
+            settings.biosPath = argv[++i];
+        } else if (arg == "--update") {
+            update = true;
+        } else if (arg == "--gbc") {
+            settings.mode = Mode::CGB_GBC;
+        } else if (arg == "--gb") {
+            settings.mode = Mode::DMG;
+        } else if (settings.romName.empty()) {
+            settings.romName = arg;
+        } else {
+            logPath = arg;
+        }
+    }
+    if (logPath.empty() || every == 0) {
+        std::fprintf(stderr, "USAGE: StarGBC_Tests --frame-hashes <rom> <log> [options]\n"
+                     "Options:\n"
+                     "  --movie <file>      play a recorded movie, for as long as it lasts\n"
+                     "  --frames <n>        frames to record without a movie (default 3600)\n"
+                     "  --every <n>         hash one frame in n when recording (default 1)\n"
+                     "  --update            record the log even if it exists\n"
+                     "  --png <dir>         where differing frames go (default .)\n"
+                     "  --max-png <n>       differing frames written at most (default 20)\n"
+                     "  --bios <path>       boot through a BIOS first\n"
+                     "  --gbc | --gb        force gbc/dmg mode\n");
+        return EXIT_FAILURE;
+    }
+
+    try {
+        std::unique_ptr<FrameHashLog> golden;
+        if (!update && std::filesystem::exists(logPath)) {
+            golden = std::make_unique<FrameHashLog>(FrameHashLog::Read(logPath));
+            every = golden->Interval();
+        }
+        Gameboy gameboy(settings);
+        if (golden && golden->RomCrc32() != gameboy.GetRomCrc32()) {
+            std::fprintf(stderr, "%s was recorded with another ROM\n", logPath.c_str());
+            return EXIT_FAILURE;
+        }
+        if (!moviePath.empty()) gameboy.PlayMovie(InputMovie::Read(moviePath));
+        gameboy.SetFrameHashing(every);
+        const FrameHashLog &log = *gameboy.GetFrameHashLog();
+
+        if (!golden) {
+            if (!moviePath.empty()) {
+                while (gameboy.IsPlayingMovie()) gameboy.RunFrame();
+            } else {
+                for (uint64_t frame = 0; frame < frames; frame++) gameboy.RunFrame();
+            }
+            log.Write(logPath);
+            std::printf("Recorded %zu hashes of %s, one every %u frames\n", log.Hashes().size(),
+                        settings.romName.c_str(), every);
+            return EXIT_SUCCESS;
+        }
+
+        size_t differing = 0;
+        const std::vector<uint64_t> &want = golden->Hashes();
+        while (log.Hashes().size() < want.size()) {
+            const size_t entry = log.Hashes().size();
+            gameboy.RunFrame();
+            if (log.Hashes().size() == entry || log.Hashes()[entry] == want[entry]) continue;
+            if (differing++ < maxPng) {
+                char name[32];
+                std::snprintf(name, sizeof(name), "frame-%08llu.png",
+                              static_cast<unsigned long long>(golden->FrameOf(entry)));
+                std::filesystem::create_directories(pngDirectory);
+                WritePng((pngDirectory / name).string(), gameboy.GetScreenData(), SCREEN_WIDTH, SCREEN_HEIGHT);
+                std::printf("Frame %llu differs, written to %s\n",
+                            static_cast<unsigned long long>(golden->FrameOf(entry)),
+                            (pngDirectory / name).string().c_str());
+            }
+        }
+        std::printf("%zu of %zu hashed frames differ from %s\n", differing, want.size(), logPath.c_str());
+        return differing == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    } catch (const std::exception &e) {
+        std::fprintf(stderr, "Error: %s\n", e.what());
+        return EXIT_FAILURE;
+    }
+}
+
+// Usage: --diff-hashes <a> <b>. Lists the frames two logs disagree on,
+// for comparing builds when both logs already exist.
+inline int ExecuteHashDiff(const int argc, char **argv) {
+    if (argc != 4) {
+        std::fprintf(stderr, "USAGE: StarGBC_Tests --diff-hashes <log> <log>\n");
+        return EXIT_FAILURE;
+    }
+    try {
+        const FrameHashLog a = FrameHashLog::Read(argv[2]);
+        const FrameHashLog b = FrameHashLog::Read(argv[3]);
+        if (a.RomCrc32() != b.RomCrc32() || a.Interval() != b.Interval()) {
+            std::fprintf(stderr, "The logs are of different ROMs or intervals\n");
+            return EXIT_FAILURE;
+        }
+        const size_t common = std::min(a.Hashes().size(), b.Hashes().size());
+        size_t differing = 0;
+        for (size_t entry = 0; entry < common; entry++) {
+            if (a.Hashes()[entry] == b.Hashes()[entry]) continue;
+            if (differing++ < 20) std::printf("Frame %llu differs\n", static_cast<unsigned long long>(a.FrameOf(entry)));
+        }
+        if (differing > 20) std::printf("... and %zu more\n", differing - 20);
+        if (a.Hashes().size() != b.Hashes().size()) {
+            std::printf("The logs cover %zu and %zu hashed frames\n", a.Hashes().size(), b.Hashes().size());
+        }
+        std::printf("%zu of %zu hashed frames differ\n", differing, common);
+        return differing == 0 && a.Hashes().size() == b.Hashes().size() ? EXIT_SUCCESS : EXIT_FAILURE;
+    } catch (const std::exception &e) {
+        std::fprintf(stderr, "Error: %s\n", e.what());
+        return EXIT_FAILURE;
+    }
+}
+
+#endif //STARGBC_FRAMEHASHES_H
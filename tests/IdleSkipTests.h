@@ -0,0 +1,138 @@
+#ifndef STARGBC_IDLESKIPTESTS_H
+#define STARGBC_IDLESKIPTESTS_H
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <Gameboy.h>
+
+#include "doctest.h"
+#include "SyntheticRoms.h"
+
+// RunFrame skips idle stretches; StepInstruction never does. Both cores are
+// checked, since each has its own skipping path.
+static GameboySettings IdleSkipSettings(const std::string &romName, const bool fastCore) {
+    GameboySettings settings;
+    settings.romName = romName;
+    settings.mode = Mode::DMG;
+    settings.unthrottled = true;
+    settings.readOnlySave = true;
+    settings.fastCore = fastCore;
+    return settings;
+}
+
+// Steps `stepped` to the instruction boundary `skipped` stands at
+static void StepToSameInstruction(Gameboy &stepped, const Gameboy &skipped) {
+    while (stepped.InstructionsRetired() < skipped.InstructionsRetired()) REQUIRE(stepped.StepInstruction());
+    CHECK(stepped.InstructionsRetired() == skipped.InstructionsRetired());
+}
+
+// Sets up the timer to overflow at 1024 Hz and the VBlank, STAT (LYC=40) and timer
+// interrupts, then halts in a loop with IME as `ime` (0xFB ei, 0xF3 di)
+// leaves it, counting wake-ups at C000 and sampling DIV into C001
+static std::vector<uint8_t> HaltLoopRom(const uint8_t ime) {
+    std::vector<uint8_t> rom = MakeTestRom(0x00, 0x00, {
+                                               0x3E, 0x05, 0xE0, 0x07, // ld a,05; ldh (TAC),a
+                                               0x3E, 0x28, 0xE0, 0x45, // ld a,28; ldh (LYC),a
+                                               0x3E, 0x40, 0xE0, 0x41, // ld a,40; ldh (STAT),a
+                                               0x3E, 0x07, 0xE0, 0xFF, // ld a,07; ldh (IE),a
+                                               ime,
+                                               0x76, // loop: halt
+                                               0x00, // nop
+                                               0xAF, 0xE0, 0x0F, // xor a; ldh (IF),a
+                                               0x21, 0x00, 0xC0, 0x34, // ld hl,C000; inc (hl)
+                                               0xF0, 0x04, 0xEA, 0x01, 0xC0, // ldh a,(DIV); ld (C001),a
+                                               0x18, 0xF0, // jr loop
+                                           });
+    for (const size_t vector: {0x40, 0x48, 0x50}) rom[vector] = 0xD9; // reti
+    return rom;
+}
+
+TEST_CASE("idle skipping: fast-forwarding HALT matches stepping through it") {
+    for (const bool fastCore: {false, true}) {
+        for (const uint8_t ime: {uint8_t{0xFB}, uint8_t{0xF3}}) {
+            const std::string rom = WriteTempFile("stargbc-halt.gb", HaltLoopRom(ime));
+            Gameboy skipped(IdleSkipSettings(rom, fastCore));
+            Gameboy stepped(IdleSkipSettings(rom, fastCore));
+            for (int frame = 0; frame < 10; ++frame) skipped.RunFrame();
+            REQUIRE(skipped.StepInstruction());
+            StepToSameInstruction(stepped, skipped);
+
+            CHECK_MESSAGE(skipped.GetFrameStats().haltedMCycles > 10000, "the loop should spend most of a frame halted");
+            CHECK(stepped.CycleCount() == skipped.CycleCount());
+            CHECK(stepped.GetStateView().Hash() == skipped.GetStateView().Hash());
+        }
+    }
+}
+
+TEST_CASE("idle skipping: a STOP skipped a frame at a time leaves the machine as stepping does") {
+    const std::string rom = WriteTempFile("stargbc-stop.gb", MakeTestRom(0x00, 0x00, {
+                                                                              0x10, 0x00, // loop: stop
+                                                                              0x21, 0x00, 0xC0, 0x34, // ld hl,C000; inc (hl)
+                                                                              0xF0, 0x04, 0xEA, 0x01, 0xC0, // ldh a,(DIV); ld (C001),a
+                                                                              0x18, 0xF3, // jr loop
+                                                                          }));
+    for (const bool fastCore: {false, true}) {
+        Gameboy skipped(IdleSkipSettings(rom, fastCore));
+        Gameboy stepped(IdleSkipSettings(rom, fastCore));
+        for (int frame = 0; frame < 3; ++frame) skipped.RunFrame();
+        while (stepped.StepInstruction()) {
+        }
+        // Nothing ticks in STOP, so only the time spent there differs
+        for (int frame = 0; frame < 3; ++frame) {
+            CHECK_FALSE(stepped.StepInstruction());
+            CHECK(stepped.GetStateView().Hash() == skipped.GetStateView().Hash());
+        }
+
+        for (Gameboy *gameboy: {&skipped, &stepped}) {
+            gameboy->KeyDown(Keys::A);
+            REQUIRE(gameboy->StepInstruction());
+            gameboy->KeyUp(Keys::A);
+        }
+        StepToSameInstruction(stepped, skipped);
+        CHECK(stepped.GetStateView().Hash() == skipped.GetStateView().Hash());
+    }
+}
+
+// With IME off, polls IF for the timer (1024 Hz) and then LY for line 144,
+// counting each at C000 and C001
+static std::vector<uint8_t> PollingRom() {
+    return MakeTestRom(0x00, 0x00, {
+                           0xF3, // di
+                           0x3E, 0x05, 0xE0, 0x07, // ld a,05; ldh (TAC),a
+                           0xF0, 0x0F, // loop: ldh a,(IF)
+                           0xE6, 0x04, // and 04
+                           0x28, 0xFA, // jr z,loop
+                           0xAF, 0xE0, 0x0F, // xor a; ldh (IF),a
+                           0x21, 0x00, 0xC0, 0x34, // ld hl,C000; inc (hl)
+                           0xF0, 0x44, // wait: ldh a,(LY)
+                           0xFE, 0x90, // cp 90
+                           0x20, 0xFA, // jr nz,wait
+                           0x21, 0x01, 0xC0, 0x34, // ld hl,C001; inc (hl)
+                           0x18, 0xE7, // jr loop
+                       });
+}
+
+TEST_CASE("idle skipping: skipped polling loops end every frame where running them does") {
+    const std::string rom = WriteTempFile("stargbc-polling.gb", PollingRom());
+    for (const auto &[fastCore, blockCache]: {std::pair{false, false}, std::pair{true, false}, std::pair{true, true}}) {
+        GameboySettings settings = IdleSkipSettings(rom, fastCore);
+        settings.blockCache = blockCache;
+        Gameboy run(settings);
+        settings.idleLoops = true;
+        Gameboy skipped(settings);
+        for (int frame = 0; frame < 10; ++frame) {
+            run.RunFrame();
+            skipped.RunFrame();
+            CHECK(skipped.CycleCount() == run.CycleCount());
+            CHECK(skipped.GetStateView().Hash() == run.GetStateView().Hash());
+        }
+        CHECK(skipped.PeekByte(0xC001) >= 10);
+        // A frame is 140448 master cycles
+        CHECK_MESSAGE(skipped.GetIdleLoopStats().skippedCycles > 10 * 140448 / 4, "a good part of the frames should be skipped");
+    }
+}
+
+#endif //STARGBC_IDLESKIPTESTS_H
@@ -0,0 +1,133 @@
+#ifndef STARGBC_JSONSTREAM_H
+#define STARGBC_JSONSTREAM_H
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+// Pull parser over a file read in fixed-size chunks, so test vector files of
+// any size are walked without being loaded. Callers ask for the value they
+// expect next and skip the rest; only what the tests use is understood
+// (no string escapes beyond \" and \\, no fractions or exponents).
+class JsonStream {
+public:
+    explicit JsonStream(const std::string &path) : file_(std::fopen(path.c_str(), "rb"), &std::fclose) {
+        if (!file_) throw std::runtime_error("Could not open file " + path);
+    }
+
+    // Next non-whitespace character, without consuming it; 0 at the end
+    char Peek() {
+        while (true) {
+            if (pos_ == size_ && !Refill()) return 0;
+            if (const char c = buffer_[pos_]; c != ' ' && c != '\n' && c != '\r' && c != '\t') return c;
+            ++pos_;
+        }
+    }
+
+    void Expect(const char expected) {
+        if (Peek() != expected) Fail(std::string("expected '") + expected + "'");
+        ++pos_;
+    }
+
+    // Consumes `c` if it is next
+    bool Consume(const char c) {
+        if (Peek() != c) return false;
+        ++pos_;
+        return true;
+    }
+
+    // For walking arrays and objects: true while there is another element,
+    // consuming the separator or the closing bracket
+    bool NextElement(const char close, bool &first) {
+        if (Consume(close)) return false;
+        if (!first) Expect(',');
+        first = false;
+        return true;
+    }
+
+    std::string ReadString() {
+        Expect('"');
+        std::string text;
+        for (char c = Get(); c != '"'; c = Get()) {
+            if (c == '\\') c = Get();
+            text.push_back(c);
+        }
+        return text;
+    }
+
+    uint64_t ReadUnsigned() {
+        if (Peek() < '0' || Peek() > '9') Fail("expected a number");
+        uint64_t value = 0;
+        while (pos_ < size_ || Refill()) {
+            const char c = buffer_[pos_];
+            if (c < '0' || c > '9') break;
+            value = value * 10 + static_cast<uint64_t>(c - '0');
+            ++pos_;
+        }
+        return value;
+    }
+
+    // Consumes a null if it is next
+    bool ConsumeNull() {
+        if (Peek() != 'n') return false;
+        for (const char c: {'n', 'u', 'l', 'l'}) {
+            if (Get() != c) Fail("expected null");
+        }
+        return true;
+    }
+
+    void SkipValue() {
+        switch (Peek()) {
+            case '"': ReadString();
+                break;
+            case '[':
+            case '{': {
+                const char close = Peek() == '[' ? ']' : '}';
+                ++pos_;
+                bool first = true;
+                while (NextElement(close, first)) {
+                    if (close == '}') {
+                        ReadString();
+                        Expect(':');
+                    }
+                    SkipValue();
+                }
+                break;
+            }
+            default:
+                // Numbers and literals end at the next delimiter
+                while (const char c = Peek()) {
+                    if (c == ',' || c == ']' || c == '}') break;
+                    ++pos_;
+                }
+        }
+    }
+
+    [[noreturn]] void Fail(const std::string &what) const {
+        throw std::runtime_error("JSON parse error at byte " + std::to_string(offset_ + pos_) + ": " + what);
+    }
+
+private:
+    char Get() {
+        if (pos_ == size_ && !Refill()) Fail("unexpected end of file");
+        return buffer_[pos_++];
+    }
+
+    bool Refill() {
+        offset_ += size_;
+        size_ = std::fread(buffer_.data(), 1, buffer_.size(), file_.get());
+        pos_ = 0;
+        return size_ > 0;
+    }
+
+    std::unique_ptr<std::FILE, decltype(&std::fclose)> file_;
+    std::array<char, 1 << 16> buffer_{};
+    size_t size_{0};
+    size_t pos_{0};
+    size_t offset_{0};
+};
+
+#endif //STARGBC_JSONSTREAM_H
@@ -0,0 +1,224 @@
+#ifndef STARGBC_LOCKSTEP_H
+#define STARGBC_LOCKSTEP_H
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+
+#include <Gameboy.h>
+
+// Differential run of two CPU cores on the same ROM and inputs. Both are
+// brought to the same instruction boundary after every frame (the cores end
+// frames at slightly different points) and their StateView hashes compared.
+// At the first mismatch the frame is replayed from the last matching point
+// one instruction at a time to find the instruction that diverged, and the
+// differing registers and bytes are printed.
+//
+// Two exact cores must agree on every frame of every ROM; any mismatch
+// between them is a bug. The others may drift from them:
+// - fast syncs peripherals at I/O accesses and instruction boundaries, so
+//   a timer or PPU register read mid-instruction can see another value
+// - blocks also takes interrupts only between blocks, so it diverges on
+//   any ROM that takes one outside HALT
+// - jit runs blocks as compiled code, and must match blocks exactly
+struct LockstepCore {
+    std::string_view name;
+    CpuCore cpuCore;
+    bool fast;
+    bool blocks;
+    bool jit;
+    bool exact; // cycle-accurate
+};
+
+static constexpr LockstepCore LOCKSTEP_CORES[] = {
+    {"accurate", CpuCore::StepTable, false, false, false, true},
+    {"coroutine", CpuCore::Coroutine, false, false, false, true},
+    {"fast", CpuCore::StepTable, true, false, false, false},
+    {"blocks", CpuCore::StepTable, true, true, false, false},
+    {"jit", CpuCore::StepTable, true, true, true, false},
+};
+
+static const LockstepCore *FindLockstepCore(const std::string_view name) {
+    for (const LockstepCore &core: LOCKSTEP_CORES) {
+        if (core.name == name) return &core;
+    }
+    return nullptr;
+}
+
+// Finishes any instruction in flight, then steps whichever instance is
+// behind until both have completed the same number. False if one cannot
+// get there (stopped, or halted for good).
+static bool AlignInstructions(Gameboy &a, Gameboy &b) {
+    for (Gameboy *gameboy: {&a, &b}) {
+        if (!gameboy->AtInstructionBoundary() && !gameboy->StepInstruction()) return false;
+    }
+    while (a.InstructionsRetired() != b.InstructionsRetired()) {
+        Gameboy &behind = a.InstructionsRetired() < b.InstructionsRetired() ? a : b;
+        if (!behind.StepInstruction()) return false;
+    }
+    return true;
+}
+
+// Registers that differ, then up to `limit` differing bytes per region
+static void PrintStateDiff(const StateView &reference, const StateView &candidate, const size_t limit) {
+    for (size_t i = 0; i < reference.cpu.size(); i++) {
+        if (reference.cpu[i] != candidate.cpu[i]) {
+            std::printf("  %-6s %02X vs %02X\n", StateView::CPU_FIELDS[i], reference.cpu[i], candidate.cpu[i]);
+        }
+    }
+    for (size_t i = 0; i < reference.io.size(); i++) {
+        if (reference.io[i] != candidate.io[i]) {
+            std::printf("  FF%02zX   %02X vs %02X\n", i, reference.io[i], candidate.io[i]);
+        }
+    }
+    for (size_t r = 0; r < reference.memory.size(); r++) {
+        const auto &want = reference.memory[r].bytes;
+        const auto &got = candidate.memory[r].bytes;
+        if (want.size() != got.size()) {
+            std::printf("  %s is %zu bytes vs %zu\n", reference.memory[r].name, want.size(), got.size());
+            continue;
+        }
+        size_t differing = 0;
+        for (size_t i = 0; i < want.size(); i++) {
+            if (want[i] == got[i]) continue;
+            if (differing++ < limit) {
+                std::printf("  %s+%04zX %02X vs %02X\n", reference.memory[r].name, i, want[i], got[i]);
+            }
+        }
+        if (differing > limit) std::printf("  %s: %zu more bytes differ\n", reference.memory[r].name, differing - limit);
+    }
+}
+
+// Replays from a matching pair one instruction at a time, up to `count`
+// instructions. True if the divergence was found and printed.
+static bool ReplayToDivergence(const Gameboy &referenceStart, const Gameboy &candidateStart, const uint8_t keys,
+                               const uint64_t count) {
+    const auto reference = referenceStart.Fork();
+    const auto candidate = candidateStart.Fork();
+    reference->SetKeys(keys);
+    candidate->SetKeys(keys);
+    for (uint64_t i = 1; i <= count; i++) {
+        const StateView before = reference->GetStateView();
+        const auto pc = static_cast<uint16_t>(before.cpu[10] << 8 | before.cpu[11]);
+        const uint8_t opcode = reference->PeekByte(pc);
+        if (!reference->StepInstruction() || !candidate->StepInstruction()) return false;
+        const StateView want = reference->GetStateView();
+        if (const StateView got = candidate->GetStateView(); want.Hash() != got.Hash()) {
+            std::printf("First differing instruction: #%llu of the frame, opcode %02X at %04X\n",
+                        static_cast<unsigned long long>(i), opcode, pc);
+            PrintStateDiff(want, got, 16);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Usage: --lockstep <rom> [--reference <core>] [--candidate <core>]
+//        [--frames <n>] [--seed <n>] [--gbc | --gb] [--bios <path>]
+inline int ExecuteLockstep(const int argc, char **argv) {
+    GameboySettings settings;
+    settings.unthrottled = true;
+    settings.readOnlySave = true;
+    const LockstepCore *referenceCore = FindLockstepCore("accurate");
+    const LockstepCore *candidateCore = FindLockstepCore("coroutine");
+    uint64_t frames = 3600;
+    uint32_t seed = 1;
+    for (int i = 2; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--reference" && hasValue) {
+            referenceCore = FindLockstepCore(argv[++i]);
+        } else if (arg == "--candidate" && hasValue) {
+            candidateCore = FindLockstepCore(argv[++i]);
+        } else if (arg == "--frames" && hasValue) {
+            frames = std::stoull(argv[++i]);
+        } else if (arg == "--seed" && hasValue) {
+            seed = static_cast<uint32_t>(std::stoul(argv[++i]));
+        } else if (arg == "--bios" && hasValue) {
+            settings.biosPath = argv[++i];
+        } else if (arg == "--gbc") {
+            settings.mode = Mode::CGB_GBC;
+        } else if (arg == "--gb") {
+            settings.mode = Mode::DMG;
+        } else {
+            settings.romName = arg;
+        }
+    }
+    if (settings.romName.empty() || !referenceCore || !candidateCore) {
+        std::fprintf(stderr, "USAGE: StarGBC_Tests --lockstep <rom> [options]\n"
+                     "Options:\n"
+                     "  --reference <core>  accurate (default), coroutine, fast, blocks or jit\n"
+                     "  --candidate <core>  core checked against it (default coroutine)\n"
+                     "  --frames <n>        frames to compare (default 3600)\n"
+                     "  --seed <n>          seed of the random key presses (default 1)\n"
+                     "  --bios <path>       boot through a BIOS first\n"
+                     "  --gbc | --gb        force gbc/dmg mode\n");
+        return EXIT_FAILURE;
+    }
+
+    const SharedResources resources = SharedResources::Load(settings);
+    const auto make = [&](const LockstepCore &core) {
+        GameboySettings coreSettings = settings;
+        coreSettings.cpuCore = core.cpuCore;
+        coreSettings.fastCore = core.fast;
+        coreSettings.blockCache = core.blocks;
+        coreSettings.jit = core.jit;
+        return std::make_unique<Gameboy>(coreSettings, resources);
+    };
+    const auto reference = make(*referenceCore);
+    const auto candidate = make(*candidateCore);
+    std::unique_ptr<Gameboy> referenceCheckpoint = reference->Fork();
+    std::unique_ptr<Gameboy> candidateCheckpoint = candidate->Fork();
+    uint64_t checkpointRetired = 0;
+
+    // Keys are held for a few frames at a time, about half the time none
+    std::mt19937 random(seed);
+    uint8_t keys = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (uint64_t frame = 0; frame < frames; frame++) {
+        if (frame % 8 == 0) keys = random() % 2 ? static_cast<uint8_t>(random()) : 0;
+        reference->SetKeys(keys);
+        candidate->SetKeys(keys);
+        reference->RunFrame();
+        candidate->RunFrame();
+
+        const bool aligned = AlignInstructions(*reference, *candidate);
+        const StateView want = reference->GetStateView();
+        const StateView got = candidate->GetStateView();
+        if (aligned && want.Hash() == got.Hash()) {
+            referenceCheckpoint = reference->Fork();
+            candidateCheckpoint = candidate->Fork();
+            checkpointRetired = reference->InstructionsRetired();
+            continue;
+        }
+
+        std::printf("%s and %s diverge in frame %llu (seed %u)\n", referenceCore->name.data(),
+                    candidateCore->name.data(), static_cast<unsigned long long>(frame), seed);
+        if (!aligned) {
+            std::printf("Could not bring both to the same instruction (%llu vs %llu completed)\n",
+                        static_cast<unsigned long long>(reference->InstructionsRetired()),
+                        static_cast<unsigned long long>(candidate->InstructionsRetired()));
+        }
+        const uint64_t count = reference->InstructionsRetired() - checkpointRetired;
+        if (!ReplayToDivergence(*referenceCheckpoint, *candidateCheckpoint, keys, count)) {
+            // Block cache code, which a step-by-step replay does not run
+            std::printf("Instruction-by-instruction replay agrees; the frame ends with:\n");
+            PrintStateDiff(want, got, 16);
+        }
+        if (!referenceCore->exact || !candidateCore->exact) {
+            std::printf("%s is allowed to drift from the cycle-accurate cores\n",
+                        (referenceCore->exact ? candidateCore : referenceCore)->name.data());
+        }
+        return EXIT_FAILURE;
+    }
+
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::printf("%s and %s agree over %llu frames (seed %u) in %.2fs\n", referenceCore->name.data(),
+                candidateCore->name.data(), static_cast<unsigned long long>(frames), seed, elapsed.count());
+    return EXIT_SUCCESS;
+}
+
+#endif //STARGBC_LOCKSTEP_H
@@ -0,0 +1,286 @@
+#ifndef STARGBC_MAPPERTESTS_H
+#define STARGBC_MAPPERTESTS_H
+
+#include <array>
+#include <initializer_list>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <Cartridge.h>
+
+#include "doctest.h"
+#include "SyntheticRoms.h"
+
+// A cartridge over a synthetic ROM that neither reads nor writes a save file
+struct CartridgeFixture {
+    CartridgeFixture(const std::string &name, const std::vector<uint8_t> &rom) : path(WriteTempFile(name, rom)),
+        cartridge(path, Cartridge::LoadRom(path), rtc, false) {
+        cartridge.SetSaveWritable(false);
+    }
+
+    // The number MakeTestRom put at the start of the bank mapped at `address`
+    [[nodiscard]] uint16_t BankAt(const uint16_t address) const {
+        return static_cast<uint16_t>(cartridge.ReadByte(address) | cartridge.ReadByte(address + 1) << 8);
+    }
+
+    RealTimeClock rtc{false};
+    std::string path;
+    Cartridge cartridge;
+};
+
+TEST_CASE("mapper: MBC5 switches all 512 ROM banks") {
+    CartridgeFixture fixture("stargbc-mbc5.gb", MakeTestRom(0x19, 0x00, {}, size_t{8} << 20));
+    Cartridge &cart = fixture.cartridge;
+    CHECK(fixture.BankAt(0x4000) == 1);
+    cart.WriteByte(0x3000, 0x01); // bit 8
+    CHECK(fixture.BankAt(0x4000) == 0x101);
+    cart.WriteByte(0x2000, 0xFF);
+    CHECK(fixture.BankAt(0x4000) == 0x1FF);
+    cart.WriteByte(0x2000, 0x00); // bank 0 is selectable in the upper window
+    CHECK(fixture.BankAt(0x4000) == 0x100);
+    cart.WriteByte(0x3000, 0x00);
+    CHECK(fixture.BankAt(0x4000) == 0);
+    CHECK(fixture.BankAt(0x0000) == 0);
+}
+
+TEST_CASE("mapper: MBC6 switches its 8 KiB ROM windows, 4 KiB RAM windows and flash") {
+    CartridgeFixture fixture("stargbc-mbc6.gb", MakeTestRom(0x20, 0x00, {}, 0x20000));
+    Cartridge &cart = fixture.cartridge;
+    // 8 KiB bank 2n starts 16 KiB bank n
+    cart.WriteByte(0x2000, 6);
+    cart.WriteByte(0x3000, 10);
+    CHECK(fixture.BankAt(0x4000) == 3);
+    CHECK(fixture.BankAt(0x6000) == 5);
+
+    cart.WriteByte(0x0000, 0x0A);
+    cart.WriteByte(0x0400, 1);
+    cart.WriteByte(0x0800, 2);
+    cart.WriteByte(0xA000, 0x11);
+    cart.WriteByte(0xB000, 0x22);
+    CHECK(cart.GameRam()[0x1000] == 0x11);
+    CHECK(cart.GameRam()[0x2000] == 0x22);
+    CHECK(cart.ReadByte(0xB000) == 0x22);
+
+    // Flash in window A reads erased; programming only clears bits
+    cart.WriteByte(0x0C00, 0x01);
+    cart.WriteByte(0x2800, 0x08);
+    cart.WriteByte(0x2000, 0);
+    CHECK(cart.ReadByte(0x4000) == 0xFF);
+    cart.WriteByte(0x4000, 0x0F);
+    CHECK(cart.ReadByte(0x4000) == 0xFF); // not write-enabled
+    cart.WriteByte(0x1000, 0x01);
+    cart.WriteByte(0x4000, 0x0F);
+    cart.WriteByte(0x4000, 0xF5);
+    CHECK(cart.ReadByte(0x4000) == 0x05);
+    CHECK(fixture.BankAt(0x6000) == 5);
+}
+
+// Drives the MBC7's 93LC56 through its port at A080: chip select, clock, data in
+struct Eeprom {
+    Cartridge &cart;
+
+    void Command(const uint32_t bits, const int count) const {
+        cart.WriteByte(0xA080, 0x00); // deselect, ending any command
+        cart.WriteByte(0xA080, 0x80);
+        for (int i = count - 1; i >= 0; --i) Clock(bits >> i & 1);
+    }
+
+    void Clock(const uint32_t bit) const {
+        cart.WriteByte(0xA080, static_cast<uint8_t>(0x80 | bit << 1));
+        cart.WriteByte(0xA080, static_cast<uint8_t>(0xC0 | bit << 1));
+    }
+
+    [[nodiscard]] bool DataOut() const { return cart.ReadByte(0xA080) & 0x01; }
+
+    // Start bit, opcode and address, then the word clocked out MSB first
+    [[nodiscard]] uint16_t Read(const uint8_t address) const {
+        Command(0b110 << 8 | address, 11);
+        CHECK_FALSE(DataOut()); // the dummy zero
+        uint16_t word = 0;
+        for (int i = 0; i < 16; ++i) {
+            Clock(0);
+            word = static_cast<uint16_t>(word << 1 | DataOut());
+        }
+        return word;
+    }
+
+    void Write(const uint8_t address, const uint16_t word) const {
+        Command(0b101 << 8 | address, 11);
+        for (int i = 15; i >= 0; --i) Clock(word >> i & 1);
+    }
+
+    void Erase(const uint8_t address) const { Command(0b111 << 8 | address, 11); }
+
+    void EnableWrites(const bool enable) const { Command(0b100 << 8 | (enable ? 0xC0 : 0x00), 11); }
+};
+
+TEST_CASE("mapper: MBC7 EEPROM read, write and erase, and the accelerometer") {
+    CartridgeFixture fixture("stargbc-mbc7.gb", MakeTestRom(0x22, 0x00, {}, 0x20000));
+    Cartridge &cart = fixture.cartridge;
+    cart.WriteByte(0x2000, 5);
+    CHECK(fixture.BankAt(0x4000) == 5);
+    CHECK(cart.ReadByte(0xA080) == 0xFF); // both enables needed
+    cart.WriteByte(0x0000, 0x0A);
+    cart.WriteByte(0x4000, 0x40);
+
+    const Eeprom eeprom{cart};
+    CHECK(eeprom.Read(5) == 0xFFFF); // blank
+    eeprom.Write(5, 0x1234);
+    CHECK(eeprom.Read(5) == 0xFFFF); // write-protected until EWEN
+    eeprom.EnableWrites(true);
+    eeprom.Write(5, 0x1234);
+    CHECK(eeprom.Read(5) == 0x1234);
+    CHECK(cart.GameRam()[10] == 0x12);
+    CHECK(cart.GameRam()[11] == 0x34);
+    CHECK(eeprom.Read(4) == 0xFFFF);
+    eeprom.Erase(5);
+    CHECK(eeprom.Read(5) == 0xFFFF);
+    eeprom.Write(6, 0xBEEF);
+    eeprom.EnableWrites(false);
+    eeprom.Erase(6);
+    CHECK(eeprom.Read(6) == 0xBEEF);
+
+    // 0x81D0 at rest, 0x70 per g; latched until reset
+    cart.SetAccelerometer(1.0, -0.5);
+    cart.WriteByte(0xA000, 0x55);
+    cart.WriteByte(0xA010, 0xAA);
+    CHECK((cart.ReadByte(0xA020) | cart.ReadByte(0xA030) << 8) == 0x8160);
+    CHECK((cart.ReadByte(0xA040) | cart.ReadByte(0xA050) << 8) == 0x8198);
+    cart.SetAccelerometer(0.0, 0.0);
+    cart.WriteByte(0xA010, 0xAA);
+    CHECK((cart.ReadByte(0xA020) | cart.ReadByte(0xA030) << 8) == 0x8160);
+}
+
+TEST_CASE("mapper: HuC1 banks ROM and RAM and swaps RAM for the IR port") {
+    CartridgeFixture fixture("stargbc-huc1.gb", MakeTestRom(0xFF, 0x03, {}, 0x20000));
+    Cartridge &cart = fixture.cartridge;
+    cart.WriteByte(0x2000, 5);
+    CHECK(fixture.BankAt(0x4000) == 5);
+    cart.WriteByte(0x2000, 0);
+    CHECK(fixture.BankAt(0x4000) == 1);
+
+    cart.WriteByte(0x0000, 0x0A);
+    cart.WriteByte(0x4000, 2);
+    cart.WriteByte(0xA000, 0x77);
+    CHECK(cart.GameRam()[0x4000] == 0x77);
+    CHECK(cart.ReadByte(0xA000) == 0x77);
+
+    cart.WriteByte(0x0000, 0x0E);
+    CHECK(cart.ReadByte(0xA000) == 0xC0); // no light
+    cart.WriteByte(0xA000, 0x01);
+    CHECK(cart.GameRam()[0x4000] == 0x77);
+    cart.WriteByte(0x0000, 0x0A);
+    CHECK(cart.ReadByte(0xA000) == 0x77);
+}
+
+// HuC3 commands go through A000: the command in mode 0B, executed by a
+// write in mode 0D, the result read in mode 0C
+static uint8_t HuC3Command(Cartridge &cart, const uint8_t command, const uint8_t argument) {
+    cart.WriteByte(0x0000, 0x0B);
+    cart.WriteByte(0xA000, static_cast<uint8_t>(command << 4 | argument));
+    cart.WriteByte(0x0000, 0x0D);
+    CHECK(cart.ReadByte(0xA000) == 0x01);
+    cart.WriteByte(0xA000, 0x00);
+    cart.WriteByte(0x0000, 0x0C);
+    const uint8_t result = cart.ReadByte(0xA000);
+    CHECK(result >> 4 == (0x08 | command));
+    return result & 0x0F;
+}
+
+TEST_CASE("mapper: HuC3 command protocol, RTC and IR") {
+    CartridgeFixture fixture("stargbc-huc3.gb", MakeTestRom(0xFE, 0x03, {}, 0x20000));
+    Cartridge &cart = fixture.cartridge;
+    cart.WriteByte(0x2000, 6);
+    CHECK(fixture.BankAt(0x4000) == 6);
+    cart.WriteByte(0x0000, 0x0A);
+    cart.WriteByte(0x4000, 1);
+    cart.WriteByte(0xA000, 0x5A);
+    CHECK(cart.GameRam()[0x2000] == 0x5A);
+
+    // Address 12, store 9 and A, read both back
+    HuC3Command(cart, 0x4, 0x2);
+    HuC3Command(cart, 0x5, 0x1);
+    HuC3Command(cart, 0x3, 0x9);
+    HuC3Command(cart, 0x3, 0xA);
+    HuC3Command(cart, 0x4, 0x2);
+    CHECK(HuC3Command(cart, 0x1, 0x0) == 0x9);
+    CHECK(HuC3Command(cart, 0x1, 0x0) == 0xA);
+
+    // Set the clock to day 5, 12:03 from memory 00-05, then read it back
+    HuC3Command(cart, 0x4, 0x0);
+    HuC3Command(cart, 0x5, 0x0);
+    for (const uint8_t nibble: {0x3, 0xD, 0x2, 0x5, 0x0, 0x0}) HuC3Command(cart, 0x3, nibble);
+    HuC3Command(cart, 0x6, 0x1);
+    HuC3Command(cart, 0x4, 0x0);
+    for (int i = 0; i < 6; ++i) HuC3Command(cart, 0x3, 0x0);
+    HuC3Command(cart, 0x6, 0x0);
+    HuC3Command(cart, 0x4, 0x0);
+    std::array<uint8_t, 6> clock{};
+    for (uint8_t &nibble: clock) nibble = HuC3Command(cart, 0x1, 0x0);
+    CHECK((clock == std::array<uint8_t, 6>{0x3, 0xD, 0x2, 0x5, 0x0, 0x0}));
+    CHECK(HuC3Command(cart, 0x6, 0x2) == 0x1);
+
+    cart.WriteByte(0x0000, 0x0E);
+    CHECK(cart.ReadByte(0xA000) == 0xC0); // no IR light
+}
+
+TEST_CASE("mapper: MMM01 maps its menu, then locks into the selected game") {
+    std::vector<uint8_t> rom = MakeTestRom(0x0B, 0x00, {}, 0x100000);
+    // The menu, and the header that names the mapper, are in the last 32 KiB
+    std::copy_n(rom.begin() + 0x100, 0x50, rom.end() - 0x8000 + 0x100);
+    CartridgeFixture fixture("stargbc-mmm01.gb", rom);
+    Cartridge &cart = fixture.cartridge;
+    CHECK(fixture.BankAt(0x0000) == 62);
+    CHECK(fixture.BankAt(0x4000) == 63);
+
+    cart.WriteByte(0x2000, 0x22); // game at bank 32 + 2
+    cart.WriteByte(0x6000, 0x0C); // bits 1-2 of the bank stay the menu's
+    cart.WriteByte(0x0000, 0x40);
+    CHECK(fixture.BankAt(0x0000) == 34);
+    CHECK(fixture.BankAt(0x4000) == 34);
+    cart.WriteByte(0x2000, 0x01);
+    CHECK(fixture.BankAt(0x4000) == 35);
+    cart.WriteByte(0x2000, 0x1F);
+    CHECK(fixture.BankAt(0x4000) == 59);
+    cart.WriteByte(0x2000, 0x61); // the outer bank no longer moves
+    CHECK(fixture.BankAt(0x4000) == 35);
+}
+
+TEST_CASE("mapper: Pocket Camera captures from the attached source") {
+    CartridgeFixture fixture("stargbc-camera.gb", MakeTestRom(0xFC, 0x00, {}, 0x20000));
+    Cartridge &cart = fixture.cartridge;
+    cart.WriteByte(0x2000, 3);
+    CHECK(fixture.BankAt(0x4000) == 3);
+
+    // Dark on the left, bright on the right
+    cart.SetCameraSource([](const std::span<uint8_t> image) {
+        for (size_t i = 0; i < image.size(); ++i) {
+            image[i] = i % PocketCameraMapper::SENSOR_WIDTH < 64 ? 0x20 : 0xF0;
+        }
+    });
+    cart.WriteByte(0x4000, 0x10); // registers
+    cart.WriteByte(0xA002, 0x10); // exposure 1.0
+    cart.WriteByte(0xA003, 0x00);
+    for (uint16_t reg = 6; reg < 6 + 48; reg += 3) {
+        cart.WriteByte(0xA000 + reg, 0x40);
+        cart.WriteByte(0xA000 + reg + 1, 0x80);
+        cart.WriteByte(0xA000 + reg + 2, 0xC0);
+    }
+    cart.WriteByte(0xA000, 0x01);
+    CHECK(cart.ReadByte(0xA000) == 0x00); // done
+
+    cart.WriteByte(0x0000, 0x0A);
+    cart.WriteByte(0x4000, 0x00);
+    // Tiles 0-7 of each row are black, 8-15 white
+    for (const uint16_t tile: {0, 7, 16, 16 * 13 + 7}) {
+        CHECK(cart.ReadByte(0xA100 + tile * 16) == 0xFF);
+        CHECK(cart.ReadByte(0xA100 + tile * 16 + 1) == 0xFF);
+    }
+    for (const uint16_t tile: {8, 15, 16 * 13 + 8}) {
+        CHECK(cart.ReadByte(0xA100 + tile * 16) == 0x00);
+        CHECK(cart.ReadByte(0xA100 + tile * 16 + 1) == 0x00);
+    }
+}
+
+#endif //STARGBC_MAPPERTESTS_H
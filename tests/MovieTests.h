@@ -0,0 +1,115 @@
+#ifndef STARGBC_MOVIETESTS_H
+#define STARGBC_MOVIETESTS_H
+
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <Gameboy.h>
+#include <InputMovie.h>
+
+#include "doctest.h"
+#include "SyntheticRoms.h"
+
+// Overwrites `size` bytes of the file at `offset`
+static void PatchFile(const std::string &path, const std::streamoff offset, const void *data, const size_t size) {
+    std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+    file.seekp(offset);
+    file.write(static_cast<const char *>(data), static_cast<std::streamsize>(size));
+}
+
+static InputMovie SampleMovie() {
+    InputMovie movie;
+    movie.romCrc32 = 0x12345678;
+    movie.start = InputMovie::Start::Snapshot;
+    movie.sram = {0x01, 0x02, 0x03};
+    movie.rtc = {0x10, 0x20, 0x30, 0x40, 0x50};
+    movie.snapshot = std::vector<uint8_t>(300, 0xA5);
+    movie.events = {{100, static_cast<uint8_t>(Keys::A), true}, {70000, static_cast<uint8_t>(Keys::A), false}};
+    movie.length = 140448;
+    return movie;
+}
+
+TEST_CASE("input movie: written and read back field for field") {
+    const std::string path = WriteTempFile("stargbc-movie.sgbm", {});
+    const InputMovie movie = SampleMovie();
+    movie.Write(path);
+    const InputMovie read = InputMovie::Read(path);
+    CHECK(read.romCrc32 == movie.romCrc32);
+    CHECK(read.start == movie.start);
+    CHECK(read.sram == movie.sram);
+    CHECK(read.rtc == movie.rtc);
+    CHECK(read.snapshot == movie.snapshot);
+    REQUIRE(read.events.size() == movie.events.size());
+    for (size_t i = 0; i < movie.events.size(); ++i) {
+        CHECK(read.events[i].cycle == movie.events[i].cycle);
+        CHECK(read.events[i].key == movie.events[i].key);
+        CHECK(read.events[i].down == movie.events[i].down);
+    }
+    CHECK(read.length == movie.length);
+}
+
+TEST_CASE("input movie: a damaged payload or an unknown start is refused") {
+    const std::string path = WriteTempFile("stargbc-damaged.sgbm", {});
+    SampleMovie().Write(path);
+    std::ifstream in(path, std::ios::binary);
+    const std::vector<uint8_t> bytes(std::istreambuf_iterator<char>(in), {});
+    in.close();
+
+    // The last byte is the second event's down flag
+    const uint8_t flipped = bytes.back() ^ 0x01;
+    PatchFile(path, static_cast<std::streamoff>(bytes.size() - 1), &flipped, 1);
+    CHECK_THROWS_WITH(InputMovie::Read(path), path + " is damaged");
+
+    // `start` follows the magic, version and ROM CRC
+    SampleMovie().Write(path);
+    constexpr uint32_t start = 2;
+    PatchFile(path, 12, &start, sizeof(start));
+    CHECK_THROWS_WITH(InputMovie::Read(path), path + " is damaged");
+
+    const std::string truncated = WriteTempFile("stargbc-short.sgbm", {0x53, 0x47});
+    CHECK_THROWS_WITH(InputMovie::Read(truncated), truncated + " is not a movie");
+}
+
+TEST_CASE("input movie: a recording replays to the state it ended in") {
+    // Adds the pressed buttons to C000 as fast as it can read them, so a
+    // key applied a cycle off changes the sum
+    GameboySettings settings;
+    settings.romName = WriteTempFile("stargbc-keys.gb", MakeTestRom(0x00, 0x00, {
+                                                                       0x3E, 0x10, 0xE0, 0x00, // ld a,10; ldh (P1),a
+                                                                       0x21, 0x00, 0xC0, // ld hl,C000
+                                                                       0xF0, 0x00, // loop: ldh a,(P1)
+                                                                       0x2F, // cpl
+                                                                       0xE6, 0x0F, // and 0F
+                                                                       0x86, 0x77, // add (hl); ld (hl),a
+                                                                       0x18, 0xF7, // jr loop
+                                                                   }));
+    settings.mode = Mode::DMG;
+    settings.unthrottled = true;
+    settings.readOnlySave = true;
+    const std::string path = WriteTempFile("stargbc-recorded.sgbm", {});
+
+    for (const bool fromPowerOn: {false, true}) {
+        Gameboy recorder(settings);
+        recorder.RunFrame();
+        recorder.StartRecording(fromPowerOn);
+        for (int frame = 0; frame < 6; ++frame) {
+            if (frame == 1) recorder.KeyDown(Keys::A);
+            if (frame == 2) recorder.KeyDown(Keys::Start);
+            if (frame == 4) recorder.KeyUp(Keys::A);
+            recorder.RunFrame();
+        }
+        recorder.StopRecording().Write(path);
+
+        Gameboy player(settings);
+        player.RunFrame();
+        player.PlayMovie(InputMovie::Read(path));
+        while (player.IsPlayingMovie()) player.RunFrame();
+        CHECK(player.PeekByte(0xC000) != 0x00);
+        CHECK(player.GetStateView().Hash() == recorder.GetStateView().Hash());
+    }
+}
+
+#endif //STARGBC_MOVIETESTS_H
@@ -0,0 +1,119 @@
+#ifndef STARGBC_PNGWRITERTESTS_H
+#define STARGBC_PNGWRITERTESTS_H
+
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <span>
+#include <utility>
+#include <string>
+#include <vector>
+
+#include <PngWriter.h>
+#include <RomSource.h>
+
+#include "doctest.h"
+#include "RomSourceTests.h" // Gzip
+#include "SyntheticRoms.h"
+
+static uint32_t GetBigEndian(const std::span<const uint8_t> bytes) {
+    return uint32_t{bytes[0]} << 24 | uint32_t{bytes[1]} << 16 | uint32_t{bytes[2]} << 8 | bytes[3];
+}
+
+struct PngImage {
+    uint32_t width{0};
+    uint32_t height{0};
+    std::vector<uint8_t> deflate; // the IDAT data without its zlib wrapper
+    uint32_t adler32{0};
+};
+
+// Checks the signature, chunk CRCs, IHDR and zlib header of a PNG from
+// WritePng and takes its image data apart
+static PngImage ReadPng(const std::string &path) {
+    std::ifstream in(path, std::ios::binary);
+    const std::vector<uint8_t> png(std::istreambuf_iterator<char>(in), {});
+    REQUIRE(png.size() > 8);
+    CHECK((std::vector(png.begin(), png.begin() + 8) == std::vector<uint8_t>{0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'}));
+
+    PngImage image;
+    std::vector<uint8_t> zlib;
+    std::vector<std::string> types;
+    for (size_t at = 8; at < png.size();) {
+        REQUIRE(at + 12 <= png.size());
+        const uint32_t length = GetBigEndian(std::span(png).subspan(at));
+        REQUIRE(at + 12 + length <= png.size());
+        const std::span<const uint8_t> typeAndData = std::span(png).subspan(at + 4, 4 + length);
+        CHECK(GetBigEndian(std::span(png).subspan(at + 8 + length)) == RomSource::Crc32(typeAndData));
+        const std::string type(typeAndData.begin(), typeAndData.begin() + 4);
+        const std::span<const uint8_t> data = typeAndData.subspan(4);
+        if (type == "IHDR") {
+            REQUIRE(data.size() == 13);
+            image.width = GetBigEndian(data);
+            image.height = GetBigEndian(data.subspan(4));
+            CHECK((std::vector(data.begin() + 8, data.end()) == std::vector<uint8_t>{8, 6, 0, 0, 0}));
+        } else if (type == "IDAT") {
+            zlib.insert(zlib.end(), data.begin(), data.end());
+        }
+        types.push_back(type);
+        at += 12 + length;
+    }
+    CHECK((types == std::vector<std::string>{"IHDR", "IDAT", "IEND"}));
+
+    // Deflate, and a header that checks
+    REQUIRE(zlib.size() > 6);
+    CHECK((zlib[0] & 0x0F) == 8);
+    CHECK((zlib[0] << 8 | zlib[1]) % 31 == 0);
+    image.deflate.assign(zlib.begin() + 2, zlib.end() - 4);
+    image.adler32 = GetBigEndian(std::span(zlib).last(4));
+    return image;
+}
+
+// What the IDAT should decode to: each row of `pixels` behind filter type 0
+static std::vector<uint8_t> Scanlines(const std::vector<uint32_t> &pixels, const uint32_t width) {
+    const auto *bytes = reinterpret_cast<const uint8_t *>(pixels.data());
+    std::vector<uint8_t> raw;
+    for (size_t row = 0; row < pixels.size() / width; ++row) {
+        raw.push_back(0);
+        raw.insert(raw.end(), bytes + row * width * 4, bytes + (row + 1) * width * 4);
+    }
+    return raw;
+}
+
+static uint32_t Adler32(const std::vector<uint8_t> &bytes) {
+    uint32_t a = 1;
+    uint32_t b = 0;
+    for (const uint8_t byte: bytes) {
+        a = (a + byte) % 65521;
+        b = (b + a) % 65521;
+    }
+    return b << 16 | a;
+}
+
+TEST_CASE("png writer: the image data inflates to the pixels, compressed or stored") {
+    constexpr uint32_t width = 160;
+    constexpr uint32_t height = 144;
+    // Bands of a few colours compress; noise is stored, in two blocks
+    std::vector<uint32_t> screen(width * height);
+    for (size_t i = 0; i < screen.size(); ++i) screen[i] = 0xFF000000 | 0x00555555 * (i / width / 8 % 4) + i % 3;
+    std::vector<uint32_t> noise(width * height);
+    std::mt19937 random(49);
+    for (uint32_t &pixel: noise) pixel = random();
+
+    for (const auto &[pixels, blockType]: {std::pair{screen, 1}, std::pair{noise, 0}}) {
+        const std::string path = WriteTempFile("stargbc-screen.png", {});
+        WritePng(path, pixels.data(), width, height);
+        const PngImage image = ReadPng(path);
+        CHECK(image.width == width);
+        CHECK(image.height == height);
+        CHECK((image.deflate[0] >> 1 & 0x03) == blockType);
+
+        // RomSource inflates gzip, whose CRC and size check the result
+        const std::vector<uint8_t> raw = Scanlines(pixels, width);
+        CHECK(RomSource::Load(WriteTempFile("stargbc-idat.gz", Gzip(image.deflate, raw))).data == raw);
+        CHECK(image.adler32 == Adler32(raw));
+        if (blockType == 1) CHECK(image.deflate.size() < raw.size() / 10);
+    }
+}
+
+#endif //STARGBC_PNGWRITERTESTS_H
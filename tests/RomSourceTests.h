@@ -0,0 +1,217 @@
+#ifndef STARGBC_ROMSOURCETESTS_H
+#define STARGBC_ROMSOURCETESTS_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <RomSource.h>
+
+#include "doctest.h"
+#include "SyntheticRoms.h"
+
+// Deflate streams are built by hand so every block type is covered without
+// a compressor in the build. Bits go out LSB first, Huffman codes MSB first.
+class DeflateWriter {
+public:
+    void Bits(const uint32_t value, const int count) {
+        for (int i = 0; i < count; ++i) Bit(value >> i & 1);
+    }
+
+    void Code(const uint32_t code, const int length) {
+        for (int i = length - 1; i >= 0; --i) Bit(code >> i & 1);
+    }
+
+    void AlignToByte() { bitCount_ = 0; }
+
+    void Stored(const std::string &text, const bool last) {
+        Bits(last, 1);
+        Bits(0, 2);
+        AlignToByte();
+        Bits(static_cast<uint32_t>(text.size()), 16);
+        Bits(~static_cast<uint32_t>(text.size()) & 0xFFFF, 16);
+        for (const char c: text) Bits(static_cast<uint8_t>(c), 8);
+    }
+
+    // Literal/length symbol with the fixed code of RFC 1951 3.2.6
+    void FixedSymbol(const uint32_t symbol) {
+        if (symbol < 144) Code(0x30 + symbol, 8);
+        else if (symbol < 256) Code(0x190 + symbol - 144, 9);
+        else if (symbol < 280) Code(symbol - 256, 7);
+        else Code(0xC0 + symbol - 280, 8);
+    }
+
+    std::vector<uint8_t> bytes;
+
+private:
+    void Bit(const uint32_t bit) {
+        if (bitCount_ == 0) bytes.push_back(0);
+        bytes.back() |= static_cast<uint8_t>(bit << bitCount_);
+        bitCount_ = (bitCount_ + 1) % 8;
+    }
+
+    int bitCount_{0};
+};
+
+// RFC 1951 3.2.2: the canonical codes for a set of code lengths
+static std::vector<uint32_t> CanonicalCodes(const std::vector<uint8_t> &lengths) {
+    std::array<uint32_t, 16> count{};
+    std::array<uint32_t, 16> next{};
+    for (const uint8_t length: lengths) {
+        if (length) ++count[length];
+    }
+    uint32_t code = 0;
+    for (int bits = 1; bits < 16; ++bits) {
+        code = (code + count[bits - 1]) << 1;
+        next[bits] = code;
+    }
+    std::vector<uint32_t> codes(lengths.size());
+    for (size_t symbol = 0; symbol < lengths.size(); ++symbol) {
+        if (lengths[symbol]) codes[symbol] = next[lengths[symbol]]++;
+    }
+    return codes;
+}
+
+static void PutLittleEndian(std::vector<uint8_t> &out, const uint32_t value, const int bytes) {
+    for (int i = 0; i < bytes; ++i) out.push_back(static_cast<uint8_t>(value >> 8 * i));
+}
+
+static std::vector<uint8_t> Bytes(const std::string &text) {
+    return {text.begin(), text.end()};
+}
+
+static std::vector<uint8_t> Gzip(const std::vector<uint8_t> &deflate, const std::vector<uint8_t> &decoded) {
+    std::vector<uint8_t> file = {0x1F, 0x8B, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF};
+    file.insert(file.end(), deflate.begin(), deflate.end());
+    PutLittleEndian(file, RomSource::Crc32(decoded), 4);
+    PutLittleEndian(file, static_cast<uint32_t>(decoded.size()), 4);
+    return file;
+}
+
+// A zip local file entry; with `descriptor` the CRC and sizes follow the data
+static void ZipEntry(std::vector<uint8_t> &file, const std::string &name, const uint16_t method,
+                     const std::vector<uint8_t> &data, const std::vector<uint8_t> &decoded, const bool descriptor) {
+    const uint32_t crc = RomSource::Crc32(decoded);
+    PutLittleEndian(file, 0x04034B50, 4);
+    PutLittleEndian(file, 20, 2);
+    PutLittleEndian(file, descriptor ? 0x08 : 0x00, 2);
+    PutLittleEndian(file, method, 2);
+    PutLittleEndian(file, 0, 4); // time, date
+    for (const uint32_t field: {crc, static_cast<uint32_t>(data.size()), static_cast<uint32_t>(decoded.size())}) {
+        PutLittleEndian(file, descriptor ? 0 : field, 4);
+    }
+    PutLittleEndian(file, static_cast<uint32_t>(name.size()), 2);
+    PutLittleEndian(file, 0, 2);
+    file.insert(file.end(), name.begin(), name.end());
+    file.insert(file.end(), data.begin(), data.end());
+    if (descriptor) {
+        PutLittleEndian(file, 0x08074B50, 4);
+        PutLittleEndian(file, crc, 4);
+        PutLittleEndian(file, static_cast<uint32_t>(data.size()), 4);
+        PutLittleEndian(file, static_cast<uint32_t>(decoded.size()), 4);
+    }
+}
+
+// A stored block, a fixed-Huffman block and a dynamic-Huffman block, the
+// last two with back-references. Decodes to "ABCDEABCDEABABA".
+static std::vector<uint8_t> MixedDeflate() {
+    DeflateWriter out;
+    out.Stored("ABCD", false);
+
+    out.Bits(0, 1);
+    out.Bits(1, 2);
+    out.FixedSymbol('E');
+    out.FixedSymbol(259); // length 5
+    out.Code(4, 5); // distance 5..6
+    out.Bits(0, 1);
+    out.FixedSymbol(256);
+
+    // Literals A and B, end of block and length 3 at two bits each;
+    // distances 1 and 2 at one bit
+    std::vector<uint8_t> lengths(258 + 2, 0);
+    lengths['A'] = lengths['B'] = lengths[256] = lengths[257] = 2;
+    lengths[258] = lengths[259] = 1;
+    const std::vector<uint32_t> literal = CanonicalCodes({lengths.begin(), lengths.begin() + 258});
+    const std::vector<uint32_t> distance = CanonicalCodes({lengths.begin() + 258, lengths.end()});
+    // The code length code: lengths 1 and 2, and 18 for runs of zeros
+    std::vector<uint8_t> codeLengths(19, 0);
+    codeLengths[1] = codeLengths[2] = 2;
+    codeLengths[18] = 1;
+    const std::vector<uint32_t> codeLength = CanonicalCodes(codeLengths);
+    constexpr std::array<uint8_t, 19> order{16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+    out.Bits(1, 1);
+    out.Bits(2, 2);
+    out.Bits(258 - 257, 5);
+    out.Bits(2 - 1, 5);
+    out.Bits(18 - 4, 4);
+    for (int i = 0; i < 18; ++i) out.Bits(codeLengths[order[i]], 3);
+    const auto zeros = [&](const uint32_t count) {
+        out.Code(codeLength[18], codeLengths[18]);
+        out.Bits(count - 11, 7);
+    };
+    const auto length = [&](const uint8_t value) { out.Code(codeLength[value], codeLengths[value]); };
+    zeros(65);
+    length(2);
+    length(2);
+    zeros(138);
+    zeros(51);
+    length(2);
+    length(2);
+    length(1);
+    length(1);
+    for (const uint32_t symbol: {uint32_t{'A'}, uint32_t{'B'}, uint32_t{257}}) out.Code(literal[symbol], 2);
+    out.Code(distance[1], 1);
+    out.Code(literal[256], 2);
+    return out.bytes;
+}
+
+TEST_CASE("rom source: gzip with stored, fixed and dynamic Huffman blocks") {
+    const std::vector<uint8_t> expected = Bytes("ABCDEABCDEABABA");
+    const RomImage image = RomSource::Load(WriteTempFile("stargbc-mixed.gb.gz", Gzip(MixedDeflate(), expected)));
+    CHECK(image.container == RomContainer::Gzip);
+    CHECK(image.data == expected);
+    CHECK(image.crc32 == RomSource::Crc32(expected));
+}
+
+TEST_CASE("rom source: gzip with a bad CRC is rejected") {
+    const std::vector<uint8_t> expected = Bytes("ABCDEABCDEABABA");
+    std::vector<uint8_t> file = Gzip(MixedDeflate(), expected);
+    file[file.size() - 8] ^= 0x01;
+    CHECK_THROWS_WITH(RomSource::Load(WriteTempFile("stargbc-bad-crc.gb.gz", file)),
+                      "Corrupt ROM archive: gzip checksum mismatch");
+}
+
+TEST_CASE("rom source: zip entry with a data descriptor") {
+    const std::vector<uint8_t> expected = Bytes("ABCDEABCDEABABA");
+    const std::vector<uint8_t> readme = Bytes("not a ROM");
+    std::vector<uint8_t> file;
+    ZipEntry(file, "readme.txt", 0, readme, readme, false);
+    ZipEntry(file, "game.gb", 8, MixedDeflate(), expected, true);
+    const RomImage image = RomSource::Load(WriteTempFile("stargbc-descriptor.zip", file));
+    CHECK(image.container == RomContainer::Zip);
+    CHECK(image.data == expected);
+    CHECK(image.crc32 == RomSource::Crc32(expected));
+}
+
+TEST_CASE("rom source: decoding stops past MAX_ROM_SIZE") {
+    // One literal, then copies of 258 bytes until the output is too big
+    DeflateWriter out;
+    out.Bits(1, 1);
+    out.Bits(1, 2);
+    out.FixedSymbol(0);
+    for (size_t size = 1; size <= RomSource::MAX_ROM_SIZE; size += 258) {
+        out.FixedSymbol(285);
+        out.Code(0, 5); // distance 1
+    }
+    out.FixedSymbol(256);
+    const std::vector<uint8_t> file = Gzip(out.bytes, {});
+    CHECK(file.size() < RomSource::MAX_ROM_SIZE / 100);
+    CHECK_THROWS_WITH(RomSource::Load(WriteTempFile("stargbc-bomb.gb.gz", file)), "ROM is larger than 8 MiB");
+
+    const std::vector<uint8_t> raw(RomSource::MAX_ROM_SIZE + 1, 0x00);
+    CHECK_THROWS_WITH(RomSource::Load(WriteTempFile("stargbc-huge.gb", raw)), "ROM is larger than 8 MiB");
+}
+
+#endif //STARGBC_ROMSOURCETESTS_H
@@ -0,0 +1,324 @@
+#ifndef STARGBC_SINGLESTEPTESTS_H
+#define STARGBC_SINGLESTEPTESTS_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CPU.h"
+#include "FlatBus.h"
+
+#include "JsonStream.h"
+#include "ThreadContext.h"
+
+// SM83 SingleStepTests (github.com/SingleStepTests/sm83): one JSON file per
+// opcode, each an array of cases giving the state before and after a single
+// instruction and the bus activity of every M-cycle in between. Cases start
+// with the opcode already fetched, pc just past it, which is exactly where
+// CPU leaves off between instructions.
+static constexpr auto SST_DIRECTORY = "roms/sm83/v1";
+
+struct SstState {
+    Registers regs{};
+    uint16_t pc{0};
+    uint16_t sp{0};
+    std::optional<bool> ime;
+    uint8_t ie{0};
+    std::vector<std::pair<uint16_t, uint8_t> > ram;
+};
+
+struct SstCycle {
+    bool active{false}; // false for internal cycles with nothing on the bus
+    FlatBus::Access access{};
+};
+
+struct SstCase {
+    std::string name;
+    SstState initial;
+    SstState final;
+    std::vector<SstCycle> cycles;
+};
+
+static SstState ReadSstState(JsonStream &json) {
+    SstState state;
+    json.Expect('{');
+    bool first = true;
+    while (json.NextElement('}', first)) {
+        const std::string key = json.ReadString();
+        json.Expect(':');
+        if (key == "ram") {
+            json.Expect('[');
+            bool firstByte = true;
+            while (json.NextElement(']', firstByte)) {
+                json.Expect('[');
+                const auto address = static_cast<uint16_t>(json.ReadUnsigned());
+                json.Expect(',');
+                state.ram.emplace_back(address, static_cast<uint8_t>(json.ReadUnsigned()));
+                json.Expect(']');
+            }
+            continue;
+        }
+        if (key == "pc") state.pc = static_cast<uint16_t>(json.ReadUnsigned());
+        else if (key == "sp") state.sp = static_cast<uint16_t>(json.ReadUnsigned());
+        else if (key == "a") state.regs.a = static_cast<uint8_t>(json.ReadUnsigned());
+        else if (key == "b") state.regs.b = static_cast<uint8_t>(json.ReadUnsigned());
+        else if (key == "c") state.regs.c = static_cast<uint8_t>(json.ReadUnsigned());
+        else if (key == "d") state.regs.d = static_cast<uint8_t>(json.ReadUnsigned());
+        else if (key == "e") state.regs.e = static_cast<uint8_t>(json.ReadUnsigned());
+        else if (key == "f") state.regs.f = static_cast<uint8_t>(json.ReadUnsigned());
+        else if (key == "h") state.regs.h = static_cast<uint8_t>(json.ReadUnsigned());
+        else if (key == "l") state.regs.l = static_cast<uint8_t>(json.ReadUnsigned());
+        else if (key == "ime") state.ime = json.ReadUnsigned() != 0;
+        else if (key == "ie") state.ie = static_cast<uint8_t>(json.ReadUnsigned());
+        else json.SkipValue();
+    }
+    return state;
+}
+
+// A cycle is null, or [address, value, "rwm"] with the value null and the
+// flags "---" when nothing was on the bus
+static SstCycle ReadSstCycle(JsonStream &json) {
+    SstCycle cycle;
+    if (json.ConsumeNull()) return cycle;
+    json.Expect('[');
+    const auto address = static_cast<uint16_t>(json.ReadUnsigned());
+    json.Expect(',');
+    const bool hasValue = !json.ConsumeNull();
+    const auto value = hasValue ? static_cast<uint8_t>(json.ReadUnsigned()) : uint8_t{0};
+    json.Expect(',');
+    const std::string flags = json.ReadString();
+    json.Expect(']');
+    const bool read = flags.find('r') != std::string::npos;
+    const bool write = flags.find('w') != std::string::npos;
+    cycle.active = hasValue && (read || write);
+    cycle.access = {address, value, write};
+    return cycle;
+}
+
+// Reads the next case of the top-level array; false after the last one
+static bool ReadSstCase(JsonStream &json, bool &first, SstCase &out) {
+    if (!json.NextElement(']', first)) return false;
+    out.initial = {};
+    out.final = {};
+    out.cycles.clear();
+    json.Expect('{');
+    bool firstKey = true;
+    while (json.NextElement('}', firstKey)) {
+        const std::string key = json.ReadString();
+        json.Expect(':');
+        if (key == "name") {
+            out.name = json.ReadString();
+        } else if (key == "initial") {
+            out.initial = ReadSstState(json);
+        } else if (key == "final") {
+            out.final = ReadSstState(json);
+        } else if (key == "cycles") {
+            json.Expect('[');
+            bool firstCycle = true;
+            while (json.NextElement(']', firstCycle)) out.cycles.push_back(ReadSstCycle(json));
+        } else {
+            json.SkipValue();
+        }
+    }
+    return true;
+}
+
+static std::string DescribeAccess(const SstCycle &cycle) {
+    if (!cycle.active) return "idle";
+    char text[24];
+    std::snprintf(text, sizeof(text), "%s %04X=%02X", cycle.access.write ? "write" : "read", cycle.access.address,
+                  cycle.access.value);
+    return text;
+}
+
+// One worker's machine. The CPU is rebuilt only when a case leaves it stuck
+// mid-instruction.
+class SstRunner {
+public:
+    SstRunner() {
+        Rebuild();
+    }
+
+    // Empty when the case passes, otherwise the first difference
+    std::string Run(const SstCase &test) {
+        for (const auto &[address, value]: test.initial.ram) bus_.memory[address] = value;
+        registers_ = test.initial.regs;
+        interrupts_.interruptMasterEnable = test.initial.ime.value_or(false);
+        interrupts_.interruptDelay = false;
+        interrupts_.interruptEnable = test.initial.ie;
+        interrupts_.interruptFlag = 0x00;
+        cpu_->pc(test.initial.pc);
+        cpu_->sp(test.initial.sp);
+        cpu_->halted(false);
+        cpu_->haltBug(false);
+        cpu_->stopped(false);
+        cpu_->currentInstruction = bus_.memory[static_cast<uint16_t>(test.initial.pc - 1)];
+        cpu_->prefixed = false;
+
+        // A CB instruction is the prefix and the op after it
+        accesses_.clear();
+        cycles_.clear();
+        bus_.accesses = &accesses_;
+        std::string failure;
+        while (true) {
+            const size_t before = accesses_.size();
+            const bool done = cpu_->StepMCycle(instructions_, false);
+            if (accesses_.size() - before > 1 && failure.empty()) {
+                failure = "cycle " + std::to_string(cycles_.size()) + " has " +
+                          std::to_string(accesses_.size() - before) + " bus accesses";
+            }
+            cycles_.push_back(accesses_.size() == before ? SstCycle{} : SstCycle{true, accesses_[before]});
+            if (done && !cpu_->prefixed) break;
+            if (cycles_.size() > 16) {
+                bus_.accesses = nullptr;
+                Rebuild();
+                return "instruction never completed";
+            }
+        }
+        bus_.accesses = nullptr;
+
+        if (failure.empty()) failure = Compare(test);
+        for (const auto &[address, value]: test.initial.ram) bus_.memory[address] = 0x00;
+        for (const FlatBus::Access &access: accesses_) bus_.memory[access.address] = 0x00;
+        return failure;
+    }
+
+private:
+    void Rebuild() {
+        cpu_.reset();
+        cpu_.emplace(Mode::DMG, nullptr, bus_, interrupts_, registers_);
+        bus_.memory.fill(0x00); // drops the power-on I/O values the CPU wrote
+    }
+
+    std::string Compare(const SstCase &test) {
+        char text[96];
+        const SstState &want = test.final;
+        const std::pair<const char *, std::pair<unsigned, unsigned> > values[] = {
+            {"a", {registers_.a, want.regs.a}}, {"f", {registers_.f, want.regs.f}},
+            {"b", {registers_.b, want.regs.b}}, {"c", {registers_.c, want.regs.c}},
+            {"d", {registers_.d, want.regs.d}}, {"e", {registers_.e, want.regs.e}},
+            {"h", {registers_.h, want.regs.h}}, {"l", {registers_.l, want.regs.l}},
+            {"pc", {cpu_->pc(), want.pc}}, {"sp", {cpu_->sp(), want.sp}},
+        };
+        for (const auto &[name, pair]: values) {
+            if (pair.first != pair.second) {
+                std::snprintf(text, sizeof(text), "%s is %X, expected %X", name, pair.first, pair.second);
+                return text;
+            }
+        }
+        if (want.ime && *want.ime != interrupts_.interruptMasterEnable) {
+            return std::string("ime is ") + (interrupts_.interruptMasterEnable ? "1" : "0");
+        }
+        for (const auto &[address, value]: want.ram) {
+            if (bus_.memory[address] != value) {
+                std::snprintf(text, sizeof(text), "ram %04X is %02X, expected %02X", address, bus_.memory[address],
+                              value);
+                return text;
+            }
+        }
+        if (cycles_.size() != test.cycles.size()) {
+            return "took " + std::to_string(cycles_.size()) + " M-cycles, expected " +
+                   std::to_string(test.cycles.size());
+        }
+        for (size_t i = 0; i < cycles_.size(); i++) {
+            const SstCycle &got = cycles_[i];
+            const SstCycle &expected = test.cycles[i];
+            if (got.active != expected.active ||
+                (got.active && (got.access.address != expected.access.address ||
+                                got.access.value != expected.access.value ||
+                                got.access.write != expected.access.write))) {
+                return "cycle " + std::to_string(i) + " was " + DescribeAccess(got) + ", expected " +
+                       DescribeAccess(expected);
+            }
+        }
+        return {};
+    }
+
+    FlatBus bus_;
+    Interrupts interrupts_;
+    Registers registers_;
+    std::optional<CPU<FlatBus> > cpu_;
+    Instructions<CPU<FlatBus> > instructions_{registers_, interrupts_};
+    std::vector<FlatBus::Access> accesses_;
+    std::vector<SstCycle> cycles_;
+};
+
+// Usage: --sst [directory] [--max-threads=<n>]. Files are spread over the
+// workers; each is parsed as it runs, one case at a time.
+inline int ExecuteSingleStepTests(const int argc, char **argv) {
+    std::string directory = SST_DIRECTORY;
+    for (int i = 2; i < argc; ++i) {
+        if (const std::string_view arg = argv[i]; arg.starts_with("--max-threads=")) {
+            maxThreads = std::stoul(std::string(arg.substr(14)));
+        } else if (!arg.starts_with('-')) {
+            directory = arg;
+        }
+    }
+
+    std::vector<std::filesystem::path> files;
+    std::error_code error;
+    for (const auto &entry: std::filesystem::directory_iterator(directory, error)) {
+        if (entry.path().extension() == ".json") files.push_back(entry.path());
+    }
+    if (files.empty()) {
+        std::cerr << "No SingleStepTests JSON files in " << directory << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::ranges::sort(files);
+
+    std::atomic<size_t> nextFile{0};
+    std::atomic<uint64_t> passed{0};
+    std::atomic<uint64_t> failed{0};
+    std::mutex output;
+    const auto worker = [&] {
+        SstRunner runner;
+        SstCase test;
+        for (size_t index; (index = nextFile.fetch_add(1)) < files.size();) {
+            const std::string path = files[index].string();
+            uint64_t filePassed = 0;
+            uint64_t fileFailed = 0;
+            std::string firstFailure;
+            try {
+                JsonStream json(path);
+                json.Expect('[');
+                for (bool first = true; ReadSstCase(json, first, test);) {
+                    if (std::string failure = runner.Run(test); failure.empty()) {
+                        ++filePassed;
+                    } else if (fileFailed++ == 0) {
+                        firstFailure = test.name + ": " + failure;
+                    }
+                }
+            } catch (const std::exception &e) {
+                ++fileFailed;
+                if (firstFailure.empty()) firstFailure = e.what();
+            }
+            passed += filePassed;
+            failed += fileFailed;
+            if (fileFailed > 0) {
+                const std::lock_guard lock(output);
+                std::cerr << "Failed " << path << " (" << fileFailed << " cases), first: " << firstFailure << std::endl;
+            }
+        }
+    };
+
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::jthread> workers;
+    const size_t count = std::clamp<size_t>(maxThreads, 1, files.size());
+    for (size_t i = 0; i < count; i++) workers.emplace_back(worker);
+    workers.clear();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::printf("SingleStepTests: %llu/%llu cases passed across %zu files in %.2fs\n",
+                static_cast<unsigned long long>(passed.load()),
+                static_cast<unsigned long long>(passed.load() + failed.load()), files.size(), elapsed.count());
+    return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+#endif //STARGBC_SINGLESTEPTESTS_H
@@ -0,0 +1,44 @@
+#ifndef STARGBC_SYNTHETICROMS_H
+#define STARGBC_SYNTHETICROMS_H
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Small ROMs built in memory for the unit tests. The entry point jumps to
+// `program` at 0150. Each 16 KiB bank starts with its number (low byte,
+// high byte) so tests can tell which bank is mapped.
+static std::vector<uint8_t> MakeTestRom(const uint8_t type, const uint8_t ramSize,
+                                        const std::vector<uint8_t> &program, const size_t size = 0x8000) {
+    std::vector<uint8_t> rom(size, 0x00);
+    for (size_t bank = 1; bank < size / 0x4000; bank++) {
+        rom[bank * 0x4000] = static_cast<uint8_t>(bank);
+        rom[bank * 0x4000 + 1] = static_cast<uint8_t>(bank >> 8);
+    }
+    rom[0x100] = 0x00; // nop
+    rom[0x101] = 0xC3; // jp 0150
+    rom[0x102] = 0x50;
+    rom[0x103] = 0x01;
+    rom[0x147] = type;
+    rom[0x148] = static_cast<uint8_t>(std::max(0, std::countr_zero(size / 0x8000)));
+    rom[0x149] = ramSize;
+    std::ranges::copy(program, rom.begin() + 0x150);
+    uint8_t checksum = 0;
+    for (size_t i = 0x134; i < 0x14D; i++) checksum = static_cast<uint8_t>(checksum - rom[i] - 1);
+    rom[0x14D] = checksum;
+    return rom;
+}
+
+// Writes `bytes` to `name` in the temp directory and returns the path
+static std::string WriteTempFile(const std::string &name, const std::vector<uint8_t> &bytes) {
+    const std::string path = (std::filesystem::temp_directory_path() / name).string();
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    return path;
+}
+
+#endif //STARGBC_SYNTHETICROMS_H
@@ -0,0 +1,96 @@
+#ifndef STARGBC_WAVWRITERTESTS_H
+#define STARGBC_WAVWRITERTESTS_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <WavWriter.h>
+
+#include "doctest.h"
+#include "SyntheticRoms.h"
+
+static uint32_t GetLittleEndian(const std::vector<uint8_t> &bytes, const size_t at, const int count) {
+    uint32_t value = 0;
+    for (int i = 0; i < count; ++i) value |= uint32_t{bytes[at + i]} << 8 * i;
+    return value;
+}
+
+TEST_CASE("wav writer: header and sizes match the samples written across blocks") {
+    // Two and a bit blocks through a one-block queue, so Write() has to
+    // wait for the worker
+    const size_t frames = WavWriter::BLOCK_FRAMES * 2 + 123;
+    std::vector<float> samples(frames * 2);
+    for (size_t i = 0; i < samples.size(); ++i) samples[i] = static_cast<float>(i % 2001) / 1000.0f - 1.0f;
+    const std::string path = WriteTempFile("stargbc-audio.wav", {});
+    {
+        WavWriter writer(path, 48000, 1);
+        for (size_t at = 0; at < frames;) {
+            const size_t take = std::min<size_t>(frames - at, 5000);
+            writer.Write(&samples[at * 2], take);
+            at += take;
+        }
+        CHECK(writer.FramesWritten() == frames);
+        writer.Finish();
+    }
+
+    std::ifstream in(path, std::ios::binary);
+    const std::vector<uint8_t> bytes(std::istreambuf_iterator<char>(in), {});
+    const uint32_t dataBytes = static_cast<uint32_t>(frames * 2 * sizeof(float));
+    REQUIRE(bytes.size() == 44 + dataBytes);
+    CHECK(std::memcmp(&bytes[0], "RIFF", 4) == 0);
+    CHECK(GetLittleEndian(bytes, 4, 4) == 36 + dataBytes);
+    CHECK(std::memcmp(&bytes[8], "WAVEfmt ", 8) == 0);
+    CHECK(GetLittleEndian(bytes, 16, 4) == 16);
+    CHECK(GetLittleEndian(bytes, 20, 2) == 3); // IEEE float
+    CHECK(GetLittleEndian(bytes, 22, 2) == 2);
+    CHECK(GetLittleEndian(bytes, 24, 4) == 48000);
+    CHECK(GetLittleEndian(bytes, 28, 4) == 48000 * 8);
+    CHECK(GetLittleEndian(bytes, 32, 2) == 8);
+    CHECK(GetLittleEndian(bytes, 34, 2) == 32);
+    CHECK(std::memcmp(&bytes[36], "data", 4) == 0);
+    CHECK(GetLittleEndian(bytes, 40, 4) == dataBytes);
+
+    const WavAudio audio = WavAudio::Read(path);
+    CHECK(audio.sampleRate == 48000);
+    CHECK(audio.channels == 2);
+    CHECK(audio.samples == samples);
+}
+
+TEST_CASE("wav writer: the destructor finishes the file") {
+    const std::string path = WriteTempFile("stargbc-unfinished.wav", {});
+    const std::vector<float> samples = {0.5f, -0.5f, 0.25f, -0.25f};
+    {
+        WavWriter writer(path, 44100);
+        writer.Write(samples.data(), 2);
+    }
+    CHECK(std::filesystem::file_size(path) == 44 + samples.size() * sizeof(float));
+    CHECK(WavAudio::Read(path).samples == samples);
+}
+
+TEST_CASE("wav audio: reads 16-bit PCM and refuses what is not a WAV file") {
+    // A LIST chunk with an odd size and its pad byte comes before the data
+    const std::vector<uint8_t> pcm = {
+        'R', 'I', 'F', 'F', 50, 0, 0, 0, 'W', 'A', 'V', 'E',
+        'f', 'm', 't', ' ', 16, 0, 0, 0, 1, 0, 2, 0, 0x44, 0xAC, 0, 0, 0x10, 0xB1, 2, 0, 4, 0, 16, 0,
+        'L', 'I', 'S', 'T', 1, 0, 0, 0, 'x', 0,
+        'd', 'a', 't', 'a', 4, 0, 0, 0, 0x00, 0x40, 0x00, 0x80,
+    };
+    const WavAudio audio = WavAudio::Read(WriteTempFile("stargbc-pcm.wav", pcm));
+    CHECK(audio.sampleRate == 44100);
+    CHECK(audio.channels == 2);
+    CHECK((audio.samples == std::vector<float>{0.5f, -1.0f}));
+
+    const std::string text = WriteTempFile("stargbc-text.wav", {'h', 'e', 'l', 'l', 'o'});
+    CHECK_THROWS_WITH(WavAudio::Read(text), text + " is not a WAV file");
+    std::vector<uint8_t> cut(pcm.begin(), pcm.end() - 2);
+    const std::string damaged = WriteTempFile("stargbc-cut.wav", cut);
+    CHECK_THROWS_WITH(WavAudio::Read(damaged), damaged + " is damaged");
+}
+
+#endif //STARGBC_WAVWRITERTESTS_H
@@ -1,16 +1,64 @@
 #define DOCTEST_CONFIG_IMPLEMENT
+#include "AudioRender.h"
+#include "BlockJitTests.h"
+#include "BootStateCacheTests.h"
+#include "BusTests.h"
+#include "CartridgeTests.h"
+#include "CoroutineCoreTests.h"
+#include "FrameHashLogTests.h"
+#include "FrameHashes.h"
+#include "IdleSkipTests.h"
+#include "Lockstep.h"
+#include "MapperTests.h"
+#include "MovieTests.h"
+#include "PngWriterTests.h"
+#include "RomSourceTests.h"
+#include "SingleStepTests.h"
 #include "TestRoms.h"
+#include "WavWriterTests.h"
+
+// Every doctest case that needs no ROMs or bootroms from disk
+static int ExecuteUnitTests(const int argc, char **argv) {
+    doctest::Context ctx;
+    ctx.setOption("test-case-exclude", "*blargg*");
+    ctx.applyCommandLine(argc - 1, argv + 1);
+    return ctx.run();
+}
 
 int main(const int argc, char **argv) {
     const std::string_view arg = argc > 1 ? argv[1] : "";
     if (arg == "--blargg") {
-        ExecuteTestRoms(argc, argv);
+        return ExecuteTestRoms(argc, argv);
+    } else if (arg == "--unit") {
+        return ExecuteUnitTests(argc, argv);
+    } else if (arg == "--sst") {
+        return ExecuteSingleStepTests(argc, argv);
+    } else if (arg == "--lockstep") {
+        return ExecuteLockstep(argc, argv);
+    } else if (arg == "--frame-hashes") {
+        return ExecuteFrameHashes(argc, argv);
+    } else if (arg == "--diff-hashes") {
+        return ExecuteHashDiff(argc, argv);
+    } else if (arg == "--render-wav") {
+        return ExecuteRenderWav(argc, argv);
+    } else if (arg == "--compare-wav") {
+        return ExecuteCompareWav(argc, argv);
     } else if (arg == "--all") {
-        ExecuteTestRoms(argc, argv);
+        const int unit = ExecuteUnitTests(argc, argv);
+        const int roms = ExecuteTestRoms(argc, argv);
+        const int singleStep = ExecuteSingleStepTests(argc, argv);
+        return unit != 0 ? unit : roms != 0 ? roms : singleStep;
     } else {
         std::fprintf(stderr, "USAGE: StarGBC_Tests [options]\n"
                      "Options:\n"
+                     "  --unit              unit tests that need no ROM files\n"
                      "  --blargg            blargg test roms\n"
+                     "  --sst [dir]         SM83 SingleStepTests JSON (default roms/sm83/v1)\n"
+                     "  --lockstep <rom>    compare two CPU cores (--lockstep alone for options)\n"
+                     "  --frame-hashes <rom> <log>  record or check per-frame screen hashes\n"
+                     "  --diff-hashes <log> <log>   frames two hash logs disagree on\n"
+                     "  --render-wav <rom> <wav>    render audio offline at full speed\n"
+                     "  --compare-wav <wav> <wav>   numeric difference of two renders\n"
                      "  --all               all tests\n");
         return -1;
     }
@@ -0,0 +1,74 @@
+#ifndef STARGBC_FLATBUS_H
+#define STARGBC_FLATBUS_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Common.h"
+#include "GPU.h"
+
+// 64KB of plain memory behind the bus interface the CPU expects. Every read
+// and write is a single array access and the hardware the CPU reaches into
+// is reduced to inert stand-ins, so timing CPU<FlatBus> measures instruction
+// dispatch alone (see the --opcodes bench). With `accesses` set every
+// access is also logged, for the cycle-by-cycle CPU tests.
+struct FlatBus {
+    struct Access {
+        uint16_t address;
+        uint8_t value;
+        bool write;
+    };
+
+    struct InertHDMA {
+        [[nodiscard]] bool ShouldHaltCPU() const { return false; }
+    };
+
+    struct InertGPU {
+        Hardware hardware{Hardware::DMG};
+        InertHDMA hdma{};
+        Stat stat{};
+        std::vector<uint32_t> screenData; // blanked by STOP; nothing draws here
+    };
+
+    struct InertAudio {
+        void SetDMG(bool) {
+        }
+    };
+
+    struct InertCartridge {
+        [[nodiscard]] uint8_t ReadByte(uint16_t) const { return 0x00; }
+
+        [[nodiscard]] size_t RomPageOffset(uint16_t) const { return SIZE_MAX; }
+    };
+
+    [[nodiscard]] uint8_t ReadByte(const uint16_t address, ComponentSource) const {
+        if (accesses) accesses->push_back({address, memory[address], false});
+        return memory[address];
+    }
+
+    void WriteByte(const uint16_t address, const uint8_t value, ComponentSource) {
+        if (accesses) accesses->push_back({address, value, true});
+        memory[address] = value;
+    }
+
+    void ChangeSpeed() {
+        prepareSpeedShift = false;
+    }
+
+    void HandleOAMCorruption(uint16_t, CorruptionType) const {
+    }
+
+    std::array<uint8_t, 0x10000> memory{};
+    InertGPU gpu_{};
+    InertAudio audio_{};
+    InertCartridge cartridge_{};
+    bool bootromRunning{false};
+    bool prepareSpeedShift{false};
+    std::shared_ptr<const std::vector<uint8_t> > bootrom;
+    std::vector<Access> *accesses{nullptr};
+};
+
+#endif //STARGBC_FLATBUS_H
@@ -0,0 +1,4 @@
+#include "CPU.inl"
+#include "FlatBus.h"
+
+template class CPU<FlatBus>; // for the opcode bench and SingleStepTests